@@ -19,18 +19,25 @@
 */
 
 #include "archive.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
+#include <thread>
 #include <archive_entry.h>
 #include "../../filesystem/file.hpp"
+#include "../signatures.hpp"
 
 namespace libstriezel::sevenZip
 {
 
-archive::archive(const std::string& fileName)
-: libstriezel::archive::archiveLibarchive(fileName)
+archive::archive(const std::string& fileName, const bool lazy)
+: libstriezel::archive::archiveLibarchive(fileName),
+  m_folders(),
+  m_foldersRead(false)
 {
   applyFormats();
   int ret = archive_read_open_filename(m_archive, fileName.c_str(), 4096);
@@ -40,8 +47,45 @@ archive::archive(const std::string& fileName)
     m_archive = nullptr;
     throw std::runtime_error("libstriezel::7z::archive: Failed to open file " + fileName + "!");
   }
-  //fill entries
-  fillEntries();
+  //fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(const void* data, const std::size_t size, const bool lazy)
+: libstriezel::archive::archiveLibarchive(data, size),
+  m_folders(),
+  m_foldersRead(false)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::7z::archive: Failed to open archive from memory!");
+  }
+  //fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(libstriezel::archive::seekableStream& stream, const bool lazy)
+: libstriezel::archive::archiveLibarchive(stream),
+  m_folders(),
+  m_foldersRead(false)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::7z::archive: Failed to open archive from stream!");
+  }
+  //fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
 }
 
 archive::~archive()
@@ -65,34 +109,166 @@ void archive::applyFormats()
 
 bool archive::is7z(const std::string& fileName)
 {
-  /* The magic literal for 7z files is "7z\xBC\xAF\x27\x1C" and starts at
-     offset zero. */
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
-    return false;
+  char head[6];
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head, sizeof(head));
+  return libstriezel::archive::signatures::is7z(head, size);
+}
 
-  std::string sequence = "";
-  try
+std::map<std::string, bool> archive::extractMany(const std::map<std::string, std::string>& files,
+                                                 const unsigned int threads)
+{
+  const unsigned int workers = (threads == 0) ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+  // Streams cannot be opened a second time, so there is only one handle. A
+  // single pass in archive order already decompresses each folder once.
+  if ((workers < 2) || (nullptr != m_stream) || (files.size() < 2) || !readFolderMap())
+    return archiveLibarchive::extractMany(files);
+
+  std::map<std::string, bool> result;
+  std::map<int64_t, std::vector<request> > byFolder;
+  std::vector<const std::string*> names;
+  for (const auto& item : files)
   {
-    char buffer[6];
-    std::memset(buffer, '\0', 6);
-    stream.read(buffer, 6);
-    if (!stream.good() || (stream.gcount() < 6))
+    const int64_t idx = m_entryIndex.find(item.first);
+    if (idx < 0)
     {
-      stream.close();
-      return false;
+      std::cerr << "7z::archive::extractMany: Could not find file "
+                << item.first << " in archive!" << std::endl;
+      result[item.first] = false;
+      continue;
     }
-    sequence = std::string(buffer, 6);
+    byFolder[m_folders[idx]].push_back(request{ idx, &item.second, names.size() });
+    names.push_back(&item.first);
   }
-  catch (...)
+  // Files without data need no decompression, but they may be anywhere in
+  // the archive, so they get their own group.
+  std::vector<std::vector<request> > groups;
+  for (auto& item : byFolder)
   {
-    stream.close();
-    return false;
+    std::sort(item.second.begin(), item.second.end(),
+              [](const request& a, const request& b) { return a.entry < b.entry; });
+    groups.push_back(std::move(item.second));
+  }
+
+  std::vector<char> results(names.size(), 0);
+  // Groups are handed out in folder order, so every handle moves forward
+  // through the archive.
+  std::atomic<std::size_t> next(0);
+  const auto work = [&groups, &results, &next](archive& handle)
+  {
+    int64_t position = 0;
+    for (std::size_t g = next++; g < groups.size(); g = next++)
+      handle.extractGroup(groups[g], position, results);
+  };
+  const std::size_t helpers = std::min<std::size_t>(workers, groups.size()) - 1;
+  std::vector<std::thread> pool;
+  for (std::size_t i = 0; i < helpers; ++i)
+  {
+    pool.emplace_back([this, &work]()
+    {
+      try
+      {
+        // lazy: the entries of this handle are never listed
+        std::unique_ptr<archive> handle = (nullptr != m_data)
+            ? std::make_unique<archive>(m_data, m_dataSize, true)
+            : std::make_unique<archive>(m_fileName, true);
+        work(*handle);
+      }
+      catch (const std::exception& ex)
+      {
+        std::cerr << "7z::archive::extractMany: " << ex.what() << std::endl;
+      }
+    });
   }
-  stream.close();
+  try
+  {
+    reopen();
+    work(*this);
+    reopen();
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << "7z::archive::extractMany: " << ex.what() << std::endl;
+  }
+  for (auto& t : pool)
+    t.join();
+
+  for (std::size_t i = 0; i < names.size(); ++i)
+    result[*names[i]] = (results[i] != 0);
+  return result;
+}
 
-  return (sequence == std::string("7z\xBC\xAF\x27\x1C"));
+void archive::extractGroup(const std::vector<request>& group, int64_t& position,
+                           std::vector<char>& results)
+{
+  if (group.empty())
+    return;
+  // The handle may already be behind the first file, e.g. after the files
+  // without data.
+  if (group.front().entry < position)
+  {
+    reopen();
+    position = 0;
+  }
+  auto wanted = group.begin();
+  struct archive_entry * ent = nullptr;
+  unsigned int retryCount = 0;
+  while (wanted != group.end())
+  {
+    const int ret = archive_read_next_header(m_archive, &ent);
+    if (ret == ARCHIVE_RETRY)
+    {
+      ++retryCount;
+      if (retryCount < 100)
+        continue;
+      std::cerr << "7z::archive::extractGroup(): Too many re-tries!" << std::endl;
+      break;
+    }
+    if ((ret != ARCHIVE_OK) && (ret != ARCHIVE_WARN))
+    {
+      std::cerr << "7z::archive::extractGroup(): Could not read entry header!" << std::endl;
+      break;
+    }
+    if (position == wanted->entry)
+    {
+      results[wanted->slot] = writeEntryData(*wanted->destination,
+          archive_entry_size_is_set(ent) ? archive_entry_size(ent) : -1) ? 1 : 0;
+      ++wanted;
+    }
+    // Skipping does not decompress anything, as long as nothing of the
+    // folder of the entry has been read.
+    else if (archive_read_data_skip(m_archive) != ARCHIVE_OK)
+    {
+      std::cerr << "7z::archive::extractGroup(): Could not skip data!" << std::endl;
+      ++position;
+      break;
+    }
+    ++position;
+  }
+  // Anything that was not reached failed. The next group starts over.
+  if (wanted != group.end())
+    position = INT64_MAX;
+}
+
+CompressedReader archive::compressedReader() const
+{
+  return libstriezel::archive::compressedReader(m_fileName, m_data, m_dataSize, m_stream);
+}
+
+bool archive::readFolderMap()
+{
+  if (m_foldersRead)
+    return !m_folders.empty();
+  m_foldersRead = true;
+
+  std::vector<int64_t> folders;
+  if (!readFolders(compressedReader(), folders))
+    return false;
+  // The folders only help, if they match the entries that libarchive sees.
+  listEntries();
+  if (folders.size() != m_entries.size())
+    return false;
+  m_folders.swap(folders);
+  return !m_folders.empty();
 }
 
 } //namespace
@@ -21,11 +21,13 @@
 #ifndef LIBSTRIEZEL_7Z_ARCHIVE_HPP
 #define LIBSTRIEZEL_7Z_ARCHIVE_HPP
 
+#include <map>
 #include <string>
 #include <vector>
 #include <archive.h>
 #include "../archiveLibarchive.hpp"
 #include "../entryLibarchive.hpp"
+#include "folders.hpp"
 
 namespace libstriezel::sevenZip
 {
@@ -38,10 +40,37 @@ class archive: public libstriezel::archive::archiveLibarchive
      /** \brief constructor - opens a 7z archive in read-only mode
       *
       * \param fileName  -  file name of the 7z archive
+      * \param lazy      -  if true, the entries are listed when they are needed
+      *                     for the first time, not during construction
       * \remarks This function throws an exception, if the file does not
       *          exist or a similar error occurs.
       */
-    archive(const std::string& fileName);
+    archive(const std::string& fileName, const bool lazy = false);
+
+
+     /** \brief constructor - opens a 7z archive in memory in read-only mode
+      *
+      * \param data  pointer to the start of the archive data - the data must
+      *              stay valid as long as the archive object exists
+      * \param size  size of the archive data in bytes
+      * \param lazy  if true, the entries are listed when they are needed
+      *              for the first time, not during construction
+      * \remarks This function throws an exception, if the data cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(const void* data, const std::size_t size, const bool lazy = false);
+
+
+     /** \brief constructor - opens a 7z archive from a stream in read-only mode
+      *
+      * \param stream  the stream that contains the archive - the stream must
+      *                stay valid as long as the archive object exists
+      * \param lazy    if true, the entries are listed when they are needed
+      *                for the first time, not during construction
+      * \remarks This function throws an exception, if the stream cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(libstriezel::archive::seekableStream& stream, const bool lazy = false);
 
 
     /** \brief destructor
@@ -63,10 +92,68 @@ class archive: public libstriezel::archive::archiveLibarchive
      *         Returns false, if not.
      */
     static bool is7z(const std::string& fileName);
+
+
+    /** \brief Extracts several files to the specified destinations.
+     *
+     * \param files    maps the path of each file within the archive to the
+     *                 destination file name - destination files must not exist yet
+     * \param threads  number of threads that extract files, zero means one
+     *                 thread per processor core
+     * \return Returns a map that tells for each requested file whether it
+     *         was extracted successfully.
+     * \remarks The requested files are grouped by the solid folder that
+     *          contains them. Each folder is decompressed at most once, and
+     *          independent folders are decompressed in parallel, each one
+     *          with its own handle of the archive. Archives from streams and
+     *          archives whose header cannot be read are extracted in a single
+     *          pass by one thread.
+     */
+    std::map<std::string, bool> extractMany(const std::map<std::string, std::string>& files,
+                                            const unsigned int threads = 0);
   private:
+    /** \brief a file that shall be extracted by extractMany()
+     */
+    struct request
+    {
+      int64_t entry; /**< index of the entry in the archive */
+      const std::string* destination; /**< destination file name */
+      std::size_t slot; /**< position of the result */
+    };
+
+
     /** \brief apply format support for 7z archives
      */
     void applyFormats();
+
+
+    /** \brief Gets a callback that reads the archive data.
+     *
+     * \return Returns a reader for the archive data.
+     */
+    CompressedReader compressedReader() const;
+
+
+    /** \brief Determines the folder of each entry, if that did not happen yet.
+     *
+     * \return Returns true, if the folders of the entries are known.
+     *         Returns false, if the header of the archive could not be read.
+     */
+    bool readFolderMap();
+
+
+    /** \brief Extracts the requested files of one folder.
+     *
+     * \param group     the requested files, ordered by their position in the archive
+     * \param position  index of the entry whose header is read next - gets updated
+     * \param results   receives the result of each request at its slot
+     */
+    void extractGroup(const std::vector<request>& group, int64_t& position,
+                      std::vector<char>& results);
+
+
+    std::vector<int64_t> m_folders; /**< folder of each entry, -1 for entries without data */
+    bool m_foldersRead; /**< whether the folders have been read */
 };
 
 } // namespace
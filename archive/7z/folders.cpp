@@ -0,0 +1,562 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "folders.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <lzma.h>
+
+namespace libstriezel::sevenZip
+{
+
+namespace
+{
+
+using libstriezel::archive::readFull;
+
+/// property ids of the 7z header, see 7zFormat.txt of the 7-Zip sources
+enum property: uint64_t
+{
+  kEnd = 0x00,
+  kHeader = 0x01,
+  kArchiveProperties = 0x02,
+  kAdditionalStreamsInfo = 0x03,
+  kMainStreamsInfo = 0x04,
+  kFilesInfo = 0x05,
+  kPackInfo = 0x06,
+  kUnPackInfo = 0x07,
+  kSubStreamsInfo = 0x08,
+  kSize = 0x09,
+  kCRC = 0x0A,
+  kFolder = 0x0B,
+  kCodersUnPackSize = 0x0C,
+  kNumUnPackStream = 0x0D,
+  kEmptyStream = 0x0E,
+  kEncodedHeader = 0x17
+};
+
+/// size of the signature header at the start of every 7z archive
+const int64_t signatureHeaderSize = 32;
+
+/// largest header that will be read, protects against absurd allocations
+const uint64_t maximumHeaderSize = 256 * 1024 * 1024;
+
+/// maximum number of nested encoded headers
+const unsigned int maximumEncodingDepth = 4;
+
+uint32_t little32(const uint8_t* bytes)
+{
+  return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8)
+       | (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+uint64_t little64(const uint8_t* bytes)
+{
+  return static_cast<uint64_t>(little32(bytes)) | (static_cast<uint64_t>(little32(bytes + 4)) << 32);
+}
+
+/* Reads the elements of a header. After the first error all reads return
+   zero and failed() is true, so callers only have to check at the end of a
+   structure. */
+class headerReader
+{
+  public:
+    headerReader(const std::vector<uint8_t>& data)
+    : m_data(data), m_position(0), m_failed(false)
+    { }
+
+    bool failed() const
+    {
+      return m_failed;
+    }
+
+    std::size_t remaining() const
+    {
+      return m_data.size() - m_position;
+    }
+
+    uint8_t byte()
+    {
+      if (m_failed || (m_position >= m_data.size()))
+      {
+        m_failed = true;
+        return 0;
+      }
+      return m_data[m_position++];
+    }
+
+    /* Reads a number in the variable length encoding of 7z: the leading one
+       bits of the first byte tell how many bytes follow. */
+    uint64_t number()
+    {
+      const uint8_t first = byte();
+      uint8_t mask = 0x80;
+      uint64_t value = 0;
+      for (unsigned int i = 0; i < 8; ++i)
+      {
+        if ((first & mask) == 0)
+        {
+          const uint64_t high = first & (mask - 1);
+          return value | (high << (8 * i));
+        }
+        value |= static_cast<uint64_t>(byte()) << (8 * i);
+        mask >>= 1;
+      }
+      return value;
+    }
+
+    /* Reads a count of items that take at least one byte each. Counts that
+       cannot fit into the header are errors. */
+    uint64_t count()
+    {
+      const uint64_t value = number();
+      if (value > remaining())
+        m_failed = true;
+      return m_failed ? 0 : value;
+    }
+
+    void skip(const uint64_t size)
+    {
+      if (size > remaining())
+        m_failed = true;
+      else
+        m_position += static_cast<std::size_t>(size);
+    }
+
+    /* Reads a bit vector, most significant bit first. */
+    std::vector<bool> bits(const uint64_t size)
+    {
+      if ((size + 7) / 8 > remaining())
+      {
+        m_failed = true;
+        return std::vector<bool>();
+      }
+      std::vector<bool> result(size, false);
+      uint8_t current = 0;
+      for (uint64_t i = 0; i < size; ++i)
+      {
+        if ((i % 8) == 0)
+          current = byte();
+        result[i] = (current & (0x80 >> (i % 8))) != 0;
+      }
+      return result;
+    }
+
+    /* Reads CRC digests, returns which of them are defined. */
+    std::vector<bool> digests(const uint64_t size)
+    {
+      std::vector<bool> defined = (byte() != 0) ? std::vector<bool>(size, true) : bits(size);
+      uint64_t present = 0;
+      for (const bool d : defined)
+      {
+        if (d)
+          ++present;
+      }
+      skip(4 * present);
+      return defined;
+    }
+
+    void fail()
+    {
+      m_failed = true;
+    }
+  private:
+    const std::vector<uint8_t>& m_data;
+    std::size_t m_position;
+    bool m_failed;
+};
+
+struct coderInfo
+{
+  std::vector<uint8_t> id;
+  std::vector<uint8_t> properties;
+  uint64_t inStreams;
+  uint64_t outStreams;
+};
+
+struct folderInfo
+{
+  std::vector<coderInfo> coders;
+  std::vector<uint64_t> unpackSizes;
+  bool crcDefined = false;
+  uint64_t unpackStreams = 1;
+};
+
+struct streamsInfo
+{
+  uint64_t packPosition = 0;
+  std::vector<uint64_t> packSizes;
+  std::vector<folderInfo> folders;
+};
+
+void readPackInfo(headerReader& reader, streamsInfo& info)
+{
+  info.packPosition = reader.number();
+  const uint64_t streams = reader.count();
+  info.packSizes.assign(streams, 0);
+  for (uint64_t type = reader.number(); (type != kEnd) && !reader.failed(); type = reader.number())
+  {
+    if (type == kSize)
+    {
+      for (auto& size : info.packSizes)
+        size = reader.number();
+    }
+    else if (type == kCRC)
+      reader.digests(streams);
+    else
+      reader.fail();
+  }
+}
+
+void readFolder(headerReader& reader, folderInfo& folder)
+{
+  const uint64_t coders = reader.count();
+  uint64_t totalIn = 0;
+  uint64_t totalOut = 0;
+  for (uint64_t i = 0; (i < coders) && !reader.failed(); ++i)
+  {
+    coderInfo coder;
+    const uint8_t flags = reader.byte();
+    for (unsigned int j = 0; j < (flags & 0x0F); ++j)
+      coder.id.push_back(reader.byte());
+    coder.inStreams = 1;
+    coder.outStreams = 1;
+    if ((flags & 0x10) != 0)
+    {
+      coder.inStreams = reader.count();
+      coder.outStreams = reader.count();
+    }
+    if ((flags & 0x20) != 0)
+    {
+      const uint64_t size = reader.count();
+      for (uint64_t j = 0; j < size; ++j)
+        coder.properties.push_back(reader.byte());
+    }
+    // alternative methods were never used by 7-Zip
+    if ((flags & 0x80) != 0)
+      reader.fail();
+    totalIn += coder.inStreams;
+    totalOut += coder.outStreams;
+    folder.coders.push_back(coder);
+  }
+  if ((totalOut == 0) || reader.failed())
+  {
+    reader.fail();
+    return;
+  }
+  // bind pairs
+  for (uint64_t i = 0; i + 1 < totalOut; ++i)
+  {
+    reader.number();
+    reader.number();
+  }
+  if (totalIn < totalOut - 1)
+  {
+    reader.fail();
+    return;
+  }
+  const uint64_t packedStreams = totalIn - (totalOut - 1);
+  if (packedStreams > 1)
+  {
+    for (uint64_t i = 0; i < packedStreams; ++i)
+      reader.number();
+  }
+  folder.unpackSizes.assign(totalOut, 0);
+}
+
+void readUnpackInfo(headerReader& reader, streamsInfo& info)
+{
+  if (reader.number() != kFolder)
+  {
+    reader.fail();
+    return;
+  }
+  const uint64_t folders = reader.count();
+  // folders in additional streams are not supported
+  if (reader.byte() != 0)
+  {
+    reader.fail();
+    return;
+  }
+  info.folders.assign(folders, folderInfo());
+  for (auto& folder : info.folders)
+    readFolder(reader, folder);
+  if (reader.number() != kCodersUnPackSize)
+  {
+    reader.fail();
+    return;
+  }
+  for (auto& folder : info.folders)
+  {
+    for (auto& size : folder.unpackSizes)
+      size = reader.number();
+  }
+  for (uint64_t type = reader.number(); (type != kEnd) && !reader.failed(); type = reader.number())
+  {
+    if (type == kCRC)
+    {
+      const std::vector<bool> defined = reader.digests(folders);
+      for (std::size_t i = 0; (i < defined.size()) && (i < info.folders.size()); ++i)
+        info.folders[i].crcDefined = defined[i];
+    }
+    else
+      reader.fail();
+  }
+}
+
+void readSubStreamsInfo(headerReader& reader, streamsInfo& info)
+{
+  uint64_t type = reader.number();
+  if (type == kNumUnPackStream)
+  {
+    for (auto& folder : info.folders)
+      folder.unpackStreams = reader.number();
+    type = reader.number();
+  }
+  if (type == kSize)
+  {
+    // The size of the last stream of each folder is implicit.
+    for (const auto& folder : info.folders)
+    {
+      for (uint64_t i = 1; (i < folder.unpackStreams) && !reader.failed(); ++i)
+        reader.number();
+    }
+    type = reader.number();
+  }
+  while ((type != kEnd) && !reader.failed())
+  {
+    if (type == kCRC)
+    {
+      // Folders with a single stream already have a CRC in the unpack info.
+      uint64_t digests = 0;
+      for (const auto& folder : info.folders)
+      {
+        if ((folder.unpackStreams != 1) || !folder.crcDefined)
+          digests += folder.unpackStreams;
+      }
+      if (digests > reader.remaining() * 8)
+        reader.fail();
+      else
+        reader.digests(digests);
+    }
+    else
+      reader.fail();
+    type = reader.number();
+  }
+}
+
+void readStreamsInfo(headerReader& reader, streamsInfo& info)
+{
+  for (uint64_t type = reader.number(); (type != kEnd) && !reader.failed(); type = reader.number())
+  {
+    switch (type)
+    {
+      case kPackInfo:
+           readPackInfo(reader, info);
+           break;
+      case kUnPackInfo:
+           readUnpackInfo(reader, info);
+           break;
+      case kSubStreamsInfo:
+           readSubStreamsInfo(reader, info);
+           break;
+      default:
+           reader.fail();
+           break;
+    }
+  }
+}
+
+/* Decompresses the first folder of an encoded header. Only folders with a
+   single coder are supported, which is what 7-Zip writes for headers. */
+bool decodeHeader(const CompressedReader& reader, const streamsInfo& info, std::vector<uint8_t>& header)
+{
+  if (info.folders.empty() || info.packSizes.empty() || (info.folders[0].coders.size() != 1))
+    return false;
+  const coderInfo& coder = info.folders[0].coders[0];
+  const uint64_t packSize = info.packSizes[0];
+  const uint64_t unpackSize = info.folders[0].unpackSizes[0];
+  if ((coder.inStreams != 1) || (coder.outStreams != 1) || (packSize > maximumHeaderSize)
+      || (unpackSize > maximumHeaderSize) || (info.packPosition > static_cast<uint64_t>(INT64_MAX) - signatureHeaderSize))
+    return false;
+
+  std::vector<uint8_t> packed(static_cast<std::size_t>(packSize));
+  if (readFull(reader, signatureHeaderSize + static_cast<int64_t>(info.packPosition), packed.data(), packed.size())
+      != static_cast<int64_t>(packed.size()))
+    return false;
+
+  // copy
+  if ((coder.id.size() == 1) && (coder.id[0] == 0x00))
+  {
+    if (packSize < unpackSize)
+      return false;
+    header.assign(packed.begin(), packed.begin() + static_cast<std::ptrdiff_t>(unpackSize));
+    return true;
+  }
+
+  lzma_filter filters[2];
+  if ((coder.id.size() == 1) && (coder.id[0] == 0x21))
+    filters[0].id = LZMA_FILTER_LZMA2;
+  else if ((coder.id.size() == 3) && (coder.id[0] == 0x03) && (coder.id[1] == 0x01) && (coder.id[2] == 0x01))
+    filters[0].id = LZMA_FILTER_LZMA1;
+  else
+    return false;
+  filters[0].options = nullptr;
+  filters[1].id = LZMA_VLI_UNKNOWN;
+  filters[1].options = nullptr;
+  if (lzma_properties_decode(&filters[0], nullptr, coder.properties.data(), coder.properties.size()) != LZMA_OK)
+    return false;
+
+  lzma_stream strm = LZMA_STREAM_INIT;
+  const lzma_ret init = lzma_raw_decoder(&strm, filters);
+  std::free(filters[0].options);
+  if (init != LZMA_OK)
+    return false;
+  header.assign(static_cast<std::size_t>(unpackSize), 0);
+  strm.next_in = packed.data();
+  strm.avail_in = packed.size();
+  strm.next_out = header.data();
+  strm.avail_out = header.size();
+  // LZMA data in 7z archives usually has no end marker, so decoding stops
+  // as soon as the expected amount of data is there. liblzma reports
+  // LZMA_BUF_ERROR, if the input ends before that.
+  lzma_ret ret = LZMA_OK;
+  while ((strm.avail_out > 0) && (ret == LZMA_OK))
+    ret = lzma_code(&strm, LZMA_RUN);
+  const bool complete = (strm.avail_out == 0) && ((ret == LZMA_OK) || (ret == LZMA_STREAM_END));
+  lzma_end(&strm);
+  return complete;
+}
+
+} // anonymous namespace
+
+bool readFolders(const CompressedReader& reader, std::vector<int64_t>& folders)
+{
+  folders.clear();
+  uint8_t signature[signatureHeaderSize];
+  if (readFull(reader, 0, signature, sizeof(signature)) != static_cast<int64_t>(sizeof(signature)))
+    return false;
+  if (std::memcmp(signature, "7z\xBC\xAF\x27\x1C", 6) != 0)
+    return false;
+  if (lzma_crc32(signature + 12, 20, 0) != little32(signature + 8))
+    return false;
+  const uint64_t nextHeaderOffset = little64(signature + 12);
+  const uint64_t nextHeaderSize = little64(signature + 20);
+  if ((nextHeaderSize == 0) || (nextHeaderSize > maximumHeaderSize)
+      || (nextHeaderOffset > static_cast<uint64_t>(INT64_MAX) - signatureHeaderSize - maximumHeaderSize))
+    return false;
+
+  std::vector<uint8_t> header(static_cast<std::size_t>(nextHeaderSize));
+  if (readFull(reader, signatureHeaderSize + static_cast<int64_t>(nextHeaderOffset), header.data(), header.size())
+      != static_cast<int64_t>(header.size()))
+    return false;
+  if (lzma_crc32(header.data(), header.size(), 0) != little32(signature + 28))
+    return false;
+
+  // Headers are usually compressed, the compressed data is described by
+  // streams info right after the kEncodedHeader id.
+  for (unsigned int depth = 0; !header.empty() && (header[0] == kEncodedHeader); ++depth)
+  {
+    if (depth >= maximumEncodingDepth)
+      return false;
+    streamsInfo info;
+    headerReader encoded(header);
+    encoded.byte();
+    readStreamsInfo(encoded, info);
+    std::vector<uint8_t> decoded;
+    if (encoded.failed() || !decodeHeader(reader, info, decoded))
+      return false;
+    header.swap(decoded);
+  }
+
+  headerReader r(header);
+  if (r.number() != kHeader)
+    return false;
+  uint64_t type = r.number();
+  if (type == kArchiveProperties)
+  {
+    for (uint64_t prop = r.number(); (prop != kEnd) && !r.failed(); prop = r.number())
+      r.skip(r.number());
+    type = r.number();
+  }
+  if (type == kAdditionalStreamsInfo)
+  {
+    streamsInfo additional;
+    readStreamsInfo(r, additional);
+    type = r.number();
+  }
+  streamsInfo main;
+  if (type == kMainStreamsInfo)
+  {
+    readStreamsInfo(r, main);
+    type = r.number();
+  }
+  uint64_t files = 0;
+  std::vector<bool> emptyStream;
+  if (type == kFilesInfo)
+  {
+    files = r.count();
+    for (uint64_t prop = r.number(); (prop != kEnd) && !r.failed(); prop = r.number())
+    {
+      const uint64_t size = r.number();
+      if (prop == kEmptyStream)
+      {
+        if (size < (files + 7) / 8)
+          return false;
+        emptyStream = r.bits(files);
+        r.skip(size - (files + 7) / 8);
+      }
+      else
+        r.skip(size);
+    }
+    type = r.number();
+  }
+  if ((type != kEnd) || r.failed())
+    return false;
+
+  // Files with data get the streams of the folders one by one.
+  std::size_t folder = 0;
+  uint64_t streamsLeft = main.folders.empty() ? 0 : main.folders[0].unpackStreams;
+  folders.reserve(static_cast<std::size_t>(files));
+  for (uint64_t i = 0; i < files; ++i)
+  {
+    if ((i < emptyStream.size()) && emptyStream[i])
+    {
+      folders.push_back(-1);
+      continue;
+    }
+    while ((streamsLeft == 0) && (folder < main.folders.size()))
+    {
+      ++folder;
+      if (folder < main.folders.size())
+        streamsLeft = main.folders[folder].unpackStreams;
+    }
+    if (folder >= main.folders.size())
+    {
+      folders.clear();
+      return false;
+    }
+    folders.push_back(static_cast<int64_t>(folder));
+    --streamsLeft;
+  }
+  return true;
+}
+
+} // namespace
@@ -0,0 +1,55 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_7Z_FOLDERS_HPP
+#define LIBSTRIEZEL_7Z_FOLDERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../compressedReader.hpp"
+
+namespace libstriezel::sevenZip
+{
+
+using libstriezel::archive::CompressedReader;
+
+
+/** \brief Determines the folder that holds the data of each file in a 7z archive.
+ *
+ * A folder is a solid block of the archive: its files are compressed as one
+ * stream, so they can only be decompressed in order, starting with the
+ * first file of the folder. Different folders are independent of each other.
+ *
+ * \param reader   callback that reads the archive data
+ * \param folders  receives the index of the folder of each file, in the order
+ *                 of the files in the archive, or -1 for files without data,
+ *                 e.g. directories and empty files
+ * \return Returns true, if the folders could be determined.
+ *         Returns false, if the archive header could not be read.
+ * \remarks Only the header of the archive is read. Compressed headers are
+ *          supported, as long as they use LZMA, LZMA2 or no compression.
+ *          Encrypted headers are not supported.
+ */
+bool readFolders(const CompressedReader& reader, std::vector<int64_t>& folders);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_7Z_FOLDERS_HPP
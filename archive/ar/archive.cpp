@@ -19,16 +19,29 @@
 */
 
 #include "archive.hpp"
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <fcntl.h>
+#if defined(_WIN32)
+  #include <io.h>
+  #include <sys/stat.h>
+#else
+  #include <unistd.h>
+#endif
+#include "../../filesystem/file.hpp"
+#include "../signatures.hpp"
 
 namespace libstriezel::ar
 {
 
-archive::archive(const std::string& fileName)
-: archiveLibarchive(fileName)
+archive::archive(const std::string& fileName, const bool lazy)
+: archiveLibarchive(fileName),
+  m_mapped(nullptr),
+  m_mappedRead(false)
 {
   applyFormats();
   int ret = archive_read_open_filename(m_archive, fileName.c_str(), 4096);
@@ -38,8 +51,45 @@ archive::archive(const std::string& fileName)
     m_archive = nullptr;
     throw std::runtime_error("libstriezel::ar::archive: Failed to open file " + fileName + "!");
   }
-  // fill entries
-  fillEntries();
+  // fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(const void* data, const std::size_t size, const bool lazy)
+: archiveLibarchive(data, size),
+  m_mapped(nullptr),
+  m_mappedRead(false)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::ar::archive: Failed to open archive from memory!");
+  }
+  // fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(libstriezel::archive::seekableStream& stream, const bool lazy)
+: archiveLibarchive(stream),
+  m_mapped(nullptr),
+  m_mappedRead(false)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::ar::archive: Failed to open archive from stream!");
+  }
+  // fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
 }
 
 archive::~archive()
@@ -61,22 +111,130 @@ void archive::applyFormats()
   }
 }
 
-bool archive::isAr(const std::string& fileName)
+void archive::fillEntries()
+{
+  const mappedArchive * native = mapped();
+  if (nullptr == native)
+  {
+    archiveLibarchive::fillEntries();
+    return;
+  }
+  const std::vector<member>& members = native->members();
+  m_entries.clear();
+  m_headerOffsets.clear();
+  m_entryIndex.clear();
+  m_entries.reserve(members.size());
+  m_headerOffsets.reserve(members.size());
+  for (std::size_t i = 0; i < members.size(); ++i)
+  {
+    const member& m = members[i];
+    const libstriezel::archive::entryView view{ static_cast<int64_t>(i), m.name, static_cast<int64_t>(m.size),
+                                                m.m_time, m.directory, m.symLink };
+    m_entries.emplace_back(view);
+    m_headerOffsets.push_back(m.headerOffset);
+    // first entry wins a lookup, just like a scan from the start would do
+    m_entryIndex.add(m_entries.back().name());
+  }
+  m_entriesListed = true;
+}
+
+const mappedArchive * archive::mapped()
+{
+  if (!m_mappedRead)
+  {
+    m_mappedRead = true;
+    try
+    {
+      if (!m_fileName.empty())
+        m_mapped = std::make_unique<mappedArchive>(m_fileName);
+      else if (nullptr != m_data)
+        m_mapped = std::make_unique<mappedArchive>(m_data, m_dataSize);
+    }
+    catch (const std::exception&)
+    {
+      // libarchive may still be able to read the archive.
+      m_mapped = nullptr;
+    }
+  }
+  return m_mapped.get();
+}
+
+bool archive::memberData(const std::string& archiveFilePath, const void*& data, std::size_t& size)
 {
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
+  const mappedArchive * native = mapped();
+  const int64_t idx = (native != nullptr) ? native->locate(archiveFilePath) : -1;
+  if (idx < 0)
     return false;
+  const member& m = native->members()[static_cast<std::size_t>(idx)];
+  data = m.data;
+  size = m.size;
+  return true;
+}
 
-  char start[7];
-  std::memset(start, '\0', 7);
-  stream.read(start, 7);
-  if (!stream.good() || stream.gcount() != 7)
+bool archive::extractTo(const std::string& destFileName, const std::string& archiveFilePath)
+{
+  const mappedArchive * native = mapped();
+  const int64_t idx = (native != nullptr) ? native->locate(archiveFilePath) : -1;
+  if ((idx < 0) || native->members()[static_cast<std::size_t>(idx)].directory
+      || native->members()[static_cast<std::size_t>(idx)].symLink)
+    return archiveLibarchive::extractTo(destFileName, archiveFilePath);
+
+  if (filesystem::file::exists(destFileName))
+  {
+    std::cerr << "ar::archive::extractTo: error: destination file "
+              << destFileName << " already exists!" << std::endl;
     return false;
-  stream.close();
+  }
+  #if defined(_WIN32)
+  const int destination = _open(destFileName.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY,
+                                _S_IREAD | _S_IWRITE);
+  #else
+  const int destination = open(destFileName.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+  #endif
+  if (destination < 0)
+  {
+    std::cerr << "ar::archive::extractTo: error: destination file "
+              << destFileName << " could not be created/opened for writing!"
+              << std::endl;
+    return false;
+  }
+  // The data is written straight from the mapping.
+  const member& m = native->members()[static_cast<std::size_t>(idx)];
+  std::size_t written = 0;
+  bool success = true;
+  while (success && (written < m.size))
+  {
+    #if defined(_WIN32)
+    const int bytesWritten = _write(destination, m.data + written,
+                                    static_cast<unsigned int>(std::min<std::size_t>(m.size - written, 1 << 30)));
+    #else
+    const ssize_t bytesWritten = write(destination, m.data + written, m.size - written);
+    #endif
+    if ((bytesWritten < 0) && (errno == EINTR))
+      continue;
+    success = bytesWritten > 0;
+    if (success)
+      written += static_cast<std::size_t>(bytesWritten);
+  }
+  #if defined(_WIN32)
+  success = (_close(destination) == 0) && success;
+  #else
+  success = (close(destination) == 0) && success;
+  #endif
+  if (!success)
+  {
+    std::cerr << "ar::archive::extractTo: error: Could not write data to file "
+              << destFileName << "." << std::endl;
+    filesystem::file::remove(destFileName);
+  }
+  return success;
+}
 
-  /* magic literal for Ar files is "!<arch>".*/
-  return (std::string(start, 7) == "!<arch>");
+bool archive::isAr(const std::string& fileName)
+{
+  char head[7];
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head, sizeof(head));
+  return libstriezel::archive::signatures::isAr(head, size);
 }
 
 } // namespace
@@ -21,11 +21,13 @@
 #ifndef LIBSTRIEZEL_AR_ARCHIVE_HPP
 #define LIBSTRIEZEL_AR_ARCHIVE_HPP
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <archive.h>
 #include "../archiveLibarchive.hpp"
 #include "../entryLibarchive.hpp"
+#include "mappedArchive.hpp"
 
 namespace libstriezel::ar
 {
@@ -34,6 +36,10 @@ namespace libstriezel::ar
 using entry = libstriezel::archive::entryLibarchive;
 
 /** \brief class for handling Ar archives
+ *
+ * Archives in files or in memory are read by mappedArchive, so listing and
+ * extraction work on views of the mapped data. Archives from streams and
+ * archives that mappedArchive rejects are read with libarchive.
  */
 class archive: public libstriezel::archive::archiveLibarchive
 {
@@ -41,10 +47,37 @@ class archive: public libstriezel::archive::archiveLibarchive
      /** \brief constructor - opens an ar archive in read-only mode
       *
       * \param fileName  -  file name of the ar archive
+      * \param lazy      -  if true, the entries are listed when they are needed
+      *                     for the first time, not during construction
       * \remarks This function throws an exception, if the file does not
       *          exist or a similar error occurs.
       */
-    archive(const std::string& fileName);
+    archive(const std::string& fileName, const bool lazy = false);
+
+
+     /** \brief constructor - opens an ar archive in memory in read-only mode
+      *
+      * \param data  pointer to the start of the archive data - the data must
+      *              stay valid as long as the archive object exists
+      * \param size  size of the archive data in bytes
+      * \param lazy  if true, the entries are listed when they are needed
+      *              for the first time, not during construction
+      * \remarks This function throws an exception, if the data cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(const void* data, const std::size_t size, const bool lazy = false);
+
+
+     /** \brief constructor - opens an ar archive from a stream in read-only mode
+      *
+      * \param stream  the stream that contains the archive - the stream must
+      *                stay valid as long as the archive object exists
+      * \param lazy    if true, the entries are listed when they are needed
+      *                for the first time, not during construction
+      * \remarks This function throws an exception, if the stream cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(libstriezel::archive::seekableStream& stream, const bool lazy = false);
 
 
     /** \brief destructor
@@ -66,10 +99,58 @@ class archive: public libstriezel::archive::archiveLibarchive
      *         Returns false, if not.
      */
     static bool isAr(const std::string& fileName);
+
+
+    /** \brief Extracts the file with the given name to the specified destination.
+     *
+     * \param destFileName     the destination file name - file must not exist yet
+     * \param archiveFilePath  path of the file that shall be extracted
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     * \remarks The data is written straight from the mapping, if the native
+     *          reader can read the archive.
+     */
+    bool extractTo(const std::string& destFileName, const std::string& archiveFilePath) override;
+
+
+    /** \brief Gets the data of a member without copying it.
+     *
+     * \param archiveFilePath  name of the member
+     * \param data             receives a pointer to the start of the data
+     * \param size             receives the size of the data in bytes
+     * \return Returns true, if the member was found.
+     *         Returns false, if there is no such member or if the archive
+     *         is not read natively, e.g. because it comes from a stream.
+     * \remarks The data points into the mapped file or into the memory
+     *          buffer of the archive and stays valid as long as the archive
+     *          object exists. It can be passed to other archive classes as
+     *          it is, e.g. to tar::archive for the control.tar.xz of a
+     *          Debian package.
+     */
+    bool memberData(const std::string& archiveFilePath, const void*& data, std::size_t& size);
+  protected:
+    /** \brief Fills the list of archive entries.
+     *
+     * \remarks Only the member headers are read, if the native reader can
+     *          read the archive.
+     */
+    void fillEntries() override;
   private:
     /** \brief apply format support for Ar archives
      */
     void applyFormats();
+
+
+    /** \brief Gets the native reader of the archive, creating it on first use.
+     *
+     * \return Returns the reader. Returns nullptr for archives from streams
+     *         or archives that the native reader cannot handle.
+     */
+    const mappedArchive * mapped();
+
+
+    std::unique_ptr<mappedArchive> m_mapped; /**< native reader, or nullptr */
+    bool m_mappedRead; /**< whether the native reader has been tried */
 };
 
 } // namespace
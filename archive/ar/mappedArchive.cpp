@@ -0,0 +1,214 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "mappedArchive.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace libstriezel::ar
+{
+
+namespace
+{
+
+/// signature at the start of every ar archive
+const char signature[] = "!<arch>\n";
+/// size of the signature
+const std::size_t signatureSize = 8;
+/// size of a member header
+const std::size_t headerSize = 60;
+/// longest BSD name that is accepted, same limit as libarchive
+const uint64_t maximumNameLength = 1024 * 1024;
+
+/// offsets and sizes of the fields of a member header
+const std::size_t nameOffset = 0;
+const std::size_t nameSize = 16;
+const std::size_t timeOffset = 16;
+const std::size_t timeSize = 12;
+const std::size_t modeOffset = 40;
+const std::size_t modeSize = 8;
+const std::size_t sizeOffset = 48;
+const std::size_t sizeSize = 10;
+const std::size_t magicOffset = 58;
+
+/// file type bits of the mode
+const uint64_t typeMask = 0170000;
+const uint64_t typeDirectory = 0040000;
+const uint64_t typeSymLink = 0120000;
+
+/* Throws the exception for invalid archives. */
+[[noreturn]] void invalid(const std::string& reason)
+{
+  throw std::runtime_error("libstriezel::ar::mappedArchive: " + reason);
+}
+
+/* Parses a number with the given base like libarchive does it: leading
+   blanks are skipped, the number ends at the first other character. */
+uint64_t number(const unsigned char* field, const std::size_t length, const unsigned int base)
+{
+  std::size_t i = 0;
+  while ((i < length) && ((field[i] == ' ') || (field[i] == '\t')))
+    ++i;
+  uint64_t value = 0;
+  for (; (i < length) && (field[i] >= '0') && (field[i] < '0' + base); ++i)
+  {
+    if (value > (UINT64_MAX - 9) / base)
+      return UINT64_MAX;
+    value = value * base + (field[i] - '0');
+  }
+  return value;
+}
+
+} // anonymous namespace
+
+mappedArchive::mappedArchive(const std::string& fileName)
+: m_data(nullptr),
+  m_size(0),
+  m_file(nullptr),
+  m_members(std::vector<member>()),
+  m_lookup(std::unordered_map<std::string_view, std::size_t>())
+{
+  m_file = std::make_unique<libstriezel::archive::fileMapping>(fileName);
+  m_data = m_file->data();
+  m_size = m_file->size();
+  parse();
+}
+
+mappedArchive::mappedArchive(const void* data, const std::size_t size)
+: m_data(static_cast<const unsigned char*>(data)),
+  m_size(size),
+  m_file(nullptr),
+  m_members(std::vector<member>()),
+  m_lookup(std::unordered_map<std::string_view, std::size_t>())
+{
+  if (nullptr == data)
+    invalid("Archive data must not be null!");
+  parse();
+}
+
+const std::vector<member>& mappedArchive::members() const
+{
+  return m_members;
+}
+
+int64_t mappedArchive::locate(const std::string_view name) const
+{
+  const auto iter = m_lookup.find(name);
+  if (iter == m_lookup.end())
+    return -1;
+  return static_cast<int64_t>(iter->second);
+}
+
+void mappedArchive::parse()
+{
+  if ((m_size < signatureSize) || (std::memcmp(m_data, signature, signatureSize) != 0))
+    invalid("Data is not an ar archive.");
+
+  // GNU name table, the names are terminated by "/\n"
+  std::string_view nameTable;
+  bool hasNameTable = false;
+  std::size_t pos = signatureSize;
+  while (pos < m_size)
+  {
+    if (m_size - pos < headerSize)
+      invalid("Member header is truncated.");
+    const unsigned char * header = m_data + pos;
+    if ((header[magicOffset] != '`') || (header[magicOffset + 1] != '\n'))
+      invalid("Member header has no valid signature.");
+    const uint64_t size = number(header + sizeOffset, sizeSize, 10);
+    const std::size_t dataStart = pos + headerSize;
+    if (size > m_size - dataStart)
+      invalid("Member data is truncated.");
+
+    // Names are padded with spaces, GNU names end with a slash.
+    const char * field = reinterpret_cast<const char*>(header + nameOffset);
+    const void * nul = std::memchr(field, '\0', nameSize);
+    std::string_view name(field, (nul != nullptr) ? static_cast<const char*>(nul) - field : nameSize);
+    while (!name.empty() && (name.back() == ' '))
+      name.remove_suffix(1);
+    if ((name.size() > 1) && (name.front() != '/') && (name.back() == '/'))
+      name.remove_suffix(1);
+    if (name.empty())
+      invalid("Member has an empty name.");
+
+    member m;
+    m.data = m_data + dataStart;
+    m.size = static_cast<std::size_t>(size);
+    m.headerOffset = static_cast<int64_t>(pos);
+    m.m_time = static_cast<std::time_t>(number(header + timeOffset, timeSize, 10));
+    const uint64_t mode = number(header + modeOffset, modeSize, 8);
+    m.directory = (mode & typeMask) == typeDirectory;
+    m.symLink = (mode & typeMask) == typeSymLink;
+
+    if (name == "//")
+    {
+      if (hasNameTable || (size == 0))
+        invalid("Archive has an invalid name table.");
+      nameTable = std::string_view(reinterpret_cast<const char*>(m.data), m.size);
+      // A slash is only allowed as end of a name.
+      for (std::size_t i = 0; i + 1 < nameTable.size(); ++i)
+      {
+        if ((nameTable[i] == '/') && (nameTable[i + 1] != '\n'))
+          invalid("Archive has an invalid name table.");
+      }
+      hasNameTable = true;
+      // libarchive lists the table as empty file.
+      m.size = 0;
+      m.directory = false;
+      m.symLink = false;
+    }
+    else if ((name.size() > 1) && (name[0] == '/') && (name[1] >= '0') && (name[1] <= '9'))
+    {
+      const uint64_t offset = number(header + nameOffset + 1, nameSize - 1, 10);
+      if (!hasNameTable || (offset >= nameTable.size()))
+        invalid("Member refers to a name that does not exist.");
+      name = nameTable.substr(static_cast<std::size_t>(offset));
+      name = name.substr(0, name.find_first_of(std::string_view("/\n\0", 3)));
+    }
+    else if (name.substr(0, 3) == "#1/")
+    {
+      const uint64_t length = number(header + nameOffset + 3, nameSize - 3, 10);
+      if ((length > maximumNameLength) || (length > size))
+        invalid("Member has an invalid name length.");
+      // The name is stored before the data.
+      name = std::string_view(reinterpret_cast<const char*>(m.data), static_cast<std::size_t>(length));
+      name = name.substr(0, name.find('\0'));
+      m.data += length;
+      m.size -= static_cast<std::size_t>(length);
+    }
+    else if ((name == "/") || (name == "/SYM64/"))
+    {
+      // symbol tables are regular files, whatever their mode says
+      m.directory = false;
+      m.symLink = false;
+    }
+    if (name.empty())
+      invalid("Member has an empty name.");
+    m.name = name;
+    // first member wins a lookup, just like a scan from the start would do
+    m_lookup.emplace(m.name, m_members.size());
+    m_members.push_back(m);
+
+    // Data is padded to an even size.
+    pos = dataStart + static_cast<std::size_t>(size) + static_cast<std::size_t>(size % 2);
+  } // while
+}
+
+} // namespace
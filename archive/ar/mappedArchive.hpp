@@ -0,0 +1,127 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_AR_MAPPEDARCHIVE_HPP
+#define LIBSTRIEZEL_AR_MAPPEDARCHIVE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../fileMapping.hpp"
+
+namespace libstriezel::ar
+{
+
+/** \brief a member of an ar archive that points into the archive data
+ *
+ * Name and data are views of the mapped file or of the memory buffer, so
+ * they are only valid as long as the mappedArchive object exists.
+ */
+struct member
+{
+  std::string_view name; /**< name of the member */
+  const unsigned char * data; /**< start of the data of the member */
+  std::size_t size; /**< size of the data in bytes */
+  int64_t headerOffset; /**< offset of the member header from the start of the archive */
+  std::time_t m_time; /**< modification time */
+  bool directory; /**< whether the mode marks the member as directory */
+  bool symLink; /**< whether the mode marks the member as symbolic link */
+};
+
+
+/** \brief reads the members of an ar archive without libarchive
+ *
+ * The archive is mapped into memory and its 60-byte member headers are
+ * walked once. GNU long names from the "//" table and BSD long names
+ * ("#1/<length>") are resolved to the same names that libarchive reports.
+ * No data is copied: every member is a view of its bytes in the mapping,
+ * which can be handed to a decompressor as it is, e.g. the control.tar.xz
+ * of a Debian package.
+ */
+class mappedArchive
+{
+  public:
+    /** \brief constructor - maps an ar file into memory and reads its
+     * member headers
+     *
+     * \param fileName  -  file name of the ar archive
+     * \remarks This function throws an exception, if the file cannot be
+     *          mapped or is not a valid ar archive.
+     */
+    mappedArchive(const std::string& fileName);
+
+
+    /** \brief constructor - reads the member headers of an ar archive in memory
+     *
+     * \param data  pointer to the start of the archive - the data must stay
+     *              valid as long as the object exists
+     * \param size  size of the archive in bytes
+     * \remarks This function throws an exception, if the data is not a
+     *          valid ar archive.
+     */
+    mappedArchive(const void* data, const std::size_t size);
+
+
+    /* Delete unwanted default copy constructor, assignment operator and
+       move constructor. */
+    mappedArchive(const mappedArchive& op) = delete;
+    mappedArchive & operator=(const mappedArchive& op) = delete;
+    mappedArchive(const mappedArchive&& op) = delete;
+
+
+    /** \brief Gets all members of the archive.
+     *
+     * \return Returns the members in the order of the archive, including
+     *         the symbol table and the GNU name table, just like libarchive
+     *         lists them.
+     */
+    const std::vector<member>& members() const;
+
+
+    /** \brief Gets the index of the member with the given name.
+     *
+     * \param name  the name of the member
+     * \return Returns the index of the first member with that name.
+     *         Returns -1, if there is no such member.
+     */
+    int64_t locate(const std::string_view name) const;
+  private:
+    /** \brief Walks the member headers.
+     *
+     * \remarks This function throws an exception, if the data is not valid.
+     */
+    void parse();
+
+
+    const unsigned char * m_data; /**< start of the archive */
+    std::size_t m_size; /**< size of the archive */
+    std::unique_ptr<libstriezel::archive::fileMapping> m_file; /**< the mapped file, or nullptr for data in memory */
+    std::vector<member> m_members; /**< the members */
+    std::unordered_map<std::string_view, std::size_t> m_lookup; /**< index of each name */
+};
+
+} // namespace
+
+#endif // LIBSTRIEZEL_AR_MAPPEDARCHIVE_HPP
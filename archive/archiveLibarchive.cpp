@@ -19,18 +19,165 @@
 */
 
 #include "archiveLibarchive.hpp"
+#include <algorithm>
+#include <cerrno>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
+#include "writeBehind.hpp"
 #include "../filesystem/file.hpp"
 
 namespace libstriezel::archive
 {
 
+namespace
+{
+
+/* Gets the size of an entry from its header, or -1, if it is not known. */
+int64_t sizeHint(struct archive_entry* ent)
+{
+  return archive_entry_size_is_set(ent) ? archive_entry_size(ent) : -1;
+}
+
+/// state of a reader that starts somewhere within the archive file
+struct OffsetReader
+{
+  std::ifstream stream; /**< stream of the archive file */
+  char buffer[16384]; /**< buffer for data that is passed to libarchive */
+};
+
+la_ssize_t offsetRead(struct ::archive * a, void * clientData, const void ** buffer)
+{
+  OffsetReader * reader = static_cast<OffsetReader*>(clientData);
+  reader->stream.read(reader->buffer, sizeof(reader->buffer));
+  if (reader->stream.bad())
+  {
+    archive_set_error(a, EIO, "Read error");
+    return -1;
+  }
+  *buffer = reader->buffer;
+  return static_cast<la_ssize_t>(reader->stream.gcount());
+}
+
+la_int64_t offsetSkip(struct ::archive *, void * clientData, la_int64_t request)
+{
+  OffsetReader * reader = static_cast<OffsetReader*>(clientData);
+  if (!reader->stream.good())
+    return 0;
+  reader->stream.seekg(request, std::ios_base::cur);
+  if (!reader->stream.good())
+  {
+    // Position is unknown now, so let libarchive notice the error.
+    return 0;
+  }
+  return request;
+}
+
+int offsetClose(struct ::archive *, void * clientData)
+{
+  delete static_cast<OffsetReader*>(clientData);
+  return ARCHIVE_OK;
+}
+
+/// state of a reader that gets its data from a seekable stream
+struct StreamReader
+{
+  seekableStream * stream; /**< the stream that contains the archive */
+  int64_t base; /**< position in the stream where the archive data starts */
+  char buffer[65536]; /**< buffer for data that is passed to libarchive */
+};
+
+la_ssize_t streamRead(struct ::archive * a, void * clientData, const void ** buffer)
+{
+  StreamReader * reader = static_cast<StreamReader*>(clientData);
+  const int64_t bytesRead = reader->stream->read(reader->buffer, sizeof(reader->buffer));
+  if (bytesRead < 0)
+  {
+    archive_set_error(a, EIO, "Read error");
+    return -1;
+  }
+  *buffer = reader->buffer;
+  return static_cast<la_ssize_t>(bytesRead);
+}
+
+la_int64_t streamSkip(struct ::archive *, void * clientData, la_int64_t request)
+{
+  StreamReader * reader = static_cast<StreamReader*>(clientData);
+  if (reader->stream->seek(request, SEEK_CUR) < 0)
+  {
+    // Position is unknown now, so let libarchive notice the error.
+    return 0;
+  }
+  return request;
+}
+
+la_int64_t streamSeek(struct ::archive *, void * clientData, la_int64_t offset, int whence)
+{
+  StreamReader * reader = static_cast<StreamReader*>(clientData);
+  // libarchive counts from the start of the archive data
+  const int64_t target = (whence == SEEK_SET) ? reader->base + offset : offset;
+  const int64_t position = reader->stream->seek(target, whence);
+  if (position < 0)
+    return ARCHIVE_FATAL;
+  return position - reader->base;
+}
+
+int streamClose(struct ::archive *, void * clientData)
+{
+  // The stream itself belongs to the caller, only the reader is deleted.
+  delete static_cast<StreamReader*>(clientData);
+  return ARCHIVE_OK;
+}
+
+} // anonymous namespace
+
 archiveLibarchive::archiveLibarchive(const std::string& fileName)
 : m_archive(nullptr),
   m_entries(std::vector<libstriezel::archive::entryLibarchive>()),
-  m_fileName(fileName)
+  m_fileName(fileName),
+  m_data(nullptr),
+  m_dataSize(0),
+  m_stream(nullptr),
+  m_entriesListed(false),
+  m_listingKey(listingKey()),
+  m_listingKeyValid(false)
+{
+  // allocate new archive for reading
+  m_archive = archive_read_new();
+  if (nullptr == m_archive)
+    throw std::runtime_error("libstriezel::archive::archiveLibarchive: Could not allocate archive structure!");
+}
+
+archiveLibarchive::archiveLibarchive(const void* data, const std::size_t size)
+: m_archive(nullptr),
+  m_entries(std::vector<libstriezel::archive::entryLibarchive>()),
+  m_fileName(std::string()),
+  m_data(data),
+  m_dataSize(size),
+  m_stream(nullptr),
+  m_entriesListed(false),
+  m_listingKey(listingKey()),
+  m_listingKeyValid(false)
+{
+  if (nullptr == data)
+    throw std::runtime_error("libstriezel::archive::archiveLibarchive: Archive data must not be null!");
+  // allocate new archive for reading
+  m_archive = archive_read_new();
+  if (nullptr == m_archive)
+    throw std::runtime_error("libstriezel::archive::archiveLibarchive: Could not allocate archive structure!");
+}
+
+archiveLibarchive::archiveLibarchive(seekableStream& stream)
+: m_archive(nullptr),
+  m_entries(std::vector<libstriezel::archive::entryLibarchive>()),
+  m_fileName(std::string()),
+  m_data(nullptr),
+  m_dataSize(0),
+  m_stream(&stream),
+  m_entriesListed(false),
+  m_listingKey(listingKey()),
+  m_listingKeyValid(false)
 {
   // allocate new archive for reading
   m_archive = archive_read_new();
@@ -52,6 +199,8 @@ archiveLibarchive::~archiveLibarchive()
 void archiveLibarchive::fillEntries()
 {
   m_entries.clear();
+  m_headerOffsets.clear();
+  m_entryIndex.clear();
   struct archive_entry * ent;
   unsigned int retryCount = 0;
   bool finished = false;
@@ -63,6 +212,9 @@ void archiveLibarchive::fillEntries()
       case ARCHIVE_OK: // all OK
       case ARCHIVE_WARN: // success, but non-critical error occurred
            m_entries.push_back(ent);
+           m_headerOffsets.push_back(archive_read_header_position(m_archive));
+           // first entry wins a lookup, just like a scan from the start would do
+           m_entryIndex.add(m_entries.back().name());
            break;
       case ARCHIVE_EOF:
            // reached end of archive
@@ -73,33 +225,42 @@ void archiveLibarchive::fillEntries()
            ++retryCount;
            if (retryCount >= 100)
            {
-             archive_read_free(m_archive);
-             m_archive = nullptr;
+             // keep a usable handle, archives may be listed after construction
+             reopen();
              throw std::runtime_error("libstriezel::archive::archiveLibarchive::fillEntries(): "
                      + std::string("Too many retries!"));
            }
            break;
       case ARCHIVE_FATAL:
            // fatal error
-           archive_read_free(m_archive);
-           m_archive = nullptr;
+           reopen();
            throw std::runtime_error("libstriezel::archive::archiveLibarchive::fillEntries(): "
                    + std::string("Fatal error while getting archive entries!"));
            break;
       default:
            // unknown error
-           archive_read_free(m_archive);
-           m_archive = nullptr;
+           reopen();
            throw std::runtime_error("libstriezel::archive::archiveLibarchive::fillEntries(): "
                    + std::string("Unknown error while getting archive entries!"));
            break;
     }
   }
 
+  m_entriesListed = true;
   // reopen file to start at beginning when getting next header
   reopen();
 }
 
+void archiveLibarchive::listEntries()
+{
+  if (m_entriesListed)
+    return;
+  // A change of the file during the scan makes the key outdated, so a
+  // listing that is saved with it will not be used.
+  m_listingKeyValid = !m_fileName.empty() && getListingKey(m_fileName, m_listingKey);
+  fillEntries();
+}
+
 void archiveLibarchive::reopen()
 {
   //close and re-open archive to get to the first entry again
@@ -109,32 +270,236 @@ void archiveLibarchive::reopen()
   if (nullptr == m_archive)
     throw std::runtime_error("libstriezel::archive::archiveLibarchive::reopen(): Could not allocate archive structure!");
   applyFormats();
-  int r2 = archive_read_open_filename(m_archive, m_fileName.c_str(), 4096);
+  int r2 = openSource();
   if (r2 != ARCHIVE_OK)
   {
     archive_read_free(m_archive);
     m_archive = nullptr;
-    throw std::runtime_error("libstriezel::archive::archiveLibarchive::reopen(): Failed to re-open file " + m_fileName + "!");
+    if (!m_fileName.empty())
+      throw std::runtime_error("libstriezel::archive::archiveLibarchive::reopen(): Failed to re-open file " + m_fileName + "!");
+    throw std::runtime_error("libstriezel::archive::archiveLibarchive::reopen(): Failed to re-open archive!");
   }
 }
 
-std::vector<libstriezel::archive::entryLibarchive> archiveLibarchive::entries() const
+int archiveLibarchive::openSource(const int64_t offset)
 {
+  if (offset < 0)
+    return ARCHIVE_FATAL;
+  if (nullptr != m_data)
+  {
+    if (static_cast<uint64_t>(offset) > m_dataSize)
+      return ARCHIVE_FATAL;
+    return archive_read_open_memory(m_archive, static_cast<const char*>(m_data) + offset,
+                                    m_dataSize - static_cast<std::size_t>(offset));
+  }
+  if (nullptr != m_stream)
+  {
+    if (m_stream->seek(offset, SEEK_SET) != offset)
+      return ARCHIVE_FATAL;
+    std::unique_ptr<StreamReader> reader(new StreamReader);
+    reader->stream = m_stream;
+    reader->base = offset;
+    archive_read_set_seek_callback(m_archive, streamSeek);
+    // libarchive owns the reader from here on and deletes it in streamClose().
+    return archive_read_open2(m_archive, reader.release(), nullptr,
+                              streamRead, streamSkip, streamClose);
+  }
+  if (offset == 0)
+    return archive_read_open_filename(m_archive, m_fileName.c_str(), 4096);
+
+  std::unique_ptr<OffsetReader> reader(new OffsetReader);
+  reader->stream.open(m_fileName, std::ios_base::in | std::ios_base::binary);
+  if (!reader->stream.good() || !reader->stream.is_open())
+    return ARCHIVE_FATAL;
+  reader->stream.seekg(offset);
+  if (!reader->stream.good())
+    return ARCHIVE_FATAL;
+  // libarchive owns the reader from here on and deletes it in offsetClose().
+  return archive_read_open2(m_archive, reader.release(), nullptr,
+                            offsetRead, offsetSkip, offsetClose);
+}
+
+std::vector<libstriezel::archive::entryLibarchive> archiveLibarchive::entries()
+{
+  listEntries();
   return m_entries;
 }
 
-bool archiveLibarchive::contains(const std::string& fileName) const
+bool archiveLibarchive::forEachEntry(const EntryVisitor& visitor)
 {
-  auto it = m_entries.begin();
-  while (it != m_entries.end())
+  if (m_entriesListed)
   {
-    if (it->name() == fileName)
-      return true;
-    ++it;
-  } // while
+    for (std::size_t i = 0; i < m_entries.size(); ++i)
+    {
+      const entryLibarchive& e = m_entries[i];
+      const entryView view { static_cast<int64_t>(i), e.name(), e.size(), e.m_time(),
+                             e.isDirectory(), e.isSymLink() };
+      if (!visitor(view))
+        return false;
+    }
+    return true;
+  }
+
+  // read the headers straight from the archive, without building a list
+  reopen();
+  struct archive_entry * ent;
+  int64_t index = 0;
+  unsigned int retryCount = 0;
+  bool success = false;
+  bool finished = false;
+  while (!finished)
+  {
+    const int ret = archive_read_next_header(m_archive, &ent);
+    if ((ret == ARCHIVE_OK) || (ret == ARCHIVE_WARN))
+    {
+      const char * name = archive_entry_pathname(ent);
+      const auto type = archive_entry_filetype(ent);
+      const entryView view { index, (name != nullptr) ? std::string_view(name) : std::string_view(),
+                             archive_entry_size(ent), archive_entry_mtime(ent),
+                             type == AE_IFDIR, type == AE_IFLNK };
+      ++index;
+      finished = !visitor(view);
+    }
+    else if (ret == ARCHIVE_EOF)
+    {
+      success = true;
+      finished = true;
+    }
+    else if (ret == ARCHIVE_RETRY)
+    {
+      ++retryCount;
+      if (retryCount >= 100)
+      {
+        std::cerr << "archive::archiveLibarchive::forEachEntry(): Too many re-tries!" << std::endl;
+        finished = true;
+      }
+    }
+    else
+    {
+      //May be ARCHIVE_FATAL or similar
+      std::cerr << "archive::archiveLibarchive::forEachEntry(): Fatal or unknown error!" << std::endl;
+      finished = true;
+    }
+  } //while
+  // start at the first entry again for the next operation
+  reopen();
+  return success;
+}
+
+bool archiveLibarchive::supportsHeaderSeek() const
+{
   return false;
 }
 
+bool archiveLibarchive::seekToHeader(const int64_t offset)
+{
+  archive_read_free(m_archive);
+  m_archive = nullptr;
+  m_archive = archive_read_new();
+  if (nullptr == m_archive)
+    throw std::runtime_error("libstriezel::archive::archiveLibarchive::seekToHeader(): Could not allocate archive structure!");
+  applyFormats();
+  const int ret = openSource(offset);
+  if (ret != ARCHIVE_OK)
+  {
+    reopen();
+    return false;
+  }
+  return true;
+}
+
+bool archiveLibarchive::fillEntryTable(libstriezel::archive::entryTable& table)
+{
+  table.clear();
+  if (m_entriesListed)
+    table.reserve(m_entries.size());
+  return forEachEntry([&table](const entryView& view)
+  {
+    table.add(view);
+    return true;
+  });
+}
+
+bool archiveLibarchive::saveListing(const std::string& cacheFileName)
+{
+  if (m_fileName.empty())
+  {
+    std::cerr << "archive::archiveLibarchive::saveListing(): Only archives from files can be cached!" << std::endl;
+    return false;
+  }
+  listEntries();
+  // The listing may be older than the current state of the file, so it is
+  // saved with the key of the state that was listed.
+  if (!m_listingKeyValid)
+  {
+    std::cerr << "archive::archiveLibarchive::saveListing(): State of the archive file during the listing is unknown!" << std::endl;
+    return false;
+  }
+  entryTable table;
+  table.reserve(m_entries.size());
+  for (std::size_t i = 0; i < m_entries.size(); ++i)
+  {
+    const entryLibarchive& e = m_entries[i];
+    table.add(entryView { static_cast<int64_t>(i), e.name(), e.size(), e.m_time(),
+                          e.isDirectory(), e.isSymLink() });
+  }
+  return libstriezel::archive::saveListing(cacheFileName.empty() ? sidecarName(m_fileName) : cacheFileName,
+                                           m_listingKey, table, m_headerOffsets);
+}
+
+bool archiveLibarchive::loadListing(const std::string& cacheFileName)
+{
+  if (m_fileName.empty())
+    return false;
+  listingKey key;
+  if (!getListingKey(m_fileName, key))
+    return false;
+  entryTable table;
+  std::vector<int64_t> offsets;
+  if (!libstriezel::archive::loadListing(cacheFileName.empty() ? sidecarName(m_fileName) : cacheFileName,
+                                         key, table, offsets))
+    return false;
+  // Header seeks need one offset per entry.
+  if (offsets.size() != table.size())
+    return false;
+
+  m_entries.clear();
+  m_entries.reserve(table.size());
+  m_entryIndex.clear();
+  for (std::size_t row = 0; row < table.size(); ++row)
+  {
+    m_entries.emplace_back(table.view(row));
+    m_entryIndex.add(table.name(row));
+  }
+  m_headerOffsets.swap(offsets);
+  m_entriesListed = true;
+  m_listingKey = key;
+  m_listingKeyValid = true;
+  return true;
+}
+
+bool archiveLibarchive::useListingCache(const std::string& cacheFileName)
+{
+  if (loadListing(cacheFileName))
+    return true;
+  listEntries();
+  if (!m_fileName.empty())
+    saveListing(cacheFileName);
+  return false;
+}
+
+bool archiveLibarchive::contains(const std::string& fileName)
+{
+  listEntries();
+  return m_entryIndex.contains(fileName);
+}
+
+const libstriezel::archive::entryIndex& archiveLibarchive::index()
+{
+  listEntries();
+  return m_entryIndex;
+}
+
 bool archiveLibarchive::extractTo(const std::string& destFileName, const std::string& archiveFilePath)
 {
   //If file does not exist in archive, it cannot be extracted.
@@ -154,6 +519,14 @@ bool archiveLibarchive::extractTo(const std::string& destFileName, const std::st
     return false;
   }
 
+  /* Jump straight to the header of the entry, if the format allows it. The
+     scan below then finds the entry with the first header it reads. If the
+     jump fails, the scan starts at the first entry instead. */
+  if (supportsHeaderSeek())
+  {
+    seekToHeader(m_headerOffsets[m_entryIndex.find(archiveFilePath)]);
+  }
+
   struct archive_entry * ent;
   bool beenToEOF = false;
   unsigned int retryCount = 0;
@@ -166,55 +539,7 @@ bool archiveLibarchive::extractTo(const std::string& destFileName, const std::st
       if (e.name() == archiveFilePath)
       {
         //found the file, extract data
-        //open/create destination file
-        std::ofstream destination;
-        destination.open(destFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-        if (!destination.good() || !destination.is_open())
-        {
-          std::cerr << "archive::archiveLibarchive::extractTo: error: destination file "
-                    << destFileName << " could not be created/opened for writing!"
-                    << std::endl;
-          return false;
-        }
-
-        int64_t totalBytesRead = 0;
-        int bytesRead = 1;
-        const unsigned int bufferSize = 4096;
-        char buffer[bufferSize];
-        while (bytesRead > 0)
-        {
-          //if (totalBytesRead + bufferSize <= e.size())
-            bytesRead = archive_read_data(m_archive, buffer, bufferSize);
-          /*
-          else
-            bytesRead = archive_read_data(m_archive, buffer, e.size() % bufferSize);
-          */
-          if (bytesRead >= 0)
-          {
-            //write bytes to file
-            destination.write(buffer, bytesRead);
-            if (!destination.good())
-            {
-              std::cerr << "archive::archiveLibarchive::extractTo: error: Could not write data to file "
-                        << destFileName << "." << std::endl;
-              destination.close();
-              filesystem::file::remove(destFileName);
-              return false;
-            } //if write failed
-            totalBytesRead += bytesRead;
-          }
-          else
-          {
-            std::cerr << "archive::archiveLibarchive::extractTo: error while reading data from archive!"
-                      << std::endl;
-            destination.close();
-            filesystem::file::remove(destFileName);
-            return false;
-          } //else (error)
-        } //while
-        //close destination file
-        destination.close();
-        return true;
+        return writeEntryData(destFileName, sizeHint(ent));
       } //if
     } //if ARCHIVE_OK or ARCHIVE_WARN
     else if (ret == ARCHIVE_EOF)
@@ -273,50 +598,7 @@ bool archiveLibarchive::extractDataTo(const std::string& destFileName)
       if (e.name() == "data")
       {
         //found the data entry, extract data
-        //open/create destination file
-        std::ofstream destination;
-        destination.open(destFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-        if (!destination.good() || !destination.is_open())
-        {
-          std::cerr << "archive::archiveLibarchive::extractDataTo: error: destination file "
-                    << destFileName << " could not be created/opened for writing!"
-                    << std::endl;
-          return false;
-        }
-
-        int64_t totalBytesRead = 0;
-        int bytesRead = 1;
-        const unsigned int bufferSize = 4096;
-        char buffer[bufferSize];
-        while (bytesRead > 0)
-        {
-          bytesRead = archive_read_data(m_archive, buffer, bufferSize);
-          if (bytesRead >= 0)
-          {
-            //write bytes to file
-            destination.write(buffer, bytesRead);
-            if (!destination.good())
-            {
-              std::cerr << "archive::archiveLibarchive::extractDataTo: error: Could not write data to file "
-                        << destFileName << "." << std::endl;
-              destination.close();
-              filesystem::file::remove(destFileName);
-              return false;
-            } //if write failed
-            totalBytesRead += bytesRead;
-          }
-          else
-          {
-            std::cerr << "archive::archiveLibarchive::extractDataTo: error while reading data from archive!"
-                      << std::endl;
-            destination.close();
-            filesystem::file::remove(destFileName);
-            return false;
-          } //else (error)
-        } //while
-        //close destination file
-        destination.close();
-        return true;
+        return writeEntryData(destFileName, sizeHint(ent));
       } //if
     } //if ARCHIVE_OK or ARCHIVE_WARN
     else if (ret == ARCHIVE_EOF)
@@ -352,4 +634,328 @@ bool archiveLibarchive::extractDataTo(const std::string& destFileName)
   } //while
 }
 
+bool archiveLibarchive::writeEntryData(const std::string& destFileName, const int64_t expectedSize)
+{
+  /* Check whether destination file already exists, we do not want to overwrite
+     existing files. */
+  if (libstriezel::filesystem::file::exists(destFileName))
+  {
+    std::cerr << "archive::archiveLibarchive::writeEntryData: error: destination file "
+              << destFileName << " already exists!" << std::endl;
+    return false;
+  }
+
+  //open/create destination file
+  writeBehind destination;
+  if (!destination.open(destFileName, expectedSize))
+  {
+    std::cerr << "archive::archiveLibarchive::writeEntryData: error: destination file "
+              << destFileName << " could not be created/opened for writing!"
+              << std::endl;
+    return false;
+  }
+
+  // libarchive decompresses straight into the buffers of the writer.
+  la_ssize_t bytesRead = 1;
+  while (bytesRead > 0)
+  {
+    bytesRead = archive_read_data(m_archive, destination.data(), destination.space());
+    if (bytesRead < 0)
+    {
+      std::cerr << "archive::archiveLibarchive::writeEntryData: error while reading data from archive!"
+                << std::endl;
+      destination.finish();
+      filesystem::file::remove(destFileName);
+      return false;
+    }
+    if (!destination.produced(static_cast<std::size_t>(bytesRead)))
+    {
+      std::cerr << "archive::archiveLibarchive::writeEntryData: error: Could not write data to file "
+                << destFileName << "." << std::endl;
+      destination.finish();
+      filesystem::file::remove(destFileName);
+      return false;
+    }
+  } //while
+  //write remaining data and close destination file
+  if (!destination.finish())
+  {
+    std::cerr << "archive::archiveLibarchive::writeEntryData: error: Could not write data to file "
+              << destFileName << "." << std::endl;
+    filesystem::file::remove(destFileName);
+    return false;
+  }
+  return true;
+}
+
+std::map<std::string, bool> archiveLibarchive::extractMany(const std::map<std::string, std::string>& files)
+{
+  std::map<std::string, bool> result;
+  if (files.empty())
+    return result;
+  //start at the first entry, a previous extraction may have moved on
+  reopen();
+
+  struct archive_entry * ent;
+  unsigned int retryCount = 0;
+  bool finished = false;
+  while (!finished && (result.size() < files.size()))
+  {
+    const int ret = archive_read_next_header(m_archive, &ent);
+    if ((ret == ARCHIVE_OK) || (ret == ARCHIVE_WARN))
+    {
+      const char * name = archive_entry_pathname(ent);
+      const auto iter = (name != nullptr) ? files.find(name) : files.end();
+      // first entry wins, if there are several entries with the same name
+      if ((iter != files.end()) && (result.find(iter->first) == result.end()))
+        result[iter->first] = writeEntryData(iter->second, sizeHint(ent));
+      else if (archive_read_data_skip(m_archive) != ARCHIVE_OK)
+      {
+        std::cerr << "archive::archiveLibarchive::extractMany(): Could not skip data!" << std::endl;
+        finished = true;
+      }
+    } //if ARCHIVE_OK or ARCHIVE_WARN
+    else if (ret == ARCHIVE_EOF)
+    {
+      // reopen file to start at beginning when getting next header
+      reopen();
+      finished = true;
+    }
+    else if (ret == ARCHIVE_RETRY)
+    {
+      //retry
+      ++retryCount;
+      if (retryCount >= 100)
+      {
+        std::cerr << "archive::archiveLibarchive::extractMany(): Too many re-tries!" << std::endl;
+        finished = true;
+      }
+    } //if retry
+    else
+    {
+      //May be ARCHIVE_FATAL or similar
+      std::cerr << "archive::archiveLibarchive::extractMany(): Fatal or unknown error!" << std::endl;
+      finished = true;
+    } //else
+  } //while
+
+  //files that were not found (or not reached) could not be extracted
+  for (const auto& item : files)
+  {
+    if (result.find(item.first) == result.end())
+    {
+      std::cerr << "archive::archiveLibarchive::extractMany: Could not find file "
+                << item.first << " in archive!" << std::endl;
+      result[item.first] = false;
+    }
+  }
+  return result;
+}
+
+bool archiveLibarchive::extractToSink(const std::string& archiveFilePath, const Sink& sink)
+{
+  //If file does not exist in archive, it cannot be extracted.
+  if (!contains(archiveFilePath))
+  {
+    std::cerr << "archive::archiveLibarchive::extractToSink: error: file "
+              << archiveFilePath << " does not exist!" << std::endl;
+    return false;
+  }
+
+  struct archive_entry * ent = nullptr;
+  if (!moveToEntry(archiveFilePath, ent))
+    return false;
+  return readEntryData(ent, sink);
+}
+
+bool archiveLibarchive::extractToBuffer(const std::string& archiveFilePath, std::vector<uint8_t>& buffer)
+{
+  buffer.clear();
+  listEntries();
+  const int64_t idx = m_entryIndex.find(archiveFilePath);
+  if ((idx >= 0) && (m_entries[idx].size() > 0))
+    buffer.reserve(static_cast<std::size_t>(m_entries[idx].size()));
+  if (extractToSink(archiveFilePath, vectorSink(buffer)))
+    return true;
+  buffer.clear();
+  return false;
+}
+
+bool archiveLibarchive::extractToBuffer(const std::string& archiveFilePath, void* buffer,
+                                        const std::size_t capacity, std::size_t& size)
+{
+  size = 0;
+  return extractToSink(archiveFilePath, memorySink(buffer, capacity, size));
+}
+
+bool archiveLibarchive::extractDataToSink(const Sink& sink)
+{
+  struct archive_entry * ent = nullptr;
+  if (!moveToEntry("data", ent))
+    return false;
+  return readEntryData(ent, sink);
+}
+
+bool archiveLibarchive::extractDataToBuffer(std::vector<uint8_t>& buffer)
+{
+  buffer.clear();
+  if (extractDataToSink(vectorSink(buffer)))
+    return true;
+  buffer.clear();
+  return false;
+}
+
+bool archiveLibarchive::moveToEntry(const std::string& archiveFilePath, struct archive_entry*& ent)
+{
+  // Jump straight to the header of the entry, if the format allows it.
+  if (supportsHeaderSeek())
+  {
+    const int64_t idx = m_entryIndex.find(archiveFilePath);
+    if (idx >= 0)
+      seekToHeader(m_headerOffsets[idx]);
+  }
+
+  bool beenToEOF = false;
+  unsigned int retryCount = 0;
+  while (true)
+  {
+    const int ret = archive_read_next_header(m_archive, &ent);
+    if ((ret == ARCHIVE_OK) || (ret == ARCHIVE_WARN))
+    {
+      const char * name = archive_entry_pathname(ent);
+      if ((name != nullptr) && (archiveFilePath == name))
+        return true;
+    } //if ARCHIVE_OK or ARCHIVE_WARN
+    else if (ret == ARCHIVE_EOF)
+    {
+      if (beenToEOF)
+      {
+        //Already been here, quit.
+        std::cerr << "archive::archiveLibarchive::moveToEntry: Could not find file "
+                  << archiveFilePath << " in archive!" << std::endl;
+        return false;
+      }
+      //set EOF flag for later detection
+      beenToEOF = true;
+      //close and re-open archive to get to the first entry again
+      reopen();
+    } //if ARCHIVE_EOF
+    else if (ret == ARCHIVE_RETRY)
+    {
+      //retry
+      ++retryCount;
+      if (retryCount >= 100)
+      {
+        std::cerr << "archive::archiveLibarchive::moveToEntry(): Too many re-tries!" << std::endl;
+        return false;
+      }
+    } //if retry
+    else
+    {
+      //May be ARCHIVE_FATAL or similar
+      std::cerr << "archive::archiveLibarchive::moveToEntry(): Fatal or unknown error!" << std::endl;
+      return false;
+    } //else
+  } //while
+}
+
+bool archiveLibarchive::readEntryData(struct archive_entry* ent, const Sink& sink)
+{
+  // zeros for holes in sparse files
+  const char zeros[4096] = { 0 };
+  const void * block = nullptr;
+  size_t blockSize = 0;
+  la_int64_t offset = 0;
+  int64_t position = 0;
+  int dataRet = ARCHIVE_OK;
+  bool aborted = false;
+  while (!aborted)
+  {
+    dataRet = archive_read_data_block(m_archive, &block, &blockSize, &offset);
+    if ((dataRet != ARCHIVE_OK) && (dataRet != ARCHIVE_WARN))
+      break;
+    while (!aborted && (position < offset))
+    {
+      const int64_t gap = std::min<int64_t>(offset - position, sizeof(zeros));
+      aborted = !sink(zeros, static_cast<std::size_t>(gap));
+      position += gap;
+    }
+    //block points into the decompression buffer of libarchive, no copy
+    if (!aborted)
+      aborted = !sink(block, blockSize);
+    position = offset + static_cast<int64_t>(blockSize);
+  } //while
+  const std::string name = archive_entry_pathname(ent) != nullptr ? archive_entry_pathname(ent) : "";
+  if (aborted)
+  {
+    std::cerr << "archive::archiveLibarchive::readEntryData: error: The data of "
+              << name << " was not accepted by the sink!" << std::endl;
+    return false;
+  }
+  if (dataRet != ARCHIVE_EOF)
+  {
+    std::cerr << "archive::archiveLibarchive::readEntryData: error while reading data of "
+              << name << " from archive!" << std::endl;
+    return false;
+  }
+  //sparse files may end with a hole
+  const int64_t size = archive_entry_size_is_set(ent) ? archive_entry_size(ent) : 0;
+  while ((archive_entry_sparse_count(ent) > 0) && (position < size))
+  {
+    const int64_t gap = std::min<int64_t>(size - position, sizeof(zeros));
+    if (!sink(zeros, static_cast<std::size_t>(gap)))
+    {
+      std::cerr << "archive::archiveLibarchive::readEntryData: error: The data of "
+                << name << " was not accepted by the sink!" << std::endl;
+      return false;
+    }
+    position += gap;
+  }
+  return true;
+}
+
+bool archiveLibarchive::extractAllToSinks(const std::function<Sink(const entryLibarchive&)>& sinkFor)
+{
+  //start at the first entry, a previous extraction may have moved on
+  reopen();
+
+  struct archive_entry * ent;
+  unsigned int retryCount = 0;
+  while (true)
+  {
+    const int ret = archive_read_next_header(m_archive, &ent);
+    if ((ret == ARCHIVE_OK) || (ret == ARCHIVE_WARN))
+    {
+      entryLibarchive e(ent);
+      if (e.isDirectory() || e.isSymLink())
+        continue;
+
+      if (!readEntryData(ent, sinkFor(e)))
+        return false;
+    } //if ARCHIVE_OK or ARCHIVE_WARN
+    else if (ret == ARCHIVE_EOF)
+    {
+      // reopen file to start at beginning when getting next header
+      reopen();
+      return true;
+    }
+    else if (ret == ARCHIVE_RETRY)
+    {
+      //retry
+      ++retryCount;
+      if (retryCount >= 100)
+      {
+        std::cerr << "archive::archiveLibarchive::extractAllToSinks(): Too many re-tries!" << std::endl;
+        return false;
+      }
+    } //if retry
+    else
+    {
+      //May be ARCHIVE_FATAL or similar
+      std::cerr << "archive::archiveLibarchive::extractAllToSinks(): Fatal or unknown error!" << std::endl;
+      return false;
+    } //else
+  } //while
+}
+
 } // namespace
@@ -21,15 +21,30 @@
 #ifndef LIBSTRIEZEL_ARCHIVE_ARCHIVELIBARCHIVE_HPP
 #define LIBSTRIEZEL_ARCHIVE_ARCHIVELIBARCHIVE_HPP
 
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 #include <archive.h>
 #include "entryLibarchive.hpp"
+#include "entryIndex.hpp"
+#include "entryTable.hpp"
+#include "entryView.hpp"
+#include "listingCache.hpp"
+#include "seekableStream.hpp"
+#include "sink.hpp"
 
 namespace libstriezel::archive
 {
 
 /** \brief archive class for files opened with libarchive
+ *
+ * \remarks Archives that are opened lazily read their headers on the first
+ *          call of a function that needs the entries. Like all other
+ *          functions that read from the archive, these functions are not
+ *          thread-safe. Concurrent threads need their own archive objects.
  */
 class archiveLibarchive
 {
@@ -41,6 +56,23 @@ class archiveLibarchive
     archiveLibarchive(const std::string& fileName);
 
 
+     /** \brief constructor for archives in memory
+      *
+      * \param data  pointer to the start of the archive data - the data must
+      *              stay valid as long as the archive object exists
+      * \param size  size of the archive data in bytes
+      */
+    archiveLibarchive(const void* data, const std::size_t size);
+
+
+     /** \brief constructor for archives that are read from a stream
+      *
+      * \param stream  the stream that contains the archive - the stream must
+      *                stay valid as long as the archive object exists
+      */
+    archiveLibarchive(seekableStream& stream);
+
+
     /** \brief destructor
      */
     virtual ~archiveLibarchive();
@@ -57,8 +89,73 @@ class archiveLibarchive
      *
      * \return Returns a vector of all entries within the archive.
      * Returns an empty vector, if an error occurred.
+     * \remarks If the archive was opened lazily, the headers are read during
+     *          the first call. This function throws an exception, if they
+     *          cannot be read.
+     */
+    std::vector<libstriezel::archive::entryLibarchive> entries();
+
+
+    /** \brief Passes all entries of the archive to a visitor, one at a time.
+     *
+     * \param visitor  callback that gets a view of each entry
+     * \return Returns true, if all entries were visited.
+     *         Returns false, if an error occurred or the visitor stopped.
+     * \remarks If the entries have not been listed yet, the headers are read
+     *          straight from the archive and no list of entries is built.
+     *          The views point into the header buffer of libarchive then.
+     */
+    bool forEachEntry(const EntryVisitor& visitor);
+
+
+    /** \brief Fills a compact table with all entries of the archive.
+     *
+     * \param table  the table, its previous content is removed
+     * \return Returns true, if all entries were added.
+     *         Returns false, if an error occurred.
+     * \remarks If the entries have not been listed yet, the table is filled
+     *          straight from the headers without building entry objects.
+     */
+    bool fillEntryTable(libstriezel::archive::entryTable& table);
+
+
+    /** \brief Writes the listing of the archive to a cache file.
+     *
+     * \param cacheFileName  name of the cache file - if empty, the file is
+     *                       placed next to the archive, see sidecarName()
+     * \return Returns true, if the cache file was written.
+     *         Returns false, if an error occurred.
+     * \remarks Only archives that were opened from a file can be cached.
+     *          The cache also holds the header offsets of the entries, so
+     *          formats that support it can still jump to the entries.
+     */
+    bool saveListing(const std::string& cacheFileName = std::string());
+
+
+    /** \brief Takes the listing of the archive from a cache file.
+     *
+     * \param cacheFileName  name of the cache file - if empty, the file is
+     *                       expected next to the archive, see sidecarName()
+     * \return Returns true, if the entries were taken from the cache.
+     *         Returns false, if there is no valid cache for the archive in
+     *         its current state. The entries are unchanged then.
+     * \remarks Open the archive lazily to skip reading the headers, if the
+     *          cache is valid.
+     */
+    bool loadListing(const std::string& cacheFileName = std::string());
+
+
+    /** \brief Takes the listing from a cache file, or lists the entries and
+     * writes the cache file, if there is no valid cache yet.
+     *
+     * \param cacheFileName  name of the cache file - if empty, the file is
+     *                       next to the archive, see sidecarName()
+     * \return Returns true, if the cache was used.
+     *         Returns false, if the headers had to be read.
+     * \remarks This function throws an exception, if the headers have to be
+     *          read and that fails.
      */
-    std::vector<libstriezel::archive::entryLibarchive> entries() const;
+    bool useListingCache(const std::string& cacheFileName = std::string());
 
 
     /** \brief Checks whether the archive contains a certain file.
@@ -66,7 +163,20 @@ class archiveLibarchive
      * \param fileName  path of the file whose existence shall be checked
      * \return Returns true, if the file exists. Returns false otherwise.
      */
-    bool contains(const std::string& fileName) const;
+    bool contains(const std::string& fileName);
+
+
+    /** \brief Gets the index of the entry names.
+     *
+     * \return Returns the index. The ids in the index are the positions of
+     *         the entries in the vector that entries() returns.
+     * \remarks The index allows to look up names, list directories and search
+     *          by prefix or wildcard pattern without a scan of all entries.
+     *          If the archive was opened lazily, the headers are read during
+     *          the first call. This function throws an exception, if they
+     *          cannot be read.
+     */
+    const libstriezel::archive::entryIndex& index();
 
 
     /** \brief Extracts the file with the given name to the specified destination.
@@ -87,24 +197,196 @@ class archiveLibarchive
      * \remarks This function is only useful for single-file archives like .xz
      *          or similar archive types.
      */
-    bool extractDataTo(const std::string& destFileName);
+    virtual bool extractDataTo(const std::string& destFileName);
+
+
+    /** \brief Extracts several files to the specified destinations.
+     *
+     * \param files  maps the path of each file within the archive to the
+     *               destination file name - destination files must not exist yet
+     * \return Returns a map that contains an element for every requested file.
+     *         Its value is true, if the file could be extracted successfully,
+     *         or false, if the extraction failed.
+     * \remarks All files are extracted during a single pass over the
+     *          archive. Entries that were not requested are skipped.
+     */
+    std::map<std::string, bool> extractMany(const std::map<std::string, std::string>& files);
+
+
+    /** \brief Extracts the file with the given name and passes its data to a sink.
+     *
+     * \param archiveFilePath  path of the file that shall be extracted
+     * \param sink             callback that receives the data chunk by chunk
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed or the sink aborted it.
+     * \remarks The chunks point straight into the decompression buffer of
+     *          libarchive. Holes of sparse files are passed as zeros.
+     */
+    bool extractToSink(const std::string& archiveFilePath, const Sink& sink);
+
+
+    /** \brief Extracts the file with the given name into a memory buffer.
+     *
+     * \param archiveFilePath  path of the file that shall be extracted
+     * \param buffer           vector that will hold the data of the file
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     */
+    bool extractToBuffer(const std::string& archiveFilePath, std::vector<uint8_t>& buffer);
+
+
+    /** \brief Extracts the file with the given name into a preallocated buffer.
+     *
+     * \param archiveFilePath  path of the file that shall be extracted
+     * \param buffer           pointer to the start of the buffer
+     * \param capacity         size of the buffer in bytes
+     * \param size             variable that will hold the size of the data
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed or if the data does not
+     *         fit into the buffer.
+     */
+    bool extractToBuffer(const std::string& archiveFilePath, void* buffer,
+                         const std::size_t capacity, std::size_t& size);
+
+
+    /** \brief Extracts the data entry and passes its data to a sink.
+     *
+     * \param sink  callback that receives the data chunk by chunk
+     * \return Returns true, if the data could be extracted successfully.
+     *         Returns false, if the extraction failed or the sink aborted it.
+     * \remarks This function is only useful for single-file archives like .xz
+     *          or similar archive types.
+     */
+    bool extractDataToSink(const Sink& sink);
+
+
+    /** \brief Extracts the data entry into a memory buffer.
+     *
+     * \param buffer  vector that will hold the data
+     * \return Returns true, if the data could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     * \remarks This function is only useful for single-file archives like .xz
+     *          or similar archive types.
+     */
+    bool extractDataToBuffer(std::vector<uint8_t>& buffer);
+
+
+    /** \brief Extracts all files within the archive in a single pass and
+     * passes their data to sinks, without extracting them to disk.
+     *
+     * \param sinkFor  callback that gets the entry of each file and returns
+     *                 the sink for the data of that file
+     * \return Returns true, if all files could be extracted successfully.
+     *         Returns false, if an error occurred or a sink aborted.
+     * \remarks Directories and symbolic links are skipped. The data is passed
+     *          to the sinks straight from the decompression buffer.
+     */
+    bool extractAllToSinks(const std::function<Sink(const entryLibarchive&)>& sinkFor);
   protected:
     /** \brief Fills the list of archive entries.
+     *
+     * \remarks Formats whose headers can be read without libarchive may
+     *          override this function to list the entries faster.
+     */
+    virtual void fillEntries();
+
+
+    /** \brief Fills the list of archive entries, if that has not happened yet.
+     *
+     * \remarks Constructors of archives that are opened lazily skip the call
+     *          of this function, so every function that needs the list of
+     *          entries calls it first. It takes the listing key of the
+     *          archive file before the scan, so saveListing() writes the key
+     *          of the state that was listed.
      */
-    void fillEntries();
+    void listEntries();
 
     /** \brief Re-opens the archive.
      */
     void reopen();
 
+
+    /** \brief Opens the archive handle on the source of the archive data.
+     *
+     * \param offset  byte offset where reading shall start
+     * \return Returns the status code of libarchive, i.e. ARCHIVE_OK in case
+     *         of success.
+     * \remarks The formats have to be applied to the handle before. Memory
+     *          buffers and streams never touch the file system. Formats
+     *          that feed libarchive with data of their own, e.g. data that
+     *          is decompressed on another thread, may override this.
+     */
+    virtual int openSource(const int64_t offset = 0);
+
     /** \brief Apply format support for supported archive types.
      */
     virtual void applyFormats() = 0;
 
 
+    /** \brief Checks whether reading can start at the header of any entry.
+     *
+     * \return Returns true, if the format allows to start reading at the
+     *         recorded header offset of an entry. Returns false otherwise.
+     * \remarks This is only true for formats without compression and without
+     *          state that is carried from one entry to the next one.
+     */
+    virtual bool supportsHeaderSeek() const;
+
+
+    /** \brief Re-opens the archive so that reading starts at the given offset.
+     *
+     * \param offset  byte offset of an entry's header within the archive file
+     * \return Returns true, if the next header that is read is the header at
+     *         the given offset. Returns false, if the archive could not be
+     *         opened at that offset. In that case it starts at the first
+     *         entry again.
+     */
+    bool seekToHeader(const int64_t offset);
+
+
+    /** \brief Reads headers until the header of the given entry has been read.
+     *
+     * \param archiveFilePath  path of the entry within the archive
+     * \param ent              pointer that will point to the entry's header
+     * \return Returns true, if the entry was found. Its data is the next data
+     *         that can be read from the archive. Returns false otherwise.
+     */
+    bool moveToEntry(const std::string& archiveFilePath, struct archive_entry*& ent);
+
+
+    /** \brief Passes the data of the entry whose header was read last to a sink.
+     *
+     * \param ent   the header of the entry
+     * \param sink  callback that receives the data chunk by chunk
+     * \return Returns true, if the data could be read completely.
+     *         Returns false, if an error occurred or the sink aborted.
+     */
+    bool readEntryData(struct archive_entry* ent, const Sink& sink);
+
+
+    /** \brief Writes the data of the entry whose header was read last to a file.
+     *
+     * \param destFileName  the destination file name - file must not exist yet
+     * \param expectedSize  size of the entry in bytes, or -1, if it is not known
+     * \return Returns true, if the data could be written successfully.
+     *         Returns false, if an error occurred.
+     * \remarks Decompression and writing run on separate threads for large
+     *          entries, see writeBehind.
+     */
+    bool writeEntryData(const std::string& destFileName, const int64_t expectedSize);
+
+
     struct ::archive * m_archive; /**< archive handle */
     std::vector<libstriezel::archive::entryLibarchive> m_entries; /**< the entries in the archive */
-    std::string m_fileName; /**< original file name of archive */
+    std::vector<int64_t> m_headerOffsets; /**< header offsets of the entries, same order as m_entries */
+    libstriezel::archive::entryIndex m_entryIndex; /**< index of the entry names, ids are positions in m_entries */
+    std::string m_fileName; /**< original file name of archive, empty for other sources */
+    const void * m_data; /**< start of archive data in memory, or nullptr */
+    std::size_t m_dataSize; /**< size of archive data in memory */
+    seekableStream * m_stream; /**< stream that contains the archive, or nullptr */
+    bool m_entriesListed; /**< whether m_entries has been filled */
+    listingKey m_listingKey; /**< key of the archive file before the entries were listed */
+    bool m_listingKeyValid; /**< whether m_listingKey could be determined */
 };
 
 } // namespace
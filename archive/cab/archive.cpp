@@ -23,11 +23,12 @@
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include "../signatures.hpp"
 
 namespace libstriezel::cab
 {
 
-archive::archive(const std::string& fileName)
+archive::archive(const std::string& fileName, const bool lazy)
 : archiveLibarchive(fileName)
 {
   applyFormats();
@@ -38,8 +39,41 @@ archive::archive(const std::string& fileName)
     m_archive = nullptr;
     throw std::runtime_error("libstriezel::cab::archive: Failed to open file " + fileName + "!");
   }
-  // fill entries
-  fillEntries();
+  // fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(const void* data, const std::size_t size, const bool lazy)
+: archiveLibarchive(data, size)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::cab::archive: Failed to open archive from memory!");
+  }
+  // fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(libstriezel::archive::seekableStream& stream, const bool lazy)
+: archiveLibarchive(stream)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::cab::archive: Failed to open archive from stream!");
+  }
+  // fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
 }
 
 archive::~archive()
@@ -63,20 +97,9 @@ void archive::applyFormats()
 
 bool archive::isCab(const std::string& fileName)
 {
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
-    return false;
-
-  char start[8];
-  std::memset(start, '\0', 8);
-  stream.read(start, 8);
-  if (!stream.good() || stream.gcount() != 8)
-    return false;
-  stream.close();
-
-  /* The magic literal for Cabinet files is "MSCF\0\0\0\0".*/
-  return (std::string(start, 8) == std::string("MSCF\0\0\0\0", 8));
+  char head[8];
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head, sizeof(head));
+  return libstriezel::archive::signatures::isCab(head, size);
 }
 
 } // namespace
@@ -38,10 +38,37 @@ class archive: public libstriezel::archive::archiveLibarchive
      /** \brief constructor - opens a Cabinet archive in read-only mode
       *
       * \param fileName  -  file name of the Cabinet archive
+      * \param lazy      -  if true, the entries are listed when they are needed
+      *                     for the first time, not during construction
       * \remarks This function throws an exception, if the file does not
       *          exist or a similar error occurs.
       */
-    archive(const std::string& fileName);
+    archive(const std::string& fileName, const bool lazy = false);
+
+
+     /** \brief constructor - opens a Cabinet archive in memory in read-only mode
+      *
+      * \param data  pointer to the start of the archive data - the data must
+      *              stay valid as long as the archive object exists
+      * \param size  size of the archive data in bytes
+      * \param lazy  if true, the entries are listed when they are needed
+      *              for the first time, not during construction
+      * \remarks This function throws an exception, if the data cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(const void* data, const std::size_t size, const bool lazy = false);
+
+
+     /** \brief constructor - opens a Cabinet archive from a stream in read-only mode
+      *
+      * \param stream  the stream that contains the archive - the stream must
+      *                stay valid as long as the archive object exists
+      * \param lazy    if true, the entries are listed when they are needed
+      *                for the first time, not during construction
+      * \remarks This function throws an exception, if the stream cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(libstriezel::archive::seekableStream& stream, const bool lazy = false);
 
 
     /** \brief destructor
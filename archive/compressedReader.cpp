@@ -0,0 +1,117 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "compressedReader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#if defined(_WIN32)
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+
+namespace libstriezel::archive
+{
+
+CompressedReader compressedReader(const std::string& fileName, const void* data, const std::size_t dataSize,
+                                  seekableStream* stream)
+{
+  if (nullptr != data)
+  {
+    const uint8_t * bytes = static_cast<const uint8_t*>(data);
+    return [bytes, dataSize](const int64_t offset, void* buffer, const std::size_t size) -> int64_t
+    {
+      if ((offset < 0) || (static_cast<uint64_t>(offset) >= dataSize))
+        return 0;
+      const std::size_t chunk = std::min<std::size_t>(size, dataSize - static_cast<std::size_t>(offset));
+      std::memcpy(buffer, bytes + offset, chunk);
+      return static_cast<int64_t>(chunk);
+    };
+  }
+  if (nullptr != stream)
+  {
+    return [stream](const int64_t offset, void* buffer, const std::size_t size) -> int64_t
+    {
+      if (stream->seek(offset, SEEK_SET) != offset)
+        return -1;
+      return stream->read(buffer, size);
+    };
+  }
+  // The reader owns its file stream, so that every reader has its own.
+  const auto file = std::make_shared<std::ifstream>();
+  return [file, fileName](const int64_t offset, void* buffer, const std::size_t size) -> int64_t
+  {
+    if (!file->is_open())
+    {
+      file->open(fileName, std::ios_base::in | std::ios_base::binary);
+      if (!file->good())
+        return -1;
+    }
+    file->clear();
+    file->seekg(offset, std::ios_base::beg);
+    if (!file->good())
+      return -1;
+    file->read(static_cast<char*>(buffer), static_cast<std::streamsize>(size));
+    if (file->bad())
+      return -1;
+    return static_cast<int64_t>(file->gcount());
+  };
+}
+
+CompressedReader descriptorReader(const int fd)
+{
+  return [fd](const int64_t offset, void* buffer, const std::size_t size) -> int64_t
+  {
+    while (true)
+    {
+      #if defined(_WIN32)
+      if (_lseeki64(fd, offset, SEEK_SET) != offset)
+        return -1;
+      const int bytesRead = _read(fd, buffer, static_cast<unsigned int>(std::min<std::size_t>(size, 1 << 30)));
+      #else
+      const ssize_t bytesRead = pread(fd, buffer, size, offset);
+      #endif
+      if ((bytesRead < 0) && (errno == EINTR))
+        continue;
+      return bytesRead;
+    }
+  };
+}
+
+int64_t readFull(const CompressedReader& reader, const int64_t offset, void* buffer, const std::size_t size)
+{
+  uint8_t * bytes = static_cast<uint8_t*>(buffer);
+  std::size_t filled = 0;
+  while (filled < size)
+  {
+    const int64_t bytesRead = reader(offset + static_cast<int64_t>(filled), bytes + filled, size - filled);
+    if (bytesRead < 0)
+      return -1;
+    if (bytesRead == 0)
+      break;
+    filled += static_cast<std::size_t>(bytesRead);
+  }
+  return static_cast<int64_t>(filled);
+}
+
+} // namespace
@@ -0,0 +1,89 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_COMPRESSEDREADER_HPP
+#define LIBSTRIEZEL_ARCHIVE_COMPRESSEDREADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "seekableStream.hpp"
+
+namespace libstriezel::archive
+{
+
+/** \brief callback that reads archive data at a given position
+ *
+ * The first parameter is the offset from the start of the data, the second
+ * one is the buffer and the third one is the size of the buffer.
+ * The callback returns the number of bytes that were read, zero at the end
+ * of the data, or -1, if an error occurred.
+ */
+typedef std::function<int64_t(const int64_t offset, void* buffer, const std::size_t size)> CompressedReader;
+
+
+/** \brief Creates a reader for the source of an archive.
+ *
+ * \param fileName  name of the archive file, used when data and stream are
+ *                  both nullptr
+ * \param data      start of the archive data in memory, or nullptr
+ * \param dataSize  size of the archive data in memory
+ * \param stream    stream that contains the archive, or nullptr
+ * \return Returns a reader for the data in memory, if data is not nullptr.
+ *         Otherwise returns a reader for the stream, if stream is not
+ *         nullptr, or a reader for the file.
+ * \remarks A reader for a file opens the file on its first read and keeps
+ *          it open as long as the reader exists. Every reader has its own
+ *          file, so readers for files and memory may be used on different
+ *          threads at the same time. Readers for a stream move the position
+ *          of the stream and must not be used at the same time.
+ */
+CompressedReader compressedReader(const std::string& fileName, const void* data, const std::size_t dataSize,
+                                  seekableStream* stream);
+
+
+/** \brief Creates a reader for a file that is already open.
+ *
+ * \param fd  file descriptor of the file
+ * \return Returns a reader that does positioned reads on the file.
+ * \remarks The reader does not own the file descriptor, so it must not be
+ *          used after the file was closed. On systems with pread() the file
+ *          position is not changed, and several readers may share the same
+ *          descriptor on different threads.
+ */
+CompressedReader descriptorReader(const int fd);
+
+
+/** \brief Reads up to size bytes at the given offset, unless the data ends
+ * first.
+ *
+ * \param reader  the reader
+ * \param offset  offset of the first byte
+ * \param buffer  the buffer that gets the data
+ * \param size    number of bytes to read
+ * \return Returns the number of bytes that were read, which is less than
+ *         size only at the end of the data. Returns -1, if an error occurred.
+ */
+int64_t readFull(const CompressedReader& reader, const int64_t offset, void* buffer, const std::size_t size);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_COMPRESSEDREADER_HPP
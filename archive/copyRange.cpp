@@ -0,0 +1,250 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "copyRange.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <memory>
+#include <fcntl.h>
+#if defined(_WIN32)
+  #include <io.h>
+  #include <stdio.h>
+  #include <sys/stat.h>
+#else
+  #include <unistd.h>
+#endif
+#if defined(__linux__)
+  #include <linux/fs.h>
+  #include <sys/ioctl.h>
+  #include <sys/sendfile.h>
+  #include <sys/stat.h>
+  #include <sys/syscall.h>
+#endif
+#include "../filesystem/file.hpp"
+
+namespace libstriezel::archive
+{
+
+namespace
+{
+
+/// largest amount of data that is passed to the kernel in one call
+const int64_t chunkSize = 1 << 30;
+
+#if defined(__linux__)
+/* Returns true, if the error means that the kernel cannot do this kind of
+   copy at all, so that the next way has to be tried. */
+bool unsupported(const int error)
+{
+  return (error == ENOSYS) || (error == EXDEV) || (error == EINVAL)
+      || (error == EOPNOTSUPP) || (error == ENOTTY) || (error == EBADF)
+      || (error == ETXTBSY) || (error == EPERM);
+}
+#endif
+
+/* Copies the data with reads and writes through a buffer. */
+bool copyBuffered(const int source, const int64_t sourceOffset,
+                  const int destination, const int64_t destinationOffset,
+                  const int64_t length)
+{
+  const std::size_t bufferSize = 1024 * 1024;
+  std::unique_ptr<char[]> buffer(new char[bufferSize]);
+  int64_t done = 0;
+  #if defined(_WIN32)
+  if ((_lseeki64(source, sourceOffset, SEEK_SET) != sourceOffset)
+      || (_lseeki64(destination, destinationOffset, SEEK_SET) != destinationOffset))
+    return false;
+  #endif
+  while (done < length)
+  {
+    const std::size_t wanted = (length - done < static_cast<int64_t>(bufferSize))
+                             ? static_cast<std::size_t>(length - done) : bufferSize;
+    #if defined(_WIN32)
+    const int bytesRead = _read(source, buffer.get(), static_cast<unsigned int>(wanted));
+    #else
+    const ssize_t bytesRead = pread(source, buffer.get(), wanted, sourceOffset + done);
+    #endif
+    if (bytesRead < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    // source ends too early
+    if (bytesRead == 0)
+      return false;
+    std::size_t written = 0;
+    while (written < static_cast<std::size_t>(bytesRead))
+    {
+      #if defined(_WIN32)
+      const int bytesWritten = _write(destination, buffer.get() + written,
+                                      static_cast<unsigned int>(bytesRead - written));
+      #else
+      const ssize_t bytesWritten = pwrite(destination, buffer.get() + written,
+                                          static_cast<std::size_t>(bytesRead) - written,
+                                          destinationOffset + done + static_cast<int64_t>(written));
+      #endif
+      if (bytesWritten < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      written += static_cast<std::size_t>(bytesWritten);
+    }
+    done += bytesRead;
+  } // while
+  return true;
+}
+
+} // anonymous namespace
+
+bool copyRange(const int source, const int64_t sourceOffset,
+               const int destination, const int64_t destinationOffset,
+               const int64_t length)
+{
+  if ((source < 0) || (destination < 0) || (sourceOffset < 0)
+      || (destinationOffset < 0) || (length < 0))
+    return false;
+  int64_t done = 0;
+
+  #if defined(__linux__)
+  // Reflinks share the blocks of the source, e.g. on Btrfs or XFS. They only
+  // work for whole blocks, so the tail is copied by the other ways.
+  struct stat status;
+  if ((length > 0) && (fstat(destination, &status) == 0) && (status.st_blksize > 0))
+  {
+    const int64_t blockSize = status.st_blksize;
+    const int64_t aligned = length - length % blockSize;
+    if ((aligned > 0) && (sourceOffset % blockSize == 0) && (destinationOffset % blockSize == 0))
+    {
+      struct file_clone_range range;
+      range.src_fd = source;
+      range.src_offset = static_cast<uint64_t>(sourceOffset);
+      range.src_length = static_cast<uint64_t>(aligned);
+      range.dest_offset = static_cast<uint64_t>(destinationOffset);
+      if (ioctl(destination, FICLONERANGE, &range) == 0)
+        done = aligned;
+    }
+  }
+
+  #if defined(SYS_copy_file_range)
+  // copy_file_range() stays in the kernel and may still use reflinks or
+  // server-side copies for the parts that were not cloned.
+  bool kernelCopy = true;
+  while (kernelCopy && (done < length))
+  {
+    loff_t in = sourceOffset + done;
+    loff_t out = destinationOffset + done;
+    const std::size_t wanted = static_cast<std::size_t>(std::min(length - done, chunkSize));
+    const long copied = syscall(SYS_copy_file_range, source, &in, destination, &out, wanted, 0u);
+    if (copied < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      if (!unsupported(errno))
+        return false;
+      kernelCopy = false;
+    }
+    else if (copied == 0)
+    {
+      // source ends too early
+      return false;
+    }
+    else
+    {
+      done += copied;
+    }
+  } // while
+  #endif
+
+  // sendfile() writes at the current offset of the destination.
+  if ((done < length) && (lseek(destination, destinationOffset + done, SEEK_SET) >= 0))
+  {
+    bool kernelSend = true;
+    while (kernelSend && (done < length))
+    {
+      off_t in = sourceOffset + done;
+      const std::size_t wanted = static_cast<std::size_t>(std::min(length - done, chunkSize));
+      const ssize_t sent = sendfile(destination, source, &in, wanted);
+      if (sent < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        if (!unsupported(errno))
+          return false;
+        kernelSend = false;
+      }
+      else if (sent == 0)
+      {
+        return false;
+      }
+      else
+      {
+        done += sent;
+      }
+    } // while
+  }
+  #endif
+
+  if (done >= length)
+    return true;
+  return copyBuffered(source, sourceOffset + done, destination, destinationOffset + done, length - done);
+}
+
+bool copyToNewFile(const int source, const std::vector<byteRange>& ranges, const std::string& destFileName)
+{
+  #if defined(_WIN32)
+  const int destination = _open(destFileName.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY,
+                                _S_IREAD | _S_IWRITE);
+  #else
+  const int destination = open(destFileName.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+  #endif
+  if (destination < 0)
+  {
+    std::cerr << "archive::copyToNewFile: error: destination file "
+              << destFileName << " could not be created/opened for writing!"
+              << std::endl;
+    return false;
+  }
+
+  bool success = true;
+  int64_t written = 0;
+  for (const auto& range : ranges)
+  {
+    success = success && copyRange(source, range.offset, destination, written, range.size);
+    written += range.size;
+  }
+  #if defined(_WIN32)
+  success = (_close(destination) == 0) && success;
+  #else
+  success = (close(destination) == 0) && success;
+  #endif
+  if (!success)
+  {
+    std::cerr << "archive::copyToNewFile: error: Could not copy data to file "
+              << destFileName << "." << std::endl;
+    filesystem::file::remove(destFileName);
+  }
+  return success;
+}
+
+} // namespace
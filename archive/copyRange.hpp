@@ -0,0 +1,75 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_COPYRANGE_HPP
+#define LIBSTRIEZEL_ARCHIVE_COPYRANGE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace libstriezel::archive
+{
+
+/** \brief a range of bytes in a file
+ */
+struct byteRange
+{
+  int64_t offset; /**< offset of the first byte from the start of the file */
+  int64_t size; /**< number of bytes in the range */
+};
+
+
+/** \brief Copies a range of bytes from one file to another one.
+ *
+ * On Linux the data is shared via reflink where the file system supports
+ * it and the range is aligned to its blocks. Otherwise the kernel copies
+ * the data with copy_file_range() or sendfile(), so it does not pass
+ * through user space. Other systems use plain reads and writes.
+ * \param source             file descriptor of the source file
+ * \param sourceOffset       offset of the first byte to copy in the source
+ * \param destination        file descriptor of the destination file
+ * \param destinationOffset  offset in the destination where the data goes
+ * \param length             number of bytes to copy
+ * \return Returns true, if all bytes were copied.
+ *         Returns false, if an error occurred or the source ends early.
+ * \remarks The file offsets of both descriptors may change.
+ */
+bool copyRange(const int source, const int64_t sourceOffset,
+               const int destination, const int64_t destinationOffset,
+               const int64_t length);
+
+
+/** \brief Copies ranges of a file into a new file.
+ *
+ * \param source        file descriptor of the source file
+ * \param ranges        ranges of the source, in the order in which they are
+ *                      written to the new file
+ * \param destFileName  name of the new file - the file must not exist yet
+ * \return Returns true, if the file was created and all bytes were copied.
+ *         Returns false, if an error occurred.
+ * \remarks The data is copied with copyRange(). If copying fails, then the
+ *          new file is removed again.
+ */
+bool copyToNewFile(const int source, const std::vector<byteRange>& ranges, const std::string& destFileName);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_COPYRANGE_HPP
@@ -0,0 +1,320 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "entryIndex.hpp"
+#include <algorithm>
+#include <limits>
+#include "serialization.hpp"
+
+namespace libstriezel::archive
+{
+
+namespace
+{
+
+/// initial number of slots of the hash tables, must be a power of two
+const std::size_t initialSlots = 16;
+
+/* Computes the hash of a name for the hash tables. */
+uint64_t hashOf(const std::string_view str)
+{
+  return serialization::fnv1a(str);
+}
+
+/* Removes trailing slashes from a path. */
+std::string_view withoutTrailingSlash(std::string_view path)
+{
+  while (!path.empty() && (path.back() == '/'))
+    path.remove_suffix(1);
+  return path;
+}
+
+/* Checks whether a text matches a wildcard pattern, see entryIndex::match(). */
+bool globMatch(std::string_view pattern, std::string_view text)
+{
+  while (!pattern.empty())
+  {
+    if (pattern[0] == '*')
+    {
+      const bool crossSlash = (pattern.size() > 1) && (pattern[1] == '*');
+      pattern.remove_prefix(crossSlash ? 2 : 1);
+      // try all lengths the wildcard could match, shortest first
+      for (std::size_t i = 0; i <= text.size(); ++i)
+      {
+        if (globMatch(pattern, text.substr(i)))
+          return true;
+        if ((i < text.size()) && !crossSlash && (text[i] == '/'))
+          return false;
+      }
+      return false;
+    }
+    if (text.empty())
+      return false;
+    if (pattern[0] == '?')
+    {
+      if (text[0] == '/')
+        return false;
+    }
+    else if (pattern[0] != text[0])
+      return false;
+    pattern.remove_prefix(1);
+    text.remove_prefix(1);
+  }
+  return text.empty();
+}
+
+} // anonymous namespace
+
+const std::size_t entryIndex::none = std::numeric_limits<std::size_t>::max();
+
+entryIndex::entryIndex()
+: m_names(std::string()),
+  m_offsets(std::vector<std::size_t>()),
+  m_nameTable(std::vector<slot>()),
+  m_nameCount(0),
+  m_nodes(std::vector<node>()),
+  m_nodeTable(std::vector<slot>()),
+  m_duplicates(std::vector<std::pair<std::size_t, std::size_t> >())
+{
+  clear();
+}
+
+void entryIndex::clear()
+{
+  m_names.clear();
+  m_offsets.assign(1, 0);
+  m_nameTable.assign(initialSlots, slot{ 0, none });
+  m_nameCount = 0;
+  // The root of the tree has the empty path and is not in the table.
+  m_nodes.clear();
+  m_nodes.push_back(node{ 0, 0, -1, std::vector<std::size_t>() });
+  m_nodeTable.assign(initialSlots, slot{ 0, none });
+  m_duplicates.clear();
+}
+
+std::size_t entryIndex::add(const std::string_view name)
+{
+  const std::size_t id = size();
+  const std::size_t offset = m_names.size();
+  m_names.append(name);
+  m_offsets.push_back(m_names.size());
+
+  const uint64_t hash = hashOf(name);
+  const std::size_t pos = findSlot(m_nameTable, hash, name, false);
+  if (m_nameTable[pos].id == none)
+  {
+    ++m_nameCount;
+    insert(m_nameTable, m_nameCount, hash, pos, id);
+  }
+
+  const std::size_t length = withoutTrailingSlash(name).size();
+  if (length == 0)
+    return id;
+  const std::size_t nodeId = ensureNode(offset, length);
+  if (m_nodes[nodeId].entry < 0)
+    m_nodes[nodeId].entry = static_cast<int64_t>(id);
+  else
+    m_duplicates.emplace_back(nodeId, id);
+  return id;
+}
+
+std::size_t entryIndex::size() const
+{
+  return m_offsets.size() - 1;
+}
+
+std::string_view entryIndex::name(const std::size_t id) const
+{
+  return std::string_view(m_names.data() + m_offsets[id], m_offsets[id + 1] - m_offsets[id]);
+}
+
+int64_t entryIndex::find(const std::string_view name) const
+{
+  const std::size_t pos = findSlot(m_nameTable, hashOf(name), name, false);
+  if (m_nameTable[pos].id == none)
+    return -1;
+  return static_cast<int64_t>(m_nameTable[pos].id);
+}
+
+bool entryIndex::contains(const std::string_view name) const
+{
+  return find(name) >= 0;
+}
+
+bool entryIndex::isDirectory(const std::string_view path) const
+{
+  const int64_t nodeId = findNode(path);
+  if (nodeId < 0)
+    return false;
+  const node& n = m_nodes[nodeId];
+  if ((nodeId == 0) || !n.children.empty())
+    return true;
+  // directory entries end with a slash
+  return (n.entry >= 0) && (name(n.entry).back() == '/');
+}
+
+std::vector<std::string_view> entryIndex::children(const std::string_view directory) const
+{
+  std::vector<std::string_view> result;
+  const int64_t nodeId = findNode(directory);
+  if (nodeId < 0)
+    return result;
+  result.reserve(m_nodes[nodeId].children.size());
+  for (const std::size_t child : m_nodes[nodeId].children)
+  {
+    result.push_back(nodePath(child));
+  }
+  return result;
+}
+
+std::vector<std::size_t> entryIndex::withPrefix(const std::string_view prefix) const
+{
+  std::vector<std::size_t> result;
+  const std::string_view::size_type cut = prefix.rfind('/');
+  const int64_t start = findNode(cut == std::string_view::npos ? std::string_view() : prefix.substr(0, cut));
+  if (start < 0)
+    return result;
+
+  // Below the first level every entry starts with the prefix, so only the
+  // children of the start node have to be checked.
+  std::vector<std::size_t> stack;
+  std::vector<bool> visited(m_duplicates.empty() ? 0 : m_nodes.size(), false);
+  const node& first = m_nodes[start];
+  if ((first.entry >= 0) && (name(first.entry).substr(0, prefix.size()) == prefix))
+  {
+    result.push_back(static_cast<std::size_t>(first.entry));
+    if (!visited.empty())
+      visited[start] = true;
+  }
+  for (const std::size_t child : first.children)
+  {
+    if (nodePath(child).substr(0, prefix.size()) == prefix)
+      stack.push_back(child);
+  }
+  while (!stack.empty())
+  {
+    const std::size_t current = stack.back();
+    stack.pop_back();
+    const node& n = m_nodes[current];
+    if (n.entry >= 0)
+      result.push_back(static_cast<std::size_t>(n.entry));
+    if (!visited.empty())
+      visited[current] = true;
+    stack.insert(stack.end(), n.children.begin(), n.children.end());
+  }
+  for (const auto& item : m_duplicates)
+  {
+    if (visited[item.first])
+      result.push_back(item.second);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<std::size_t> entryIndex::match(const std::string_view pattern) const
+{
+  // The part before the first wildcard narrows down the search.
+  const std::string_view literal = pattern.substr(0, pattern.find_first_of("*?"));
+  std::vector<std::size_t> result = withPrefix(literal);
+  if (literal.size() == pattern.size())
+  {
+    result.erase(std::remove_if(result.begin(), result.end(),
+                                [this, pattern](const std::size_t id) { return name(id) != pattern; }),
+                 result.end());
+    return result;
+  }
+  result.erase(std::remove_if(result.begin(), result.end(),
+                              [this, pattern](const std::size_t id) { return !globMatch(pattern, name(id)); }),
+               result.end());
+  return result;
+}
+
+std::string_view entryIndex::nodePath(const std::size_t id) const
+{
+  return std::string_view(m_names.data() + m_nodes[id].offset, m_nodes[id].length);
+}
+
+int64_t entryIndex::findNode(const std::string_view path) const
+{
+  const std::string_view stripped = withoutTrailingSlash(path);
+  if (stripped.empty())
+    return 0;
+  const std::size_t pos = findSlot(m_nodeTable, hashOf(stripped), stripped, true);
+  if (m_nodeTable[pos].id == none)
+    return -1;
+  return static_cast<int64_t>(m_nodeTable[pos].id);
+}
+
+std::size_t entryIndex::ensureNode(const std::size_t offset, const std::size_t length)
+{
+  const std::string_view path(m_names.data() + offset, length);
+  const uint64_t hash = hashOf(path);
+  const std::size_t existing = m_nodeTable[findSlot(m_nodeTable, hash, path, true)].id;
+  if (existing != none)
+    return existing;
+
+  const std::string_view::size_type cut = path.rfind('/');
+  const std::size_t parent = (cut == std::string_view::npos)
+      ? 0 : ensureNode(offset, withoutTrailingSlash(path.substr(0, cut)).size());
+  const std::size_t id = m_nodes.size();
+  m_nodes.push_back(node{ offset, length, -1, std::vector<std::size_t>() });
+  m_nodes[parent].children.push_back(id);
+  // Creating the parents may have grown the table, so search again.
+  insert(m_nodeTable, m_nodes.size() - 1, hash, findSlot(m_nodeTable, hash, path, true), id);
+  return id;
+}
+
+std::size_t entryIndex::findSlot(const std::vector<slot>& table, const uint64_t hash,
+                                 const std::string_view key, const bool nodes) const
+{
+  const std::size_t mask = table.size() - 1;
+  std::size_t pos = static_cast<std::size_t>(hash) & mask;
+  // linear probing, the table is never more than half full
+  while (table[pos].id != none)
+  {
+    if ((table[pos].hash == hash)
+        && ((nodes ? nodePath(table[pos].id) : name(table[pos].id)) == key))
+      return pos;
+    pos = (pos + 1) & mask;
+  }
+  return pos;
+}
+
+void entryIndex::insert(std::vector<slot>& table, const std::size_t count, const uint64_t hash,
+                        const std::size_t pos, const std::size_t id)
+{
+  table[pos] = slot{ hash, id };
+  if (count * 2 <= table.size())
+    return;
+  std::vector<slot> grown(table.size() * 2, slot{ 0, none });
+  const std::size_t mask = grown.size() - 1;
+  for (const slot& s : table)
+  {
+    if (s.id == none)
+      continue;
+    std::size_t p = static_cast<std::size_t>(s.hash) & mask;
+    while (grown[p].id != none)
+      p = (p + 1) & mask;
+    grown[p] = s;
+  }
+  table.swap(grown);
+}
+
+} // namespace
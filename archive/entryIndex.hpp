@@ -0,0 +1,226 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_ENTRYINDEX_HPP
+#define LIBSTRIEZEL_ARCHIVE_ENTRYINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace libstriezel::archive
+{
+
+/** \brief index over the names of the entries of an archive
+ *
+ * The index assigns ids to the names in the order they are added, starting
+ * at zero, so the ids match the positions in the entry list of an archive.
+ * Names are looked up through an open-addressing hash table, and a tree of
+ * the directories allows to list directories and search by prefix without
+ * comparing all names.
+ */
+class entryIndex
+{
+  public:
+    /** \brief Creates an empty index.
+     */
+    entryIndex();
+
+
+    /** \brief Removes all names from the index.
+     */
+    void clear();
+
+
+    /** \brief Adds the name of the next entry.
+     *
+     * \param name  name of the entry, directories may end with a slash
+     * \return Returns the id of the entry.
+     * \remarks If a name is added more than once, find() returns the id of
+     *          the first occurrence.
+     */
+    std::size_t add(const std::string_view name);
+
+
+    /** \brief Gets the number of entries in the index.
+     *
+     * \return Returns the number of added names.
+     */
+    std::size_t size() const;
+
+
+    /** \brief Gets the name of an entry.
+     *
+     * \param id  id of the entry, must be less than size()
+     * \return Returns the name of the entry. The view is valid until the
+     *         next call of add() or clear().
+     */
+    std::string_view name(const std::size_t id) const;
+
+
+    /** \brief Gets the id of the entry with the given name.
+     *
+     * \param name  the exact name of the entry
+     * \return Returns the id of the entry.
+     *         Returns -1, if there is no such entry.
+     */
+    int64_t find(const std::string_view name) const;
+
+
+    /** \brief Checks whether there is an entry with the given name.
+     *
+     * \param name  the exact name of the entry
+     * \return Returns true, if the entry exists. Returns false otherwise.
+     */
+    bool contains(const std::string_view name) const;
+
+
+    /** \brief Checks whether a path is a directory in the index.
+     *
+     * \param path  path of the directory, with or without trailing slash
+     * \return Returns true, if there is an entry below that path or an entry
+     *         for the directory itself. Returns false otherwise.
+     *         The empty path is the root and always a directory.
+     */
+    bool isDirectory(const std::string_view path) const;
+
+
+    /** \brief Lists the direct children of a directory.
+     *
+     * \param directory  path of the directory, with or without trailing
+     *                   slash - use an empty path for the top level
+     * \return Returns the full paths of the files and directories that are
+     *         directly in the given directory, without trailing slashes and
+     *         in the order of their first appearance. This includes
+     *         directories that have no entry of their own. Returns an empty
+     *         vector, if there is no such directory.
+     */
+    std::vector<std::string_view> children(const std::string_view directory) const;
+
+
+    /** \brief Gets the entries whose names start with a given prefix.
+     *
+     * \param prefix  the prefix
+     * \return Returns the ids of the matching entries in ascending order.
+     * \remarks Only the part of the tree below the directory part of the
+     *          prefix is searched.
+     */
+    std::vector<std::size_t> withPrefix(const std::string_view prefix) const;
+
+
+    /** \brief Gets the entries whose names match a wildcard pattern.
+     *
+     * \param pattern  the pattern: '?' matches a single character and '*'
+     *                 matches any number of characters, both not including
+     *                 slashes, '**' matches any number of characters
+     *                 including slashes
+     * \return Returns the ids of the matching entries in ascending order.
+     */
+    std::vector<std::size_t> match(const std::string_view pattern) const;
+  private:
+    /// marks an empty slot in the hash tables
+    static const std::size_t none;
+
+
+    /** slot of one of the open-addressing hash tables */
+    struct slot
+    {
+      uint64_t hash; /**< hash of the key */
+      std::size_t id; /**< id of the entry or the node, or none for empty slots */
+    };
+
+
+    /** node of the directory tree */
+    struct node
+    {
+      std::size_t offset; /**< start of the path of the node in m_names */
+      std::size_t length; /**< length of the path of the node */
+      int64_t entry; /**< id of the first entry for this path, or -1 */
+      std::vector<std::size_t> children; /**< ids of the child nodes */
+    };
+
+
+    /** \brief Gets the path of a node of the tree.
+     *
+     * \param id  id of the node
+     * \return Returns the path of the node, without trailing slash.
+     */
+    std::string_view nodePath(const std::size_t id) const;
+
+
+    /** \brief Gets the id of the node with the given path.
+     *
+     * \param path  the path, without trailing slash
+     * \return Returns the id of the node.
+     *         Returns -1, if there is no such node.
+     */
+    int64_t findNode(const std::string_view path) const;
+
+
+    /** \brief Gets the node of a path, and creates it and its parents, if
+     * they do not exist yet.
+     *
+     * \param offset  start of the path in m_names
+     * \param length  length of the path
+     * \return Returns the id of the node.
+     */
+    std::size_t ensureNode(const std::size_t offset, const std::size_t length);
+
+
+    /** \brief Finds the slot of a key in a hash table.
+     *
+     * \param table  the hash table
+     * \param hash   hash of the key
+     * \param key    the key
+     * \param nodes  whether the table maps node paths instead of names
+     * \return Returns the position of the slot that holds the key, or of
+     *         the empty slot where the key would have to be inserted.
+     */
+    std::size_t findSlot(const std::vector<slot>& table, const uint64_t hash,
+                         const std::string_view key, const bool nodes) const;
+
+
+    /** \brief Inserts an id into a hash table and grows the table, if needed.
+     *
+     * \param table  the hash table
+     * \param count  number of ids in the table after the insertion
+     * \param hash   hash of the key
+     * \param pos    position of the empty slot as returned by findSlot()
+     * \param id     the id to insert
+     */
+    void insert(std::vector<slot>& table, const std::size_t count, const uint64_t hash,
+                const std::size_t pos, const std::size_t id);
+
+
+    std::string m_names; /**< the names of all entries, one after another */
+    std::vector<std::size_t> m_offsets; /**< start of each name in m_names, plus the end of the last name */
+    std::vector<slot> m_nameTable; /**< maps names to entry ids */
+    std::size_t m_nameCount; /**< number of distinct names in m_nameTable */
+    std::vector<node> m_nodes; /**< nodes of the directory tree, the root is the first node */
+    std::vector<slot> m_nodeTable; /**< maps paths to node ids */
+    std::vector<std::pair<std::size_t, std::size_t> > m_duplicates; /**< (node, entry) pairs of entries that are not the first one of their path */
+};
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_ENTRYINDEX_HPP
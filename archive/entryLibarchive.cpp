@@ -47,4 +47,14 @@ entryLibarchive::entryLibarchive(struct archive_entry * ent)
   #endif
 }
 
+entryLibarchive::entryLibarchive(const entryView& view)
+: archive::entry()
+{
+  setName(std::string(view.name));
+  setSize(view.size);
+  setDirectory(view.directory);
+  setSymLink(view.symLink);
+  setTime(view.m_time);
+}
+
 } // namespace
@@ -26,6 +26,7 @@
 #include <string>
 #include <archive_entry.h>
 #include "entry.hpp"
+#include "entryView.hpp"
 
 namespace libstriezel::archive
 {
@@ -40,6 +41,13 @@ class entryLibarchive: public entry
      * \param statbuf   pointer to libarchive entry, may not be null
      */
     entryLibarchive(struct archive_entry * ent);
+
+
+    /** \brief constructor to create entry from a view, e.g. of a cached listing
+     *
+     * \param view   view of the entry
+     */
+    entryLibarchive(const entryView& view);
 };
 
 } // namespace
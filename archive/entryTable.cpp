@@ -0,0 +1,157 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "entryTable.hpp"
+
+namespace libstriezel::archive
+{
+
+entryTable::entryTable()
+: m_names(std::string()),
+  m_offsets(std::vector<std::size_t>(1, 0)),
+  m_sizes(std::vector<int64_t>()),
+  m_times(std::vector<std::time_t>()),
+  m_flags(std::vector<uint8_t>()),
+  m_compressedSizes(std::vector<int64_t>()),
+  m_crcs(std::vector<uint32_t>())
+{
+}
+
+void entryTable::clear()
+{
+  m_names.clear();
+  m_offsets.assign(1, 0);
+  m_sizes.clear();
+  m_times.clear();
+  m_flags.clear();
+  m_compressedSizes.clear();
+  m_crcs.clear();
+}
+
+void entryTable::reserve(const std::size_t count, const std::size_t nameBytes)
+{
+  if (nameBytes > 0)
+    m_names.reserve(nameBytes);
+  m_offsets.reserve(count + 1);
+  m_sizes.reserve(count);
+  m_times.reserve(count);
+  m_flags.reserve(count);
+}
+
+std::size_t entryTable::add(const entryView& view, const int64_t compressedSize, const uint32_t crc)
+{
+  const std::size_t row = size();
+  m_names.append(view.name);
+  m_offsets.push_back(m_names.size());
+  m_sizes.push_back(view.size);
+  m_times.push_back(view.m_time);
+  m_flags.push_back(static_cast<uint8_t>((view.directory ? flagDirectory : 0) | (view.symLink ? flagSymLink : 0)));
+  // The optional columns only get memory once the first value shows up.
+  if ((compressedSize >= 0) || !m_compressedSizes.empty())
+  {
+    m_compressedSizes.resize(row, -1);
+    m_compressedSizes.push_back(compressedSize < 0 ? -1 : compressedSize);
+  }
+  if ((crc != 0) || !m_crcs.empty())
+  {
+    m_crcs.resize(row, 0);
+    m_crcs.push_back(crc);
+  }
+  return row;
+}
+
+std::size_t entryTable::size() const
+{
+  return m_sizes.size();
+}
+
+bool entryTable::empty() const
+{
+  return m_sizes.empty();
+}
+
+std::string_view entryTable::name(const std::size_t row) const
+{
+  return std::string_view(m_names.data() + m_offsets[row], m_offsets[row + 1] - m_offsets[row]);
+}
+
+int64_t entryTable::entrySize(const std::size_t row) const
+{
+  return m_sizes[row];
+}
+
+std::time_t entryTable::m_time(const std::size_t row) const
+{
+  return m_times[row];
+}
+
+bool entryTable::isDirectory(const std::size_t row) const
+{
+  return (m_flags[row] & flagDirectory) != 0;
+}
+
+bool entryTable::isSymLink(const std::size_t row) const
+{
+  return (m_flags[row] & flagSymLink) != 0;
+}
+
+int64_t entryTable::compressedSize(const std::size_t row) const
+{
+  if (m_compressedSizes.empty())
+    return -1;
+  return m_compressedSizes[row];
+}
+
+uint32_t entryTable::crc(const std::size_t row) const
+{
+  if (m_crcs.empty())
+    return 0;
+  return m_crcs[row];
+}
+
+entryView entryTable::view(const std::size_t row) const
+{
+  return entryView { static_cast<int64_t>(row), name(row), m_sizes[row], m_times[row],
+                     isDirectory(row), isSymLink(row) };
+}
+
+entry entryTable::at(const std::size_t row) const
+{
+  entry e;
+  e.setName(std::string(name(row)));
+  e.setSize(m_sizes[row]);
+  e.setTime(m_times[row]);
+  e.setDirectory(isDirectory(row));
+  e.setSymLink(isSymLink(row));
+  return e;
+}
+
+std::size_t entryTable::memoryUsage() const
+{
+  return m_names.capacity()
+       + m_offsets.capacity() * sizeof(std::size_t)
+       + m_sizes.capacity() * sizeof(int64_t)
+       + m_times.capacity() * sizeof(std::time_t)
+       + m_flags.capacity() * sizeof(uint8_t)
+       + m_compressedSizes.capacity() * sizeof(int64_t)
+       + m_crcs.capacity() * sizeof(uint32_t);
+}
+
+} // namespace
@@ -0,0 +1,186 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_ENTRYTABLE_HPP
+#define LIBSTRIEZEL_ARCHIVE_ENTRYTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "entry.hpp"
+#include "entryView.hpp"
+
+namespace libstriezel::archive
+{
+
+/** \brief compact list of the entries of an archive
+ *
+ * Instead of one entry object with its own string per entry, the table keeps
+ * all names in a single buffer and every other property in an array of its
+ * own. That needs much less memory for archives with millions of entries.
+ * Use at() to get an entry object for a single row, when it is needed.
+ */
+class entryTable
+{
+  public:
+    /** \brief Creates an empty table.
+     */
+    entryTable();
+
+
+    /** \brief Removes all entries from the table.
+     */
+    void clear();
+
+
+    /** \brief Reserves memory for a number of entries.
+     *
+     * \param count      expected number of entries
+     * \param nameBytes  expected total length of all names, zero if unknown
+     */
+    void reserve(const std::size_t count, const std::size_t nameBytes = 0);
+
+
+    /** \brief Appends an entry to the table.
+     *
+     * \param view            name, size, time and type of the entry
+     * \param compressedSize  compressed size in bytes, or -1, if not known
+     * \param crc             CRC-32 of the data, or zero, if not known
+     * \return Returns the row of the new entry.
+     * \remarks The index in the view is not stored, rows count from zero.
+     */
+    std::size_t add(const entryView& view, const int64_t compressedSize = -1, const uint32_t crc = 0);
+
+
+    /** \brief Gets the number of entries in the table.
+     *
+     * \return Returns the number of entries.
+     */
+    std::size_t size() const;
+
+
+    /** \brief Checks whether the table is empty.
+     *
+     * \return Returns true, if there are no entries. Returns false otherwise.
+     */
+    bool empty() const;
+
+
+    /** \brief Gets the name of an entry.
+     *
+     * \param row  row of the entry, must be less than size()
+     * \return Returns the name of the entry. The view is valid until the
+     *         next call of add(), reserve() or clear().
+     */
+    std::string_view name(const std::size_t row) const;
+
+
+    /** \brief Gets the size of an entry in bytes.
+     *
+     * \param row  row of the entry, must be less than size()
+     * \return Returns the size in bytes. Returns -1, if the size is not known.
+     */
+    int64_t entrySize(const std::size_t row) const;
+
+
+    /** \brief Gets the modification time of an entry.
+     *
+     * \param row  row of the entry, must be less than size()
+     * \return Returns the modification time.
+     *         Returns -1 (cast to time_t), if the time is not known.
+     */
+    std::time_t m_time(const std::size_t row) const;
+
+
+    /** \brief Checks whether an entry is a directory.
+     *
+     * \param row  row of the entry, must be less than size()
+     * \return Returns true, if the entry is a directory. Returns false, if not.
+     */
+    bool isDirectory(const std::size_t row) const;
+
+
+    /** \brief Checks whether an entry is a symbolic link.
+     *
+     * \param row  row of the entry, must be less than size()
+     * \return Returns true, if the entry is a symbolic link. Returns false, if not.
+     */
+    bool isSymLink(const std::size_t row) const;
+
+
+    /** \brief Gets the compressed size of an entry in bytes.
+     *
+     * \param row  row of the entry, must be less than size()
+     * \return Returns the compressed size in bytes.
+     *         Returns -1, if the compressed size is not known.
+     */
+    int64_t compressedSize(const std::size_t row) const;
+
+
+    /** \brief Gets the CRC-32 of the data of an entry.
+     *
+     * \param row  row of the entry, must be less than size()
+     * \return Returns the CRC-32. Returns zero, if it is not known.
+     */
+    uint32_t crc(const std::size_t row) const;
+
+
+    /** \brief Gets a view of an entry.
+     *
+     * \param row  row of the entry, must be less than size()
+     * \return Returns a view of the entry whose index is the row.
+     */
+    entryView view(const std::size_t row) const;
+
+
+    /** \brief Creates an entry object for a row of the table.
+     *
+     * \param row  row of the entry, must be less than size()
+     * \return Returns an entry object with the data of the row.
+     */
+    entry at(const std::size_t row) const;
+
+
+    /** \brief Gets the number of bytes that the table uses.
+     *
+     * \return Returns the number of bytes of all arrays of the table.
+     */
+    std::size_t memoryUsage() const;
+  private:
+    /// flag for directories in m_flags
+    static const uint8_t flagDirectory = 1;
+    /// flag for symbolic links in m_flags
+    static const uint8_t flagSymLink = 2;
+
+    std::string m_names; /**< the names of all entries, one after another */
+    std::vector<std::size_t> m_offsets; /**< start of each name in m_names, plus the end of the last name */
+    std::vector<int64_t> m_sizes; /**< sizes of the entries in bytes */
+    std::vector<std::time_t> m_times; /**< modification times of the entries */
+    std::vector<uint8_t> m_flags; /**< directory and symbolic link flags */
+    std::vector<int64_t> m_compressedSizes; /**< compressed sizes, empty while no entry has one */
+    std::vector<uint32_t> m_crcs; /**< CRC-32 values, empty while no entry has one */
+};
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_ENTRYTABLE_HPP
@@ -0,0 +1,57 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_ENTRYVIEW_HPP
+#define LIBSTRIEZEL_ARCHIVE_ENTRYVIEW_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string_view>
+
+namespace libstriezel::archive
+{
+
+/** \brief lightweight description of an archive entry
+ *
+ * Unlike entry, a view does not own the name of the entry. It points into
+ * memory of the archive that is only valid during the call of the visitor,
+ * so copy the name, if it is needed later.
+ */
+struct entryView
+{
+  int64_t index; /**< position of the entry in the archive, starting at zero */
+  std::string_view name; /**< name of the entry */
+  int64_t size; /**< size of the entry in bytes, or -1, if it is not known */
+  std::time_t m_time; /**< modification time, or -1, if it is not known */
+  bool directory; /**< whether the entry is a directory */
+  bool symLink; /**< whether the entry is a symbolic link */
+};
+
+
+/** \brief callback that receives the entries of an archive one by one
+ *
+ * The callback returns true to get the next entry, or false to stop.
+ */
+typedef std::function<bool(const entryView& view)> EntryVisitor;
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_ENTRYVIEW_HPP
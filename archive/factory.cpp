@@ -0,0 +1,93 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "factory.hpp"
+#include <stdexcept>
+
+namespace libstriezel::archive
+{
+
+anyArchive openArchive(const std::string& fileName)
+{
+  return openArchive(fileName, detectFormat(fileName));
+}
+
+anyArchive openArchive(const std::string& fileName, const format type)
+{
+  switch (type)
+  {
+    case format::sevenZip:
+         return std::make_unique<libstriezel::sevenZip::archive>(fileName);
+    case format::ar:
+         return std::make_unique<libstriezel::ar::archive>(fileName);
+    case format::cab:
+         return std::make_unique<libstriezel::cab::archive>(fileName);
+    case format::gzip:
+         return std::make_unique<libstriezel::gzip::archive>(fileName);
+    case format::installShield:
+         return std::make_unique<libstriezel::installshield::archive>(fileName);
+    case format::iso9660:
+         return std::make_unique<libstriezel::archive::iso9660::archive>(fileName);
+    case format::rar:
+         return std::make_unique<libstriezel::rar::archive>(fileName);
+    case format::tar:
+         return std::make_unique<libstriezel::tar::archive>(fileName);
+    case format::xz:
+         return std::make_unique<libstriezel::xz::archive>(fileName);
+    case format::zip:
+         return std::make_unique<libstriezel::zip::archive>(fileName);
+    case format::unknown:
+         break;
+  }
+  throw std::runtime_error("libstriezel::archive::openArchive: Format of file " + fileName + " is unknown!");
+}
+
+anyArchive openArchive(const void* data, const std::size_t size)
+{
+  const format type = detectFormat(data, size);
+  switch (type)
+  {
+    case format::sevenZip:
+         return std::make_unique<libstriezel::sevenZip::archive>(data, size);
+    case format::ar:
+         return std::make_unique<libstriezel::ar::archive>(data, size);
+    case format::cab:
+         return std::make_unique<libstriezel::cab::archive>(data, size);
+    case format::gzip:
+         return std::make_unique<libstriezel::gzip::archive>(data, size);
+    case format::installShield:
+         throw std::runtime_error("libstriezel::archive::openArchive: InstallShield cabinets can only be opened from files!");
+    case format::iso9660:
+         return std::make_unique<libstriezel::archive::iso9660::archive>(data, size);
+    case format::rar:
+         return std::make_unique<libstriezel::rar::archive>(data, size);
+    case format::tar:
+         return std::make_unique<libstriezel::tar::archive>(data, size);
+    case format::xz:
+         return std::make_unique<libstriezel::xz::archive>(data, size);
+    case format::zip:
+         return std::make_unique<libstriezel::zip::archive>(data, size);
+    case format::unknown:
+         break;
+  }
+  throw std::runtime_error("libstriezel::archive::openArchive: Format of archive data is unknown!");
+}
+
+} // namespace
@@ -0,0 +1,95 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_FACTORY_HPP
+#define LIBSTRIEZEL_ARCHIVE_FACTORY_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <variant>
+#include "format.hpp"
+#include "7z/archive.hpp"
+#include "ar/archive.hpp"
+#include "cab/archive.hpp"
+#include "gzip/archive.hpp"
+#include "installshield/archive.hpp"
+#include "iso9660/archive.hpp"
+#include "rar/archive.hpp"
+#include "tar/archive.hpp"
+#include "xz/archive.hpp"
+#include "zip/archive.hpp"
+
+namespace libstriezel::archive
+{
+
+/** \brief holds an archive object of any of the supported formats
+ *
+ * The archive classes have no common base class, so use std::visit() or
+ * std::get() to work with the contained object.
+ */
+typedef std::variant<std::unique_ptr<libstriezel::sevenZip::archive>,
+                     std::unique_ptr<libstriezel::ar::archive>,
+                     std::unique_ptr<libstriezel::cab::archive>,
+                     std::unique_ptr<libstriezel::gzip::archive>,
+                     std::unique_ptr<libstriezel::installshield::archive>,
+                     std::unique_ptr<libstriezel::archive::iso9660::archive>,
+                     std::unique_ptr<libstriezel::rar::archive>,
+                     std::unique_ptr<libstriezel::tar::archive>,
+                     std::unique_ptr<libstriezel::xz::archive>,
+                     std::unique_ptr<libstriezel::zip::archive> > anyArchive;
+
+
+/** \brief Opens an archive file with the class that matches its format.
+ *
+ * \param fileName  name of the archive file
+ * \return Returns the opened archive.
+ * \remarks This function throws an exception, if the format of the file is
+ *          unknown or the archive class cannot open the file.
+ */
+anyArchive openArchive(const std::string& fileName);
+
+
+/** \brief Opens an archive file whose format is already known.
+ *
+ * \param fileName  name of the archive file
+ * \param type      format of the archive, e.g. as returned by detectFormat()
+ * \return Returns the opened archive.
+ * \remarks This function throws an exception, if the format is unknown or
+ *          the archive class cannot open the file.
+ */
+anyArchive openArchive(const std::string& fileName, const format type);
+
+
+/** \brief Opens an archive in memory with the class that matches its format.
+ *
+ * \param data  pointer to the start of the archive data - the data must
+ *              stay valid as long as the archive object exists
+ * \param size  size of the archive data in bytes
+ * \return Returns the opened archive.
+ * \remarks This function throws an exception, if the format of the data is
+ *          unknown or the archive class cannot open it. InstallShield
+ *          cabinets can only be opened from files.
+ */
+anyArchive openArchive(const void* data, const std::size_t size);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_FACTORY_HPP
@@ -0,0 +1,142 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "fileMapping.hpp"
+#include <stdexcept>
+#if defined(_WIN32)
+  #include <Windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace libstriezel::archive
+{
+
+namespace
+{
+
+/* Throws the exception for a file that cannot be mapped. */
+[[noreturn]] void invalid(const std::string& reason)
+{
+  throw std::runtime_error("libstriezel::archive::fileMapping: " + reason);
+}
+
+} // anonymous namespace
+
+fileMapping::fileMapping(const std::string& fileName)
+: m_mapping(nullptr),
+  m_size(0)
+{
+  #if defined(_WIN32)
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    invalid("Could not open file " + fileName + "!");
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize))
+  {
+    CloseHandle(file);
+    invalid("Could not get the size of file " + fileName + "!");
+  }
+  // Empty files cannot be mapped.
+  if (fileSize.QuadPart == 0)
+  {
+    CloseHandle(file);
+    return;
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+    invalid("Could not map file " + fileName + " into memory!");
+  // The view keeps the mapping object alive.
+  m_mapping = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (m_mapping == nullptr)
+    invalid("Could not map file " + fileName + " into memory!");
+  m_size = static_cast<std::size_t>(fileSize.QuadPart);
+  #else
+  const int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    invalid("Could not open file " + fileName + "!");
+  struct stat buffer;
+  if (fstat(fd, &buffer) != 0)
+  {
+    close(fd);
+    invalid("Could not get the size of file " + fileName + "!");
+  }
+  // Empty files cannot be mapped.
+  if (buffer.st_size == 0)
+  {
+    close(fd);
+    return;
+  }
+  void * mapped = mmap(nullptr, static_cast<std::size_t>(buffer.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  if (mapped == MAP_FAILED)
+    invalid("Could not map file " + fileName + " into memory!");
+  m_mapping = mapped;
+  m_size = static_cast<std::size_t>(buffer.st_size);
+  #endif
+}
+
+fileMapping::~fileMapping()
+{
+  if (m_mapping != nullptr)
+  {
+    #if defined(_WIN32)
+    UnmapViewOfFile(m_mapping);
+    #else
+    munmap(m_mapping, m_size);
+    #endif
+    m_mapping = nullptr;
+  }
+}
+
+const unsigned char * fileMapping::data() const
+{
+  return static_cast<const unsigned char*>(m_mapping);
+}
+
+std::size_t fileMapping::size() const
+{
+  return m_size;
+}
+
+void fileMapping::adviseSequential(const std::size_t offset, const std::size_t length) const
+{
+  #if defined(_WIN32)
+  (void) offset;
+  (void) length;
+  #else
+  if ((m_mapping == nullptr) || (offset >= m_size))
+    return;
+  // madvise() needs an address at the start of a page.
+  const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const std::size_t start = offset / pageSize * pageSize;
+  const std::size_t end = (length > m_size - offset) ? m_size : offset + length;
+  madvise(static_cast<unsigned char*>(m_mapping) + start, end - start, MADV_SEQUENTIAL);
+  #endif
+}
+
+} // namespace
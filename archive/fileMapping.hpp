@@ -0,0 +1,90 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_FILEMAPPING_HPP
+#define LIBSTRIEZEL_ARCHIVE_FILEMAPPING_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace libstriezel::archive
+{
+
+/** \brief maps a whole file into memory for reading
+ *
+ * The mapping is removed when the object is destroyed. Pages are only read
+ * from the disk when they are accessed, so large files cost little, as long
+ * as only small parts of them are used.
+ */
+class fileMapping
+{
+  public:
+    /** \brief constructor - maps a file into memory
+     *
+     * \param fileName  name of the file
+     * \remarks This function throws an exception, if the file cannot be
+     *          opened or mapped. An empty file gives an empty mapping.
+     */
+    fileMapping(const std::string& fileName);
+
+
+    /** \brief destructor - unmaps the file
+     */
+    ~fileMapping();
+
+
+    /* Delete unwanted default copy constructor, assignment operator and
+       move constructor. */
+    fileMapping(const fileMapping& op) = delete;
+    fileMapping & operator=(const fileMapping& op) = delete;
+    fileMapping(const fileMapping&& op) = delete;
+
+
+    /** \brief Gets the start of the mapped file.
+     *
+     * \return Returns the start of the file data.
+     *         Returns nullptr for an empty file.
+     */
+    const unsigned char * data() const;
+
+
+    /** \brief Gets the size of the mapped file.
+     *
+     * \return Returns the size of the file in bytes.
+     */
+    std::size_t size() const;
+
+
+    /** \brief Tells the system that a range will be read once from start to
+     * end, so that it can read ahead.
+     *
+     * \param offset  offset of the first byte of the range
+     * \param length  length of the range in bytes
+     * \remarks This is only a hint and does nothing on some systems.
+     */
+    void adviseSequential(const std::size_t offset, const std::size_t length) const;
+  private:
+    void * m_mapping; /**< start of the mapped file, or nullptr for an empty file */
+    std::size_t m_size; /**< size of the file */
+};
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_FILEMAPPING_HPP
@@ -0,0 +1,131 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "format.hpp"
+#include <cstdint>
+#include <fcntl.h>
+#if defined(_WIN32)
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+#include "compressedReader.hpp"
+#include "signatures.hpp"
+
+namespace libstriezel::archive
+{
+
+std::string formatName(const format f)
+{
+  switch (f)
+  {
+    case format::sevenZip:
+         return "7z";
+    case format::ar:
+         return "ar";
+    case format::cab:
+         return "Cabinet";
+    case format::gzip:
+         return "gzip";
+    case format::installShield:
+         return "InstallShield";
+    case format::iso9660:
+         return "ISO 9660";
+    case format::rar:
+         return "RAR";
+    case format::tar:
+         return "tar";
+    case format::xz:
+         return "xz";
+    case format::zip:
+         return "ZIP";
+    case format::unknown:
+         break;
+  }
+  return "unknown";
+}
+
+format detectFormat(const void* data, const std::size_t size)
+{
+  if (signatures::isZip(data, size))
+    return format::zip;
+  if (signatures::is7z(data, size))
+    return format::sevenZip;
+  if (signatures::isRar(data, size))
+    return format::rar;
+  if (signatures::isCab(data, size))
+    return format::cab;
+  if (signatures::isAr(data, size))
+    return format::ar;
+  if (signatures::isXz(data, size))
+    return format::xz;
+  if (signatures::isGzip(data, size))
+    return format::gzip;
+  if (signatures::isInstallShield(data, size))
+    return format::installShield;
+  if (signatures::isTar(data, size))
+    return format::tar;
+  if (signatures::isISO9660(data, size))
+    return format::iso9660;
+  return format::unknown;
+}
+
+format detectFormat(const int fd)
+{
+  if (fd < 0)
+    return format::unknown;
+  const CompressedReader reader = descriptorReader(fd);
+  char header[signatures::magicSize];
+  const int64_t headerBytes = readFull(reader, 0, header, sizeof(header));
+  if (headerBytes <= 0)
+    return format::unknown;
+  const format result = detectFormat(header, static_cast<std::size_t>(headerBytes));
+  // Only images that are larger than the header can be ISO 9660 images.
+  if ((result != format::unknown) || (headerBytes < static_cast<int64_t>(signatures::magicSize)))
+    return result;
+
+  char descriptor[5];
+  const int64_t descriptorBytes = readFull(reader, static_cast<int64_t>(signatures::iso9660Offset),
+                                           descriptor, sizeof(descriptor));
+  if ((descriptorBytes > 0)
+      && signatures::isISO9660Descriptor(descriptor, static_cast<std::size_t>(descriptorBytes)))
+    return format::iso9660;
+  return format::unknown;
+}
+
+format detectFormat(const std::string& fileName)
+{
+  #if defined(_WIN32)
+  const int fd = _open(fileName.c_str(), _O_RDONLY | _O_BINARY);
+  #else
+  const int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  #endif
+  if (fd < 0)
+    return format::unknown;
+  const format result = detectFormat(fd);
+  #if defined(_WIN32)
+  _close(fd);
+  #else
+  close(fd);
+  #endif
+  return result;
+}
+
+} // namespace
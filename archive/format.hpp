@@ -0,0 +1,91 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_FORMAT_HPP
+#define LIBSTRIEZEL_ARCHIVE_FORMAT_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace libstriezel::archive
+{
+
+/** \brief enumeration of the archive formats that the library can read
+ */
+enum class format
+{
+  unknown,
+  sevenZip,
+  ar,
+  cab,
+  gzip,
+  installShield,
+  iso9660,
+  rar,
+  tar,
+  xz,
+  zip
+};
+
+
+/** \brief Gets a short name of an archive format, e.g. for messages.
+ *
+ * \param f  the format
+ * \return Returns the name of the format, e.g. "7z" or "ZIP".
+ */
+std::string formatName(const format f);
+
+
+/** \brief Detects the format of archive data in memory.
+ *
+ * \param data  pointer to the start of the data
+ * \param size  number of available bytes - the ISO 9660 signature needs
+ *              0x8006 bytes, all other signatures are within 512 bytes
+ * \return Returns the format of the data. Returns format::unknown, if no
+ *         signature matches.
+ */
+format detectFormat(const void* data, const std::size_t size);
+
+
+/** \brief Detects the format of a file that is already open.
+ *
+ * \param fd  file descriptor of the file, has to support positioned reads
+ * \return Returns the format of the file. Returns format::unknown, if no
+ *         signature matches or the file could not be read.
+ * \remarks At most two small reads are done: the first 512 bytes, and the
+ *          ISO 9660 signature at offset 0x8001, if nothing else matched.
+ *          The file position is not changed on systems with pread().
+ */
+format detectFormat(const int fd);
+
+
+/** \brief Detects the format of a file.
+ *
+ * \param fileName  name of the file
+ * \return Returns the format of the file. Returns format::unknown, if no
+ *         signature matches or the file could not be read.
+ * \remarks The file is opened once and read as described for the variant
+ *          that takes a file descriptor.
+ */
+format detectFormat(const std::string& fileName);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_FORMAT_HPP
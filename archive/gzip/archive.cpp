@@ -19,19 +19,34 @@
 */
 
 #include "archive.hpp"
+#include <algorithm>
+#include <climits>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <zlib.h>
 #include "../../filesystem/file.hpp"
+#include "../signatures.hpp"
+#include "../writeBehind.hpp"
 
 namespace libstriezel::gzip
 {
 
 archive::archive(const std::string& fileName)
 : m_gzip(nullptr),
-  m_entries(std::vector<libstriezel::archive::entry>())
+  m_fileName(fileName),
+  m_entries(std::vector<libstriezel::archive::entry>()),
+  m_data(nullptr),
+  m_dataSize(0),
+  m_dataPosition(0),
+  m_stream(nullptr),
+  m_input(std::vector<uint8_t>()),
+  m_inflate(),
+  m_inflateReady(false),
+  m_inflateFinished(false),
+  m_index(checkpointIndex())
 {
   std::ifstream infile;
   infile.open(fileName.c_str(), std::ios_base::in | std::ios_base::binary);
@@ -78,11 +93,168 @@ archive::archive(const std::string& fileName)
     throw std::runtime_error("libstriezel::gzip::archive: Could not open file with gzopen()!");
 }
 
+archive::archive(const void* data, const std::size_t size)
+: m_gzip(nullptr),
+  m_fileName(std::string()),
+  m_entries(std::vector<libstriezel::archive::entry>()),
+  m_data(static_cast<const uint8_t*>(data)),
+  m_dataSize(size),
+  m_dataPosition(0),
+  m_stream(nullptr),
+  m_input(std::vector<uint8_t>()),
+  m_inflate(),
+  m_inflateReady(false),
+  m_inflateFinished(false),
+  m_index(checkpointIndex())
+{
+  if (nullptr == data)
+    throw std::runtime_error("libstriezel::gzip::archive: Data must not be null!");
+  // data should be at least 10 bytes for header + 4 bytes for size
+  if (size <= 14)
+    throw std::runtime_error("libstriezel::gzip::archive: Data is too small to be proper gzip data!");
+  uint32_t uncompressedSize = 0;
+  std::memcpy(&uncompressedSize, m_data + size - 4, 4);
+  initializeInflate(uncompressedSize);
+}
+
+archive::archive(libstriezel::archive::seekableStream& stream)
+: m_gzip(nullptr),
+  m_fileName(std::string()),
+  m_entries(std::vector<libstriezel::archive::entry>()),
+  m_data(nullptr),
+  m_dataSize(0),
+  m_dataPosition(0),
+  m_stream(&stream),
+  m_input(std::vector<uint8_t>(64 * 1024)),
+  m_inflate(),
+  m_inflateReady(false),
+  m_inflateFinished(false),
+  m_index(checkpointIndex())
+{
+  const int64_t size = stream.seek(0, SEEK_END);
+  // stream should be at least 10 bytes for header + 4 bytes for size
+  if (size <= 14)
+    throw std::runtime_error("libstriezel::gzip::archive: Stream is too small to be proper gzip data!");
+  uint32_t uncompressedSize = 0;
+  char * sizeBytes = reinterpret_cast<char*>(&uncompressedSize);
+  int64_t bytesRead = 0;
+  if (stream.seek(size - 4, SEEK_SET) != size - 4)
+    throw std::runtime_error("libstriezel::gzip::archive: Could not read uncompressed size!");
+  while (bytesRead < 4)
+  {
+    const int64_t chunk = stream.read(sizeBytes + bytesRead, static_cast<std::size_t>(4 - bytesRead));
+    if (chunk <= 0)
+      throw std::runtime_error("libstriezel::gzip::archive: Could not read uncompressed size!");
+    bytesRead += chunk;
+  }
+  initializeInflate(uncompressedSize);
+}
+
 archive::~archive()
 {
-  if (gzclose(m_gzip) != Z_OK)
-    std::cerr << "libstriezel::gzip::archive: Could not close/free archive!\n";
-  m_gzip = nullptr;
+  if (nullptr != m_gzip)
+  {
+    if (gzclose(m_gzip) != Z_OK)
+      std::cerr << "libstriezel::gzip::archive: Could not close/free archive!\n";
+    m_gzip = nullptr;
+  }
+  if (m_inflateReady)
+  {
+    inflateEnd(&m_inflate);
+    m_inflateReady = false;
+  }
+}
+
+void archive::initializeInflate(const uint32_t uncompressedSize)
+{
+  libstriezel::archive::entry oneEntry;
+  oneEntry.setSize(uncompressedSize);
+  // There is no file name to derive the name from, so use the generic name.
+  oneEntry.setName("data");
+  m_entries.push_back(oneEntry);
+
+  m_inflate.zalloc = Z_NULL;
+  m_inflate.zfree = Z_NULL;
+  m_inflate.opaque = Z_NULL;
+  m_inflate.next_in = Z_NULL;
+  m_inflate.avail_in = 0;
+  // 16 + MAX_WBITS: expect a gzip header and trailer
+  if (inflateInit2(&m_inflate, 16 + MAX_WBITS) != Z_OK)
+    throw std::runtime_error("libstriezel::gzip::archive: Could not initialize zlib!");
+  m_inflateReady = true;
+  if (!rewind())
+    throw std::runtime_error("libstriezel::gzip::archive: Unable to rewind!");
+}
+
+bool archive::rewind()
+{
+  if (nullptr != m_gzip)
+    return gzrewind(m_gzip) != -1;
+  if ((nullptr != m_stream) && (m_stream->seek(0, SEEK_SET) != 0))
+    return false;
+  m_dataPosition = 0;
+  m_inflate.next_in = Z_NULL;
+  m_inflate.avail_in = 0;
+  m_inflateFinished = false;
+  return inflateReset(&m_inflate) == Z_OK;
+}
+
+bool archive::fillInput()
+{
+  if (nullptr != m_data)
+  {
+    const std::size_t chunk = std::min<std::size_t>(m_dataSize - m_dataPosition, UINT_MAX);
+    m_inflate.next_in = const_cast<Bytef*>(m_data + m_dataPosition);
+    m_inflate.avail_in = static_cast<uInt>(chunk);
+    m_dataPosition += chunk;
+    return true;
+  }
+  const int64_t bytesRead = m_stream->read(m_input.data(), m_input.size());
+  if (bytesRead < 0)
+    return false;
+  m_inflate.next_in = m_input.data();
+  m_inflate.avail_in = static_cast<uInt>(bytesRead);
+  return true;
+}
+
+int archive::readData(void* buffer, const unsigned int size)
+{
+  if (nullptr != m_gzip)
+    return gzread(m_gzip, buffer, size);
+  if (m_inflateFinished)
+    return 0;
+
+  m_inflate.next_out = static_cast<Bytef*>(buffer);
+  m_inflate.avail_out = size;
+  while (m_inflate.avail_out > 0)
+  {
+    if ((m_inflate.avail_in == 0) && !fillInput())
+      return -1;
+    // no more input, but the compressed data is not complete
+    if (m_inflate.avail_in == 0)
+      return -1;
+    const int ret = inflate(&m_inflate, Z_NO_FLUSH);
+    if (ret == Z_STREAM_END)
+    {
+      /* Another gzip member may follow, gzread() handles that case, too.
+         Anything else after the first member is ignored like in gzread(). */
+      if ((m_inflate.avail_in == 0) && !fillInput())
+        return -1;
+      const bool nextMember = (m_inflate.avail_in >= 2)
+          ? ((m_inflate.next_in[0] == 0x1F) && (m_inflate.next_in[1] == 0x8B))
+          : ((m_inflate.avail_in == 1) && (m_inflate.next_in[0] == 0x1F));
+      if (!nextMember)
+      {
+        m_inflateFinished = true;
+        break;
+      }
+      if (inflateReset(&m_inflate) != Z_OK)
+        return -1;
+    }
+    else if (ret != Z_OK)
+      return -1;
+  } // while
+  return static_cast<int>(size - m_inflate.avail_out);
 }
 
 std::vector<libstriezel::archive::entry> archive::entries() const
@@ -90,7 +262,30 @@ std::vector<libstriezel::archive::entry> archive::entries() const
   return m_entries;
 }
 
-bool archive::extractTo(const std::string& destFileName)
+bool archive::forEachEntry(const libstriezel::archive::EntryVisitor& visitor) const
+{
+  for (std::size_t i = 0; i < m_entries.size(); ++i)
+  {
+    const libstriezel::archive::entry& e = m_entries[i];
+    const libstriezel::archive::entryView view { static_cast<int64_t>(i), e.name(), e.size(),
+                                                 e.m_time(), e.isDirectory(), e.isSymLink() };
+    if (!visitor(view))
+      return false;
+  }
+  return true;
+}
+
+bool archive::fillEntryTable(libstriezel::archive::entryTable& table) const
+{
+  table.clear();
+  return forEachEntry([&table](const libstriezel::archive::entryView& view)
+  {
+    table.add(view);
+    return true;
+  });
+}
+
+bool archive::extractTo(const std::string& destFileName, const unsigned int threads)
 {
   /* Check whether destination file already exists, we do not want to overwrite
      existing files. */
@@ -102,7 +297,7 @@ bool archive::extractTo(const std::string& destFileName)
   }
 
   //rewind
-  if (gzrewind(m_gzip) == -1)
+  if (!rewind())
   {
     //error while rewinding / seeking
     std::cerr << "gzip::archive::extractTo: error: Unable to rewind!" << std::endl;
@@ -110,9 +305,11 @@ bool archive::extractTo(const std::string& destFileName)
   }
 
   //open/create destination file
-  std::ofstream destination;
-  destination.open(destFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-  if (!destination.good() || !destination.is_open())
+  /* The stored size is only the size modulo 2^32, but a wrong value just
+     reserves the wrong amount of disk space. */
+  const int64_t expectedSize = m_entries.empty() ? -1 : m_entries.front().size();
+  libstriezel::archive::writeBehind destination;
+  if (!destination.open(destFileName, expectedSize))
   {
     std::cerr << "gzip::archive::extractTo: error: destination file "
               << destFileName << " could not be created/opened for writing!"
@@ -120,55 +317,271 @@ bool archive::extractTo(const std::string& destFileName)
     return false;
   }
 
-  const unsigned int bufferSize = 4096;
-  char buffer[bufferSize];
+  // Members can only be decompressed in parallel, if there are several.
+  // Only BGZF files tell where their members start. Other files are only
+  // scanned for members, if the caller explicitly asks for several threads,
+  // because the scan reads the whole file before the decompression.
+  std::vector<int64_t> members;
+  if ((threads != 1) && (nullptr == m_stream))
+  {
+    members = findMembers(compressedReader(), threads > 1);
+  }
+  if (members.size() > 1)
+  {
+    const bool success = inflateMembers(readerFactory(), members, threads,
+        [&destination](const void* data, const std::size_t size)
+        {
+          const char * bytes = static_cast<const char*>(data);
+          std::size_t done = 0;
+          while (done < size)
+          {
+            const std::size_t chunk = std::min(size - done, destination.space());
+            std::memcpy(destination.data(), bytes + done, chunk);
+            if (!destination.produced(chunk))
+              return false;
+            done += chunk;
+          }
+          return true;
+        });
+    if (!destination.finish() || !success)
+    {
+      std::cerr << "gzip::archive::extractTo: error: Could not extract data to file "
+                << destFileName << "." << std::endl;
+      filesystem::file::remove(destFileName);
+      return false;
+    }
+    return true;
+  }
+
+  // zlib decompresses straight into the buffers of the writer.
   int bytesRead = 0;
   do
   {
-    std::memset(buffer, '\0', bufferSize);
-    bytesRead = gzread(m_gzip, buffer, bufferSize);
-    if (bytesRead > 0)
+    bytesRead = readData(destination.data(), static_cast<unsigned int>(destination.space()));
+    if ((bytesRead > 0) && !destination.produced(static_cast<std::size_t>(bytesRead)))
     {
-      //write bytes to file
-      destination.write(buffer, bytesRead);
-      if (!destination.good())
-      {
-        std::cerr << "gzip::archive::extractTo: error: Could not write data to file "
-                  << destFileName << "." << std::endl;
-        destination.close();
-        filesystem::file::remove(destFileName);
-        return false;
-      } //if write failed
-    } //if more than zero bytes have been read
+      std::cerr << "gzip::archive::extractTo: error: Could not write data to file "
+                << destFileName << "." << std::endl;
+      destination.finish();
+      filesystem::file::remove(destFileName);
+      return false;
+    } //if write failed
   } while (bytesRead > 0);
 
-  destination.close();
   //check last state
   if (bytesRead < 0)
   {
     std::cerr << "gzip::archive::extractTo: Error while reading compressed data!"
               << std::endl;
+    destination.finish();
+    filesystem::file::remove(destFileName);
+    return false;
+  }
+  if (!destination.finish())
+  {
+    std::cerr << "gzip::archive::extractTo: error: Could not write data to file "
+              << destFileName << "." << std::endl;
     filesystem::file::remove(destFileName);
     return false;
   }
   return true;
 }
 
-bool archive::isGzip(const std::string& fileName)
+bool archive::extractToSink(const libstriezel::archive::Sink& sink)
 {
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
+  //rewind
+  if (!rewind())
+  {
+    //error while rewinding / seeking
+    std::cerr << "gzip::archive::extractToSink: error: Unable to rewind!" << std::endl;
     return false;
+  }
+
+  const unsigned int bufferSize = 64 * 1024;
+  char buffer[bufferSize];
+  int bytesRead = 0;
+  do
+  {
+    bytesRead = readData(buffer, bufferSize);
+    if ((bytesRead > 0) && !sink(buffer, static_cast<std::size_t>(bytesRead)))
+    {
+      std::cerr << "gzip::archive::extractToSink: error: The data was not accepted by the sink!"
+                << std::endl;
+      return false;
+    }
+  } while (bytesRead > 0);
 
-  uint16_t start = 0;
-  stream.read(reinterpret_cast<char*>(&start), 2);
-  if (!stream.good() || stream.gcount() != 2)
+  //check last state
+  if (bytesRead < 0)
+  {
+    std::cerr << "gzip::archive::extractToSink: Error while reading compressed data!"
+              << std::endl;
     return false;
-  stream.close();
+  }
+  return true;
+}
 
-  /* magic literal for gzip files is 1F 8B.*/
-  return (start == 0x8B1F);
+bool archive::extractToBuffer(std::vector<uint8_t>& buffer)
+{
+  //rewind
+  if (!rewind())
+  {
+    //error while rewinding / seeking
+    std::cerr << "gzip::archive::extractToBuffer: error: Unable to rewind!" << std::endl;
+    buffer.clear();
+    return false;
+  }
+
+  /* The stored size is only the size modulo 2^32, so it is a hint. One byte
+     more avoids another round trip when the hint is exact. */
+  std::size_t size = 0;
+  buffer.resize(static_cast<std::size_t>(m_entries.front().size()) + 1);
+  int bytesRead = 0;
+  do
+  {
+    if (size == buffer.size())
+      buffer.resize(2 * buffer.size());
+    const std::size_t chunk = std::min<std::size_t>(buffer.size() - size, INT_MAX);
+    bytesRead = readData(buffer.data() + size, static_cast<unsigned int>(chunk));
+    if (bytesRead > 0)
+      size += static_cast<std::size_t>(bytesRead);
+  } while (bytesRead > 0);
+
+  //check last state
+  if (bytesRead < 0)
+  {
+    std::cerr << "gzip::archive::extractToBuffer: Error while reading compressed data!"
+              << std::endl;
+    buffer.clear();
+    return false;
+  }
+  buffer.resize(size);
+  return true;
+}
+
+bool archive::extractToBuffer(void* buffer, const std::size_t capacity, std::size_t& size)
+{
+  size = 0;
+  //rewind
+  if (!rewind())
+  {
+    //error while rewinding / seeking
+    std::cerr << "gzip::archive::extractToBuffer: error: Unable to rewind!" << std::endl;
+    return false;
+  }
+
+  // zlib decompresses straight into the buffer of the caller
+  char * data = static_cast<char*>(buffer);
+  int bytesRead = 1;
+  while ((bytesRead > 0) && (size < capacity))
+  {
+    const std::size_t chunk = std::min<std::size_t>(capacity - size, INT_MAX);
+    bytesRead = readData(data + size, static_cast<unsigned int>(chunk));
+    if (bytesRead > 0)
+      size += static_cast<std::size_t>(bytesRead);
+  }
+  if (bytesRead < 0)
+  {
+    std::cerr << "gzip::archive::extractToBuffer: Error while reading compressed data!"
+              << std::endl;
+    return false;
+  }
+  if (size == capacity)
+  {
+    // The buffer is full, so there must not be any more data.
+    char probe = '\0';
+    if (readData(&probe, 1) != 0)
+    {
+      std::cerr << "gzip::archive::extractToBuffer: error: Buffer is too small!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::map<std::string, bool> archive::extractMany(const std::map<std::string, std::string>& files)
+{
+  std::map<std::string, bool> result;
+  for (const auto& item : files)
+  {
+    if (item.first == m_entries.front().name())
+      result[item.first] = extractTo(item.second);
+    else
+    {
+      std::cerr << "gzip::archive::extractMany: error: file " << item.first
+                << " does not exist in archive!" << std::endl;
+      result[item.first] = false;
+    }
+  } // for
+  return result;
+}
+
+bool archive::extractAllToSinks(const std::function<libstriezel::archive::Sink(const libstriezel::archive::entry&)>& sinkFor)
+{
+  return extractToSink(sinkFor(m_entries.front()));
+}
+
+CompressedReader archive::compressedReader() const
+{
+  return libstriezel::archive::compressedReader(m_fileName, m_data, m_dataSize, m_stream);
+}
+
+ReaderFactory archive::readerFactory() const
+{
+  // Every reader opens its own file, so that every thread has its own.
+  return [this]()
+  {
+    return compressedReader();
+  };
+}
+
+bool archive::buildIndex(const int64_t spacing)
+{
+  const bool success = m_index.build(compressedReader(), spacing);
+  // The reader moved the stream, so the next extraction has to start over.
+  if ((nullptr != m_stream) && !rewind())
+    return false;
+  if (!success)
+    std::cerr << "gzip::archive::buildIndex: error: Could not decompress the data!" << std::endl;
+  return success;
+}
+
+bool archive::saveIndex(const std::string& indexFile) const
+{
+  if (m_fileName.empty())
+  {
+    std::cerr << "gzip::archive::saveIndex: error: Only indexes of files can be saved!" << std::endl;
+    return false;
+  }
+  libstriezel::archive::listingKey key;
+  if (!libstriezel::archive::getListingKey(m_fileName, key))
+    return false;
+  return m_index.save(indexFile.empty() ? checkpointIndex::indexFileName(m_fileName) : indexFile, key);
+}
+
+bool archive::loadIndex(const std::string& indexFile)
+{
+  if (m_fileName.empty())
+    return false;
+  libstriezel::archive::listingKey key;
+  if (!libstriezel::archive::getListingKey(m_fileName, key))
+    return false;
+  return m_index.load(indexFile.empty() ? checkpointIndex::indexFileName(m_fileName) : indexFile, key);
+}
+
+int64_t archive::readAt(const int64_t offset, void* buffer, const std::size_t length)
+{
+  const int64_t bytesRead = m_index.read(compressedReader(), offset, buffer, length);
+  if ((nullptr != m_stream) && !rewind())
+    return -1;
+  return bytesRead;
+}
+
+bool archive::isGzip(const std::string& fileName)
+{
+  char head[2];
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head, sizeof(head));
+  return libstriezel::archive::signatures::isGzip(head, size);
 }
 
 } // namespace
@@ -21,10 +21,19 @@
 #ifndef LIBSTRIEZEL_GZIP_ARCHIVE_HPP
 #define LIBSTRIEZEL_GZIP_ARCHIVE_HPP
 
+#include <functional>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 #include <zlib.h>
 #include "../entry.hpp"
+#include "../entryTable.hpp"
+#include "../entryView.hpp"
+#include "../seekableStream.hpp"
+#include "../sink.hpp"
+#include "checkpointIndex.hpp"
+#include "members.hpp"
 
 namespace libstriezel::gzip
 {
@@ -41,6 +50,27 @@ class archive
     archive(const std::string& fileName);
 
 
+    /** \brief constructor - opens gzip-compressed data in memory in read-only mode
+     *
+     * \param data  pointer to the start of the compressed data - the data
+     *              must stay valid as long as the archive object exists
+     * \param size  size of the compressed data in bytes
+     * \remarks This function throws an exception, if the data is too small
+     *          or a similar error occurs. The single entry is named "data".
+     */
+    archive(const void* data, const std::size_t size);
+
+
+    /** \brief constructor - opens gzip-compressed data from a stream in read-only mode
+     *
+     * \param stream  the stream that contains the compressed data - the
+     *                stream must stay valid as long as the archive object exists
+     * \remarks This function throws an exception, if the stream is too small
+     *          or a similar error occurs. The single entry is named "data".
+     */
+    archive(libstriezel::archive::seekableStream& stream);
+
+
     /** \brief destructor
      */
     virtual ~archive();
@@ -64,13 +94,146 @@ class archive
     std::vector<libstriezel::archive::entry> entries() const;
 
 
+    /** \brief Passes the entry of the gzip file to a visitor.
+     *
+     * \param visitor  callback that gets a view of the entry
+     * \return Returns true, if the entry was visited.
+     *         Returns false, if the visitor stopped.
+     */
+    bool forEachEntry(const libstriezel::archive::EntryVisitor& visitor) const;
+
+
+    /** \brief Fills a compact table with the entry of the gzip file.
+     *
+     * \param table  the table, its previous content is removed
+     * \return Returns true, if the entry was added.
+     */
+    bool fillEntryTable(libstriezel::archive::entryTable& table) const;
+
+
     /** \brief Extracts the uncompressed file to the specified destination.
      *
      * \param destFileName  the destination file name - file must not exist yet
+     * \param threads       number of threads to use, zero means one thread per
+     *                      processor core for BGZF files and a single thread
+     *                      for other files
      * \return Returns true, if the file could be extracted successfully.
      *         Returns false, if the extraction failed.
+     * \remarks BGZF files are decompressed on several threads, one member per
+     *          thread. Other files of concatenated gzip members are only
+     *          decompressed in parallel, if threads is more than one, because
+     *          the file has to be read once to find the members. Files with a
+     *          single member and data that is read from a stream always use a
+     *          single thread.
+     */
+    bool extractTo(const std::string& destFileName, const unsigned int threads = 0);
+
+
+    /** \brief Extracts the uncompressed data and passes it to a sink.
+     *
+     * \param sink  callback that receives the data chunk by chunk
+     * \return Returns true, if the data could be extracted successfully.
+     *         Returns false, if the extraction failed or the sink aborted it.
      */
-    bool extractTo(const std::string& destFileName);
+    bool extractToSink(const libstriezel::archive::Sink& sink);
+
+
+    /** \brief Extracts the uncompressed data into a memory buffer.
+     *
+     * \param buffer  vector that will hold the uncompressed data
+     * \return Returns true, if the data could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     * \remarks zlib decompresses straight into the vector. The size stored at
+     *          the end of the file is used as initial size, the vector grows
+     *          when the data is larger than that.
+     */
+    bool extractToBuffer(std::vector<uint8_t>& buffer);
+
+
+    /** \brief Extracts the uncompressed data into a preallocated buffer.
+     *
+     * \param buffer    pointer to the start of the buffer
+     * \param capacity  size of the buffer in bytes
+     * \param size      variable that will hold the size of the data
+     * \return Returns true, if the data could be extracted successfully.
+     *         Returns false, if the extraction failed or if the data does not
+     *         fit into the buffer.
+     */
+    bool extractToBuffer(void* buffer, const std::size_t capacity, std::size_t& size);
+
+
+    /** \brief Extracts several files to the specified destinations.
+     *
+     * \param files  maps the path of each file within the archive to the
+     *               destination file name - destination files must not exist yet
+     * \return Returns a map that contains an element for every requested file.
+     *         Its value is true, if the file could be extracted successfully,
+     *         or false, if the extraction failed.
+     * \remarks For gzip files, the only valid path is the name of the single
+     *          entry, see entries().
+     */
+    std::map<std::string, bool> extractMany(const std::map<std::string, std::string>& files);
+
+
+    /** \brief Extracts all files within the gzip file and passes their data
+     * to sinks, without extracting them to disk.
+     *
+     * \param sinkFor  callback that gets the entry of each file and returns
+     *                 the sink for the data of that file
+     * \return Returns true, if the data could be extracted successfully.
+     *         Returns false, if the extraction failed or the sink aborted it.
+     * \remarks For gzip files, there is only one single entry.
+     */
+    bool extractAllToSinks(const std::function<libstriezel::archive::Sink(const libstriezel::archive::entry&)>& sinkFor);
+
+
+    /** \brief Builds an index for random access into the uncompressed data.
+     *
+     * \param spacing  minimum distance between two checkpoints in bytes of
+     *                 uncompressed data - smaller values need more memory,
+     *                 but make readAt() faster
+     * \return Returns true, if the index was built.
+     *         Returns false, if an error occurred.
+     * \remarks This decompresses all data once. Use saveIndex() to keep the
+     *          index for later uses of the same file.
+     */
+    bool buildIndex(const int64_t spacing = checkpointIndex::defaultSpacing);
+
+
+    /** \brief Writes the index to a file.
+     *
+     * \param indexFile  name of the index file - an empty name means the
+     *                   default name next to the gzip file
+     * \return Returns true, if the index file was written.
+     *         Returns false, if an error occurred, the index was not built or
+     *         the archive was not opened from a file.
+     */
+    bool saveIndex(const std::string& indexFile = "") const;
+
+
+    /** \brief Reads the index from a file.
+     *
+     * \param indexFile  name of the index file - an empty name means the
+     *                   default name next to the gzip file
+     * \return Returns true, if the index was loaded.
+     *         Returns false, if the index file does not exist, is damaged or
+     *         belongs to another state of the gzip file.
+     */
+    bool loadIndex(const std::string& indexFile = "");
+
+
+    /** \brief Reads uncompressed data at any offset.
+     *
+     * \param offset  offset in the uncompressed data
+     * \param buffer  the buffer that gets the data
+     * \param length  number of bytes to read
+     * \return Returns the number of bytes that were read, which is less than
+     *         length only at the end of the data. Returns -1, if an error
+     *         occurred.
+     * \remarks Without an index, see buildIndex() and loadIndex(), every call
+     *          decompresses the data from the start up to the offset.
+     */
+    int64_t readAt(const int64_t offset, void* buffer, const std::size_t length);
 
 
     /** \brief Checks whether a file may be a gzip-compressed file.
@@ -81,8 +244,70 @@ class archive
      */
     static bool isGzip(const std::string& fileName);
   private:
-    gzFile m_gzip; /**< gzip file handle */
+    /** \brief Prepares the inflate stream for data in memory or in a stream.
+     *
+     * \param uncompressedSize  uncompressed size as stored at the end of the data
+     * \remarks This function throws an exception, if zlib cannot be initialized.
+     */
+    void initializeInflate(const uint32_t uncompressedSize);
+
+
+    /** \brief Goes back to the start of the uncompressed data.
+     *
+     * \return Returns true, if the next read starts at the beginning.
+     *         Returns false, if an error occurred.
+     */
+    bool rewind();
+
+
+    /** \brief Reads uncompressed data.
+     *
+     * \param buffer  the buffer that gets the data
+     * \param size    maximum number of bytes to read, at most INT_MAX
+     * \return Returns the number of bytes that were read, zero at the end of
+     *         the data, or -1, if an error occurred - just like gzread().
+     */
+    int readData(void* buffer, const unsigned int size);
+
+
+    /** \brief Passes the next chunk of compressed data to the inflate stream.
+     *
+     * \return Returns true, if the data could be read. An empty chunk means
+     *         that the end of the compressed data has been reached.
+     *         Returns false, if an error occurred.
+     */
+    bool fillInput();
+
+
+    /** \brief Gets a callback that reads the compressed data at any offset.
+     *
+     * \return Returns the callback.
+     * \remarks The callback uses the stream position of streams, so rewind()
+     *          has to be called before the next sequential read.
+     */
+    CompressedReader compressedReader() const;
+
+
+    /** \brief Gets a callback that creates independent readers for threads.
+     *
+     * \return Returns the callback.
+     * \remarks Only data in memory or in a file can be read by threads.
+     */
+    ReaderFactory readerFactory() const;
+
+
+    gzFile m_gzip; /**< gzip file handle, nullptr for other sources */
+    std::string m_fileName; /**< name of the gzip file, empty for other sources */
     std::vector<libstriezel::archive::entry> m_entries; /**< entries in the archive */
+    const uint8_t * m_data; /**< start of compressed data in memory, or nullptr */
+    std::size_t m_dataSize; /**< size of compressed data in memory */
+    std::size_t m_dataPosition; /**< start of the next chunk of data in memory */
+    libstriezel::archive::seekableStream * m_stream; /**< stream that contains the data, or nullptr */
+    std::vector<uint8_t> m_input; /**< buffer for compressed data from the stream */
+    z_stream m_inflate; /**< inflate stream for data in memory or in a stream */
+    bool m_inflateReady; /**< whether m_inflate has been initialized */
+    bool m_inflateFinished; /**< whether the end of the data has been reached */
+    checkpointIndex m_index; /**< checkpoints for readAt() */
 };
 
 } // namespace
@@ -0,0 +1,407 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "checkpointIndex.hpp"
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iterator>
+#include <zlib.h>
+
+namespace libstriezel::gzip
+{
+
+namespace
+{
+
+/// size of the window of deflate, i.e. the maximum distance of a match
+const std::size_t windowBytes = 32768;
+
+/// size of the chunks of compressed data that are read at once
+const std::size_t chunkBytes = 16384;
+
+/// first bytes of every index file
+const std::string magic("lstzGZI", 8);
+
+/// version of the file layout
+const uint32_t version = 2;
+
+/// ends an inflate stream when it goes out of scope
+class inflateGuard
+{
+  public:
+    explicit inflateGuard(z_stream& strm)
+    : m_strm(strm)
+    {
+    }
+
+    ~inflateGuard()
+    {
+      inflateEnd(&m_strm);
+    }
+  private:
+    z_stream& m_strm;
+};
+
+/* Checks whether another gzip member starts at the given offset. */
+bool memberFollows(const CompressedReader& reader, const int64_t offset)
+{
+  unsigned char id[2];
+  return (libstriezel::archive::readFull(reader, offset, id, sizeof(id)) == static_cast<int64_t>(sizeof(id)))
+      && (id[0] == 0x1F) && (id[1] == 0x8B);
+}
+
+using libstriezel::archive::serialization::put;
+
+} // anonymous namespace
+
+checkpointIndex::checkpointIndex()
+: m_points(std::vector<checkpoint>()),
+  m_spacing(defaultSpacing),
+  m_size(-1)
+{
+}
+
+void checkpointIndex::clear()
+{
+  m_points.clear();
+  m_spacing = defaultSpacing;
+  m_size = -1;
+}
+
+bool checkpointIndex::build(const CompressedReader& reader, const int64_t spacing)
+{
+  clear();
+  if (spacing <= 0)
+    return false;
+
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  strm.next_in = Z_NULL;
+  strm.avail_in = 0;
+  // 16 + MAX_WBITS: expect a gzip header and trailer
+  if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK)
+    return false;
+  const inflateGuard guard(strm);
+
+  std::vector<unsigned char> input(chunkBytes);
+  // The output goes round and round through the window, so that it always
+  // holds the last 32 KiB of uncompressed data.
+  std::vector<unsigned char> window(windowBytes);
+  strm.next_out = window.data();
+  strm.avail_out = static_cast<uInt>(windowBytes);
+  int64_t readPosition = 0;
+  int64_t totalIn = 0;
+  int64_t totalOut = 0;
+  int64_t last = 0;
+  std::vector<checkpoint> points;
+  while (true)
+  {
+    if (strm.avail_in == 0)
+    {
+      const int64_t bytesRead = reader(readPosition, input.data(), input.size());
+      // The end of the data before the end of the stream means truncation.
+      if (bytesRead <= 0)
+        return false;
+      strm.next_in = input.data();
+      strm.avail_in = static_cast<uInt>(bytesRead);
+      readPosition += bytesRead;
+    }
+    if (strm.avail_out == 0)
+    {
+      strm.next_out = window.data();
+      strm.avail_out = static_cast<uInt>(windowBytes);
+    }
+    totalIn += strm.avail_in;
+    totalOut += strm.avail_out;
+    // Z_BLOCK stops at the end of every deflate block.
+    const int ret = inflate(&strm, Z_BLOCK);
+    totalIn -= strm.avail_in;
+    totalOut -= strm.avail_out;
+    if ((ret == Z_NEED_DICT) || (ret == Z_DATA_ERROR) || (ret == Z_MEM_ERROR))
+      return false;
+    if (ret == Z_STREAM_END)
+    {
+      // Concatenated members form one stream of uncompressed data.
+      if (!memberFollows(reader, totalIn))
+        break;
+      if (inflateReset(&strm) != Z_OK)
+        return false;
+      readPosition = totalIn;
+      strm.avail_in = 0;
+      continue;
+    }
+    // Bit 7 marks the end of a block, bit 6 the last block of a member.
+    // There is nothing to resume after the last block.
+    if (((strm.data_type & 128) != 0) && ((strm.data_type & 64) == 0)
+        && (totalOut - last >= spacing))
+    {
+      checkpoint point;
+      point.out = totalOut;
+      point.in = totalIn;
+      point.bits = strm.data_type & 7;
+      point.windowSize = static_cast<uint32_t>(std::min<int64_t>(totalOut, windowBytes));
+      // Unroll the last bytes of the circular window.
+      std::vector<unsigned char> plain(point.windowSize);
+      const std::size_t position = windowBytes - strm.avail_out;
+      if (point.windowSize <= position)
+        std::copy(window.begin() + (position - point.windowSize), window.begin() + position, plain.begin());
+      else
+      {
+        const std::size_t wrapped = point.windowSize - position;
+        std::copy(window.end() - wrapped, window.end(), plain.begin());
+        std::copy(window.begin(), window.begin() + position, plain.begin() + wrapped);
+      }
+      uLongf compressedLength = compressBound(point.windowSize);
+      point.window.resize(compressedLength);
+      if (compress2(point.window.data(), &compressedLength, plain.data(),
+                    point.windowSize, 1) != Z_OK)
+        return false;
+      point.window.resize(compressedLength);
+      point.window.shrink_to_fit();
+      points.push_back(std::move(point));
+      last = totalOut;
+    }
+  }
+
+  m_points = std::move(points);
+  m_spacing = spacing;
+  m_size = totalOut;
+  return true;
+}
+
+bool checkpointIndex::built() const
+{
+  return m_size >= 0;
+}
+
+std::size_t checkpointIndex::size() const
+{
+  return m_points.size();
+}
+
+int64_t checkpointIndex::uncompressedSize() const
+{
+  return m_size;
+}
+
+int64_t checkpointIndex::read(const CompressedReader& reader, const int64_t offset,
+                              void* buffer, const std::size_t length) const
+{
+  if ((offset < 0) || (nullptr == buffer))
+    return -1;
+  if ((length == 0) || (built() && (offset >= m_size)))
+    return 0;
+
+  // last checkpoint at or in front of the offset
+  const auto after = std::upper_bound(m_points.begin(), m_points.end(), offset,
+      [](const int64_t value, const checkpoint& point) { return value < point.out; });
+  const checkpoint * point = (after == m_points.begin()) ? nullptr : &*(after - 1);
+
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  strm.next_in = Z_NULL;
+  strm.avail_in = 0;
+  // Checkpoints are inside the deflate data, so they need raw inflate.
+  bool raw = nullptr != point;
+  if (inflateInit2(&strm, raw ? -MAX_WBITS : 16 + MAX_WBITS) != Z_OK)
+    return -1;
+  const inflateGuard guard(strm);
+
+  int64_t readPosition = 0;
+  int64_t skip = offset;
+  if (raw)
+  {
+    readPosition = point->in;
+    skip = offset - point->out;
+    if (point->bits != 0)
+    {
+      // The block starts within the byte in front of the checkpoint.
+      unsigned char byte = 0;
+      if (reader(point->in - 1, &byte, 1) != 1)
+        return -1;
+      if (inflatePrime(&strm, point->bits, byte >> (8 - point->bits)) != Z_OK)
+        return -1;
+    }
+    std::vector<unsigned char> plain(point->windowSize);
+    uLongf plainLength = point->windowSize;
+    if ((uncompress(plain.data(), &plainLength, point->window.data(), point->window.size()) != Z_OK)
+        || (plainLength != point->windowSize))
+      return -1;
+    if (inflateSetDictionary(&strm, plain.data(), point->windowSize) != Z_OK)
+      return -1;
+  }
+
+  std::vector<unsigned char> input(chunkBytes);
+  std::vector<unsigned char> discard;
+  if (skip > 0)
+    discard.resize(windowBytes);
+  unsigned char * out = static_cast<unsigned char*>(buffer);
+  std::size_t filled = 0;
+  while (filled < length)
+  {
+    if (strm.avail_in == 0)
+    {
+      const int64_t bytesRead = reader(readPosition, input.data(), input.size());
+      if (bytesRead <= 0)
+        return -1;
+      strm.next_in = input.data();
+      strm.avail_in = static_cast<uInt>(bytesRead);
+      readPosition += bytesRead;
+    }
+    if (skip > 0)
+    {
+      strm.next_out = discard.data();
+      strm.avail_out = static_cast<uInt>(std::min<int64_t>(skip, windowBytes));
+    }
+    else
+    {
+      strm.next_out = out + filled;
+      strm.avail_out = static_cast<uInt>(std::min<std::size_t>(length - filled, UINT_MAX));
+    }
+    const uInt before = strm.avail_out;
+    const int ret = inflate(&strm, Z_NO_FLUSH);
+    const uInt produced = before - strm.avail_out;
+    if (skip > 0)
+      skip -= produced;
+    else
+      filled += produced;
+    if ((ret == Z_NEED_DICT) || (ret == Z_DATA_ERROR) || (ret == Z_MEM_ERROR))
+      return -1;
+    if (ret == Z_STREAM_END)
+    {
+      // Raw inflate leaves the trailer of eight bytes behind.
+      const int64_t next = readPosition - strm.avail_in + (raw ? 8 : 0);
+      if (!memberFollows(reader, next))
+        break;
+      raw = false;
+      if (inflateReset2(&strm, 16 + MAX_WBITS) != Z_OK)
+        return -1;
+      readPosition = next;
+      strm.avail_in = 0;
+    }
+  }
+  return static_cast<int64_t>(filled);
+}
+
+bool checkpointIndex::save(const std::string& fileName, const libstriezel::archive::listingKey& key) const
+{
+  if (!built())
+    return false;
+  std::string data(magic);
+  put(data, version, 4);
+  libstriezel::archive::writeListingKey(data, key);
+  put(data, static_cast<uint64_t>(m_spacing), 8);
+  put(data, static_cast<uint64_t>(m_size), 8);
+  put(data, m_points.size(), 8);
+  for (const checkpoint& point : m_points)
+  {
+    put(data, static_cast<uint64_t>(point.out), 8);
+    put(data, static_cast<uint64_t>(point.in), 8);
+    put(data, static_cast<uint64_t>(point.bits), 1);
+    put(data, point.windowSize, 4);
+    put(data, point.window.size(), 4);
+    data.append(reinterpret_cast<const char*>(point.window.data()), point.window.size());
+  }
+  put(data, libstriezel::archive::serialization::fnv1a(data), 8);
+  return libstriezel::archive::replaceFile(fileName, data);
+}
+
+bool checkpointIndex::load(const std::string& fileName, const libstriezel::archive::listingKey& key)
+{
+  clear();
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  if (!stream.good())
+    return false;
+  const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  stream.close();
+
+  // The checksum detects truncated or damaged files.
+  if ((data.size() < magic.size() + 8) || (data.compare(0, magic.size(), magic) != 0))
+    return false;
+  const std::size_t end = data.size() - 8;
+  uint64_t value = 0;
+  libstriezel::archive::serialization::reader tail(data, end, data.size());
+  if (!tail.get(value, 8)
+      || (value != libstriezel::archive::serialization::fnv1a(std::string_view(data.data(), end))))
+    return false;
+
+  libstriezel::archive::serialization::reader in(data, magic.size(), end);
+  if (!in.get(value, 4) || (value != version))
+    return false;
+  // The index belongs to another file or the file has changed since.
+  if (!libstriezel::archive::checkListingKey(in, key))
+    return false;
+
+  uint64_t spacing = 0;
+  uint64_t uncompressed = 0;
+  uint64_t count = 0;
+  if (!in.get(spacing, 8) || !in.get(uncompressed, 8) || !in.get(count, 8))
+    return false;
+  // Every checkpoint needs at least 25 bytes, so a wrong count cannot
+  // allocate more memory than the file size suggests.
+  if ((static_cast<int64_t>(spacing) <= 0) || (static_cast<int64_t>(uncompressed) < 0)
+      || (count > end / 25))
+    return false;
+  std::vector<checkpoint> points;
+  points.reserve(static_cast<std::size_t>(count));
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    uint64_t out = 0;
+    uint64_t inOffset = 0;
+    uint64_t bits = 0;
+    uint64_t windowSize = 0;
+    uint64_t compressedLength = 0;
+    std::string_view window;
+    if (!in.get(out, 8) || !in.get(inOffset, 8) || !in.get(bits, 1) || !in.get(windowSize, 4)
+        || !in.get(compressedLength, 4) || !in.getBytes(window, compressedLength))
+      return false;
+    // Checkpoints must be in order and within the data.
+    if ((bits > 7) || (windowSize > windowBytes) || (static_cast<int64_t>(inOffset) < 1)
+        || (static_cast<int64_t>(inOffset) > key.size) || (out > uncompressed)
+        || (!points.empty() && (static_cast<int64_t>(out) <= points.back().out)))
+      return false;
+    checkpoint point;
+    point.out = static_cast<int64_t>(out);
+    point.in = static_cast<int64_t>(inOffset);
+    point.bits = static_cast<int>(bits);
+    point.windowSize = static_cast<uint32_t>(windowSize);
+    point.window.assign(window.begin(), window.end());
+    points.push_back(std::move(point));
+  }
+  if (!in.atEnd())
+    return false;
+
+  m_points = std::move(points);
+  m_spacing = static_cast<int64_t>(spacing);
+  m_size = static_cast<int64_t>(uncompressed);
+  return true;
+}
+
+std::string checkpointIndex::indexFileName(const std::string& gzipFileName)
+{
+  return gzipFileName + ".gzidx";
+}
+
+} // namespace
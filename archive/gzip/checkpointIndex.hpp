@@ -0,0 +1,165 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_GZIP_CHECKPOINTINDEX_HPP
+#define LIBSTRIEZEL_GZIP_CHECKPOINTINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../compressedReader.hpp"
+#include "../listingCache.hpp"
+
+namespace libstriezel::gzip
+{
+
+using libstriezel::archive::CompressedReader;
+
+
+/** \brief checkpoints for random access into gzip-compressed data
+ *
+ * Deflate streams can only be decompressed from the start. The index
+ * remembers the state of the decompressor at the end of deflate blocks
+ * every few MiB of uncompressed data: the position in the compressed data
+ * down to the bit and the last 32 KiB of uncompressed data. Reading at any
+ * offset then starts at the nearest checkpoint in front of it, just like
+ * zran.c from the examples of zlib does it.
+ * Each checkpoint keeps its 32 KiB window compressed, so the memory use is
+ * usually much lower than 32 KiB per checkpoint.
+ */
+class checkpointIndex
+{
+  public:
+    /// default distance between two checkpoints in uncompressed bytes
+    static constexpr int64_t defaultSpacing = 4 * 1024 * 1024;
+
+
+    /** \brief constructor - creates an empty index
+     */
+    checkpointIndex();
+
+
+    /** \brief Removes all checkpoints.
+     */
+    void clear();
+
+
+    /** \brief Builds the index by decompressing all data once.
+     *
+     * \param reader   callback that reads the compressed data
+     * \param spacing  minimum distance between two checkpoints in bytes of
+     *                 uncompressed data
+     * \return Returns true, if the index was built.
+     *         Returns false, if the data is damaged or cannot be read.
+     * \remarks Concatenated gzip members are supported. Data after the last
+     *          member that is not another member is ignored, like gzread()
+     *          does it.
+     */
+    bool build(const CompressedReader& reader, const int64_t spacing = defaultSpacing);
+
+
+    /** \brief Checks whether the index has been built or loaded.
+     *
+     * \return Returns true, if the index knows the uncompressed data.
+     */
+    bool built() const;
+
+
+    /** \brief Gets the number of checkpoints.
+     *
+     * \return Returns the number of checkpoints.
+     */
+    std::size_t size() const;
+
+
+    /** \brief Gets the size of the uncompressed data.
+     *
+     * \return Returns the size of the uncompressed data in bytes.
+     *         Returns -1, if the index has not been built yet.
+     */
+    int64_t uncompressedSize() const;
+
+
+    /** \brief Reads uncompressed data at a given offset.
+     *
+     * \param reader  callback that reads the compressed data
+     * \param offset  offset in the uncompressed data
+     * \param buffer  the buffer that gets the data
+     * \param length  number of bytes to read
+     * \return Returns the number of bytes that were read, which is less than
+     *         length only at the end of the data. Returns -1, if an error
+     *         occurred.
+     * \remarks Without checkpoints the decompression starts at the start of
+     *          the data. With checkpoints it decompresses at most one spacing
+     *          of data in front of the offset.
+     */
+    int64_t read(const CompressedReader& reader, const int64_t offset,
+                 void* buffer, const std::size_t length) const;
+
+
+    /** \brief Writes the index to a file.
+     *
+     * \param fileName  name of the index file
+     * \param key       key of the gzip file the index belongs to
+     * \return Returns true, if the index file was written.
+     *         Returns false, if an error occurred or the index is not built.
+     */
+    bool save(const std::string& fileName, const libstriezel::archive::listingKey& key) const;
+
+
+    /** \brief Reads the index from a file.
+     *
+     * \param fileName  name of the index file
+     * \param key       current key of the gzip file
+     * \return Returns true, if the index file exists, is intact and belongs
+     *         to the given key. Returns false otherwise, and the index is
+     *         empty afterwards.
+     */
+    bool load(const std::string& fileName, const libstriezel::archive::listingKey& key);
+
+
+    /** \brief Gets the default name of the index file for a gzip file.
+     *
+     * \param gzipFileName  path of the gzip file
+     * \return Returns the name of the index file next to the gzip file.
+     */
+    static std::string indexFileName(const std::string& gzipFileName);
+  private:
+    /// state of the decompressor at the end of a deflate block
+    struct checkpoint
+    {
+      int64_t out; /**< offset in the uncompressed data */
+      int64_t in; /**< offset of the first full byte in the compressed data */
+      int bits; /**< number of bits of the byte in front of in that belong to the next block */
+      uint32_t windowSize; /**< size of the window when it is decompressed */
+      std::vector<uint8_t> window; /**< last uncompressed bytes, compressed */
+    };
+
+
+    std::vector<checkpoint> m_points; /**< checkpoints, sorted by offset */
+    int64_t m_spacing; /**< minimum distance between checkpoints */
+    int64_t m_size; /**< size of the uncompressed data, or -1 */
+}; // class
+
+} // namespace
+
+#endif // LIBSTRIEZEL_GZIP_CHECKPOINTINDEX_HPP
@@ -0,0 +1,385 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "members.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <zlib.h>
+
+namespace libstriezel::gzip
+{
+
+namespace
+{
+
+using libstriezel::archive::readFull;
+
+/// size of the chunks of compressed data that are read at once
+const std::size_t chunkBytes = 64 * 1024;
+
+/// size of the buffer for the header signature scan
+const std::size_t scanBytes = 1024 * 1024;
+
+/// uncompressed size up to which workers keep a member in memory
+const std::size_t memberLimit = 32 * 1024 * 1024;
+
+/// compressed bytes that are decompressed on trial to check a candidate
+const std::size_t trialBytes = 16 * 1024;
+
+/// size of the smallest gzip member: header, empty deflate block, trailer
+const int64_t minimumMember = 20;
+
+/// maximum ratio of uncompressed to compressed size that deflate reaches
+const int64_t maximumRatio = 1032;
+
+/* Checks whether the bytes may be the start of a gzip header: the
+   signature, deflate as method and no reserved flags. */
+bool isHeader(const uint8_t* data)
+{
+  return (data[0] == 0x1F) && (data[1] == 0x8B) && (data[2] == 8) && ((data[3] & 0xE0) == 0);
+}
+
+/* Follows the block sizes of a BGZF file. Returns false, if the file is no
+   BGZF file or the chain of blocks is broken. */
+bool followBgzf(const CompressedReader& reader, std::vector<int64_t>& members)
+{
+  int64_t offset = 0;
+  uint8_t header[12];
+  std::vector<uint8_t> extra;
+  while (true)
+  {
+    const int64_t bytesRead = readFull(reader, offset, header, sizeof(header));
+    if ((bytesRead == 0) && (offset > 0))
+      return true;
+    // The BC subfield is in the extra field, flag FEXTRA.
+    if ((bytesRead != sizeof(header)) || !isHeader(header) || ((header[3] & 4) == 0))
+      return false;
+    const std::size_t extraLength = header[10] | (header[11] << 8);
+    extra.resize(extraLength);
+    if (readFull(reader, offset + 12, extra.data(), extraLength) != static_cast<int64_t>(extraLength))
+      return false;
+    int64_t blockSize = -1;
+    std::size_t position = 0;
+    while (extraLength - position >= 4)
+    {
+      const std::size_t fieldLength = extra[position + 2] | (extra[position + 3] << 8);
+      if ((extra[position] == 'B') && (extra[position + 1] == 'C') && (fieldLength == 2)
+          && (extraLength - position >= 6))
+      {
+        // BSIZE is the size of the whole member minus one.
+        blockSize = (extra[position + 4] | (extra[position + 5] << 8)) + 1;
+        break;
+      }
+      position += 4 + fieldLength;
+    }
+    if (blockSize < 0)
+      return false;
+    members.push_back(offset);
+    offset += blockSize;
+  }
+}
+
+/* Decompresses the member that starts at the offset and passes its data to
+   the sink. Returns the offset after the member, or -1, if an error occurred
+   or the sink aborted. */
+int64_t inflateMember(const CompressedReader& reader, const int64_t offset, const libstriezel::archive::Sink& sink)
+{
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  strm.next_in = Z_NULL;
+  strm.avail_in = 0;
+  // 16 + MAX_WBITS: expect a gzip header and trailer, zlib checks the CRC
+  if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK)
+    return -1;
+
+  std::vector<uint8_t> input(chunkBytes);
+  std::vector<uint8_t> output(chunkBytes);
+  int64_t readPosition = offset;
+  int ret = Z_OK;
+  while (ret != Z_STREAM_END)
+  {
+    if (strm.avail_in == 0)
+    {
+      const int64_t bytesRead = reader(readPosition, input.data(), input.size());
+      if (bytesRead <= 0)
+        break;
+      strm.next_in = input.data();
+      strm.avail_in = static_cast<uInt>(bytesRead);
+      readPosition += bytesRead;
+    }
+    strm.next_out = output.data();
+    strm.avail_out = static_cast<uInt>(output.size());
+    ret = inflate(&strm, Z_NO_FLUSH);
+    if ((ret != Z_OK) && (ret != Z_STREAM_END) && (ret != Z_BUF_ERROR))
+      break;
+    const std::size_t produced = output.size() - strm.avail_out;
+    if ((produced > 0) && !sink(output.data(), produced))
+      break;
+  }
+  const int64_t end = readPosition - strm.avail_in;
+  inflateEnd(&strm);
+  return (ret == Z_STREAM_END) ? end : -1;
+}
+
+/* Checks whether a candidate can be the start of a member: a real member
+   follows the trailer of the previous member, and its compressed data can
+   be decompressed. Signatures within compressed data almost always fail one
+   of these checks, so workers do not waste time and memory on them. */
+bool plausibleMember(const CompressedReader& reader, const int64_t offset)
+{
+  if (offset > 0)
+  {
+    // The last four bytes of the previous trailer are ISIZE, the size of the
+    // previous member modulo 2^32. It cannot exceed what deflate produces
+    // from the data before the candidate.
+    uint8_t isize[4];
+    if ((offset < minimumMember) || (readFull(reader, offset - 4, isize, sizeof(isize)) != static_cast<int64_t>(sizeof(isize))))
+      return false;
+    const int64_t size = isize[0] | (isize[1] << 8) | (isize[2] << 16) | (static_cast<int64_t>(isize[3]) << 24);
+    const int64_t bound = (offset - minimumMember + 2) * maximumRatio;
+    if ((bound < (static_cast<int64_t>(1) << 32)) && (size > bound))
+      return false;
+  }
+
+  std::vector<uint8_t> input(trialBytes);
+  const int64_t bytesRead = readFull(reader, offset, input.data(), input.size());
+  if (bytesRead <= 0)
+    return false;
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  strm.next_in = input.data();
+  strm.avail_in = static_cast<uInt>(bytesRead);
+  // 16 + MAX_WBITS: zlib checks the whole header, including its CRC
+  if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK)
+    return false;
+  std::vector<uint8_t> output(chunkBytes);
+  int ret = Z_OK;
+  // Highly compressed data could produce a lot of output, so stop early.
+  for (std::size_t round = 0; (round < 16) && (ret == Z_OK) && (strm.avail_in > 0); ++round)
+  {
+    strm.next_out = output.data();
+    strm.avail_out = static_cast<uInt>(output.size());
+    ret = inflate(&strm, Z_NO_FLUSH);
+  }
+  inflateEnd(&strm);
+  return (ret == Z_OK) || (ret == Z_STREAM_END) || (ret == Z_BUF_ERROR);
+}
+
+/* Decompresses the members from the offset on, one after the other, like
+   gzread() does it: data that does not start with a gzip signature ends the
+   members and is ignored. Returns false, if a read error occurred, a member
+   is damaged or the sink aborted. */
+bool inflateRest(const CompressedReader& reader, int64_t offset, const libstriezel::archive::Sink& sink)
+{
+  while (true)
+  {
+    uint8_t signature[2];
+    const int64_t bytesRead = readFull(reader, offset, signature, sizeof(signature));
+    if (bytesRead < 0)
+      return false;
+    if ((bytesRead < static_cast<int64_t>(sizeof(signature))) || (signature[0] != 0x1F) || (signature[1] != 0x8B))
+      return true;
+    offset = inflateMember(reader, offset, sink);
+    if (offset < 0)
+      return false;
+  }
+}
+
+/// result of a worker for one candidate
+struct member
+{
+  bool ready; /**< whether the worker is done with the candidate */
+  int64_t end; /**< offset after the member, or -1, if the worker failed */
+  std::vector<uint8_t> data; /**< the decompressed data */
+};
+
+} // anonymous namespace
+
+std::vector<int64_t> findMembers(const CompressedReader& reader, const bool scan)
+{
+  std::vector<int64_t> members;
+  if (followBgzf(reader, members))
+    return members;
+  members.clear();
+  if (!scan)
+    return members;
+
+  // Overlap the chunks, so that no signature is cut in half.
+  const std::size_t overlap = 3;
+  std::vector<uint8_t> buffer(scanBytes);
+  int64_t offset = 0;
+  while (true)
+  {
+    const int64_t bytesRead = readFull(reader, offset, buffer.data(), buffer.size());
+    if (bytesRead < 0)
+      return std::vector<int64_t>();
+    const std::size_t size = static_cast<std::size_t>(bytesRead);
+    const bool last = size < buffer.size();
+    const std::size_t limit = last ? size : size - overlap;
+    const uint8_t * position = buffer.data();
+    const uint8_t * const end = buffer.data() + limit;
+    while (position < end)
+    {
+      position = static_cast<const uint8_t*>(std::memchr(position, 0x1F, end - position));
+      if (nullptr == position)
+        break;
+      const std::size_t index = position - buffer.data();
+      if ((size - index >= 4) && isHeader(position)
+          && plausibleMember(reader, offset + static_cast<int64_t>(index)))
+        members.push_back(offset + static_cast<int64_t>(index));
+      ++position;
+    }
+    if (last)
+      break;
+    offset += static_cast<int64_t>(limit);
+  }
+  return members;
+}
+
+bool inflateMembers(const ReaderFactory& openReader, const std::vector<int64_t>& candidates,
+                    unsigned int threads, const libstriezel::archive::Sink& sink)
+{
+  if (candidates.empty() || (candidates.front() != 0))
+    return false;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned int>(std::min<std::size_t>(threads, candidates.size()));
+
+  // Workers may only run a few members ahead of the calling thread, which
+  // limits the memory for decompressed members that wait for their turn.
+  const std::size_t window = threads + 2;
+  std::vector<member> slots(window);
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::size_t next = 0;
+  std::size_t consumed = 0;
+  bool stop = false;
+
+  const auto work = [&]()
+  {
+    const CompressedReader reader = openReader();
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+      changed.wait(lock, [&]() { return stop || (next >= candidates.size()) || (next < consumed + window); });
+      if (stop || (next >= candidates.size()))
+        return;
+      const std::size_t current = next++;
+      lock.unlock();
+
+      member result { true, -1, std::vector<uint8_t>() };
+      result.end = inflateMember(reader, candidates[current],
+          [&result](const void* data, const std::size_t size)
+          {
+            // Large members are left to the calling thread.
+            if (result.data.size() + size > memberLimit)
+              return false;
+            const uint8_t * bytes = static_cast<const uint8_t*>(data);
+            try
+            {
+              result.data.insert(result.data.end(), bytes, bytes + size);
+            }
+            catch (const std::bad_alloc&)
+            {
+              // The calling thread tries again without the buffer.
+              return false;
+            }
+            return true;
+          });
+      if (result.end < 0)
+        result.data = std::vector<uint8_t>();
+
+      lock.lock();
+      slots[current % window] = std::move(result);
+      changed.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    workers.push_back(std::thread(work));
+  }
+
+  const CompressedReader reader = openReader();
+  bool success = true;
+  int64_t cursor = 0;
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+  {
+    member current;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [&]() { return slots[i % window].ready; });
+      current = std::move(slots[i % window]);
+      slots[i % window].ready = false;
+      consumed = i + 1;
+      changed.notify_all();
+    }
+    // signature within the data of the previous member
+    if (candidates[i] < cursor)
+      continue;
+    // No candidate starts at the cursor, so the rest is left to the serial
+    // decompression below.
+    if (candidates[i] > cursor)
+      break;
+    if (current.end >= 0)
+    {
+      if (!current.data.empty() && !sink(current.data.data(), current.data.size()))
+      {
+        success = false;
+        break;
+      }
+      cursor = current.end;
+    }
+    else
+    {
+      // too large or damaged, decide it without the memory limit
+      cursor = inflateMember(reader, candidates[i], sink);
+      if (cursor < 0)
+      {
+        success = false;
+        break;
+      }
+    }
+  }
+
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  changed.notify_all();
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+  // The scan may have missed a member at the cursor, or the file may go on
+  // after the last candidate.
+  return success && inflateRest(reader, cursor, sink);
+}
+
+} // namespace
@@ -0,0 +1,81 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_GZIP_MEMBERS_HPP
+#define LIBSTRIEZEL_GZIP_MEMBERS_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "../sink.hpp"
+#include "checkpointIndex.hpp"
+
+namespace libstriezel::gzip
+{
+
+/** \brief callback that creates a new reader for the compressed data
+ *
+ * Every thread gets its own reader, so readers need not be thread-safe.
+ */
+typedef std::function<CompressedReader()> ReaderFactory;
+
+
+/** \brief Finds the offsets where gzip members may start.
+ *
+ * \param reader  callback that reads the compressed data
+ * \param scan    whether to scan files that are no BGZF files
+ * \return Returns the offsets in ascending order. Returns an empty vector
+ *         for files that are no BGZF files, if scan is false.
+ * \remarks BGZF files store the size of every member in the extra field of
+ *          its header, so their members are found without reading the
+ *          compressed data. Other files are read completely to find gzip
+ *          header signatures. A signature is only a candidate, if it follows
+ *          a plausible trailer and the start of its data can be decompressed.
+ *          Candidates that are part of the compressed data of another member
+ *          may still slip through - inflateMembers() sorts those out.
+ */
+std::vector<int64_t> findMembers(const CompressedReader& reader, const bool scan);
+
+
+/** \brief Decompresses concatenated gzip members on several threads.
+ *
+ * \param openReader  callback that creates a reader for each thread
+ * \param candidates  possible starts of members, see findMembers()
+ * \param threads     number of threads to use, zero means one thread per
+ *                    processor core
+ * \param sink        callback that receives the data in the right order
+ * \return Returns true, if all data was decompressed.
+ *         Returns false, if the data is damaged or the sink aborted.
+ * \remarks Workers decompress members into memory, the calling thread
+ *          passes them to the sink in order. It starts at offset zero and
+ *          follows the ends of the members, so candidates within other
+ *          members are skipped. Members that are too large to hold in memory
+ *          are decompressed by the calling thread while the workers go on.
+ *          If no candidate starts where a member ends, the calling thread
+ *          decompresses the rest of the members alone. Data after the last
+ *          member that does not start with a gzip signature is ignored, like
+ *          gzread() does it.
+ */
+bool inflateMembers(const ReaderFactory& openReader, const std::vector<int64_t>& candidates,
+                    unsigned int threads, const libstriezel::archive::Sink& sink);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_GZIP_MEMBERS_HPP
@@ -0,0 +1,77 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_HASHENTRIES_HPP
+#define LIBSTRIEZEL_ARCHIVE_HASHENTRIES_HPP
+
+#include <utility>
+#include <vector>
+#include "sink.hpp"
+#include "../hash/StreamHasher.hpp"
+
+namespace libstriezel::archive
+{
+
+/** \brief Computes message digests of all files within an archive in a
+ * single pass, without extracting them to disk.
+ *
+ * \param archive     the archive - any archive class with extractAllToSinks()
+ * \param algorithms  the hash algorithms to compute, a combination of
+ *                    libstriezel::hash::Algorithm flags
+ * \param result      vector that will hold the entries and their digests
+ * \return Returns true, if the digests could be computed successfully.
+ *         Returns false, if an error occurred.
+ * \remarks The data is fed to the hash functions straight from the
+ *          decompression buffer of the archive. The archive classes do not
+ *          hash anything themselves, so only code that calls this function
+ *          needs the hash implementations.
+ */
+template<typename Archive, typename Entry>
+bool hashEntries(Archive& archive, const unsigned int algorithms,
+                 std::vector<std::pair<Entry, libstriezel::hash::Digests> >& result)
+{
+  result.clear();
+  libstriezel::hash::StreamHasher hasher(algorithms);
+  const Sink toHasher = [&hasher](const void* data, const std::size_t size)
+  {
+    hasher.update(data, size);
+    return true;
+  };
+  // The digests of a file are complete when the next file starts.
+  const bool success = archive.extractAllToSinks([&hasher, &result, &toHasher](const Entry& e)
+  {
+    if (!result.empty())
+      result.back().second = hasher.finish();
+    result.push_back(std::make_pair(e, libstriezel::hash::Digests()));
+    return toHasher;
+  });
+  if (!success)
+  {
+    result.clear();
+    return false;
+  }
+  if (!result.empty())
+    result.back().second = hasher.finish();
+  return true;
+}
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_HASHENTRIES_HPP
@@ -19,16 +19,27 @@
 */
 
 #include "archive.hpp"
+#include <algorithm>
 #include <fstream> //for std::ifstream
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 #include "../../filesystem/file.hpp"
+#include "../signatures.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+  #define LIBSTRIEZEL_INSTALLSHIELD_READ_VIA_PIPE
+  #include <cerrno>
+  #include <unistd.h>
+#endif
 
 namespace libstriezel::installshield
 {
 
 archive::archive(const std::string& fileName)
-: m_archive(nullptr)
+: m_archive(nullptr),
+  m_index(libstriezel::archive::entryIndex()),
+  m_fileIndices(std::vector<int>()),
+  m_indexed(false)
 {
   unshield_set_log_level(UNSHIELD_LOG_LEVEL_ERROR);
   m_archive = unshield_open(fileName.c_str());
@@ -74,6 +85,67 @@ std::vector<libstriezel::archive::entry> archive::entries() const
   return result;
 }
 
+const libstriezel::archive::entryIndex& archive::index() const
+{
+  if (!m_indexed)
+  {
+    m_index.clear();
+    m_fileIndices.clear();
+    forEachEntry([this](const libstriezel::archive::entryView& view)
+    {
+      m_index.add(view.name);
+      m_fileIndices.push_back(static_cast<int>(view.index));
+      return true;
+    });
+    m_indexed = true;
+  }
+  return m_index;
+}
+
+bool archive::fillEntryTable(libstriezel::archive::entryTable& table) const
+{
+  table.clear();
+  return forEachEntry([&table](const libstriezel::archive::entryView& view)
+  {
+    table.add(view);
+    return true;
+  });
+}
+
+int64_t archive::findFile(const std::string& archiveFilePath) const
+{
+  const int64_t id = index().find(archiveFilePath);
+  if (id < 0)
+    return -1;
+  return m_fileIndices[id];
+}
+
+bool archive::forEachEntry(const libstriezel::archive::EntryVisitor& visitor) const
+{
+  // one name buffer for all files, instead of one string per file
+  std::string name;
+  const auto groupCount = unshield_file_group_count(m_archive);
+  for(auto groupIdx = 0; groupIdx < groupCount; ++groupIdx)
+  {
+    UnshieldFileGroup* group = unshield_file_group_get(m_archive, groupIdx);
+    for(auto fileIdx = group->first_file; fileIdx <= group->last_file; ++fileIdx)
+    {
+      if (!unshield_file_is_valid(m_archive, fileIdx))
+        continue;
+      name.assign(group->name);
+      if (!name.empty())
+        name.push_back('/');
+      name.append(unshield_file_name(m_archive, fileIdx));
+      const libstriezel::archive::entryView view { fileIdx, name,
+          static_cast<int64_t>(unshield_file_size(m_archive, fileIdx)),
+          static_cast<std::time_t>(-1), false, false };
+      if (!visitor(view))
+        return false;
+    } // for fileIdx
+  } // for groupIdx
+  return true;
+}
+
 bool archive::extractTo(const std::string& destFileName, int64_t index) const
 {
   if (!unshield_file_is_valid(m_archive, index))
@@ -102,7 +174,103 @@ bool archive::extractTo(const std::string& destFileName, const std::string& arch
     return false;
   }
   // find matching file
-  int64_t foundFileIdx = -1;
+  const int64_t foundFileIdx = findFile(archiveFilePath);
+  // Have we found anything?
+  if (foundFileIdx == -1)
+  {
+    std::cerr << "archive::installshield::extractTo: error: file "
+              << archiveFilePath << " does not exist in archive!" << std::endl;
+    return false;
+  }
+  return extractTo(destFileName, foundFileIdx);
+}
+
+bool archive::extractToSink(int64_t index, const libstriezel::archive::Sink& sink) const
+{
+  if (!unshield_file_is_valid(m_archive, index))
+  {
+    std::cerr << "Error: Index " << index << " does not point to a file!" << std::endl;
+    return false;
+  }
+  /* Data that already went to the sink cannot be taken back, so the new
+     format is only tried when the old format failed before any data. */
+  uint64_t delivered = 0;
+  bool aborted = false;
+  const auto counter = [&sink, &delivered, &aborted](const void* data, const std::size_t size)
+  {
+    if (size == 0)
+      return true;
+    delivered += size;
+    aborted = !sink(data, size);
+    return !aborted;
+  };
+  // try old format first, just like extractTo() does
+  if (saveToSink(index, true, counter))
+    return true;
+  if ((delivered == 0) && !aborted && saveToSink(index, false, counter))
+    return true;
+  std::cerr << "archive::installshield::extractToSink: error: Could not extract file "
+            << index << " from archive!" << std::endl;
+  return false;
+}
+
+bool archive::extractToBuffer(int64_t index, std::vector<uint8_t>& buffer) const
+{
+  buffer.clear();
+  if (unshield_file_is_valid(m_archive, index))
+    buffer.reserve(unshield_file_size(m_archive, index));
+  if (extractToSink(index, libstriezel::archive::vectorSink(buffer)))
+    return true;
+  buffer.clear();
+  return false;
+}
+
+bool archive::extractToBuffer(int64_t index, void* buffer, const std::size_t capacity,
+                              std::size_t& size) const
+{
+  size = 0;
+  return extractToSink(index, libstriezel::archive::memorySink(buffer, capacity, size));
+}
+
+std::map<std::string, bool> archive::extractMany(const std::map<std::string, std::string>& files) const
+{
+  std::map<std::string, bool> result;
+  // look up all requested files in the name index
+  std::vector<std::pair<int64_t, const std::pair<const std::string, std::string>*> > order;
+  order.reserve(files.size());
+  for (const auto& item : files)
+  {
+    const int64_t fileIdx = findFile(item.first);
+    if (fileIdx < 0)
+    {
+      std::cerr << "archive::installshield::extractMany: error: file "
+                << item.first << " does not exist in archive!" << std::endl;
+      result[item.first] = false;
+      continue;
+    }
+    order.push_back(std::make_pair(fileIdx, &item));
+    result[item.first] = false;
+  } // for
+  // extract in the order of the archive
+  std::sort(order.begin(), order.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  for (const auto& item : order)
+  {
+    /* Check whether destination file already exists, we do not want to overwrite
+       existing files. */
+    if (libstriezel::filesystem::file::exists(item.second->second))
+    {
+      std::cerr << "archive::installshield::extractMany: error: destination file "
+                << item.second->second << " already exists!" << std::endl;
+      continue;
+    }
+    result[item.second->first] = extractTo(item.second->second, item.first);
+  } // for
+  return result;
+}
+
+bool archive::extractAllToSinks(const std::function<libstriezel::archive::Sink(const libstriezel::archive::entry&)>& sinkFor) const
+{
   const auto groupCount = unshield_file_group_count(m_archive);
   for(auto groupIdx = 0; groupIdx < groupCount; ++groupIdx)
   {
@@ -111,54 +279,97 @@ bool archive::extractTo(const std::string& destFileName, const std::string& arch
     {
       if (unshield_file_is_valid(m_archive, fileIdx))
       {
+        libstriezel::archive::entry e;
         const std::string directoryName(group->name);
         if (!directoryName.empty())
-        {
-          if (directoryName + "/" + unshield_file_name(m_archive, fileIdx) == archiveFilePath)
-          {
-            foundFileIdx = fileIdx;
-            break;
-          }
-        }
+          e.setName(directoryName + "/" + unshield_file_name(m_archive, fileIdx));
         else
-        {
-          if (unshield_file_name(m_archive, fileIdx) == archiveFilePath)
-          {
-            foundFileIdx = fileIdx;
-            break;
-          }
-        } //else
+          e.setName(unshield_file_name(m_archive, fileIdx));
+        e.setSize(unshield_file_size(m_archive, fileIdx));
+        e.setDirectory(false);
+        if (!extractToSink(fileIdx, sinkFor(e)))
+          return false;
       } //if valid file
-    } //for fileIdx
-    if (foundFileIdx >= 0)
+    } // for fileIdx
+  } // for groupIdx
+  return true;
+}
+
+bool archive::saveToSink(const int index, const bool oldFormat, const libstriezel::archive::Sink& sink) const
+{
+  const auto save = [this, index, oldFormat](const std::string& fileName)
+  {
+    if (!oldFormat)
+      return unshield_file_save(m_archive, index, fileName.c_str());
+    unshield_set_log_level(UNSHIELD_LOG_LEVEL_LOWEST);
+    const bool success = unshield_file_save_old(m_archive, index, fileName.c_str());
+    unshield_set_log_level(UNSHIELD_LOG_LEVEL_ERROR);
+    return success;
+  };
+
+  const unsigned int bufferSize = 64 * 1024;
+  char buffer[bufferSize];
+  #if defined(LIBSTRIEZEL_INSTALLSHIELD_READ_VIA_PIPE)
+  /* libunshield opens the file by name, so it gets the write end of a pipe
+     via /dev/fd/ and runs in its own thread while this thread reads the data
+     and passes it on to the sink. */
+  int pipeFds[2];
+  if (pipe(pipeFds) != 0)
+    return false;
+  bool saved = false;
+  std::thread writer([&save, &saved, &pipeFds]()
+  {
+    saved = save("/dev/fd/" + std::to_string(pipeFds[1]));
+    // closing the write end signals end of data to the reader
+    close(pipeFds[1]);
+  });
+  bool readFailed = false;
+  bool aborted = false;
+  while (true)
+  {
+    const ssize_t bytesRead = read(pipeFds[0], buffer, bufferSize);
+    /* Data is still read and discarded after the sink aborted or a read
+       failed, because the writer would block forever on a full pipe
+       otherwise. Closing the read end early would kill the process with
+       SIGPIPE instead. */
+    if (bytesRead > 0)
+      aborted = aborted || readFailed || !sink(buffer, static_cast<std::size_t>(bytesRead));
+    else if (bytesRead == 0)
       break;
-  } //for groupIdx
-  // Have we found anything?
-  if (foundFileIdx == -1)
+    else if (errno != EINTR)
+      readFailed = true;
+  } // while
+  writer.join();
+  close(pipeFds[0]);
+  return saved && !readFailed && !aborted;
+  #else
+  std::string tempFileName;
+  if (!libstriezel::filesystem::file::createTemp(tempFileName))
+    return false;
+  if (!save(tempFileName))
   {
-    std::cerr << "archive::installshield::extractTo: error: file "
-              << archiveFilePath << " does not exist in archive!" << std::endl;
+    libstriezel::filesystem::file::remove(tempFileName);
     return false;
   }
-  return extractTo(destFileName, foundFileIdx);
+  std::ifstream stream(tempFileName, std::ios_base::in | std::ios_base::binary);
+  bool aborted = false;
+  while (stream.good() && !aborted)
+  {
+    stream.read(buffer, bufferSize);
+    aborted = !sink(buffer, static_cast<std::size_t>(stream.gcount()));
+  }
+  const bool success = stream.eof() && !aborted;
+  stream.close();
+  libstriezel::filesystem::file::remove(tempFileName);
+  return success;
+  #endif
 }
 
-
 bool archive::isInstallShield(const std::string& fileName)
 {
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
-    return false;
-
-  char start[4] = {'\0', '\0', '\0', '\0'};
-  stream.read(start, 4);
-  if (!stream.good() || stream.gcount() != 4)
-    return false;
-  stream.close();
-
-  /* magic literal for InstallShield Cab is "ISc(".*/
-  return (std::string(start, 4) == "ISc(");
+  char head[4];
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head, sizeof(head));
+  return libstriezel::archive::signatures::isInstallShield(head, size);
 }
 
 } // namespace
@@ -21,10 +21,17 @@
 #ifndef LIBSTRIEZEL_INSTALLSHIELD_ARCHIVE_HPP
 #define LIBSTRIEZEL_INSTALLSHIELD_ARCHIVE_HPP
 
+#include <functional>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 #include <libunshield.h>
 #include "../entry.hpp"
+#include "../entryIndex.hpp"
+#include "../entryTable.hpp"
+#include "../entryView.hpp"
+#include "../sink.hpp"
 
 namespace libstriezel::installshield
 {
@@ -69,6 +76,38 @@ class archive
     std::vector<libstriezel::archive::entry> entries() const;
 
 
+    /** \brief Passes all files of the InstallShield archive to a visitor, one
+     * at a time.
+     *
+     * \param visitor  callback that gets a view of each file
+     * \return Returns true, if all files were visited.
+     *         Returns false, if the visitor stopped.
+     * \remarks The index in the view is the file index that extractTo()
+     *          expects. The name is only valid during the call of the visitor.
+     */
+    bool forEachEntry(const libstriezel::archive::EntryVisitor& visitor) const;
+
+
+    /** \brief Gets the index of the file names.
+     *
+     * \return Returns the index. The ids in the index are the positions of
+     *         the files in the vector that entries() returns.
+     * \remarks The index is built during the first call of this function or
+     *          of a function that looks up files by name.
+     */
+    const libstriezel::archive::entryIndex& index() const;
+
+
+    /** \brief Fills a compact table with all files of the InstallShield archive.
+     *
+     * \param table  the table, its previous content is removed
+     * \return Returns true, if all files were added.
+     * \remarks The rows of the table are the positions of the files in the
+     *          vector that entries() returns, not the file indices.
+     */
+    bool fillEntryTable(libstriezel::archive::entryTable& table) const;
+
+
     /** \brief Extracts the file at a given index to the specified destination.
      *
      * \param destFileName  the destination file name - file must not exist yet
@@ -89,6 +128,71 @@ class archive
     bool extractTo(const std::string& destFileName, const std::string& archiveFilePath);
 
 
+    /** \brief Extracts the file at a given index and passes its data to a sink.
+     *
+     * \param index  index of the entry that shall be extracted
+     * \param sink   callback that receives the data chunk by chunk
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed or the sink aborted it.
+     * \remarks libunshield can only write to named files. Therefore the data
+     *          takes the route through a pipe on POSIX systems. Only on
+     *          other systems a temporary file is used.
+     */
+    bool extractToSink(int64_t index, const libstriezel::archive::Sink& sink) const;
+
+
+    /** \brief Extracts the file at a given index into a memory buffer.
+     *
+     * \param index   index of the entry that shall be extracted
+     * \param buffer  vector that will hold the data of the file
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     */
+    bool extractToBuffer(int64_t index, std::vector<uint8_t>& buffer) const;
+
+
+    /** \brief Extracts the file at a given index into a preallocated buffer.
+     *
+     * \param index     index of the entry that shall be extracted
+     * \param buffer    pointer to the start of the buffer
+     * \param capacity  size of the buffer in bytes
+     * \param size      variable that will hold the size of the data
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed or if the data does not
+     *         fit into the buffer.
+     */
+    bool extractToBuffer(int64_t index, void* buffer, const std::size_t capacity,
+                         std::size_t& size) const;
+
+
+    /** \brief Extracts several files to the specified destinations.
+     *
+     * \param files  maps the path of each file within the archive to the
+     *               destination file name - destination files must not exist yet
+     * \return Returns a map that contains an element for every requested file.
+     *         Its value is true, if the file could be extracted successfully,
+     *         or false, if the extraction failed.
+     * \remarks The file names are looked up in the index of the file names,
+     *          and files are extracted in the order of the archive.
+     */
+    std::map<std::string, bool> extractMany(const std::map<std::string, std::string>& files) const;
+
+
+    /** \brief Extracts all files within the InstallShield archive in a
+     * single pass and passes their data to sinks, without extracting them to
+     * disk.
+     *
+     * \param sinkFor  callback that gets the entry of each file and returns
+     *                 the sink for the data of that file
+     * \return Returns true, if all files could be extracted successfully.
+     *         Returns false, if an error occurred or a sink aborted.
+     * \remarks libunshield can only write to named files. Therefore the data
+     *          takes the route through a pipe on POSIX systems. Only on
+     *          other systems a temporary file is used.
+     */
+    bool extractAllToSinks(const std::function<libstriezel::archive::Sink(const libstriezel::archive::entry&)>& sinkFor) const;
+
+
     /** \brief Checks whether a file may be an InstallShield archive.
      *
      * \param fileName  file name of the potential InstallShield archive
@@ -97,6 +201,17 @@ class archive
      */
     static bool isInstallShield(const std::string& fileName);
   private:
+    /** \brief Passes the data of a single file to a sink.
+     *
+     * \param index      index of the file
+     * \param oldFormat  whether to use the old save function of libunshield
+     * \param sink       callback that receives the data chunk by chunk
+     * \return Returns true, if the data could be read completely.
+     *         Returns false, if an error occurred or the sink aborted.
+     */
+    bool saveToSink(const int index, const bool oldFormat, const libstriezel::archive::Sink& sink) const;
+
+
     /** \brief Gets the error message for the archive.
      *
      * \return Returns a string containing the error message.
@@ -105,7 +220,19 @@ class archive
     std::string getError() const;
 
 
+    /** \brief Gets the file index of the file with the given name.
+     *
+     * \param archiveFilePath  path of the file in the archive
+     * \return Returns the file index that extractTo() expects.
+     *         Returns -1, if there is no such file.
+     */
+    int64_t findFile(const std::string& archiveFilePath) const;
+
+
     Unshield * m_archive; /**< archive handle */
+    mutable libstriezel::archive::entryIndex m_index; /**< index of the file names */
+    mutable std::vector<int> m_fileIndices; /**< file indices of libunshield, same order as the ids in m_index */
+    mutable bool m_indexed; /**< whether m_index has been built */
 };
 
 } // namespace
@@ -19,16 +19,30 @@
 */
 
 #include "archive.hpp"
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#if defined(_WIN32)
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+#include "../../filesystem/file.hpp"
+#include "../copyRange.hpp"
+#include "../signatures.hpp"
+#include "../writeBehind.hpp"
 
 namespace libstriezel::archive::iso9660
 {
 
-archive::archive(const std::string& fileName)
-: archiveLibarchive(fileName)
+archive::archive(const std::string& fileName, const bool lazy)
+: archiveLibarchive(fileName),
+  m_image(nullptr),
+  m_imageRead(false)
 {
   applyFormats();
   int ret = archive_read_open_filename(m_archive, fileName.c_str(), 4096);
@@ -38,8 +52,45 @@ archive::archive(const std::string& fileName)
     m_archive = nullptr;
     throw std::runtime_error("libstriezel::archive::iso9660::archive: Failed to open file " + fileName + "!");
   }
-  // fill entries
-  fillEntries();
+  // fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(const void* data, const std::size_t size, const bool lazy)
+: archiveLibarchive(data, size),
+  m_image(nullptr),
+  m_imageRead(false)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::archive::iso9660::archive: Failed to open archive from memory!");
+  }
+  // fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(libstriezel::archive::seekableStream& stream, const bool lazy)
+: archiveLibarchive(stream),
+  m_image(nullptr),
+  m_imageRead(false)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::archive::iso9660::archive: Failed to open archive from stream!");
+  }
+  // fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
 }
 
 archive::~archive()
@@ -61,41 +112,175 @@ void archive::applyFormats()
   }
 }
 
+void archive::fillEntries()
+{
+  const image * native = nativeImage();
+  if (nullptr == native)
+  {
+    archiveLibarchive::fillEntries();
+    return;
+  }
+  const std::size_t count = static_cast<std::size_t>(native->numEntries());
+  m_entries.clear();
+  m_headerOffsets.clear();
+  m_entryIndex.clear();
+  m_entries.reserve(count);
+  m_headerOffsets.reserve(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const libstriezel::archive::entryView view{ static_cast<int64_t>(i), native->name(i), native->size(i),
+                                                native->modificationTime(i), native->isDirectory(i),
+                                                native->isSymLink(i) };
+    m_entries.emplace_back(view);
+    // Images cannot be read from the header of an entry, so there is no offset.
+    m_headerOffsets.push_back(-1);
+    // first entry wins a lookup, just like a scan from the start would do
+    m_entryIndex.add(m_entries.back().name());
+  }
+  m_entriesListed = true;
+}
+
 bool archive::isISO9660(const std::string& fileName)
 {
-  /* ISO9660 files don't use the first 32768 bytes (16 * 2048 bytes).
-     The "Volume Descriptor Set" starts at offset 0x8000 (32768), and the first
-     byte designates the type. After that, the sequence "CD001" (or in hexa-
-     decimal code "43 44 30 30 31") is encountered. We check for the existence
-     of this sequence.
-  */
-
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
+  // The signature is at offset 0x8001, so the check needs more than 32 KiB.
+  std::vector<char> head(libstriezel::archive::signatures::headSize);
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head.data(), head.size());
+  return libstriezel::archive::signatures::isISO9660(head.data(), size);
+}
+
+bool archive::extractTo(const std::string& destFileName, const std::string& archiveFilePath)
+{
+  const image * native = nativeImage();
+  const int64_t idx = (native != nullptr) ? native->locate(archiveFilePath) : -1;
+  if ((idx < 0) || !native->isPlainFile(static_cast<std::size_t>(idx)))
+    return archiveLibarchive::extractTo(destFileName, archiveFilePath);
+
+  if (filesystem::file::exists(destFileName))
+  {
+    std::cerr << "archive::iso9660::archive::extractTo: error: destination file "
+              << destFileName << " already exists!" << std::endl;
+    return false;
+  }
+  const std::size_t i = static_cast<std::size_t>(idx);
+  if (!m_fileName.empty())
+    return copyExtents(destFileName, native->extents(i));
+
+  // The image is in memory, so the data only needs to be written.
+  writeBehind destination;
+  if (!destination.open(destFileName, native->size(i)))
+  {
+    std::cerr << "archive::iso9660::archive::extractTo: error: destination file "
+              << destFileName << " could not be created/opened for writing!"
+              << std::endl;
+    return false;
+  }
+  int64_t done = 0;
+  bool success = true;
+  while (success && (done < native->size(i)))
+  {
+    const int64_t bytesRead = native->read(i, done, destination.data(), destination.space());
+    success = (bytesRead > 0) && destination.produced(static_cast<std::size_t>(bytesRead));
+    done += bytesRead;
+  }
+  success = destination.finish() && success;
+  if (!success)
+  {
+    std::cerr << "archive::iso9660::archive::extractTo: error: Could not write data to file "
+              << destFileName << "." << std::endl;
+    filesystem::file::remove(destFileName);
+  }
+  return success;
+}
+
+int64_t archive::readAt(const std::string& archiveFilePath, const int64_t offset, void* buffer,
+                        const std::size_t length)
+{
+  if (offset < 0)
+    return -1;
+  const image * native = nativeImage();
+  const int64_t idx = (native != nullptr) ? native->locate(archiveFilePath) : -1;
+  if ((idx >= 0) && native->isPlainFile(static_cast<std::size_t>(idx)))
+    return native->read(static_cast<std::size_t>(idx), offset, buffer, length);
+
+  // Without native reader the file has to be read from its start.
+  int64_t position = 0;
+  std::size_t done = 0;
+  char * out = static_cast<char*>(buffer);
+  const bool success = extractToSink(archiveFilePath,
+      [&position, &done, out, offset, length](const void* data, const std::size_t size)
+      {
+        const int64_t end = position + static_cast<int64_t>(size);
+        if ((end > offset) && (done < length))
+        {
+          const std::size_t skip = (position < offset) ? static_cast<std::size_t>(offset - position) : 0;
+          const std::size_t chunk = std::min(size - skip, length - done);
+          std::memcpy(out + done, static_cast<const char*>(data) + skip, chunk);
+          done += chunk;
+        }
+        position = end;
+        return true;
+      });
+  if (!success)
+    return -1;
+  return static_cast<int64_t>(done);
+}
+
+bool archive::fileExtents(const std::string& archiveFilePath, std::vector<extent>& extents)
+{
+  extents.clear();
+  const image * native = nativeImage();
+  const int64_t idx = (native != nullptr) ? native->locate(archiveFilePath) : -1;
+  if ((idx < 0) || !native->isPlainFile(static_cast<std::size_t>(idx)))
     return false;
-  std::string sequence = "";
-  try
+  extents = native->extents(static_cast<std::size_t>(idx));
+  return true;
+}
+
+const image * archive::nativeImage()
+{
+  if (!m_imageRead)
   {
-    stream.seekg(0x8001);
-    char buffer[6];
-    std::memset(buffer, '\0', 6);
-    stream.read(buffer, 5);
-    if (!stream.good() || (stream.gcount() != 5))
+    m_imageRead = true;
+    try
+    {
+      if (!m_fileName.empty())
+        m_image = std::make_unique<image>(m_fileName);
+      else if (nullptr != m_data)
+        m_image = std::make_unique<image>(m_data, m_dataSize);
+    }
+    catch (const std::exception&)
     {
-      stream.close();
-      return false;
+      // libarchive may still be able to read the image.
+      m_image = nullptr;
     }
-    sequence = std::string(buffer, 5);
   }
-  catch (...)
+  return m_image.get();
+}
+
+bool archive::copyExtents(const std::string& destFileName, const std::vector<extent>& extents) const
+{
+  #if defined(_WIN32)
+  const int source = _open(m_fileName.c_str(), _O_RDONLY | _O_BINARY);
+  #else
+  const int source = open(m_fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  #endif
+  if (source < 0)
   {
-    stream.close();
+    std::cerr << "archive::iso9660::archive::extractTo: error: Could not open image file "
+              << m_fileName << "!" << std::endl;
     return false;
   }
-  stream.close();
-
-  return (std::string("CD001") == sequence);
+  std::vector<byteRange> ranges;
+  ranges.reserve(extents.size());
+  for (const auto& e : extents)
+    ranges.push_back({ e.offset, e.size });
+  const bool success = copyToNewFile(source, ranges, destFileName);
+  #if defined(_WIN32)
+  _close(source);
+  #else
+  close(source);
+  #endif
+  return success;
 }
 
 } // namespace
@@ -21,9 +21,11 @@
 #ifndef LIBSTRIEZEL_ARCHIVE_ISO9660_ARCHIVE_HPP
 #define LIBSTRIEZEL_ARCHIVE_ISO9660_ARCHIVE_HPP
 
+#include <memory>
 #include <string>
 #include <vector>
 #include "../archiveLibarchive.hpp"
+#include "image.hpp"
 
 namespace libstriezel::archive::iso9660
 {
@@ -36,10 +38,37 @@ class archive: public libstriezel::archive::archiveLibarchive
      /** \brief constructor - opens an ISO9660 image in read-only mode
       *
       * \param fileName  -  file name of the ISO9660 image
+      * \param lazy      -  if true, the entries are listed when they are needed
+      *                     for the first time, not during construction
       * \remarks This function throws an exception, if the file does not
       *          exist or a similar error occurs.
       */
-    archive(const std::string& fileName);
+    archive(const std::string& fileName, const bool lazy = false);
+
+
+     /** \brief constructor - opens an ISO9660 image in memory in read-only mode
+      *
+      * \param data  pointer to the start of the archive data - the data must
+      *              stay valid as long as the archive object exists
+      * \param size  size of the archive data in bytes
+      * \param lazy  if true, the entries are listed when they are needed
+      *              for the first time, not during construction
+      * \remarks This function throws an exception, if the data cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(const void* data, const std::size_t size, const bool lazy = false);
+
+
+     /** \brief constructor - opens an ISO9660 image from a stream in read-only mode
+      *
+      * \param stream  the stream that contains the archive - the stream must
+      *                stay valid as long as the archive object exists
+      * \param lazy    if true, the entries are listed when they are needed
+      *                for the first time, not during construction
+      * \remarks This function throws an exception, if the stream cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(libstriezel::archive::seekableStream& stream, const bool lazy = false);
 
 
     /** \brief destructor
@@ -61,10 +90,81 @@ class archive: public libstriezel::archive::archiveLibarchive
      *         Returns false, if not.
      */
     static bool isISO9660(const std::string& fileName);
+
+
+    /** \brief Extracts the file with the given name to the specified destination.
+     *
+     * \param destFileName     the destination file name - file must not exist yet
+     * \param archiveFilePath  path of the file that shall be extracted
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     * \remarks Regular files of images in files or in memory are copied
+     *          straight from their extents, without listing the entries or
+     *          reading anything else. In files the kernel copies the data,
+     *          see copyRange(). Other entries are extracted by libarchive.
+     */
+    bool extractTo(const std::string& destFileName, const std::string& archiveFilePath) override;
+
+
+    /** \brief Reads a part of a file in the image.
+     *
+     * \param archiveFilePath  path of the file within the image
+     * \param offset           offset of the first byte within the file
+     * \param buffer           the buffer that gets the data
+     * \param length           number of bytes to read
+     * \return Returns the number of bytes that were read, which is less than
+     *         length at the end of the file. Returns -1, if an error occurred.
+     * \remarks For images in files or in memory only the requested bytes are
+     *          read. Images from streams have to be read up to the requested
+     *          part.
+     */
+    int64_t readAt(const std::string& archiveFilePath, const int64_t offset, void* buffer,
+                   const std::size_t length);
+
+
+    /** \brief Gets the location of the data of a file in the image.
+     *
+     * \param archiveFilePath  path of the file within the image
+     * \param extents          receives the parts of the image that hold the
+     *                         data of the file, in the order of the data
+     * \return Returns true, if the file is a regular file with uncompressed
+     *         data in the image. Returns false otherwise, e.g. for images
+     *         from streams or for files compressed with zisofs.
+     */
+    bool fileExtents(const std::string& archiveFilePath, std::vector<extent>& extents);
+  protected:
+    /** \brief Fills the list of archive entries.
+     *
+     * \remarks Only the directory records are read, if the native reader can
+     *          read the image.
+     */
+    void fillEntries() override;
   private:
     /** \brief Apply format support for ISO9660 images.
      */
     void applyFormats();
+
+
+    /** \brief Gets the native reader of the image, creates it on first use.
+     *
+     * \return Returns the native reader. Returns nullptr for images from
+     *         streams or images that the native reader cannot handle.
+     */
+    const image * nativeImage();
+
+
+    /** \brief Copies the extents of a file from the image file into a new file.
+     *
+     * \param destFileName  the destination file name - file must not exist yet
+     * \param extents       the extents of the file
+     * \return Returns true, if the data was copied successfully.
+     *         Returns false, if an error occurred.
+     */
+    bool copyExtents(const std::string& destFileName, const std::vector<extent>& extents) const;
+
+
+    std::unique_ptr<image> m_image; /**< native reader, or nullptr */
+    bool m_imageRead; /**< whether the native reader has been tried */
 };
 
 } // namespace
@@ -0,0 +1,604 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "image.hpp"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace libstriezel::archive::iso9660
+{
+
+namespace
+{
+
+/// size of a sector, volume descriptors always use it
+const std::size_t sectorSize = 2048;
+/// offset of the first volume descriptor
+const std::size_t descriptorStart = 16 * sectorSize;
+/// maximum number of volume descriptors that are examined
+const std::size_t maximumDescriptors = 64;
+/// size of a directory record without name and system use area
+const std::size_t recordSize = 33;
+/// maximum number of continuation areas of one system use area
+const unsigned int maximumContinuations = 16;
+
+/// kinds of entries
+enum entryType: uint8_t
+{
+  typeDirectory = 0,
+  typePlain = 1, // regular file with all data in the image
+  typeOther = 2, // zisofs file, truncated file, ...
+  typeSymLink = 3
+};
+
+/// flags of directory records
+const uint8_t flagDirectory = 0x02;
+const uint8_t flagAssociated = 0x04;
+const uint8_t flagMultiExtent = 0x80;
+
+uint16_t le16(const unsigned char* p)
+{
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t le32(const unsigned char* p)
+{
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+       | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/* Converts a date of the Gregorian calendar and a time in UTC to seconds
+   since the epoch, without the time zone of the system that mktime() uses. */
+std::time_t toTime(const int year, const int month, const int day, const int hour,
+                   const int minute, const int second)
+{
+  // days since 1970-01-01, see http://howardhinnant.github.io/date_algorithms.html
+  const int y = (month <= 2) ? year - 1 : year;
+  const int era = ((y >= 0) ? y : y - 399) / 400;
+  const int yearOfEra = y - era * 400;
+  const int dayOfYear = (153 * ((month + 9) % 12) + 2) / 5 + day - 1;
+  const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  const int64_t days = static_cast<int64_t>(era) * 146097 + dayOfEra - 719468;
+  return static_cast<std::time_t>(days * 86400 + hour * 3600 + minute * 60 + second);
+}
+
+/* Applies the offset from GMT of ISO 9660 dates, which is given in intervals
+   of 15 minutes. Invalid offsets are ignored, just like libarchive does. */
+std::time_t fromLocal(const std::time_t local, const unsigned char offsetByte)
+{
+  const int offset = static_cast<signed char>(offsetByte);
+  if ((offset > -48) && (offset < 52))
+    return local - offset * 15 * 60;
+  return local;
+}
+
+/* Converts the seven byte date of directory records and Rock Ridge TF entries. */
+std::time_t shortDate(const unsigned char* v)
+{
+  return fromLocal(toTime(1900 + v[0], v[1], v[2], v[3], v[4], v[5]), v[6]);
+}
+
+/* Converts the 17 byte date of the long form of Rock Ridge TF entries. */
+std::time_t longDate(const unsigned char* v)
+{
+  const auto digits = [v](const std::size_t pos, const std::size_t count)
+  {
+    int value = 0;
+    for (std::size_t i = pos; i < pos + count; ++i)
+      value = value * 10 + (v[i] - '0');
+    return value;
+  };
+  return fromLocal(toTime(digits(0, 4), digits(4, 2), digits(6, 2), digits(8, 2),
+                          digits(10, 2), digits(12, 2)), v[16]);
+}
+
+/* Throws the exception for invalid images. */
+[[noreturn]] void invalid(const std::string& reason)
+{
+  throw std::runtime_error("libstriezel::archive::iso9660::image: " + reason);
+}
+
+/* Converts a Joliet name (UCS-2 / UTF-16, big endian) to UTF-8. */
+std::string jolietToUtf8(const unsigned char* name, const std::size_t length)
+{
+  std::string result;
+  for (std::size_t i = 0; i + 1 < length; i += 2)
+  {
+    uint32_t code = (static_cast<uint32_t>(name[i]) << 8) | name[i + 1];
+    if ((code >= 0xD800) && (code < 0xDC00) && (i + 3 < length))
+    {
+      const uint32_t low = (static_cast<uint32_t>(name[i + 2]) << 8) | name[i + 3];
+      if ((low >= 0xDC00) && (low < 0xE000))
+      {
+        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        i += 2;
+      }
+    }
+    if (code < 0x80)
+      result.push_back(static_cast<char>(code));
+    else if (code < 0x800)
+    {
+      result.push_back(static_cast<char>(0xC0 | (code >> 6)));
+      result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    else if (code < 0x10000)
+    {
+      result.push_back(static_cast<char>(0xE0 | (code >> 12)));
+      result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    else
+    {
+      result.push_back(static_cast<char>(0xF0 | (code >> 18)));
+      result.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+      result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+  }
+  return result;
+}
+
+/// Rock Ridge information of a directory record
+struct rockRidge
+{
+  std::string name; /**< alternate name from NM entries */
+  bool hasName = false; /**< whether there was an NM entry */
+  uint32_t mode = 0; /**< POSIX file mode from the PX entry */
+  bool hasMode = false; /**< whether there was a PX entry */
+  bool symLink = false; /**< whether there was an SL entry */
+  std::time_t m_time = 0; /**< modification time from the TF entry */
+  bool hasTime = false; /**< whether the TF entry has a modification time */
+  bool zisofs = false; /**< whether there was a ZF entry */
+  int64_t zisofsSize = -1; /**< uncompressed size from the ZF entry, or -1 */
+  bool relocated = false; /**< whether there was an RE entry */
+  int64_t childLink = -1; /**< location from the CL entry, or -1 */
+};
+
+} // anonymous namespace
+
+image::image(const std::string& fileName)
+: m_data(nullptr),
+  m_size(0),
+  m_file(nullptr),
+  m_blockSize(sectorSize),
+  m_suspSkip(-1),
+  m_names(std::vector<std::string>()),
+  m_sizes(std::vector<int64_t>()),
+  m_types(std::vector<uint8_t>()),
+  m_times(std::vector<std::time_t>()),
+  m_extents(std::vector<std::vector<extent> >()),
+  m_lookup(std::unordered_map<std::string_view, std::size_t>())
+{
+  m_file = std::make_unique<libstriezel::archive::fileMapping>(fileName);
+  m_data = m_file->data();
+  m_size = m_file->size();
+  parse();
+}
+
+image::image(const void* data, const std::size_t size)
+: m_data(static_cast<const unsigned char*>(data)),
+  m_size(size),
+  m_file(nullptr),
+  m_blockSize(sectorSize),
+  m_suspSkip(-1),
+  m_names(std::vector<std::string>()),
+  m_sizes(std::vector<int64_t>()),
+  m_types(std::vector<uint8_t>()),
+  m_times(std::vector<std::time_t>()),
+  m_extents(std::vector<std::vector<extent> >()),
+  m_lookup(std::unordered_map<std::string_view, std::size_t>())
+{
+  if (nullptr == data)
+    invalid("Image data must not be null!");
+  parse();
+}
+
+void image::parse()
+{
+  if (m_size < descriptorStart + sectorSize)
+    invalid("Data is too small for an ISO 9660 image.");
+
+  const unsigned char * primary = nullptr;
+  const unsigned char * joliet = nullptr;
+  for (std::size_t i = 0; i < maximumDescriptors; ++i)
+  {
+    const std::size_t pos = descriptorStart + i * sectorSize;
+    if (pos + sectorSize > m_size)
+      break;
+    const unsigned char * vd = m_data + pos;
+    if (std::memcmp(vd + 1, "CD001", 5) != 0)
+      break;
+    // volume descriptor set terminator
+    if (vd[0] == 255)
+      break;
+    if ((vd[0] == 1) && (primary == nullptr))
+      primary = vd;
+    // Joliet uses a supplementary volume descriptor with UCS-2 escape sequences.
+    else if ((vd[0] == 2) && (joliet == nullptr) && (vd[88] == 0x25) && (vd[89] == 0x2F)
+             && ((vd[90] == 0x40) || (vd[90] == 0x43) || (vd[90] == 0x45)))
+      joliet = vd;
+  }
+  if (primary == nullptr)
+    invalid("Image has no primary volume descriptor.");
+  m_blockSize = le16(primary + 128);
+  if ((m_blockSize != 512) && (m_blockSize != 1024) && (m_blockSize != 2048))
+    invalid("Image has an unsupported logical block size.");
+
+  // The first record of the root directory starts the system use sharing
+  // protocol, if the image has Rock Ridge extensions.
+  const unsigned char * root = primary + 156;
+  const uint64_t rootStart = static_cast<uint64_t>(le32(root + 2)) * m_blockSize;
+  if (rootStart + recordSize + 1 + 7 <= m_size)
+  {
+    const unsigned char * self = m_data + rootStart;
+    const std::size_t length = self[0];
+    if ((length >= recordSize + 1 + 7) && (self[32] == 1)
+        && (self[34] == 'S') && (self[35] == 'P') && (self[36] == 7)
+        && (self[38] == 0xBE) && (self[39] == 0xEF))
+      m_suspSkip = self[40];
+  }
+  // Like libarchive, prefer Rock Ridge names over Joliet names.
+  const bool useJoliet = (m_suspSkip < 0) && (joliet != nullptr);
+  if (useJoliet)
+    root = joliet + 156;
+
+  // libarchive lists the root directory as ".", before all other entries.
+  std::vector<uint64_t> locations;
+  m_names.push_back(".");
+  m_sizes.push_back(le32(root + 10));
+  m_types.push_back(typeDirectory);
+  m_times.push_back(shortDate(root + 18));
+  m_extents.push_back(std::vector<extent>());
+  locations.push_back(static_cast<uint64_t>(le32(root + 2)) * m_blockSize);
+
+  std::vector<pendingDirectory> pending;
+  pending.push_back(pendingDirectory{ std::string(), le32(root + 2), le32(root + 10) });
+  std::unordered_set<uint32_t> visited;
+  while (!pending.empty())
+  {
+    const pendingDirectory directory = pending.back();
+    pending.pop_back();
+    // Damaged images may contain loops.
+    if (!visited.insert(directory.location).second)
+      continue;
+    readDirectory(directory, useJoliet, pending, locations);
+  }
+
+  // libarchive reads the image from start to end, so it lists the entries
+  // in the order of their location.
+  std::vector<std::size_t> order(m_names.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&locations](const std::size_t a, const std::size_t b)
+  {
+    return locations[a] < locations[b];
+  });
+  std::vector<std::string> names;
+  std::vector<int64_t> sizes;
+  std::vector<uint8_t> types;
+  std::vector<std::time_t> times;
+  std::vector<std::vector<extent> > extents;
+  names.reserve(order.size());
+  sizes.reserve(order.size());
+  types.reserve(order.size());
+  times.reserve(order.size());
+  extents.reserve(order.size());
+  for (const std::size_t i : order)
+  {
+    names.push_back(std::move(m_names[i]));
+    sizes.push_back(m_sizes[i]);
+    types.push_back(m_types[i]);
+    times.push_back(m_times[i]);
+    extents.push_back(std::move(m_extents[i]));
+  }
+  m_names.swap(names);
+  m_sizes.swap(sizes);
+  m_types.swap(types);
+  m_times.swap(times);
+  m_extents.swap(extents);
+
+  // The names do not move anymore, so the table can point into them.
+  m_lookup.reserve(m_names.size());
+  for (std::size_t i = 0; i < m_names.size(); ++i)
+    m_lookup.emplace(m_names[i], i);
+}
+
+void image::readDirectory(const pendingDirectory& directory, const bool joliet,
+                          std::vector<pendingDirectory>& pending, std::vector<uint64_t>& locations)
+{
+  const uint64_t start = static_cast<uint64_t>(directory.location) * m_blockSize;
+  if (start >= m_size)
+    return;
+  const uint64_t end = std::min<uint64_t>(start + directory.length, m_size);
+  std::vector<extent> carried;
+  std::string carriedName;
+  uint64_t carriedLocation = 0;
+  uint64_t pos = start;
+  while (pos < end)
+  {
+    const std::size_t length = m_data[pos];
+    // Records do not cross block boundaries, the rest of a block is zero.
+    if (length == 0)
+    {
+      pos = (pos / m_blockSize + 1) * m_blockSize;
+      continue;
+    }
+    if ((length < recordSize + 1) || (pos + length > end))
+      break;
+    const unsigned char * record = m_data + pos;
+    pos += length;
+    const std::size_t nameLength = record[32];
+    const uint8_t flags = record[25];
+    if (recordSize + nameLength > length)
+      continue;
+    // "." and ".."
+    if ((nameLength == 1) && (record[33] <= 1))
+      continue;
+    if ((flags & flagAssociated) != 0)
+      continue;
+
+    rockRidge rr;
+    if ((m_suspSkip >= 0) && !joliet)
+    {
+      std::size_t areaStart = recordSize + nameLength + ((nameLength % 2 == 0) ? 1 : 0) + m_suspSkip;
+      const unsigned char * area = record + areaStart;
+      std::size_t areaSize = (areaStart < length) ? length - areaStart : 0;
+      for (unsigned int continuation = 0; (area != nullptr) && (continuation <= maximumContinuations); ++continuation)
+      {
+        const unsigned char * next = nullptr;
+        std::size_t nextSize = 0;
+        std::size_t p = 0;
+        while (p + 4 <= areaSize)
+        {
+          const unsigned char * e = area + p;
+          const std::size_t entryLength = e[2];
+          if ((entryLength < 4) || (p + entryLength > areaSize))
+            break;
+          if ((e[0] == 'N') && (e[1] == 'M') && (entryLength >= 5))
+          {
+            // Flags for "." and ".." carry no name.
+            if ((e[4] & 0x06) == 0)
+            {
+              rr.name.append(reinterpret_cast<const char*>(e + 5), entryLength - 5);
+              rr.hasName = true;
+            }
+          }
+          else if ((e[0] == 'P') && (e[1] == 'X') && (entryLength >= 12))
+          {
+            rr.mode = le32(e + 4);
+            rr.hasMode = true;
+          }
+          else if ((e[0] == 'S') && (e[1] == 'L'))
+            rr.symLink = true;
+          else if ((e[0] == 'T') && (e[1] == 'F') && (entryLength >= 5))
+          {
+            const bool longForm = (e[4] & 0x80) != 0;
+            const std::size_t dateSize = longForm ? 17 : 7;
+            // The modification time follows the creation time, if there is one.
+            const std::size_t offset = 5 + (((e[4] & 0x01) != 0) ? dateSize : 0);
+            if (((e[4] & 0x02) != 0) && (offset + dateSize <= entryLength))
+            {
+              rr.m_time = longForm ? longDate(e + offset) : shortDate(e + offset);
+              rr.hasTime = true;
+            }
+          }
+          else if ((e[0] == 'Z') && (e[1] == 'F'))
+          {
+            rr.zisofs = true;
+            if (entryLength >= 16)
+              rr.zisofsSize = le32(e + 8);
+          }
+          else if ((e[0] == 'R') && (e[1] == 'E'))
+            rr.relocated = true;
+          else if ((e[0] == 'C') && (e[1] == 'L') && (entryLength >= 12))
+            rr.childLink = le32(e + 4);
+          else if ((e[0] == 'C') && (e[1] == 'E') && (entryLength >= 28))
+          {
+            const uint64_t ceStart = static_cast<uint64_t>(le32(e + 4)) * m_blockSize + le32(e + 12);
+            const uint64_t ceSize = le32(e + 20);
+            if (ceStart + ceSize <= m_size)
+            {
+              next = m_data + ceStart;
+              nextSize = static_cast<std::size_t>(ceSize);
+            }
+          }
+          else if ((e[0] == 'S') && (e[1] == 'T'))
+            break;
+          p += entryLength;
+        }
+        area = next;
+        areaSize = nextSize;
+      }
+    }
+    // Relocated directories are read where their child link points to them.
+    if (rr.relocated)
+      continue;
+
+    std::string name;
+    if (rr.hasName)
+      name = rr.name;
+    else if (joliet)
+    {
+      std::size_t len = nameLength;
+      const unsigned char * p = record + 33;
+      // Chop off trailing ';1' from files, just like libarchive.
+      if ((len > 4) && (p[len - 4] == 0) && (p[len - 3] == ';') && (p[len - 2] == 0) && (p[len - 1] == '1'))
+        len -= 4;
+      name = jolietToUtf8(p, len);
+    }
+    else
+    {
+      std::size_t len = nameLength;
+      const char * p = reinterpret_cast<const char*>(record + 33);
+      // Chop off trailing ';1' and a trailing '.', just like libarchive.
+      if ((len > 2) && (p[len - 2] == ';') && (p[len - 1] == '1'))
+        len -= 2;
+      if ((len > 1) && (p[len - 1] == '.'))
+        --len;
+      name.assign(p, len);
+    }
+    if (name.empty() || (name == ".") || (name == ".."))
+      continue;
+
+    const std::string path = directory.path.empty() ? name : directory.path + "/" + name;
+    const uint64_t location = static_cast<uint64_t>(le32(record + 2)) + record[1];
+    const uint32_t dataLength = le32(record + 10);
+    const std::time_t m_time = rr.hasTime ? rr.m_time : shortDate(record + 18);
+
+    if (((flags & flagDirectory) != 0) || (rr.childLink >= 0))
+    {
+      pendingDirectory child{ path, static_cast<uint32_t>(location), dataLength };
+      if (rr.childLink >= 0)
+      {
+        // The size of a relocated directory is in its "." record.
+        const uint64_t childStart = static_cast<uint64_t>(rr.childLink) * m_blockSize;
+        if (childStart + recordSize > m_size)
+          continue;
+        child.location = static_cast<uint32_t>(rr.childLink);
+        child.length = le32(m_data + childStart + 10);
+      }
+      m_names.push_back(path);
+      m_sizes.push_back(child.length);
+      m_types.push_back(typeDirectory);
+      m_times.push_back(m_time);
+      m_extents.push_back(std::vector<extent>());
+      locations.push_back(static_cast<uint64_t>(child.location) * m_blockSize);
+      pending.push_back(child);
+      continue;
+    }
+
+    // Files of 4 GiB or more are split into several records with the same
+    // name. All but the last one have the multi-extent flag.
+    if (carriedName != path)
+    {
+      carried.clear();
+      carriedName = path;
+      carriedLocation = location * m_blockSize;
+    }
+    // Empty files may have any location, so they get no extent at all.
+    if (dataLength > 0)
+      carried.push_back(extent{ static_cast<int64_t>(location * m_blockSize), static_cast<int64_t>(dataLength) });
+    if ((flags & flagMultiExtent) != 0)
+      continue;
+
+    int64_t total = 0;
+    bool inside = true;
+    for (const auto& e : carried)
+    {
+      total += e.size;
+      inside = inside && (static_cast<uint64_t>(e.offset) + static_cast<uint64_t>(e.size) <= m_size);
+    }
+    const bool regular = !rr.hasMode || ((rr.mode & 0170000) == 0100000);
+    const bool symLink = rr.symLink || (rr.hasMode && ((rr.mode & 0170000) == 0120000));
+    m_names.push_back(path);
+    // Like libarchive, symbolic links have no data and compressed files
+    // have the size of the uncompressed data.
+    if (symLink)
+      m_sizes.push_back(0);
+    else
+      m_sizes.push_back((rr.zisofsSize >= 0) ? rr.zisofsSize : total);
+    if (symLink)
+      m_types.push_back(typeSymLink);
+    else
+      m_types.push_back((regular && inside && !rr.zisofs) ? typePlain : typeOther);
+    m_times.push_back(m_time);
+    m_extents.push_back(carried);
+    locations.push_back(carriedLocation);
+    carried.clear();
+    carriedName.clear();
+  }
+}
+
+int64_t image::numEntries() const
+{
+  return static_cast<int64_t>(m_names.size());
+}
+
+const std::string& image::name(const std::size_t index) const
+{
+  return m_names[index];
+}
+
+int64_t image::size(const std::size_t index) const
+{
+  return m_sizes[index];
+}
+
+bool image::isDirectory(const std::size_t index) const
+{
+  return m_types[index] == typeDirectory;
+}
+
+bool image::isSymLink(const std::size_t index) const
+{
+  return m_types[index] == typeSymLink;
+}
+
+std::time_t image::modificationTime(const std::size_t index) const
+{
+  return m_times[index];
+}
+
+bool image::isPlainFile(const std::size_t index) const
+{
+  return m_types[index] == typePlain;
+}
+
+const std::vector<extent>& image::extents(const std::size_t index) const
+{
+  return m_extents[index];
+}
+
+int64_t image::locate(const std::string_view name) const
+{
+  const auto iter = m_lookup.find(name);
+  if (iter == m_lookup.end())
+    return -1;
+  return static_cast<int64_t>(iter->second);
+}
+
+int64_t image::read(const std::size_t index, const int64_t offset, void* buffer,
+                    const std::size_t length) const
+{
+  if ((m_types[index] != typePlain) || (offset < 0))
+    return -1;
+  int64_t skip = offset;
+  unsigned char * out = static_cast<unsigned char*>(buffer);
+  std::size_t done = 0;
+  for (const auto& e : m_extents[index])
+  {
+    if (done == length)
+      break;
+    if (skip >= e.size)
+    {
+      skip -= e.size;
+      continue;
+    }
+    const std::size_t chunk = static_cast<std::size_t>(std::min<int64_t>(e.size - skip, length - done));
+    std::memcpy(out + done, m_data + e.offset + skip, chunk);
+    done += chunk;
+    skip = 0;
+  }
+  return static_cast<int64_t>(done);
+}
+
+} // namespace
@@ -0,0 +1,220 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_ISO9660_IMAGE_HPP
+#define LIBSTRIEZEL_ARCHIVE_ISO9660_IMAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../fileMapping.hpp"
+
+namespace libstriezel::archive::iso9660
+{
+
+/** \brief contiguous part of the data of a file in an ISO 9660 image
+ */
+struct extent
+{
+  int64_t offset; /**< offset of the first byte from the start of the image */
+  int64_t size; /**< size of the part in bytes */
+};
+
+
+/** \brief reads the directory tree of an ISO 9660 image without libarchive
+ *
+ * The image is mapped into memory and its directories are parsed once.
+ * Names follow the same rules as libarchive: Rock Ridge names are preferred,
+ * then Joliet names, then the plain ISO 9660 names without version number.
+ * Since the data of a file is stored uncompressed in one or more extents,
+ * any part of any file can be read without reading anything else. The
+ * entries are in the same order as libarchive lists them.
+ */
+class image
+{
+  public:
+    /** \brief constructor - maps an image file into memory and parses its
+     * directory tree
+     *
+     * \param fileName  -  file name of the ISO 9660 image
+     * \remarks This function throws an exception, if the file cannot be
+     *          mapped or is not a valid image.
+     */
+    image(const std::string& fileName);
+
+
+    /** \brief constructor - parses the directory tree of an image in memory
+     *
+     * \param data  pointer to the start of the image - the data must stay
+     *              valid as long as the object exists
+     * \param size  size of the image in bytes
+     * \remarks This function throws an exception, if the data is not a
+     *          valid image.
+     */
+    image(const void* data, const std::size_t size);
+
+
+    /* Delete unwanted default copy constructor, assignment operator and
+       move constructor. */
+    image(const image& op) = delete;
+    image & operator=(const image& op) = delete;
+    image(const image&& op) = delete;
+
+
+    /** \brief Returns the number of files and directories in the image.
+     *
+     * \return Returns the number of entries. Like in the listing of
+     *         libarchive, the root directory is the first entry and its
+     *         name is ".".
+     */
+    int64_t numEntries() const;
+
+
+    /** \brief Gets the path of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the path, e.g. "boot/isolinux/boot.msg".
+     */
+    const std::string& name(const std::size_t index) const;
+
+
+    /** \brief Gets the size of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the size of the data in bytes.
+     */
+    int64_t size(const std::size_t index) const;
+
+
+    /** \brief Checks whether an entry is a directory.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns true, if the entry is a directory.
+     */
+    bool isDirectory(const std::size_t index) const;
+
+
+    /** \brief Checks whether an entry is a symbolic link.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns true, if the entry is a Rock Ridge symbolic link.
+     */
+    bool isSymLink(const std::size_t index) const;
+
+
+    /** \brief Gets the modification time of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the modification time from the Rock Ridge extensions,
+     *         or the recording time of the directory record without them.
+     */
+    std::time_t modificationTime(const std::size_t index) const;
+
+
+    /** \brief Checks whether the data of an entry can be read directly.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns true, if the entry is a regular file whose extents
+     *         are within the image. Returns false for directories, symbolic
+     *         links, files compressed with zisofs and truncated files.
+     */
+    bool isPlainFile(const std::size_t index) const;
+
+
+    /** \brief Gets the extents that hold the data of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the extents in the order of the data. Files that are
+     *         larger than 4 GiB have several extents.
+     */
+    const std::vector<extent>& extents(const std::size_t index) const;
+
+
+    /** \brief Gets the index of the entry with the given path.
+     *
+     * \param name  the path of the entry, without leading slash
+     * \return Returns the index of the first entry with that path.
+     *         Returns -1, if there is no such entry.
+     */
+    int64_t locate(const std::string_view name) const;
+
+
+    /** \brief Reads a part of the data of a plain file.
+     *
+     * \param index   index of the entry, must be less than numEntries()
+     * \param offset  offset of the first byte within the file
+     * \param buffer  the buffer that gets the data
+     * \param length  number of bytes to read
+     * \return Returns the number of bytes that were read, which is less than
+     *         length at the end of the file. Returns -1, if the entry is no
+     *         plain file or the offset is negative.
+     */
+    int64_t read(const std::size_t index, const int64_t offset, void* buffer,
+                 const std::size_t length) const;
+  private:
+    /** \brief Reads the volume descriptors and all directories.
+     *
+     * \remarks This function throws an exception, if the data is not valid.
+     */
+    void parse();
+
+
+    /** \brief a directory whose records have not been read yet
+     */
+    struct pendingDirectory
+    {
+      std::string path; /**< path of the directory, empty for the root directory */
+      uint32_t location; /**< logical block of the directory records */
+      uint32_t length; /**< size of the directory records in bytes */
+    };
+
+
+    /** \brief Reads the records of one directory and queues its subdirectories.
+     *
+     * \param directory  the directory
+     * \param joliet     whether names are Joliet names
+     * \param pending    directories that still need to be read
+     * \param locations  receives the location of each entry in the image
+     */
+    void readDirectory(const pendingDirectory& directory, const bool joliet,
+                       std::vector<pendingDirectory>& pending, std::vector<uint64_t>& locations);
+
+
+    const unsigned char * m_data; /**< start of the image */
+    std::size_t m_size; /**< size of the image */
+    std::unique_ptr<libstriezel::archive::fileMapping> m_file; /**< the mapped file, or nullptr for data in memory */
+    uint32_t m_blockSize; /**< logical block size, usually 2048 */
+    int m_suspSkip; /**< bytes to skip in every system use area, or -1 without Rock Ridge */
+    std::vector<std::string> m_names; /**< paths of the entries */
+    std::vector<int64_t> m_sizes; /**< sizes of the entries */
+    std::vector<uint8_t> m_types; /**< kind of each entry, see image.cpp */
+    std::vector<std::time_t> m_times; /**< modification times of the entries */
+    std::vector<std::vector<extent> > m_extents; /**< extents of the entries */
+    std::unordered_map<std::string_view, std::size_t> m_lookup; /**< index of each path, views point into m_names */
+};
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_ISO9660_IMAGE_HPP
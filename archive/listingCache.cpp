@@ -0,0 +1,263 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "listingCache.hpp"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#if defined(_WIN32)
+  #include <process.h>
+  #include <Windows.h>
+#else
+  #include <unistd.h>
+#endif
+
+namespace libstriezel::archive
+{
+
+namespace
+{
+
+/// first bytes of every cache file
+const std::string magic("lstzLST", 8);
+
+/// version of the file layout
+const uint32_t version = 2;
+
+/// flag in the header that marks listings with header offsets
+const uint32_t flagOffsets = 1;
+
+using serialization::put;
+using serialization::putString;
+
+} // anonymous namespace
+
+bool getListingKey(const std::string& fileName, listingKey& key)
+{
+  struct stat buffer;
+  if (stat(fileName.c_str(), &buffer) != 0)
+    return false;
+  key.path = fileName;
+  key.size = buffer.st_size;
+  key.m_time = buffer.st_mtime;
+  key.c_time = buffer.st_ctime;
+  #if defined(_WIN32)
+  // FILETIME counts intervals of 100 nanoseconds.
+  WIN32_FILE_ATTRIBUTE_DATA attributes;
+  if (GetFileAttributesExA(fileName.c_str(), GetFileExInfoStandard, &attributes) == 0)
+    return false;
+  const auto fraction = [](const FILETIME& time)
+  {
+    const uint64_t ticks = (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    return static_cast<int64_t>(ticks % 10000000) * 100;
+  };
+  key.m_timeNanoseconds = fraction(attributes.ftLastWriteTime);
+  key.c_timeNanoseconds = fraction(attributes.ftCreationTime);
+  #elif defined(__APPLE__)
+  key.m_timeNanoseconds = buffer.st_mtimespec.tv_nsec;
+  key.c_timeNanoseconds = buffer.st_ctimespec.tv_nsec;
+  #else
+  key.m_timeNanoseconds = buffer.st_mtim.tv_nsec;
+  key.c_timeNanoseconds = buffer.st_ctim.tv_nsec;
+  #endif
+  key.inode = static_cast<uint64_t>(buffer.st_ino);
+  key.device = static_cast<uint64_t>(buffer.st_dev);
+  return true;
+}
+
+void writeListingKey(std::string& data, const listingKey& key)
+{
+  putString(data, key.path);
+  put(data, static_cast<uint64_t>(key.size), 8);
+  put(data, static_cast<uint64_t>(key.m_time), 8);
+  put(data, static_cast<uint64_t>(key.m_timeNanoseconds), 8);
+  put(data, static_cast<uint64_t>(key.c_time), 8);
+  put(data, static_cast<uint64_t>(key.c_timeNanoseconds), 8);
+  put(data, key.inode, 8);
+  put(data, key.device, 8);
+}
+
+bool checkListingKey(serialization::reader& in, const listingKey& key)
+{
+  std::string_view path;
+  int64_t size = 0;
+  int64_t mtime = 0;
+  int64_t mtimeNanoseconds = 0;
+  int64_t ctime = 0;
+  int64_t ctimeNanoseconds = 0;
+  uint64_t inode = 0;
+  uint64_t device = 0;
+  if (!in.getString(path) || !in.getSigned(size) || !in.getSigned(mtime)
+      || !in.getSigned(mtimeNanoseconds) || !in.getSigned(ctime) || !in.getSigned(ctimeNanoseconds)
+      || !in.get(inode, 8) || !in.get(device, 8))
+    return false;
+  return (path == key.path) && (size == key.size) && (mtime == key.m_time)
+      && (mtimeNanoseconds == key.m_timeNanoseconds) && (ctime == key.c_time)
+      && (ctimeNanoseconds == key.c_timeNanoseconds)
+      && (inode == key.inode) && (device == key.device);
+}
+
+std::string sidecarName(const std::string& archiveFileName)
+{
+  return archiveFileName + ".listing";
+}
+
+bool replaceFile(const std::string& fileName, const std::string& data)
+{
+  // Write to a temporary file in the same directory, then replace the file.
+  // Process id and call counter make the name unique for every call.
+  static std::atomic<uint64_t> calls(0);
+  #if defined(_WIN32)
+  const std::string tempName = fileName + ".tmp" + std::to_string(_getpid())
+                             + "." + std::to_string(calls.fetch_add(1));
+  #else
+  const std::string tempName = fileName + ".tmp" + std::to_string(getpid())
+                             + "." + std::to_string(calls.fetch_add(1));
+  #endif
+  std::ofstream stream(tempName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!stream.good() || !stream.is_open())
+    return false;
+  stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+  stream.close();
+  if (!stream.good())
+  {
+    std::remove(tempName.c_str());
+    return false;
+  }
+  #if defined(_WIN32)
+  const bool replaced = MoveFileExA(tempName.c_str(), fileName.c_str(),
+                                    MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+  #else
+  const bool replaced = std::rename(tempName.c_str(), fileName.c_str()) == 0;
+  #endif
+  if (!replaced)
+    std::remove(tempName.c_str());
+  return replaced;
+}
+
+bool saveListing(const std::string& cacheFileName, const listingKey& key,
+                 const entryTable& table, const std::vector<int64_t>& offsets)
+{
+  const bool hasOffsets = !offsets.empty();
+  if (hasOffsets && (offsets.size() != table.size()))
+    return false;
+
+  std::string data(magic);
+  put(data, version, 4);
+  put(data, hasOffsets ? flagOffsets : 0, 4);
+  writeListingKey(data, key);
+  put(data, table.size(), 8);
+  for (std::size_t row = 0; row < table.size(); ++row)
+  {
+    putString(data, table.name(row));
+    put(data, static_cast<uint64_t>(table.entrySize(row)), 8);
+    put(data, static_cast<uint64_t>(table.m_time(row)), 8);
+    put(data, (table.isDirectory(row) ? 1 : 0) | (table.isSymLink(row) ? 2 : 0), 1);
+    put(data, static_cast<uint64_t>(table.compressedSize(row)), 8);
+    put(data, table.crc(row), 4);
+    if (hasOffsets)
+      put(data, static_cast<uint64_t>(offsets[row]), 8);
+  }
+  put(data, serialization::fnv1a(data), 8);
+
+  return replaceFile(cacheFileName, data);
+}
+
+bool loadListing(const std::string& cacheFileName, const listingKey& key,
+                 entryTable& table, std::vector<int64_t>& offsets)
+{
+  table.clear();
+  offsets.clear();
+  std::ifstream stream(cacheFileName, std::ios_base::in | std::ios_base::binary);
+  if (!stream.good())
+    return false;
+  const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  stream.close();
+
+  // The checksum detects truncated or damaged files.
+  if ((data.size() < magic.size() + 8) || (data.compare(0, magic.size(), magic) != 0))
+    return false;
+  const std::size_t end = data.size() - 8;
+  uint64_t value = 0;
+  serialization::reader tail(data, end, data.size());
+  if (!tail.get(value, 8) || (value != serialization::fnv1a(std::string_view(data.data(), end))))
+    return false;
+
+  serialization::reader in(data, magic.size(), end);
+  uint64_t flags = 0;
+  if (!in.get(value, 4) || (value != version) || !in.get(flags, 4))
+    return false;
+  // The listing belongs to another file or the file has changed since.
+  if (!checkListingKey(in, key))
+    return false;
+
+  uint64_t count = 0;
+  if (!in.get(count, 8))
+    return false;
+  const bool hasOffsets = (flags & flagOffsets) != 0;
+  // Every entry needs at least 33 bytes, so a wrong count cannot allocate
+  // more memory than the file size suggests.
+  if (count > (end / 33))
+    return false;
+  table.reserve(static_cast<std::size_t>(count));
+  if (hasOffsets)
+    offsets.reserve(static_cast<std::size_t>(count));
+  for (uint64_t row = 0; row < count; ++row)
+  {
+    std::string_view name;
+    int64_t entrySize = 0;
+    int64_t entryTime = 0;
+    uint64_t typeFlags = 0;
+    int64_t compressedSize = 0;
+    uint64_t crc = 0;
+    if (!in.getString(name) || !in.getSigned(entrySize) || !in.getSigned(entryTime)
+        || !in.get(typeFlags, 1) || !in.getSigned(compressedSize) || !in.get(crc, 4))
+    {
+      table.clear();
+      offsets.clear();
+      return false;
+    }
+    const entryView view { static_cast<int64_t>(row), name, entrySize, static_cast<std::time_t>(entryTime),
+                           (typeFlags & 1) != 0, (typeFlags & 2) != 0 };
+    table.add(view, compressedSize, static_cast<uint32_t>(crc));
+    if (hasOffsets)
+    {
+      int64_t offset = 0;
+      if (!in.getSigned(offset))
+      {
+        table.clear();
+        offsets.clear();
+        return false;
+      }
+      offsets.push_back(offset);
+    }
+  }
+  if (!in.atEnd())
+  {
+    table.clear();
+    offsets.clear();
+    return false;
+  }
+  return true;
+}
+
+} // namespace
@@ -0,0 +1,133 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_LISTINGCACHE_HPP
+#define LIBSTRIEZEL_ARCHIVE_LISTINGCACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "entryTable.hpp"
+#include "serialization.hpp"
+
+namespace libstriezel::archive
+{
+
+/** \brief identifies a certain state of an archive file
+ *
+ * A cached listing is only used, if the archive file still has the same
+ * path, size, modification time, status change time, inode and device as
+ * during the listing. The times include their fractional part, because a
+ * file can change several times within one second.
+ */
+struct listingKey
+{
+  std::string path; /**< path of the archive file */
+  int64_t size; /**< size of the archive file in bytes */
+  int64_t m_time; /**< modification time of the archive file */
+  int64_t m_timeNanoseconds; /**< nanoseconds part of the modification time */
+  int64_t c_time; /**< status change time, creation time on Windows */
+  int64_t c_timeNanoseconds; /**< nanoseconds part of the status change time */
+  uint64_t inode; /**< inode number of the archive file, zero where unknown */
+  uint64_t device; /**< device that contains the archive file */
+};
+
+
+/** \brief Gets the key of the current state of an archive file.
+ *
+ * \param fileName  path of the archive file
+ * \param key       receives the key
+ * \return Returns true, if the key could be determined.
+ *         Returns false, if the file cannot be accessed.
+ */
+bool getListingKey(const std::string& fileName, listingKey& key);
+
+
+/** \brief Appends a key to the data of a cache file.
+ *
+ * \param data  the data of the cache file
+ * \param key   the key
+ */
+void writeListingKey(std::string& data, const listingKey& key);
+
+
+/** \brief Reads a key that writeListingKey() wrote and compares it.
+ *
+ * \param in   reader that is positioned at the key
+ * \param key  the current key of the archive file
+ * \return Returns true, if the stored key matches the given key.
+ *         Returns false, if it does not match or could not be read.
+ */
+bool checkListingKey(serialization::reader& in, const listingKey& key);
+
+
+/** \brief Gets the default name of the cache file for an archive.
+ *
+ * \param archiveFileName  path of the archive file
+ * \return Returns the name of the cache file next to the archive.
+ */
+std::string sidecarName(const std::string& archiveFileName);
+
+
+/** \brief Replaces the content of a file without leaving a partial file.
+ *
+ * \param fileName  name of the file
+ * \param data      the new content of the file
+ * \return Returns true, if the file was written.
+ *         Returns false, if an error occurred.
+ * \remarks The data is written to a temporary file in the same directory
+ *          first, which then replaces the file. Every call uses its own
+ *          temporary file, so several threads may replace the same file.
+ */
+bool replaceFile(const std::string& fileName, const std::string& data);
+
+
+/** \brief Writes a listing to a cache file.
+ *
+ * \param cacheFileName  name of the cache file
+ * \param key            key of the archive file at the time of the listing
+ * \param table          the entries of the archive
+ * \param offsets        offsets to resume reading at the headers of the
+ *                       entries, either empty or one per entry of the table
+ * \return Returns true, if the cache file was written.
+ *         Returns false, if an error occurred.
+ * \remarks The data is written to a temporary file first, which then
+ *          replaces the cache file. Readers never see a partial file.
+ */
+bool saveListing(const std::string& cacheFileName, const listingKey& key,
+                 const entryTable& table, const std::vector<int64_t>& offsets);
+
+
+/** \brief Reads a listing from a cache file.
+ *
+ * \param cacheFileName  name of the cache file
+ * \param key            current key of the archive file
+ * \param table          receives the entries of the archive
+ * \param offsets        receives the header offsets, empty if the listing
+ *                       has none
+ * \return Returns true, if the cache file exists, is intact and belongs to
+ *         the given key. Returns false otherwise.
+ */
+bool loadListing(const std::string& cacheFileName, const listingKey& key,
+                 entryTable& table, std::vector<int64_t>& offsets);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_LISTINGCACHE_HPP
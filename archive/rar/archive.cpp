@@ -25,11 +25,12 @@
 #include <stdexcept>
 #include <archive_entry.h>
 #include "../../filesystem/file.hpp"
+#include "../signatures.hpp"
 
 namespace libstriezel::rar
 {
 
-archive::archive(const std::string& fileName)
+archive::archive(const std::string& fileName, const bool lazy)
 : libstriezel::archive::archiveLibarchive(fileName)
 {
   applyFormats();
@@ -40,8 +41,41 @@ archive::archive(const std::string& fileName)
     m_archive = nullptr;
     throw std::runtime_error("libstriezel::rar::archive: Failed to open file " + fileName + "!");
   }
-  //fill entries
-  fillEntries();
+  //fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(const void* data, const std::size_t size, const bool lazy)
+: libstriezel::archive::archiveLibarchive(data, size)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::rar::archive: Failed to open archive from memory!");
+  }
+  //fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(libstriezel::archive::seekableStream& stream, const bool lazy)
+: libstriezel::archive::archiveLibarchive(stream)
+{
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::rar::archive: Failed to open archive from stream!");
+  }
+  //fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
 }
 
 archive::~archive()
@@ -65,35 +99,9 @@ void archive::applyFormats()
 
 bool archive::isRar(const std::string& fileName)
 {
-  /* The magic literal for rar files is "Rar!\x1a\x07\x00" (newer versions) or
-     "RE\x7e\x5e" (older versions). */
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
-    return false;
-
-  std::string sequence = "";
-  try
-  {
-    char buffer[7];
-    std::memset(buffer, '\0', 7);
-    stream.read(buffer, 7);
-    if (!stream.good() || (stream.gcount() < 7))
-    {
-      stream.close();
-      return false;
-    }
-    sequence = std::string(buffer, 7);
-  }
-  catch (...)
-  {
-    stream.close();
-    return false;
-  }
-  stream.close();
-
-  return ((sequence == std::string("Rar!\x1a\x07\0", 7))
-          || (sequence.substr(0, 4) == std::string("RE\x7e\x5e", 4)));
+  char head[7];
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head, sizeof(head));
+  return libstriezel::archive::signatures::isRar(head, size);
 }
 
 } //namespace
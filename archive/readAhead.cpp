@@ -0,0 +1,318 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "readAhead.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#if defined(_WIN32)
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+#include <lzma.h>
+#include <zlib.h>
+
+namespace libstriezel::archive
+{
+
+namespace
+{
+
+/// smallest buffer size
+const std::size_t minimumBufferSize = 64 * 1024;
+
+/// size of a single read from the compressed file
+const std::size_t inputSize = 256 * 1024;
+
+} // anonymous namespace
+
+readAhead::readAhead(const std::size_t bufferSize, const std::size_t bufferCount)
+: m_bufferSize(std::max(bufferSize, minimumBufferSize)),
+  m_bufferCount(std::max<std::size_t>(bufferCount, 2)),
+  m_buffers(std::vector<std::unique_ptr<char[]> >()),
+  m_fill(std::vector<std::size_t>()),
+  m_input(nullptr),
+  m_current(0),
+  m_head(0),
+  m_queued(0),
+  m_holding(false),
+  m_type(format::unknown),
+  m_fd(-1),
+  m_data(nullptr),
+  m_dataSize(0),
+  m_dataOffset(0),
+  m_done(false),
+  m_failed(false),
+  m_stopped(false),
+  m_mutex(),
+  m_condition(),
+  m_decompressor()
+{
+}
+
+readAhead::~readAhead()
+{
+  close();
+}
+
+bool readAhead::open(const std::string& fileName, const format type)
+{
+  if ((m_fd >= 0) || (nullptr != m_data) || ((type != format::gzip) && (type != format::xz)))
+    return false;
+  #if defined(_WIN32)
+  m_fd = _open(fileName.c_str(), _O_RDONLY | _O_BINARY);
+  #else
+  m_fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  #endif
+  if (m_fd < 0)
+    return false;
+  #if defined(__linux__)
+  // The kernel reads the following data while the current data is
+  // decompressed, so the decompressor seldom waits for the disk.
+  posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  #endif
+  m_input.reset(new unsigned char[inputSize]);
+  return open(nullptr, 0, type);
+}
+
+bool readAhead::open(const void* data, const std::size_t size, const format type)
+{
+  if (m_decompressor.joinable() || ((type != format::gzip) && (type != format::xz)))
+    return false;
+  // The file overload opens the file first and passes no data.
+  if (nullptr != data)
+  {
+    if (m_fd >= 0)
+      return false;
+    m_data = static_cast<const unsigned char*>(data);
+    m_dataSize = size;
+  }
+  else if (m_fd < 0)
+    return false;
+  m_type = type;
+  m_dataOffset = 0;
+  m_buffers.clear();
+  for (std::size_t i = 0; i < m_bufferCount; ++i)
+  {
+    m_buffers.push_back(std::unique_ptr<char[]>(new char[m_bufferSize]));
+  }
+  m_fill.assign(m_bufferCount, 0);
+  m_current = 0;
+  m_head = 0;
+  m_queued = 0;
+  m_holding = false;
+  m_done = false;
+  m_failed = false;
+  m_stopped = false;
+  m_decompressor = std::thread(&readAhead::run, this);
+  return true;
+}
+
+int64_t readAhead::next(const void*& data)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_holding)
+  {
+    m_head = (m_head + 1) % m_buffers.size();
+    --m_queued;
+    m_holding = false;
+    m_condition.notify_all();
+  }
+  m_condition.wait(lock, [this]() { return (m_queued > 0) || m_done; });
+  if (m_queued == 0)
+    return m_failed ? -1 : 0;
+  m_holding = true;
+  data = m_buffers[m_head].get();
+  return static_cast<int64_t>(m_fill[m_head]);
+}
+
+void readAhead::close()
+{
+  if (m_decompressor.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_stopped = true;
+    }
+    m_condition.notify_all();
+    m_decompressor.join();
+  }
+  if (m_fd >= 0)
+  {
+    #if defined(_WIN32)
+    _close(m_fd);
+    #else
+    ::close(m_fd);
+    #endif
+    m_fd = -1;
+  }
+  m_data = nullptr;
+  m_dataSize = 0;
+}
+
+void readAhead::run()
+{
+  const bool success = (m_type == format::gzip) ? decompressGzip() : decompressXz();
+  // A partially filled buffer still holds data for the consumer.
+  if (m_fill[m_current] > 0)
+    submit();
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_failed = !success;
+  m_done = true;
+  m_condition.notify_all();
+}
+
+int64_t readAhead::readInput(const unsigned char*& data)
+{
+  if (nullptr != m_data)
+  {
+    // zlib counts input in unsigned int, so the data is passed in pieces.
+    const std::size_t count = std::min<std::size_t>(m_dataSize - m_dataOffset, UINT_MAX);
+    data = m_data + m_dataOffset;
+    m_dataOffset += count;
+    return static_cast<int64_t>(count);
+  }
+  while (true)
+  {
+    #if defined(_WIN32)
+    const int bytesRead = _read(m_fd, m_input.get(), static_cast<unsigned int>(inputSize));
+    #else
+    const ssize_t bytesRead = read(m_fd, m_input.get(), inputSize);
+    #endif
+    if ((bytesRead < 0) && (errno == EINTR))
+      continue;
+    data = m_input.get();
+    return bytesRead;
+  }
+}
+
+bool readAhead::submit()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  ++m_queued;
+  m_condition.notify_all();
+  // The next buffer is free once the consumer has less than all of them.
+  m_condition.wait(lock, [this]() { return (m_queued < m_buffers.size()) || m_stopped; });
+  if (m_stopped)
+    return false;
+  m_current = (m_current + 1) % m_buffers.size();
+  m_fill[m_current] = 0;
+  return true;
+}
+
+bool readAhead::decompressGzip()
+{
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  stream.next_in = Z_NULL;
+  stream.avail_in = 0;
+  // 15 + 16: gzip header, maximum window size
+  if (inflateInit2(&stream, 15 + 16) != Z_OK)
+    return false;
+  bool memberEnded = false;
+  bool success = true;
+  while (true)
+  {
+    if (stream.avail_in == 0)
+    {
+      const unsigned char * input = nullptr;
+      const int64_t bytesRead = readInput(input);
+      if (bytesRead <= 0)
+      {
+        // The data must not end within a member.
+        success = (bytesRead == 0) && memberEnded;
+        break;
+      }
+      stream.next_in = const_cast<unsigned char*>(input);
+      stream.avail_in = static_cast<unsigned int>(bytesRead);
+    }
+    if (memberEnded)
+    {
+      // Another member may follow. Anything else, e.g. padding with zeros,
+      // ends the data, just like gzip does it.
+      if (stream.next_in[0] != 0x1F)
+        break;
+      inflateReset(&stream);
+      memberEnded = false;
+    }
+    stream.next_out = reinterpret_cast<Bytef*>(m_buffers[m_current].get() + m_fill[m_current]);
+    stream.avail_out = static_cast<unsigned int>(m_bufferSize - m_fill[m_current]);
+    const int ret = inflate(&stream, Z_NO_FLUSH);
+    if ((ret != Z_OK) && (ret != Z_STREAM_END) && (ret != Z_BUF_ERROR))
+    {
+      success = false;
+      break;
+    }
+    m_fill[m_current] = m_bufferSize - stream.avail_out;
+    memberEnded = (ret == Z_STREAM_END);
+    if ((stream.avail_out == 0) && !submit())
+      break;
+  } // while
+  inflateEnd(&stream);
+  return success;
+}
+
+bool readAhead::decompressXz()
+{
+  lzma_stream stream = LZMA_STREAM_INIT;
+  // Concatenated streams are decompressed as one piece of data.
+  if (lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+    return false;
+  lzma_action action = LZMA_RUN;
+  bool success = true;
+  while (true)
+  {
+    if ((stream.avail_in == 0) && (action == LZMA_RUN))
+    {
+      const unsigned char * input = nullptr;
+      const int64_t bytesRead = readInput(input);
+      if (bytesRead < 0)
+      {
+        success = false;
+        break;
+      }
+      stream.next_in = input;
+      stream.avail_in = static_cast<std::size_t>(bytesRead);
+      if (bytesRead == 0)
+        action = LZMA_FINISH;
+    }
+    stream.next_out = reinterpret_cast<uint8_t*>(m_buffers[m_current].get() + m_fill[m_current]);
+    stream.avail_out = m_bufferSize - m_fill[m_current];
+    const lzma_ret ret = lzma_code(&stream, action);
+    m_fill[m_current] = m_bufferSize - stream.avail_out;
+    if (ret == LZMA_STREAM_END)
+      break;
+    if (ret != LZMA_OK)
+    {
+      success = false;
+      break;
+    }
+    if ((stream.avail_out == 0) && !submit())
+      break;
+  } // while
+  lzma_end(&stream);
+  return success;
+}
+
+} // namespace
@@ -0,0 +1,177 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_READAHEAD_HPP
+#define LIBSTRIEZEL_ARCHIVE_READAHEAD_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "format.hpp"
+
+namespace libstriezel::archive
+{
+
+/** \brief decompresses gzip or xz data on a separate thread
+ *
+ * This is the counterpart of writeBehind for the input side. A decompressor
+ * thread reads the compressed data and fills a ring of large buffers, while
+ * the consumer, e.g. libarchive's tar parser, works on the full ones. The
+ * ring is bounded, so the decompressor waits when the consumer falls behind:
+ *
+ *     readAhead reader;
+ *     if (!reader.open(fileName, format::gzip)) ...
+ *     const void * data = nullptr;
+ *     while ((bytes = reader.next(data)) > 0)
+ *       consume(data, bytes);
+ *     if (bytes < 0) ...
+ */
+class readAhead
+{
+  public:
+    /** \brief constructor
+     *
+     * \param bufferSize   size of each buffer in bytes
+     * \param bufferCount  number of buffers in the ring, at least two
+     */
+    readAhead(const std::size_t bufferSize = 1024 * 1024, const std::size_t bufferCount = 4);
+
+
+    /** \brief destructor - stops the decompressor thread
+     */
+    ~readAhead();
+
+
+    /* Delete unwanted default copy constructor, assignment operator and
+       move constructor. */
+    readAhead(const readAhead& op) = delete;
+    readAhead & operator=(const readAhead& op) = delete;
+    readAhead(const readAhead&& op) = delete;
+
+
+    /** \brief Starts to decompress a file.
+     *
+     * \param fileName  name of the compressed file
+     * \param type      compression of the file, format::gzip or format::xz
+     * \return Returns true, if the decompression was started.
+     *         Returns false, if the file could not be opened or the
+     *         compression is not supported.
+     * \remarks The kernel is told that the file is read sequentially, so it
+     *          reads ahead while the data is decompressed.
+     */
+    bool open(const std::string& fileName, const format type);
+
+
+    /** \brief Starts to decompress data in memory.
+     *
+     * \param data  pointer to the start of the compressed data - the data
+     *              must stay valid until close() is called
+     * \param size  size of the compressed data in bytes
+     * \param type  compression of the data, format::gzip or format::xz
+     * \return Returns true, if the decompression was started.
+     *         Returns false, if the compression is not supported.
+     */
+    bool open(const void* data, const std::size_t size, const format type);
+
+
+    /** \brief Gets the next chunk of decompressed data.
+     *
+     * \param data  receives a pointer to the start of the chunk
+     * \return Returns the size of the chunk in bytes, zero at the end of
+     *         the data, or -1, if the data is damaged or could not be read.
+     * \remarks The chunk stays valid until the next call of next() or
+     *          close(). Concatenated gzip members and xz streams are
+     *          decompressed as one piece of data.
+     */
+    int64_t next(const void*& data);
+
+
+    /** \brief Stops the decompressor thread and closes the input.
+     */
+    void close();
+  private:
+    /** \brief Main function of the decompressor thread.
+     */
+    void run();
+
+
+    /** \brief Decompresses gzip data into the ring.
+     *
+     * \return Returns true, if all data was decompressed or the consumer
+     *         stopped. Returns false, if an error occurred.
+     */
+    bool decompressGzip();
+
+
+    /** \brief Decompresses xz data into the ring.
+     *
+     * \return Returns true, if all data was decompressed or the consumer
+     *         stopped. Returns false, if an error occurred.
+     */
+    bool decompressXz();
+
+
+    /** \brief Gets the next piece of compressed input.
+     *
+     * \param data  receives a pointer to the start of the input
+     * \return Returns the number of bytes, zero at the end of the input, or
+     *         -1, if an error occurred.
+     */
+    int64_t readInput(const unsigned char*& data);
+
+
+    /** \brief Hands the current buffer over to the consumer and gets the next one.
+     *
+     * \return Returns true, if the decompressor shall go on.
+     *         Returns false, if the consumer has stopped.
+     */
+    bool submit();
+
+
+    std::size_t m_bufferSize; /**< size of each buffer */
+    std::size_t m_bufferCount; /**< number of buffers in the ring */
+    std::vector<std::unique_ptr<char[]> > m_buffers; /**< the ring of buffers */
+    std::vector<std::size_t> m_fill; /**< number of bytes in each buffer */
+    std::unique_ptr<unsigned char[]> m_input; /**< buffer for compressed data from the file */
+    std::size_t m_current; /**< index of the buffer that the decompressor fills */
+    std::size_t m_head; /**< index of the next buffer for the consumer */
+    std::size_t m_queued; /**< number of full buffers, including the one the consumer holds */
+    bool m_holding; /**< whether the consumer holds the buffer at m_head */
+    format m_type; /**< compression of the data */
+    int m_fd; /**< file descriptor of the compressed file, or -1 */
+    const unsigned char * m_data; /**< compressed data in memory, or nullptr */
+    std::size_t m_dataSize; /**< size of the compressed data in memory */
+    std::size_t m_dataOffset; /**< number of bytes of m_data that were passed on */
+    bool m_done; /**< whether the decompressor has no more data */
+    bool m_failed; /**< whether decompression has failed */
+    bool m_stopped; /**< whether the consumer has stopped */
+    std::mutex m_mutex; /**< protects the queue state and the flags */
+    std::condition_variable m_condition; /**< signals changes of the queue */
+    std::thread m_decompressor; /**< the decompressor thread */
+}; // class
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_READAHEAD_HPP
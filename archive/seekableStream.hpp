@@ -0,0 +1,68 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_SEEKABLESTREAM_HPP
+#define LIBSTRIEZEL_ARCHIVE_SEEKABLESTREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace libstriezel::archive
+{
+
+/** \brief interface for seekable sources of archive data
+ *
+ * Archive classes use implementations of this interface to read archives
+ * that are neither files nor complete memory buffers, e.g. data that comes
+ * from the network. The stream must stay valid as long as the archive
+ * object that reads from it exists.
+ */
+class seekableStream
+{
+  public:
+    /** \brief virtual destructor
+     */
+    virtual ~seekableStream() = default;
+
+
+    /** \brief Reads data from the current position.
+     *
+     * \param buffer  the buffer that gets the data
+     * \param size    maximum number of bytes to read
+     * \return Returns the number of bytes that were read. Returns zero at the
+     *         end of the stream. Returns -1, if an error occurred.
+     */
+    virtual int64_t read(void* buffer, const std::size_t size) = 0;
+
+
+    /** \brief Sets the position for the next read operation.
+     *
+     * \param offset  offset relative to the position given by whence
+     * \param whence  SEEK_SET, SEEK_CUR or SEEK_END, just like for fseek()
+     * \return Returns the new position, counted from the start of the stream.
+     *         Returns -1, if an error occurred.
+     */
+    virtual int64_t seek(const int64_t offset, const int whence) = 0;
+};
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_SEEKABLESTREAM_HPP
@@ -0,0 +1,181 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_SERIALIZATION_HPP
+#define LIBSTRIEZEL_ARCHIVE_SERIALIZATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/* The functions in this namespace write and read the little endian values of
+   the cache files that sit next to archives, like cached listings and gzip
+   checkpoint indices, and compute the FNV-1a hash that these files use as
+   checksum. */
+namespace libstriezel::archive::serialization
+{
+
+/** \brief Computes the 64 bit FNV-1a hash of some data.
+ *
+ * \param data  the data
+ * \return Returns the hash of the data.
+ */
+inline uint64_t fnv1a(const std::string_view data)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : data)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+
+/** \brief Appends an unsigned integer in little endian byte order.
+ *
+ * \param data   the data that gets the integer
+ * \param value  the integer
+ * \param bytes  number of bytes to write, at most eight
+ */
+inline void put(std::string& data, uint64_t value, const unsigned int bytes)
+{
+  for (unsigned int i = 0; i < bytes; ++i)
+  {
+    data.push_back(static_cast<char>(value & 0xFF));
+    value >>= 8;
+  }
+}
+
+
+/** \brief Appends a string with its length in front of it.
+ *
+ * \param data  the data that gets the string
+ * \param str   the string
+ */
+inline void putString(std::string& data, const std::string_view str)
+{
+  put(data, str.size(), 4);
+  data.append(str);
+}
+
+
+/** \brief reads the values that put() and putString() wrote one after another
+ */
+class reader
+{
+  public:
+    /** \brief Creates a reader for a part of the data.
+     *
+     * \param data   the data, must outlive the reader
+     * \param start  offset of the first byte to read
+     * \param end    offset after the last byte to read
+     */
+    reader(const std::string& data, const std::size_t start, const std::size_t end)
+    : m_data(data),
+      m_position(start),
+      m_end(end)
+    {
+    }
+
+
+    /** \brief Reads an unsigned integer in little endian byte order.
+     *
+     * \param value  receives the integer
+     * \param bytes  number of bytes to read, at most eight
+     * \return Returns true, if the integer was read.
+     *         Returns false, if there are not enough bytes left.
+     */
+    bool get(uint64_t& value, const unsigned int bytes)
+    {
+      if (m_end - m_position < bytes)
+        return false;
+      value = 0;
+      for (unsigned int i = 0; i < bytes; ++i)
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(m_data[m_position + i])) << (8 * i);
+      m_position += bytes;
+      return true;
+    }
+
+
+    /** \brief Reads a signed integer that was written with eight bytes.
+     *
+     * \param value  receives the integer
+     * \return Returns true, if the integer was read.
+     *         Returns false, if there are not enough bytes left.
+     */
+    bool getSigned(int64_t& value)
+    {
+      uint64_t raw = 0;
+      if (!get(raw, 8))
+        return false;
+      value = static_cast<int64_t>(raw);
+      return true;
+    }
+
+
+    /** \brief Reads a number of raw bytes.
+     *
+     * \param bytes   receives a view of the bytes, valid as long as the data
+     * \param length  number of bytes to read
+     * \return Returns true, if the bytes were read.
+     *         Returns false, if there are not enough bytes left.
+     */
+    bool getBytes(std::string_view& bytes, const uint64_t length)
+    {
+      if (m_end - m_position < length)
+        return false;
+      bytes = std::string_view(m_data.data() + m_position, static_cast<std::size_t>(length));
+      m_position += static_cast<std::size_t>(length);
+      return true;
+    }
+
+
+    /** \brief Reads a string that was written by putString().
+     *
+     * \param str  receives a view of the string, valid as long as the data
+     * \return Returns true, if the string was read.
+     *         Returns false, if there are not enough bytes left.
+     */
+    bool getString(std::string_view& str)
+    {
+      uint64_t length = 0;
+      return get(length, 4) && getBytes(str, length);
+    }
+
+
+    /** \brief Checks whether all bytes have been read.
+     *
+     * \return Returns true, if the reader is at the end of its part.
+     */
+    bool atEnd() const
+    {
+      return m_position == m_end;
+    }
+  private:
+    const std::string& m_data; /**< the data */
+    std::size_t m_position; /**< offset of the next byte to read */
+    std::size_t m_end; /**< offset after the last byte to read */
+};
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_SERIALIZATION_HPP
@@ -0,0 +1,253 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_SIGNATURES_HPP
+#define LIBSTRIEZEL_ARCHIVE_SIGNATURES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+/* The functions in this namespace check the magic bytes of archive formats in
+   a memory buffer that holds the start of a file. The static isXyz() methods
+   of the archive classes read the start of a file and use these functions, so
+   data that never touched the file system can be checked the same way. */
+namespace libstriezel::archive::signatures
+{
+
+/// number of bytes at the start of a file that are enough for all checks
+const std::size_t headSize = 0x8006;
+
+/// number of bytes at the start of a file that hold all signatures but ISO 9660
+const std::size_t magicSize = 512;
+
+
+/** \brief Checks whether the given bytes occur at the given offset.
+ *
+ * \param data      pointer to the start of the data
+ * \param size      size of the data in bytes
+ * \param offset    offset where the bytes are expected
+ * \param expected  the expected bytes
+ * \param length    number of expected bytes
+ * \return Returns true, if the data contains the bytes at that offset.
+ */
+inline bool matches(const void* data, const std::size_t size, const std::size_t offset,
+                    const char* expected, const std::size_t length)
+{
+  if ((nullptr == data) || (size < offset) || (size - offset < length))
+    return false;
+  return std::memcmp(static_cast<const char*>(data) + offset, expected, length) == 0;
+}
+
+
+/** \brief Reads the start of a file into a buffer.
+ *
+ * \param fileName  name of the file
+ * \param buffer    buffer that gets the data
+ * \param size      maximum number of bytes to read
+ * \return Returns the number of bytes that were read. Returns zero, if the
+ *         file could not be read.
+ */
+inline std::size_t readHead(const std::string& fileName, void* buffer, const std::size_t size)
+{
+  std::ifstream stream;
+  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
+  if (!stream.good() || !stream.is_open())
+    return 0;
+  stream.read(static_cast<char*>(buffer), size);
+  const std::streamsize count = stream.gcount();
+  stream.close();
+  return count > 0 ? static_cast<std::size_t>(count) : 0;
+}
+
+
+/** \brief Checks for the signature of 7z files.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes
+ * \return Returns true, if the data starts like a 7z file.
+ */
+inline bool is7z(const void* data, const std::size_t size)
+{
+  /* The magic literal for 7z files is "7z\xBC\xAF\x27\x1C" and starts at
+     offset zero. */
+  return matches(data, size, 0, "7z\xBC\xAF\x27\x1C", 6);
+}
+
+
+/** \brief Checks for the signature of Unix archiver files.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes
+ * \return Returns true, if the data starts like an ar file.
+ */
+inline bool isAr(const void* data, const std::size_t size)
+{
+  /* magic literal for Ar files is "!<arch>".*/
+  return matches(data, size, 0, "!<arch>", 7);
+}
+
+
+/** \brief Checks for the signature of Microsoft Cabinet files.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes
+ * \return Returns true, if the data starts like a Cabinet file.
+ */
+inline bool isCab(const void* data, const std::size_t size)
+{
+  /* The magic literal for Cabinet files is "MSCF\0\0\0\0".*/
+  return matches(data, size, 0, "MSCF\0\0\0\0", 8);
+}
+
+
+/** \brief Checks for the signature of gzip files.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes
+ * \return Returns true, if the data starts like a gzip file.
+ */
+inline bool isGzip(const void* data, const std::size_t size)
+{
+  /* magic literal for gzip files is 1F 8B.*/
+  return matches(data, size, 0, "\x1F\x8B", 2);
+}
+
+
+/** \brief Checks for the signature of InstallShield cabinet files.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes
+ * \return Returns true, if the data starts like an InstallShield cabinet.
+ */
+inline bool isInstallShield(const void* data, const std::size_t size)
+{
+  /* magic literal for InstallShield Cab is "ISc(".*/
+  return matches(data, size, 0, "ISc(", 4);
+}
+
+
+/// offset of the ISO 9660 signature within the image
+const std::size_t iso9660Offset = 0x8001;
+
+
+/** \brief Checks for the signature of the first volume descriptor of ISO 9660
+ * images.
+ *
+ * \param data  pointer to the data at offset 0x8001 of the image
+ * \param size  number of available bytes
+ * \return Returns true, if the data contains the signature.
+ */
+inline bool isISO9660Descriptor(const void* data, const std::size_t size)
+{
+  return matches(data, size, 0, "CD001", 5);
+}
+
+
+/** \brief Checks for the signature of ISO 9660 images.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes - at least 0x8006 bytes are needed
+ *              for a positive result
+ * \return Returns true, if the data starts like an ISO 9660 image.
+ */
+inline bool isISO9660(const void* data, const std::size_t size)
+{
+  /* ISO9660 files don't use the first 32768 bytes (16 * 2048 bytes).
+     The "Volume Descriptor Set" starts at offset 0x8000 (32768), and the first
+     byte designates the type. After that, the sequence "CD001" (or in hexa-
+     decimal code "43 44 30 30 31") is encountered. We check for the existence
+     of this sequence.
+  */
+  if ((nullptr == data) || (size < iso9660Offset))
+    return false;
+  return isISO9660Descriptor(static_cast<const char*>(data) + iso9660Offset, size - iso9660Offset);
+}
+
+
+/** \brief Checks for the signature of RAR files.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes
+ * \return Returns true, if the data starts like a RAR file.
+ */
+inline bool isRar(const void* data, const std::size_t size)
+{
+  /* The magic literal for rar files is "Rar!\x1a\x07\x00" (newer versions) or
+     "RE\x7e\x5e" (older versions). */
+  if (size < 7)
+    return false;
+  return matches(data, size, 0, "Rar!\x1a\x07\0", 7)
+      || matches(data, size, 0, "RE\x7e\x5e", 4);
+}
+
+
+/** \brief Checks for the signature of tar files.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes
+ * \return Returns true, if the data starts like a tar file.
+ */
+inline bool isTar(const void* data, const std::size_t size)
+{
+  /* The magic literal for tar files it at offset 257.
+     The literal can be "ustar\0" or "ustar\040\040\0", depending on the
+     version / variant of the tar file.
+  */
+  return matches(data, size, 257, "ustar\x20\x20\0", 8)
+      || matches(data, size, 257, "ustar\0", 6);
+}
+
+
+/** \brief Checks for the signature of xz files.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes
+ * \return Returns true, if the data starts like an xz file.
+ */
+inline bool isXz(const void* data, const std::size_t size)
+{
+  /* See http://tukaani.org/xz/xz-file-format-1.0.4.txt, section 2.1.1.1 for
+     an explanation of the magic bytes in the file header.
+
+     The magic literal for xz is FD 37 7A 58 5A 00 in hexadecimal,
+     or 0xFD, '7', 'z', 'X', 'Z', 0x00 in ASCII.
+  */
+  return matches(data, size, 0, "\xFD\x37\x7A\x58\x5A\x00", 6);
+}
+
+
+/** \brief Checks for the signature of ZIP files.
+ *
+ * \param data  pointer to the start of the file's data
+ * \param size  number of available bytes
+ * \return Returns true, if the data starts like a ZIP file.
+ */
+inline bool isZip(const void* data, const std::size_t size)
+{
+  /* magic literal for ZIP files is 50 4B 03 04.*/
+  return matches(data, size, 0, "\x50\x4B\x03\x04", 4);
+}
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_SIGNATURES_HPP
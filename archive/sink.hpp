@@ -0,0 +1,81 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_SINK_HPP
+#define LIBSTRIEZEL_ARCHIVE_SINK_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace libstriezel::archive
+{
+
+/** \brief callback that receives extracted data chunk by chunk
+ *
+ * The first parameter points to the data of the chunk, the second parameter
+ * is the size of the chunk in bytes. The data is only valid during the call.
+ * The callback returns true to continue the extraction, or false to abort it.
+ */
+typedef std::function<bool(const void* data, const std::size_t size)> Sink;
+
+
+/** \brief Creates a sink that appends all data to a vector.
+ *
+ * \param buffer  the vector that gets the data
+ * \return Returns a sink that appends to the vector. The sink never aborts.
+ */
+inline Sink vectorSink(std::vector<uint8_t>& buffer)
+{
+  return [&buffer](const void* data, const std::size_t size)
+  {
+    const uint8_t * bytes = static_cast<const uint8_t*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+    return true;
+  };
+}
+
+
+/** \brief Creates a sink that copies all data into a preallocated buffer.
+ *
+ * \param buffer    pointer to the start of the buffer
+ * \param capacity  size of the buffer in bytes
+ * \param size      variable that holds the number of bytes written so far
+ *                  - the sink starts writing at that position
+ * \return Returns a sink that copies data into the buffer. The sink aborts,
+ *         if the data does not fit into the buffer.
+ */
+inline Sink memorySink(void* buffer, const std::size_t capacity, std::size_t& size)
+{
+  return [buffer, capacity, &size](const void* data, const std::size_t chunkSize)
+  {
+    if (chunkSize > capacity - size)
+      return false;
+    if (chunkSize > 0)
+      std::memcpy(static_cast<uint8_t*>(buffer) + size, data, chunkSize);
+    size += chunkSize;
+    return true;
+  };
+}
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_SINK_HPP
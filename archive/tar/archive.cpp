@@ -19,29 +19,125 @@
 */
 
 #include "archive.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#if defined(_WIN32)
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
 #include <archive_entry.h>
 #include "../../filesystem/file.hpp"
+#include "../copyRange.hpp"
+#include "../signatures.hpp"
+#include "../writeBehind.hpp"
 
 namespace libstriezel::tar
 {
 
-archive::archive(const std::string& fileName)
-: libstriezel::archive::archiveLibarchive(fileName)
+namespace
 {
+
+/* Opens a file for reading. Returns the file descriptor, or -1. */
+int openForReading(const std::string& fileName)
+{
+  #if defined(_WIN32)
+  return _open(fileName.c_str(), _O_RDONLY | _O_BINARY);
+  #else
+  return open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  #endif
+}
+
+/* Closes a file descriptor. Returns true, if it was closed without error. */
+bool closeFile(const int fd)
+{
+  #if defined(_WIN32)
+  return _close(fd) == 0;
+  #else
+  return close(fd) == 0;
+  #endif
+}
+
+/* Passes the data of a readAhead instance to libarchive. */
+la_ssize_t readAheadRead(struct ::archive * a, void * clientData, const void ** buffer)
+{
+  libstriezel::archive::readAhead * reader = static_cast<libstriezel::archive::readAhead*>(clientData);
+  const int64_t bytesRead = reader->next(*buffer);
+  if (bytesRead < 0)
+  {
+    archive_set_error(a, EIO, "Compressed data is damaged or could not be read");
+    return -1;
+  }
+  return static_cast<la_ssize_t>(bytesRead);
+}
+
+} // anonymous namespace
+
+archive::archive(const std::string& fileName, const bool lazy)
+: libstriezel::archive::archiveLibarchive(fileName),
+  m_compression(libstriezel::archive::format::unknown),
+  m_readAhead(nullptr)
+{
+  char head[8];
+  detectCompression(head, libstriezel::archive::signatures::readHead(fileName, head, sizeof(head)));
   applyFormats();
-  int ret = archive_read_open_filename(m_archive, fileName.c_str(), 4096);
+  int ret = openSource();
   if (ret != ARCHIVE_OK)
   {
     archive_read_free(m_archive);
     m_archive = nullptr;
     throw std::runtime_error("libstriezel::tar::archive: Failed to open file " + fileName + "!");
   }
-  //fill entries
-  fillEntries();
+  //fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(const void* data, const std::size_t size, const bool lazy)
+: libstriezel::archive::archiveLibarchive(data, size),
+  m_compression(libstriezel::archive::format::unknown),
+  m_readAhead(nullptr)
+{
+  detectCompression(data, size);
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::tar::archive: Failed to open archive from memory!");
+  }
+  //fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
+}
+
+archive::archive(libstriezel::archive::seekableStream& stream, const bool lazy)
+: libstriezel::archive::archiveLibarchive(stream),
+  m_compression(libstriezel::archive::format::unknown),
+  m_readAhead(nullptr)
+{
+  char head[8];
+  const int64_t headSize = (stream.seek(0, SEEK_SET) == 0) ? stream.read(head, sizeof(head)) : -1;
+  detectCompression(head, (headSize > 0) ? static_cast<std::size_t>(headSize) : 0);
+  applyFormats();
+  int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::tar::archive: Failed to open archive from stream!");
+  }
+  //fill entries now, unless that shall happen on first use
+  if (!lazy)
+    listEntries();
 }
 
 archive::~archive()
@@ -50,6 +146,8 @@ archive::~archive()
   if (ret != ARCHIVE_OK)
     std::cerr << "libstriezel::tar::archive: Could not close/free archive!\n";
   m_archive = nullptr;
+  // The decompressor is stopped after libarchive stopped reading from it.
+  m_readAhead.reset();
 }
 
 void archive::applyFormats()
@@ -68,42 +166,249 @@ void archive::applyFormats()
     m_archive = nullptr;
     throw std::runtime_error("libstriezel::tar::archive::applyFormats(): Format not supported!");
   }
+  // Streams are decompressed by libarchive, other sources by readAhead. Data
+  // from readAhead is already decompressed, so it gets no filter. The
+  // filters may report ARCHIVE_WARN, if they use an external program.
+  if ((m_compression != libstriezel::archive::format::unknown) && (nullptr != m_stream))
+  {
+    r2 = (m_compression == libstriezel::archive::format::gzip)
+       ? archive_read_support_filter_gzip(m_archive)
+       : archive_read_support_filter_xz(m_archive);
+    if ((r2 != ARCHIVE_OK) && (r2 != ARCHIVE_WARN))
+    {
+      archive_read_free(m_archive);
+      m_archive = nullptr;
+      throw std::runtime_error("libstriezel::tar::archive::applyFormats(): Compression not supported!");
+    }
+  }
 }
 
-bool archive::isTar(const std::string& fileName)
+void archive::detectCompression(const void* head, const std::size_t size)
 {
-  /* The magic literal for tar files it at offset 257.
-     The literal can be "ustar\0" or "ustar\040\040\0", depending on the
-     version / variant of the tar file.
-  */
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
-    return false;
+  if (libstriezel::archive::signatures::isGzip(head, size))
+    m_compression = libstriezel::archive::format::gzip;
+  else if (libstriezel::archive::signatures::isXz(head, size))
+    m_compression = libstriezel::archive::format::xz;
+  else
+    m_compression = libstriezel::archive::format::unknown;
+}
+
+int archive::openSource(const int64_t offset)
+{
+  if ((m_compression == libstriezel::archive::format::unknown) || (nullptr != m_stream))
+    return archiveLibarchive::openSource(offset);
+  if (offset != 0)
+    return ARCHIVE_FATAL;
+
+  // A new handle gets a new decompressor that starts at the beginning.
+  m_readAhead = std::make_unique<libstriezel::archive::readAhead>();
+  const bool started = (nullptr != m_data)
+      ? m_readAhead->open(m_data, m_dataSize, m_compression)
+      : m_readAhead->open(m_fileName, m_compression);
+  if (!started)
+    return ARCHIVE_FATAL;
+  return archive_read_open2(m_archive, m_readAhead.get(), nullptr, readAheadRead, nullptr, nullptr);
+}
 
-  std::string sequence = "";
-  try
+bool archive::supportsHeaderSeek() const
+{
+  return m_compression == libstriezel::archive::format::unknown;
+}
+
+void archive::fillEntries()
+{
+  // Streams have no random access and compressed data has no offsets, so
+  // libarchive lists them.
+  if ((nullptr == m_stream) && (m_compression == libstriezel::archive::format::unknown))
   {
-    stream.seekg(257);
-    char buffer[9];
-    std::memset(buffer, '\0', 9);
-    stream.read(buffer, 8);
-    if (!stream.good() || (stream.gcount() < 8))
+    const int fd = (nullptr != m_data) ? -1 : openForReading(m_fileName);
+    std::vector<header> headers;
+    const bool native = ((nullptr != m_data) || (fd >= 0))
+                        && readHeaders(dataReader(fd), headers);
+    if (fd >= 0)
+      closeFile(fd);
+    if (native)
     {
-      stream.close();
-      return false;
+      m_entries.clear();
+      m_headerOffsets.clear();
+      m_entryIndex.clear();
+      m_entries.reserve(headers.size());
+      m_headerOffsets.reserve(headers.size());
+      for (std::size_t i = 0; i < headers.size(); ++i)
+      {
+        const header& h = headers[i];
+        const libstriezel::archive::entryView view{ static_cast<int64_t>(i), h.name, h.size,
+                                                    h.m_time, h.directory, h.symLink };
+        m_entries.emplace_back(view);
+        m_headerOffsets.push_back(h.headerOffset);
+        // first entry wins a lookup, just like a scan from the start would do
+        m_entryIndex.add(m_entries.back().name());
+      }
+      m_entriesListed = true;
+      return;
     }
-    sequence = std::string(buffer, 8);
   }
-  catch (...)
+  archiveLibarchive::fillEntries();
+}
+
+CompressedReader archive::dataReader(const int fd) const
+{
+  if (nullptr != m_data)
+    return libstriezel::archive::compressedReader(m_fileName, m_data, m_dataSize, nullptr);
+  return libstriezel::archive::descriptorReader(fd);
+}
+
+archive::copyResult archive::copyEntry(const int fd, const std::size_t idx, const std::string& destFileName) const
+{
+  // The header is read again, because the entries may come from a listing
+  // cache or from libarchive, and neither knows the data offset.
+  header h;
+  if ((idx >= m_headerOffsets.size())
+      || (readHeader(dataReader(fd), m_headerOffsets[idx], h) != headerResult::entry)
+      || !h.plain || (h.name != m_entries[idx].name()))
+    return copyResult::unsupported;
+
+  if (nullptr == m_data)
+    return libstriezel::archive::copyToNewFile(fd, { { h.dataOffset, h.size } }, destFileName)
+        ? copyResult::copied : copyResult::failed;
+
+  // The archive is in memory, so the data only needs to be written.
+  if ((h.dataOffset > static_cast<int64_t>(m_dataSize))
+      || (h.size > static_cast<int64_t>(m_dataSize) - h.dataOffset))
+  {
+    std::cerr << "tar::archive::extractTo: error: Data of " << h.name
+              << " ends after the end of the archive!" << std::endl;
+    return copyResult::failed;
+  }
+  libstriezel::archive::writeBehind destination;
+  if (!destination.open(destFileName, h.size))
+  {
+    std::cerr << "tar::archive::extractTo: error: destination file "
+              << destFileName << " could not be created/opened for writing!"
+              << std::endl;
+    return copyResult::failed;
+  }
+  const char * source = static_cast<const char*>(m_data) + h.dataOffset;
+  int64_t done = 0;
+  bool success = true;
+  while (success && (done < h.size))
+  {
+    const std::size_t count = static_cast<std::size_t>(
+        std::min<int64_t>(h.size - done, static_cast<int64_t>(destination.space())));
+    std::memcpy(destination.data(), source + done, count);
+    success = destination.produced(count);
+    done += static_cast<int64_t>(count);
+  }
+  success = destination.finish() && success;
+  if (!success)
+  {
+    std::cerr << "tar::archive::extractTo: error: Could not write data to file "
+              << destFileName << "." << std::endl;
+    filesystem::file::remove(destFileName);
+    return copyResult::failed;
+  }
+  return copyResult::copied;
+}
+
+bool archive::extractTo(const std::string& destFileName, const std::string& archiveFilePath)
+{
+  if ((nullptr != m_stream) || (m_compression != libstriezel::archive::format::unknown))
+    return archiveLibarchive::extractTo(destFileName, archiveFilePath);
+  listEntries();
+  const int64_t idx = m_entryIndex.find(archiveFilePath);
+  if (idx < 0)
+    return archiveLibarchive::extractTo(destFileName, archiveFilePath);
+  if (filesystem::file::exists(destFileName))
   {
-    stream.close();
+    std::cerr << "tar::archive::extractTo: error: destination file "
+              << destFileName << " already exists!" << std::endl;
     return false;
   }
-  stream.close();
 
-  return ((sequence == std::string("ustar\x20\x20\0", 8))
-      || (sequence.substr(0, 6) == std::string("ustar\0", 6)));
+  const int fd = (nullptr != m_data) ? -1 : openForReading(m_fileName);
+  const copyResult result = ((nullptr != m_data) || (fd >= 0))
+      ? copyEntry(fd, static_cast<std::size_t>(idx), destFileName)
+      : copyResult::unsupported;
+  if (fd >= 0)
+    closeFile(fd);
+  if (result == copyResult::unsupported)
+    return archiveLibarchive::extractTo(destFileName, archiveFilePath);
+  return result == copyResult::copied;
+}
+
+std::map<std::string, bool> archive::extractMany(const std::map<std::string, std::string>& files,
+                                                 const unsigned int threads)
+{
+  // Streams and compressed data cannot be read at arbitrary offsets.
+  if ((nullptr != m_stream) || (m_compression != libstriezel::archive::format::unknown))
+    return archiveLibarchive::extractMany(files);
+  listEntries();
+
+  std::vector<std::pair<std::size_t, const std::map<std::string, std::string>::value_type*> > jobs;
+  std::map<std::string, std::string> others;
+  for (const auto& item : files)
+  {
+    const int64_t idx = m_entryIndex.find(item.first);
+    if ((idx < 0) || m_entries[idx].isDirectory() || m_entries[idx].isSymLink())
+      others.insert(item);
+    else
+      jobs.emplace_back(static_cast<std::size_t>(idx), &item);
+  }
+  // Copies are handed out in archive order, so reads move forward.
+  std::sort(jobs.begin(), jobs.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::vector<copyResult> results(jobs.size(), copyResult::unsupported);
+  std::atomic<std::size_t> next(0);
+  const auto work = [this, &jobs, &results, &next]()
+  {
+    const int fd = (nullptr != m_data) ? -1 : openForReading(m_fileName);
+    if ((nullptr == m_data) && (fd < 0))
+      return;
+    for (std::size_t j = next++; j < jobs.size(); j = next++)
+    {
+      if (filesystem::file::exists(jobs[j].second->second))
+      {
+        std::cerr << "tar::archive::extractMany: error: destination file "
+                  << jobs[j].second->second << " already exists!" << std::endl;
+        results[j] = copyResult::failed;
+        continue;
+      }
+      results[j] = copyEntry(fd, jobs[j].first, jobs[j].second->second);
+    }
+    if (fd >= 0)
+      closeFile(fd);
+  };
+  const unsigned int workers = (threads == 0) ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+  const std::size_t helpers = jobs.empty() ? 0 : std::min<std::size_t>(workers, jobs.size()) - 1;
+  std::vector<std::thread> pool;
+  for (std::size_t i = 0; i < helpers; ++i)
+    pool.emplace_back(work);
+  work();
+  for (auto& t : pool)
+    t.join();
+
+  std::map<std::string, bool> result;
+  for (std::size_t j = 0; j < jobs.size(); ++j)
+  {
+    if (results[j] == copyResult::unsupported)
+      others.insert(*jobs[j].second);
+    else
+      result[jobs[j].second->first] = (results[j] == copyResult::copied);
+  }
+  if (!others.empty())
+  {
+    const std::map<std::string, bool> rest = archiveLibarchive::extractMany(others);
+    result.insert(rest.begin(), rest.end());
+  }
+  return result;
+}
+
+bool archive::isTar(const std::string& fileName)
+{
+  char head[257 + 8];
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head, sizeof(head));
+  return libstriezel::archive::signatures::isTar(head, size);
 }
 
 } // namespace
@@ -21,16 +21,25 @@
 #ifndef LIBSTRIEZEL_TAR_ARCHIVE_HPP
 #define LIBSTRIEZEL_TAR_ARCHIVE_HPP
 
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <archive.h>
 #include "../archiveLibarchive.hpp"
 #include "../entryLibarchive.hpp"
+#include "../format.hpp"
+#include "../readAhead.hpp"
+#include "headers.hpp"
 
 namespace libstriezel::tar
 {
 
 /** \brief archive class for tar (tape archive) files
+ *
+ * Tar files that are compressed with gzip or xz can be read, too. Their
+ * data is decompressed on a separate thread while libarchive parses the
+ * headers and passes the data of the entries on, see readAhead.
  */
 class archive: public libstriezel::archive::archiveLibarchive
 {
@@ -38,10 +47,37 @@ class archive: public libstriezel::archive::archiveLibarchive
      /** \brief constructor - opens a tape archive in read-only mode
       *
       * \param fileName  -  file name of the tape archive
+      * \param lazy      -  if true, the entries are listed when they are needed
+      *                     for the first time, not during construction
       * \remarks This function throws an exception, if the file does not
       *          exist or a similar error occurs.
       */
-    archive(const std::string& fileName);
+    archive(const std::string& fileName, const bool lazy = false);
+
+
+     /** \brief constructor - opens a tape archive in memory in read-only mode
+      *
+      * \param data  pointer to the start of the archive data - the data must
+      *              stay valid as long as the archive object exists
+      * \param size  size of the archive data in bytes
+      * \param lazy  if true, the entries are listed when they are needed
+      *              for the first time, not during construction
+      * \remarks This function throws an exception, if the data cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(const void* data, const std::size_t size, const bool lazy = false);
+
+
+     /** \brief constructor - opens a tape archive from a stream in read-only mode
+      *
+      * \param stream  the stream that contains the archive - the stream must
+      *                stay valid as long as the archive object exists
+      * \param lazy    if true, the entries are listed when they are needed
+      *                for the first time, not during construction
+      * \remarks This function throws an exception, if the stream cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(libstriezel::archive::seekableStream& stream, const bool lazy = false);
 
 
     /** \brief destructor
@@ -63,10 +99,112 @@ class archive: public libstriezel::archive::archiveLibarchive
      *         Returns false, if not.
      */
     static bool isTar(const std::string& fileName);
+
+
+    /** \brief Extracts the file with the given name to the specified destination.
+     *
+     * \param destFileName     the destination file name - file must not exist yet
+     * \param archiveFilePath  path of the file that shall be extracted
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     * \remarks Regular files of uncompressed archives in files or in memory
+     *          are copied straight from their data offset, the other ones
+     *          are extracted with libarchive.
+     */
+    bool extractTo(const std::string& destFileName, const std::string& archiveFilePath) override;
+
+
+    /** \brief Extracts several files to the specified destinations.
+     *
+     * \param files    maps the path of each file within the archive to the
+     *                 destination file name - destination files must not exist yet
+     * \param threads  number of threads that extract files, zero means one
+     *                 thread per processor core
+     * \return Returns a map that tells for each requested file whether it
+     *         was extracted successfully.
+     * \remarks Regular files are copied in parallel, because their data is
+     *          stored uncompressed at known offsets. All other files,
+     *          compressed archives and archives from streams are extracted in
+     *          a single pass.
+     */
+    std::map<std::string, bool> extractMany(const std::map<std::string, std::string>& files,
+                                            const unsigned int threads = 0);
+  protected:
+    /** \brief Fills the list of archive entries.
+     *
+     * \remarks Uncompressed archives in files or in memory are listed by
+     *          reading only the headers with pread(). Archives with features
+     *          that the native reader does not support, e.g. sparse files,
+     *          compressed archives and archives from streams are listed with
+     *          libarchive.
+     */
+    void fillEntries() override;
+
+
+    /** \brief Checks whether reading can start at the header of any entry.
+     *
+     * \return Returns true for uncompressed tar files, because every entry
+     *         starts with its own header. Returns false for compressed ones.
+     */
+    bool supportsHeaderSeek() const override;
+
+
+    /** \brief Opens the archive handle on the source of the archive data.
+     *
+     * \param offset  byte offset where reading shall start
+     * \return Returns the status code of libarchive, i.e. ARCHIVE_OK in case
+     *         of success.
+     * \remarks Compressed files and memory buffers are decompressed by a
+     *          readAhead instance, which can only start at offset zero.
+     */
+    int openSource(const int64_t offset = 0) override;
   private:
+    /** \brief result of copyEntry()
+     */
+    enum class copyResult
+    {
+      copied, /**< the data was copied to the destination */
+      failed, /**< the entry was found, but copying failed */
+      unsupported /**< the entry has to be extracted by libarchive */
+    };
+
+
     /** \brief Apply format support for tar.
      */
     void applyFormats();
+
+
+    /** \brief Finds out whether the archive data is compressed.
+     *
+     * \param head  the first bytes of the archive
+     * \param size  number of bytes in head
+     * \remarks Sets m_compression.
+     */
+    void detectCompression(const void* head, const std::size_t size);
+
+
+    /** \brief Gets a callback that reads the archive data.
+     *
+     * \param fd  file descriptor of the archive file, ignored for archives
+     *            in memory
+     * \return Returns the callback.
+     */
+    CompressedReader dataReader(const int fd) const;
+
+
+    /** \brief Copies the data of a regular file without libarchive.
+     *
+     * \param fd            file descriptor of the archive file, or -1 for
+     *                      archives in memory
+     * \param idx           position of the entry in m_entries
+     * \param destFileName  the destination file name - file must not exist yet
+     * \return Returns the result of the copy.
+     */
+    copyResult copyEntry(const int fd, const std::size_t idx, const std::string& destFileName) const;
+
+
+    libstriezel::archive::format m_compression; /**< format::gzip or format::xz for compressed files, format::unknown otherwise */
+    std::unique_ptr<libstriezel::archive::readAhead> m_readAhead; /**< decompressor of compressed files */
 };
 
 } // namespace
@@ -0,0 +1,305 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "headers.hpp"
+#include <cstdlib>
+#include <cstring>
+
+namespace libstriezel::tar
+{
+
+namespace
+{
+
+using libstriezel::archive::readFull;
+
+/// size of a tar block
+const int64_t blockSize = 512;
+
+/// largest pax header or GNU long name that is accepted
+const int64_t maximumExtensionSize = 1024 * 1024;
+
+/// maximum number of pax and long name headers before the header of an entry
+const unsigned int maximumExtensions = 16;
+
+/* Rounds a size up to a multiple of the block size. */
+int64_t padded(const int64_t size)
+{
+  return (size + blockSize - 1) / blockSize * blockSize;
+}
+
+/* Gets a string field that is terminated by NUL or by its end. */
+std::string field(const char* block, const std::size_t offset, const std::size_t length)
+{
+  const char * start = block + offset;
+  const void * nul = std::memchr(start, '\0', length);
+  return std::string(start, (nul != nullptr) ? static_cast<const char*>(nul) - start : length);
+}
+
+/* Parses a numeric field: octal digits, or base-256 for large values like
+   GNU tar and star write them. Returns -1 for invalid or negative values. */
+int64_t number(const char* block, const std::size_t offset, const std::size_t length)
+{
+  const unsigned char * p = reinterpret_cast<const unsigned char*>(block + offset);
+  if ((p[0] & 0x80) != 0)
+  {
+    // negative base-256 numbers are not supported
+    if ((p[0] & 0x40) != 0)
+      return -1;
+    uint64_t value = p[0] & 0x3F;
+    for (std::size_t i = 1; i < length; ++i)
+    {
+      if (value > (static_cast<uint64_t>(INT64_MAX) >> 8))
+        return -1;
+      value = (value << 8) | p[i];
+    }
+    return static_cast<int64_t>(value);
+  }
+  std::size_t i = 0;
+  while ((i < length) && ((p[i] == ' ') || (p[i] == '\0')))
+    ++i;
+  int64_t value = 0;
+  for (; (i < length) && (p[i] >= '0') && (p[i] <= '7'); ++i)
+  {
+    if (value > (INT64_MAX >> 3))
+      return -1;
+    value = (value << 3) | (p[i] - '0');
+  }
+  return value;
+}
+
+/* Checks the checksum of a header. Some old tar programs summed up signed
+   bytes, so both variants are accepted. */
+bool checksumMatches(const char* block)
+{
+  const int64_t expected = number(block, 148, 8);
+  int64_t unsignedSum = 0;
+  int64_t signedSum = 0;
+  for (int64_t i = 0; i < blockSize; ++i)
+  {
+    const char c = ((i >= 148) && (i < 156)) ? ' ' : block[i];
+    unsignedSum += static_cast<unsigned char>(c);
+    signedSum += static_cast<signed char>(c);
+  }
+  return (expected == unsignedSum) || (expected == signedSum);
+}
+
+/// values of a pax extended header that matter for the listing
+struct paxValues
+{
+  std::string path;
+  bool hasPath = false;
+  int64_t size = -1;
+  bool hasTime = false;
+  std::time_t m_time = 0;
+  bool unsupported = false;
+};
+
+/* Parses the records of a pax header: "<length> <key>=<value>\n". If global
+   is true, only comments are accepted, because libarchive ignores the rest
+   of global headers in a way that is hard to reproduce. */
+void parsePax(const std::string& data, const bool global, paxValues& values)
+{
+  std::size_t pos = 0;
+  while (pos < data.size())
+  {
+    std::size_t i = pos;
+    std::size_t length = 0;
+    while ((i < data.size()) && (data[i] >= '0') && (data[i] <= '9') && (length < data.size()))
+    {
+      length = length * 10 + static_cast<std::size_t>(data[i] - '0');
+      ++i;
+    }
+    // Padding with NUL bytes ends the records.
+    if ((length == 0) && (i < data.size()) && (data[i] == '\0'))
+      return;
+    if ((i >= data.size()) || (data[i] != ' ') || (length == 0) || (pos + length > data.size())
+        || (data[pos + length - 1] != '\n'))
+    {
+      values.unsupported = true;
+      return;
+    }
+    const std::string record = data.substr(i + 1, pos + length - 1 - (i + 1));
+    pos += length;
+    const std::size_t equals = record.find('=');
+    if (equals == std::string::npos)
+    {
+      values.unsupported = true;
+      return;
+    }
+    const std::string key = record.substr(0, equals);
+    const std::string value = record.substr(equals + 1);
+    if (global)
+    {
+      if (key != "comment")
+        values.unsupported = true;
+    }
+    else if (key == "path")
+    {
+      values.path = value;
+      values.hasPath = true;
+    }
+    else if (key == "size")
+    {
+      char * end = nullptr;
+      values.size = std::strtoll(value.c_str(), &end, 10);
+      if ((end == value.c_str()) || (values.size < 0))
+        values.unsupported = true;
+    }
+    else if (key == "mtime")
+    {
+      values.m_time = static_cast<std::time_t>(std::strtoll(value.c_str(), nullptr, 10));
+      values.hasTime = true;
+    }
+    // sparse files need libarchive
+    else if (key.compare(0, 10, "GNU.sparse") == 0)
+      values.unsupported = true;
+  }
+}
+
+} // anonymous namespace
+
+headerResult readHeader(const CompressedReader& reader, const int64_t offset, header& result)
+{
+  char block[blockSize];
+  std::string longName;
+  bool hasLongName = false;
+  paxValues pax;
+  int64_t position = offset;
+  for (unsigned int extension = 0; extension <= maximumExtensions; ++extension)
+  {
+    const int64_t bytesRead = readFull(reader, position, block, sizeof(block));
+    if ((bytesRead == 0) && (extension == 0))
+      return headerResult::end;
+    if (bytesRead != blockSize)
+      return headerResult::unsupported;
+    bool zero = true;
+    for (const char c : block)
+    {
+      if (c != '\0')
+      {
+        zero = false;
+        break;
+      }
+    }
+    if (zero)
+      return (extension == 0) ? headerResult::end : headerResult::unsupported;
+    if (!checksumMatches(block))
+      return headerResult::unsupported;
+
+    const char type = block[156];
+    const int64_t size = number(block, 124, 12);
+    if (size < 0)
+      return headerResult::unsupported;
+    position += blockSize;
+
+    if ((type == 'L') || (type == 'K') || (type == 'x') || (type == 'g'))
+    {
+      if (size > maximumExtensionSize)
+        return headerResult::unsupported;
+      std::string data(static_cast<std::size_t>(size), '\0');
+      if (readFull(reader, position, &data[0], data.size()) != size)
+        return headerResult::unsupported;
+      position += padded(size);
+      if (type == 'L')
+      {
+        longName = data.substr(0, data.find('\0'));
+        hasLongName = true;
+      }
+      else if (type == 'x')
+        parsePax(data, false, pax);
+      else if (type == 'g')
+      {
+        paxValues global;
+        parsePax(data, true, global);
+        pax.unsupported = pax.unsupported || global.unsupported;
+      }
+      // 'K' is the long name of a link target, which is not listed.
+      if (pax.unsupported)
+        return headerResult::unsupported;
+      continue;
+    }
+
+    const bool regular = (type == '0') || (type == '\0') || (type == '7');
+    if (!regular && ((type < '1') || (type > '6')))
+      return headerResult::unsupported;
+    // libarchive has special rules for links and directories with data,
+    // which are left to it.
+    const int64_t dataSize = (pax.size >= 0) ? pax.size : size;
+    if (!regular && (dataSize != 0))
+      return headerResult::unsupported;
+
+    if (pax.hasPath)
+      result.name = pax.path;
+    else if (hasLongName)
+      result.name = longName;
+    else
+    {
+      result.name = field(block, 0, 100);
+      // POSIX ustar splits long names into prefix and name, GNU tar uses
+      // that part of the header for other data.
+      if ((std::memcmp(block + 257, "ustar\0", 6) == 0) && (block[345] != '\0'))
+        result.name = field(block, 345, 155) + "/" + result.name;
+    }
+    if (result.name.empty())
+      return headerResult::unsupported;
+    result.headerOffset = offset;
+    result.dataOffset = position;
+    result.size = dataSize;
+    result.m_time = pax.hasTime ? pax.m_time : static_cast<std::time_t>(number(block, 136, 12));
+    // Old tar programs mark directories by a trailing slash only.
+    result.directory = (type == '5') || (regular && (result.name.back() == '/'));
+    if (result.directory && (dataSize != 0))
+      return headerResult::unsupported;
+    result.symLink = type == '2';
+    result.plain = regular && !result.directory;
+    return headerResult::entry;
+  }
+  return headerResult::unsupported;
+}
+
+int64_t nextHeader(const header& entry)
+{
+  return entry.dataOffset + padded(entry.size);
+}
+
+bool readHeaders(const CompressedReader& reader, std::vector<header>& entries)
+{
+  entries.clear();
+  int64_t offset = 0;
+  while (true)
+  {
+    header entry;
+    switch (readHeader(reader, offset, entry))
+    {
+      case headerResult::entry:
+           offset = nextHeader(entry);
+           entries.push_back(std::move(entry));
+           break;
+      case headerResult::end:
+           return true;
+      case headerResult::unsupported:
+           entries.clear();
+           return false;
+    }
+  }
+}
+
+} // namespace
@@ -0,0 +1,96 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_TAR_HEADERS_HPP
+#define LIBSTRIEZEL_TAR_HEADERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+#include "../compressedReader.hpp"
+
+namespace libstriezel::tar
+{
+
+using libstriezel::archive::CompressedReader;
+
+
+/** \brief an entry of a tar archive, as described by its headers
+ */
+struct header
+{
+  std::string name; /**< path of the entry */
+  int64_t headerOffset; /**< offset of the first header of the entry, including pax and GNU long name headers */
+  int64_t dataOffset; /**< offset of the data of the entry */
+  int64_t size; /**< size of the data in bytes */
+  std::time_t m_time; /**< modification time */
+  bool directory; /**< whether the entry is a directory */
+  bool symLink; /**< whether the entry is a symbolic link */
+  bool plain; /**< whether the entry is a regular file whose data is stored as a whole at dataOffset */
+};
+
+
+/** \brief result of readHeader()
+ */
+enum class headerResult
+{
+  entry, /**< an entry was read */
+  end, /**< the end of the archive was reached */
+  unsupported /**< the headers are damaged or use features that only libarchive supports */
+};
+
+
+/** \brief Reads the headers of the entry at the given offset.
+ *
+ * \param reader  callback that reads the archive data
+ * \param offset  offset of the first header of the entry - a multiple of 512
+ * \param result  receives the entry
+ * \return Returns headerResult::entry, if an entry was read. The next entry
+ *         starts after its data, see nextHeader().
+ * \remarks ustar, pax and GNU tar archives are supported, including long
+ *          names. Sparse files, multi-volume archives and volume labels are
+ *          not supported.
+ */
+headerResult readHeader(const CompressedReader& reader, const int64_t offset, header& result);
+
+
+/** \brief Gets the offset of the entry after the given one.
+ *
+ * \param entry  an entry that was read by readHeader()
+ * \return Returns the offset of the first header of the next entry.
+ */
+int64_t nextHeader(const header& entry);
+
+
+/** \brief Reads the headers of all entries of a tar archive.
+ *
+ * \param reader   callback that reads the archive data
+ * \param entries  receives the entries in the order of the archive
+ * \return Returns true, if all headers were read.
+ *         Returns false, if a header is damaged or unsupported.
+ * \remarks Only the headers are read, the data of the entries is skipped.
+ */
+bool readHeaders(const CompressedReader& reader, std::vector<header>& entries);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_TAR_HEADERS_HPP
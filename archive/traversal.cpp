@@ -0,0 +1,441 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "traversal.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <memory>
+#include <archive.h>
+#include <archive_entry.h>
+#include "entryLibarchive.hpp"
+#include "format.hpp"
+#include "signatures.hpp"
+
+namespace libstriezel::archive
+{
+
+traversalLimits::traversalLimits()
+: maxDepth(8),
+  maxBufferSize(64 * 1024 * 1024),
+  maxTotalSize(UINT64_C(1024) * 1024 * 1024)
+{
+}
+
+namespace
+{
+
+/// result of the traversal of a single archive
+enum class traversalStatus { complete, damaged, stopped };
+
+/// state that is shared by all levels of the traversal
+struct Traversal
+{
+  const traversalLimits& limits; /**< the limits of the traversal */
+  const TraversalCallback& callback; /**< callback for found entries */
+  std::vector<std::string> path; /**< names of the entries on the way to the current archive */
+  uint64_t totalSize; /**< number of bytes that have been decompressed so far */
+  bool limitExceeded; /**< whether the total size limit has been exceeded */
+};
+
+/// state of a reader that gets the nested archive from its containing archive
+struct ChainReader
+{
+  Traversal * traversal; /**< the traversal */
+  struct ::archive * parent; /**< the archive that contains the nested archive */
+  const std::vector<char> * prefix; /**< data that was read from the parent before */
+  bool prefixDelivered; /**< whether the prefix has been passed on already */
+  char buffer[65536]; /**< buffer for data that is passed to libarchive */
+};
+
+/* Checks whether the traversal can enter archives of the given format.
+   libunshield can only open files, so InstallShield cabinets are left out. */
+bool canEnter(const format type)
+{
+  return (type != format::unknown) && (type != format::installShield);
+}
+
+bool applyFormat(struct ::archive * a, const format type)
+{
+  int ret = ARCHIVE_FATAL;
+  switch (type)
+  {
+    case format::sevenZip:
+         ret = archive_read_support_format_7zip(a);
+         break;
+    case format::ar:
+         ret = archive_read_support_format_ar(a);
+         break;
+    case format::cab:
+         ret = archive_read_support_format_cab(a);
+         break;
+    case format::iso9660:
+         ret = archive_read_support_format_iso9660(a);
+         break;
+    case format::rar:
+         ret = archive_read_support_format_rar(a);
+         break;
+    case format::tar:
+         ret = archive_read_support_format_tar(a);
+         if (ret == ARCHIVE_OK)
+           ret = archive_read_support_format_gnutar(a);
+         break;
+    case format::zip:
+         ret = archive_read_support_format_zip(a);
+         break;
+    // Single-file formats have one entry with the decompressed data.
+    case format::gzip:
+         ret = archive_read_support_filter_gzip(a);
+         if ((ret == ARCHIVE_OK) || (ret == ARCHIVE_WARN))
+           ret = archive_read_support_format_raw(a);
+         break;
+    case format::xz:
+         ret = archive_read_support_filter_xz(a);
+         if ((ret == ARCHIVE_OK) || (ret == ARCHIVE_WARN))
+           ret = archive_read_support_format_raw(a);
+         break;
+    case format::installShield:
+    case format::unknown:
+         break;
+  }
+  return ret == ARCHIVE_OK;
+}
+
+/* Gets the name of the data entry of a gzip or xz file, using the same rules
+   as the gzip and xz archive classes do. */
+std::string dataEntryName(const std::string& containerName)
+{
+  entry helper;
+  helper.setName(containerName);
+  const std::string n = helper.basename();
+  const std::string::size_type len = n.size();
+  if ((len > 3) && ((n.substr(len-3, 3) == ".gz") || (n.substr(len-3, 3) == ".xz")
+      || (n.substr(len-3, 3) == ".XZ")))
+    return n.substr(0, len-3);
+  if ((len > 4) && ((n.substr(len-4, 4) == ".tgz") || (n.substr(len-4, 4) == ".txz")))
+    return n.substr(0, len-4) + ".tar";
+  if ((len > 5) && (n.substr(len-5, 5) == ".svgz"))
+    return n.substr(0, len-1);
+  return "data";
+}
+
+std::string joinPath(const std::vector<std::string>& path)
+{
+  std::string result;
+  for (const auto& element : path)
+  {
+    if (!result.empty())
+      result += " -> ";
+    result += element;
+  }
+  return result;
+}
+
+/* Reads data of the current entry of an archive and adds it to the total
+   size. Returns -1, if an error occurred or the limit is exceeded. */
+la_ssize_t readCounted(Traversal& t, struct ::archive * a, void * buffer, const std::size_t size)
+{
+  if (t.limitExceeded)
+    return -1;
+  const la_ssize_t bytesRead = archive_read_data(a, buffer, size);
+  if (bytesRead <= 0)
+    return bytesRead;
+  t.totalSize += static_cast<uint64_t>(bytesRead);
+  if (t.totalSize > t.limits.maxTotalSize)
+  {
+    std::cerr << "libstriezel::archive::traverse: error: More than "
+              << t.limits.maxTotalSize << " bytes would have to be decompressed!"
+              << std::endl;
+    t.limitExceeded = true;
+    return -1;
+  }
+  return bytesRead;
+}
+
+/* Reads data of the current entry of an archive until the buffer holds size
+   bytes or the entry ends. Returns false, if an error occurred. */
+bool readHead(Traversal& t, struct ::archive * a, std::vector<char>& data, const std::size_t size)
+{
+  std::size_t filled = data.size();
+  data.resize(size);
+  la_ssize_t bytesRead = 1;
+  while ((filled < size) && (bytesRead > 0))
+  {
+    bytesRead = readCounted(t, a, data.data() + filled, size - filled);
+    if (bytesRead > 0)
+      filled += static_cast<std::size_t>(bytesRead);
+  }
+  data.resize(filled);
+  return bytesRead >= 0;
+}
+
+/* Checks whether an entry may be an ISO 9660 image, that is whether it is
+   large enough to hold the volume descriptor or has the name of an image.
+   Other entries do not need to be read that far. */
+bool mayBeISO9660(struct archive_entry * ent, const std::string& name)
+{
+  if (archive_entry_size_is_set(ent)
+      && (archive_entry_size(ent) >= static_cast<int64_t>(signatures::headSize)))
+    return true;
+  const std::string::size_type len = name.size();
+  return (len > 4) && ((name.substr(len-4, 4) == ".iso") || (name.substr(len-4, 4) == ".ISO"));
+}
+
+la_ssize_t chainRead(struct ::archive * a, void * clientData, const void ** buffer)
+{
+  ChainReader * reader = static_cast<ChainReader*>(clientData);
+  if (!reader->prefixDelivered)
+  {
+    reader->prefixDelivered = true;
+    if (!reader->prefix->empty())
+    {
+      *buffer = reader->prefix->data();
+      return static_cast<la_ssize_t>(reader->prefix->size());
+    }
+  }
+  const la_ssize_t bytesRead = readCounted(*reader->traversal, reader->parent,
+                                           reader->buffer, sizeof(reader->buffer));
+  if (bytesRead < 0)
+  {
+    archive_set_error(a, EIO, "Read error in containing archive");
+    return -1;
+  }
+  *buffer = reader->buffer;
+  return bytesRead;
+}
+
+traversalStatus traverseArchive(Traversal& t, struct ::archive * a, const std::string& containerName,
+                                const unsigned int depth);
+
+/* Enters the nested archive whose head has been read from the current entry
+   of the parent archive already. */
+traversalStatus enterNested(Traversal& t, struct ::archive * parent, struct archive_entry * ent,
+                            const format type, std::vector<char>& data, const unsigned int depth)
+{
+  const std::string name = t.path.back();
+  /* ZIP and 7z files need random access, so they have to be in memory
+     completely. Large ZIP files can still be read as stream. */
+  bool inMemory = false;
+  if ((type == format::zip) || (type == format::sevenZip))
+  {
+    const bool tooLarge = archive_entry_size_is_set(ent)
+        && (archive_entry_size(ent) > static_cast<int64_t>(t.limits.maxBufferSize));
+    while (!tooLarge && (data.size() <= t.limits.maxBufferSize))
+    {
+      const std::size_t filled = data.size();
+      data.resize(filled + 65536);
+      const la_ssize_t bytesRead = readCounted(t, parent, data.data() + filled, 65536);
+      data.resize(filled + std::max<la_ssize_t>(bytesRead, 0));
+      if (bytesRead < 0)
+        return t.limitExceeded ? traversalStatus::stopped : traversalStatus::damaged;
+      if (bytesRead == 0)
+      {
+        inMemory = true;
+        break;
+      }
+    } // while
+    if (!inMemory && (type == format::sevenZip))
+    {
+      std::cerr << "libstriezel::archive::traverse: warning: " << joinPath(t.path)
+                << " is larger than " << t.limits.maxBufferSize
+                << " bytes and will not be entered!" << std::endl;
+      return traversalStatus::complete;
+    }
+  }
+
+  struct ::archive * nested = archive_read_new();
+  if (nullptr == nested)
+  {
+    std::cerr << "libstriezel::archive::traverse: error: Could not allocate archive structure!" << std::endl;
+    return traversalStatus::damaged;
+  }
+  std::unique_ptr<ChainReader> reader;
+  int ret = ARCHIVE_FATAL;
+  if (applyFormat(nested, type))
+  {
+    if (inMemory)
+      ret = archive_read_open_memory(nested, data.data(), data.size());
+    else
+    {
+      reader.reset(new ChainReader);
+      reader->traversal = &t;
+      reader->parent = parent;
+      reader->prefix = &data;
+      reader->prefixDelivered = false;
+      ret = archive_read_open2(nested, reader.get(), nullptr, chainRead, nullptr, nullptr);
+    }
+  }
+  traversalStatus status = traversalStatus::damaged;
+  if (ret == ARCHIVE_OK)
+    status = traverseArchive(t, nested, name, depth);
+  archive_read_free(nested);
+  if (t.limitExceeded)
+    return traversalStatus::stopped;
+  if (status == traversalStatus::damaged)
+  {
+    std::cerr << "libstriezel::archive::traverse: warning: Nested archive "
+              << joinPath(t.path) << " could not be read completely!" << std::endl;
+  }
+  return status;
+}
+
+traversalStatus visitEntry(Traversal& t, struct ::archive * a, struct archive_entry * ent,
+                           const std::string& containerName, const unsigned int depth)
+{
+  nestedEntry record;
+  record.info = entryLibarchive(ent);
+  if (archive_format(a) == ARCHIVE_FORMAT_RAW)
+  {
+    record.info.setName(dataEntryName(containerName));
+    if (!archive_entry_size_is_set(ent))
+      record.info.setSize(-1);
+  }
+
+  // The magic bytes at the start are enough to recognize most nested archives.
+  std::vector<char> data;
+  format type = format::unknown;
+  if ((depth < t.limits.maxDepth) && (archive_entry_filetype(ent) == AE_IFREG))
+  {
+    bool readable = readHead(t, a, data, signatures::magicSize);
+    if (readable)
+      type = detectFormat(data.data(), data.size());
+    // Only the signature of ISO 9660 images is further behind.
+    if (readable && (type == format::unknown) && (data.size() == signatures::magicSize)
+        && mayBeISO9660(ent, record.info.name()))
+    {
+      readable = readHead(t, a, data, signatures::headSize);
+      if (readable)
+        type = detectFormat(data.data(), data.size());
+    }
+    if (t.limitExceeded)
+      return traversalStatus::stopped;
+  }
+
+  record.isArchive = canEnter(type);
+  t.path.push_back(record.info.name());
+  record.path = t.path;
+  traversalStatus status = traversalStatus::complete;
+  if (!t.callback(record))
+    status = traversalStatus::stopped;
+  else if (record.isArchive)
+  {
+    status = enterNested(t, a, ent, type, data, depth + 1);
+    // A damaged nested archive does not affect the containing archive.
+    if (status == traversalStatus::damaged)
+      status = traversalStatus::complete;
+  }
+  t.path.pop_back();
+  return status;
+}
+
+traversalStatus traverseArchive(Traversal& t, struct ::archive * a, const std::string& containerName,
+                                const unsigned int depth)
+{
+  struct archive_entry * ent = nullptr;
+  unsigned int retryCount = 0;
+  while (true)
+  {
+    const int ret = archive_read_next_header(a, &ent);
+    if ((ret == ARCHIVE_OK) || (ret == ARCHIVE_WARN))
+    {
+      const traversalStatus status = visitEntry(t, a, ent, containerName, depth);
+      if (status != traversalStatus::complete)
+        return status;
+    }
+    else if (ret == ARCHIVE_EOF)
+      return traversalStatus::complete;
+    else if (ret == ARCHIVE_RETRY)
+    {
+      ++retryCount;
+      if (retryCount >= 100)
+        return traversalStatus::damaged;
+    }
+    else
+    {
+      // May be ARCHIVE_FATAL or similar.
+      return traversalStatus::damaged;
+    }
+  } // while
+}
+
+/* Traverses the outermost archive. The data is either given by a file name or
+   by a memory buffer. */
+bool traverseTopLevel(const std::string& fileName, const void* data, const std::size_t size,
+                      const traversalLimits& limits, const TraversalCallback& callback)
+{
+  const format type = (nullptr == data) ? detectFormat(fileName) : detectFormat(data, size);
+  const std::string name = (nullptr == data) ? fileName : std::string("archive data");
+  if (!canEnter(type))
+  {
+    std::cerr << "libstriezel::archive::traverse: error: " << name
+              << " is not an archive of a supported format!" << std::endl;
+    return false;
+  }
+
+  struct ::archive * a = archive_read_new();
+  if (nullptr == a)
+  {
+    std::cerr << "libstriezel::archive::traverse: error: Could not allocate archive structure!" << std::endl;
+    return false;
+  }
+  int ret = ARCHIVE_FATAL;
+  if (applyFormat(a, type))
+  {
+    if (nullptr == data)
+      ret = archive_read_open_filename(a, fileName.c_str(), 16384);
+    else
+      ret = archive_read_open_memory(a, data, size);
+  }
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(a);
+    std::cerr << "libstriezel::archive::traverse: error: Could not open " << name << "!" << std::endl;
+    return false;
+  }
+
+  Traversal t { limits, callback, std::vector<std::string>(), 0, false };
+  const traversalStatus status = traverseArchive(t, a, (nullptr == data) ? fileName : std::string(), 0);
+  archive_read_free(a);
+  if (status == traversalStatus::damaged)
+  {
+    std::cerr << "libstriezel::archive::traverse: error: " << name
+              << " could not be read completely!" << std::endl;
+  }
+  return status == traversalStatus::complete;
+}
+
+} // anonymous namespace
+
+bool traverse(const std::string& fileName, const traversalLimits& limits, const TraversalCallback& callback)
+{
+  return traverseTopLevel(fileName, nullptr, 0, limits, callback);
+}
+
+bool traverse(const void* data, const std::size_t size, const traversalLimits& limits, const TraversalCallback& callback)
+{
+  if (nullptr == data)
+  {
+    std::cerr << "libstriezel::archive::traverse: error: Archive data must not be null!" << std::endl;
+    return false;
+  }
+  return traverseTopLevel(std::string(), data, size, limits, callback);
+}
+
+} // namespace
@@ -0,0 +1,101 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_TRAVERSAL_HPP
+#define LIBSTRIEZEL_ARCHIVE_TRAVERSAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "entry.hpp"
+
+namespace libstriezel::archive
+{
+
+/** \brief limits for the traversal of nested archives
+ */
+struct traversalLimits
+{
+  /** \brief constructor that sets the default limits
+   */
+  traversalLimits();
+
+  unsigned int maxDepth; /**< number of nesting levels below the outermost archive that are entered */
+  std::size_t maxBufferSize; /**< maximum size of a nested archive that is held in memory */
+  uint64_t maxTotalSize; /**< maximum number of bytes that are decompressed in total */
+};
+
+
+/** \brief record for an entry that was found during the traversal
+ */
+struct nestedEntry
+{
+  std::vector<std::string> path; /**< names of the containing entries, outermost first, the last element is the name of the entry itself */
+  entry info; /**< the entry as reported by the archive that contains it */
+  bool isArchive; /**< whether the entry is an archive that is entered next */
+};
+
+
+/** \brief callback that receives the entries of the traversal
+ *
+ * The callback returns true to continue the traversal, or false to stop it.
+ */
+typedef std::function<bool(const nestedEntry& record)> TraversalCallback;
+
+
+/** \brief Lists all entries of an archive, including the entries of all
+ * archives that are nested inside of it.
+ *
+ * \param fileName  name of the archive file
+ * \param limits    limits for nesting depth and sizes
+ * \param callback  function that gets called for every entry
+ * \return Returns true, if the traversal was completed.
+ *         Returns false, if the archive could not be read, a size limit was
+ *         exceeded or the callback stopped the traversal.
+ * \remarks Nested archives are never written to disk. Most formats are read
+ *          straight from the decompression stream of the containing archive.
+ *          ZIP and 7z need random access, so they are read into a buffer,
+ *          if they fit into maxBufferSize. Larger ZIP files are read as stream
+ *          instead, larger 7z files are not entered. Damaged nested archives
+ *          are reported on std::cerr, but do not stop the traversal.
+ *          InstallShield cabinets are never entered.
+ */
+bool traverse(const std::string& fileName, const traversalLimits& limits, const TraversalCallback& callback);
+
+
+/** \brief Lists all entries of an archive in memory, including the entries of
+ * all archives that are nested inside of it.
+ *
+ * \param data      pointer to the start of the archive data
+ * \param size      size of the archive data in bytes
+ * \param limits    limits for nesting depth and sizes
+ * \param callback  function that gets called for every entry
+ * \return Returns true, if the traversal was completed.
+ *         Returns false, if the archive could not be read, a size limit was
+ *         exceeded or the callback stopped the traversal.
+ * \remarks See traverse() for files for details.
+ */
+bool traverse(const void* data, const std::size_t size, const traversalLimits& limits, const TraversalCallback& callback);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_TRAVERSAL_HPP
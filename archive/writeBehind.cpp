@@ -0,0 +1,278 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "writeBehind.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#if defined(_WIN32)
+  #include <io.h>
+  #include <sys/stat.h>
+#else
+  #include <climits>
+  #include <sys/uio.h>
+  #include <unistd.h>
+#endif
+
+namespace libstriezel::archive
+{
+
+namespace
+{
+
+/// smallest buffer for files that are written without a separate thread
+const std::size_t minimumBufferSize = 64 * 1024;
+
+} // anonymous namespace
+
+writeBehind::writeBehind(const std::size_t bufferSize, const std::size_t bufferCount)
+: m_bufferSize(std::max(bufferSize, minimumBufferSize)),
+  m_bufferCount(std::max<std::size_t>(bufferCount, 2)),
+  m_capacity(0),
+  m_buffers(std::vector<std::unique_ptr<char[]> >()),
+  m_fill(std::vector<std::size_t>()),
+  m_current(0),
+  m_head(0),
+  m_queued(0),
+  m_fd(-1),
+  m_offset(0),
+  m_pipelined(false),
+  m_done(false),
+  m_failed(false),
+  m_mutex(),
+  m_condition(),
+  m_writer()
+{
+}
+
+writeBehind::~writeBehind()
+{
+  stop();
+}
+
+bool writeBehind::open(const std::string& fileName, const int64_t expectedSize)
+{
+  if (m_fd >= 0)
+    return false;
+  #if defined(_WIN32)
+  m_fd = _open(fileName.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+  #else
+  m_fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+  #endif
+  if (m_fd < 0)
+    return false;
+
+  #if defined(__linux__)
+  // Reserving the space at once avoids fragmentation. The file keeps its
+  // size, so a wrong guess does no harm.
+  if (expectedSize > 0)
+    fallocate(m_fd, FALLOC_FL_KEEP_SIZE, 0, expectedSize);
+  #endif
+
+  const int64_t pipelineSize = 2 * static_cast<int64_t>(m_bufferSize);
+  m_pipelined = (expectedSize < 0) || (expectedSize >= pipelineSize);
+  std::size_t count = m_bufferCount;
+  m_capacity = m_bufferSize;
+  if (!m_pipelined)
+  {
+    count = 1;
+    // Small files do not need a large buffer.
+    m_capacity = std::min(m_bufferSize, std::max(minimumBufferSize, static_cast<std::size_t>(expectedSize)));
+  }
+  m_buffers.clear();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    m_buffers.push_back(std::unique_ptr<char[]>(new char[m_capacity]));
+  }
+  m_fill.assign(count, 0);
+  m_current = 0;
+  m_head = 0;
+  m_queued = 0;
+  m_offset = 0;
+  m_done = false;
+  m_failed = false;
+  if (m_pipelined)
+    m_writer = std::thread(&writeBehind::run, this);
+  return true;
+}
+
+char * writeBehind::data()
+{
+  return m_buffers[m_current].get() + m_fill[m_current];
+}
+
+std::size_t writeBehind::space() const
+{
+  return m_capacity - m_fill[m_current];
+}
+
+bool writeBehind::produced(const std::size_t bytes)
+{
+  m_fill[m_current] += bytes;
+  if (m_fill[m_current] < m_capacity)
+    return true;
+  return submit();
+}
+
+bool writeBehind::submit()
+{
+  if (!m_pipelined)
+  {
+    if (!writeBuffers(0, 1))
+      m_failed = true;
+    m_fill[0] = 0;
+    return !m_failed;
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  ++m_queued;
+  m_condition.notify_all();
+  // The next buffer is free once the writer has less than all of them.
+  m_condition.wait(lock, [this]() { return (m_queued < m_buffers.size()) || m_failed; });
+  if (m_failed)
+    return false;
+  m_current = (m_current + 1) % m_buffers.size();
+  m_fill[m_current] = 0;
+  return true;
+}
+
+bool writeBehind::finish()
+{
+  if (m_fd < 0)
+    return false;
+  bool success = true;
+  if (m_fill[m_current] > 0)
+    success = submit();
+  success = stop() && success;
+  return success && !m_failed;
+}
+
+bool writeBehind::stop()
+{
+  if (m_writer.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_done = true;
+    }
+    m_condition.notify_all();
+    m_writer.join();
+  }
+  if (m_fd < 0)
+    return true;
+  #if defined(_WIN32)
+  const bool closed = (_close(m_fd) == 0);
+  #else
+  const bool closed = (close(m_fd) == 0);
+  #endif
+  m_fd = -1;
+  return closed;
+}
+
+void writeBehind::run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true)
+  {
+    m_condition.wait(lock, [this]() { return (m_queued > 0) || m_done; });
+    if (m_queued == 0)
+      return;
+    // All full buffers are written at once.
+    const std::size_t first = m_head;
+    const std::size_t count = m_queued;
+    lock.unlock();
+    const bool success = writeBuffers(first, count);
+    lock.lock();
+    m_head = (m_head + count) % m_buffers.size();
+    m_queued -= count;
+    if (!success)
+      m_failed = true;
+    m_condition.notify_all();
+    if (!success)
+      return;
+  } // while
+}
+
+bool writeBehind::writeBuffers(const std::size_t first, const std::size_t count)
+{
+  #if defined(_WIN32)
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const std::size_t index = (first + i) % m_buffers.size();
+    std::size_t written = 0;
+    while (written < m_fill[index])
+    {
+      const int bytesWritten = _write(m_fd, m_buffers[index].get() + written,
+                                      static_cast<unsigned int>(m_fill[index] - written));
+      if (bytesWritten < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      written += static_cast<std::size_t>(bytesWritten);
+    }
+    m_offset += static_cast<int64_t>(written);
+  }
+  return true;
+  #else
+  std::vector<struct iovec> chunks;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const std::size_t index = (first + i) % m_buffers.size();
+    if (m_fill[index] > 0)
+      chunks.push_back(iovec { m_buffers[index].get(), m_fill[index] });
+  }
+  std::size_t pos = 0;
+  while (pos < chunks.size())
+  {
+    const int chunkCount = static_cast<int>(std::min<std::size_t>(chunks.size() - pos, IOV_MAX));
+    const ssize_t bytesWritten = pwritev(m_fd, chunks.data() + pos, chunkCount, m_offset);
+    if (bytesWritten < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    if (bytesWritten == 0)
+      return false;
+    m_offset += bytesWritten;
+    // A short write leaves the rest of the data for the next call.
+    std::size_t left = static_cast<std::size_t>(bytesWritten);
+    while ((left > 0) && (pos < chunks.size()))
+    {
+      if (left >= chunks[pos].iov_len)
+      {
+        left -= chunks[pos].iov_len;
+        ++pos;
+      }
+      else
+      {
+        chunks[pos].iov_base = static_cast<char*>(chunks[pos].iov_base) + left;
+        chunks[pos].iov_len -= left;
+        left = 0;
+      }
+    } // while
+  } // while
+  return true;
+  #endif
+}
+
+} // namespace
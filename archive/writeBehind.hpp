@@ -0,0 +1,173 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ARCHIVE_WRITEBEHIND_HPP
+#define LIBSTRIEZEL_ARCHIVE_WRITEBEHIND_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace libstriezel::archive
+{
+
+/** \brief writes extracted data to a file on a separate thread
+ *
+ * The data goes into a ring of large buffers. While a decompressor fills one
+ * buffer, a writer thread writes the full ones with as few system calls as
+ * possible, so that decompression and disk writes overlap.
+ * The decompressor writes directly into the buffer returned by data() and
+ * reports the number of bytes with produced():
+ *
+ *     writeBehind writer;
+ *     if (!writer.open(fileName, expectedSize)) ...
+ *     while (...)
+ *       bytes = decompress(writer.data(), writer.space());
+ *       if (!writer.produced(bytes)) ...
+ *     if (!writer.finish()) ...
+ */
+class writeBehind
+{
+  public:
+    /** \brief constructor
+     *
+     * \param bufferSize   size of each buffer in bytes
+     * \param bufferCount  number of buffers in the ring, at least two
+     */
+    writeBehind(const std::size_t bufferSize = 1024 * 1024, const std::size_t bufferCount = 4);
+
+
+    /** \brief destructor - stops the writer thread and closes the file
+     *
+     * \remarks The file is not removed, even if finish() was not called.
+     */
+    ~writeBehind();
+
+
+    /* Delete unwanted default copy constructor, assignment operator and
+       move constructor. */
+    writeBehind(const writeBehind& op) = delete;
+    writeBehind & operator=(const writeBehind& op) = delete;
+    writeBehind(const writeBehind&& op) = delete;
+
+
+    /** \brief Creates the destination file.
+     *
+     * \param fileName      name of the file - it must not exist yet
+     * \param expectedSize  expected size of the data in bytes, or -1, if the
+     *                      size is not known
+     * \return Returns true, if the file was created.
+     *         Returns false, if an error occurred.
+     * \remarks Space for the expected size is reserved on the disk, where
+     *          the file system supports it. Data that is smaller than two
+     *          buffers is written without a separate thread, because the
+     *          thread would cost more than it saves.
+     */
+    bool open(const std::string& fileName, const int64_t expectedSize);
+
+
+    /** \brief Gets the free part of the current buffer.
+     *
+     * \return Returns a pointer to the first free byte of the current buffer.
+     */
+    char * data();
+
+
+    /** \brief Gets the size of the free part of the current buffer.
+     *
+     * \return Returns the number of bytes that can be written to data().
+     *         The value is never zero while the file is open.
+     */
+    std::size_t space() const;
+
+
+    /** \brief Marks bytes in the free part of the current buffer as written.
+     *
+     * \param bytes  number of bytes that were written to data(), at most
+     *               space()
+     * \return Returns true, if the data was accepted.
+     *         Returns false, if writing to the file has failed.
+     */
+    bool produced(const std::size_t bytes);
+
+
+    /** \brief Writes the remaining data and closes the file.
+     *
+     * \return Returns true, if all data was written and the file was closed.
+     *         Returns false, if an error occurred.
+     */
+    bool finish();
+  private:
+    /** \brief Main function of the writer thread.
+     */
+    void run();
+
+
+    /** \brief Writes buffers of the ring to the file.
+     *
+     * \param first  index of the first buffer
+     * \param count  number of consecutive buffers, wrapping around the ring
+     * \return Returns true, if all data was written.
+     *         Returns false, if an error occurred.
+     */
+    bool writeBuffers(const std::size_t first, const std::size_t count);
+
+
+    /** \brief Hands the current buffer over to the writer and gets the next one.
+     *
+     * \return Returns true, if the data was accepted.
+     *         Returns false, if writing to the file has failed.
+     */
+    bool submit();
+
+
+    /** \brief Stops the writer thread and closes the file.
+     *
+     * \return Returns true, if the file was closed without error.
+     */
+    bool stop();
+
+
+    std::size_t m_bufferSize; /**< maximum size of each buffer */
+    std::size_t m_bufferCount; /**< maximum number of buffers in the ring */
+    std::size_t m_capacity; /**< size of each buffer of the current file */
+    std::vector<std::unique_ptr<char[]> > m_buffers; /**< the ring of buffers */
+    std::vector<std::size_t> m_fill; /**< number of bytes in each buffer */
+    std::size_t m_current; /**< index of the buffer that is filled right now */
+    std::size_t m_head; /**< index of the next buffer the writer writes */
+    std::size_t m_queued; /**< number of full buffers that wait for the writer */
+    int m_fd; /**< file descriptor of the destination, or -1 */
+    int64_t m_offset; /**< number of bytes written to the file so far */
+    bool m_pipelined; /**< whether a separate thread writes the data */
+    bool m_done; /**< whether the producer has no more data */
+    bool m_failed; /**< whether writing to the file has failed */
+    std::mutex m_mutex; /**< protects the queue state and m_failed */
+    std::condition_variable m_condition; /**< signals changes of the queue */
+    std::thread m_writer; /**< the writer thread */
+}; // class
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ARCHIVE_WRITEBEHIND_HPP
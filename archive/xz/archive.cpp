@@ -19,17 +19,24 @@
 */
 
 #include "archive.hpp"
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <lzma.h>
 #include "../../filesystem/file.hpp"
+#include "../signatures.hpp"
+#include "../writeBehind.hpp"
 
 namespace libstriezel::xz
 {
 
 archive::archive(const std::string& fileName)
-: archiveLibarchive(fileName)
+: archiveLibarchive(fileName),
+  m_blockIndex(),
+  m_blockIndexRead(false)
 {
   applyFormats();
   const int ret = archive_read_open_filename(m_archive, fileName.c_str(), 4096);
@@ -40,10 +47,46 @@ archive::archive(const std::string& fileName)
     throw std::runtime_error("libstriezel::xz::archive: Failed to open file " + fileName + "!");
   }
   //fill entries
-  fillEntries();
+  listEntries();
   postprocessEntry(fileName);
 }
 
+archive::archive(const void* data, const std::size_t size)
+: archiveLibarchive(data, size),
+  m_blockIndex(),
+  m_blockIndexRead(false)
+{
+  applyFormats();
+  const int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::xz::archive: Failed to open archive from memory!");
+  }
+  //fill entries
+  listEntries();
+  postprocessEntry("data");
+}
+
+archive::archive(libstriezel::archive::seekableStream& stream)
+: archiveLibarchive(stream),
+  m_blockIndex(),
+  m_blockIndexRead(false)
+{
+  applyFormats();
+  const int ret = openSource();
+  if (ret != ARCHIVE_OK)
+  {
+    archive_read_free(m_archive);
+    m_archive = nullptr;
+    throw std::runtime_error("libstriezel::xz::archive: Failed to open archive from stream!");
+  }
+  //fill entries
+  listEntries();
+  postprocessEntry("data");
+}
+
 archive::~archive()
 {
   int ret = archive_read_free(m_archive);
@@ -93,25 +136,9 @@ void archive::applyFormats()
 
 bool archive::isXz(const std::string& fileName)
 {
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
-    return false;
-
-  char start[7];
-  std::memset(start, '\0', 7);
-  stream.read(start, 6);
-  if (!stream.good() || stream.gcount() != 6)
-    return false;
-  stream.close();
-
-  /* See http://tukaani.org/xz/xz-file-format-1.0.4.txt, section 2.1.1.1 for
-     an explanation of the magic bytes in the file header.
-
-     The magic literal for xz is FD 37 7A 58 5A 00 in hexadecimal,
-     or 0xFD, '7', 'z', 'X', 'Z', 0x00 in ASCII.
-  */
-  return (std::string(start, 6) == std::string("\xFD\x37\x7A\x58\x5A\x00", 6));
+  char head[6];
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head, sizeof(head));
+  return libstriezel::archive::signatures::isXz(head, size);
 }
 
 bool archive::extractTo(const std::string& destFileName, const std::string& archiveFilePath)
@@ -123,4 +150,150 @@ bool archive::extractTo(const std::string& destFileName, const std::string& arch
   return extractDataTo(destFileName);
 }
 
+bool archive::extractDataTo(const std::string& destFileName)
+{
+  return extractDataTo(destFileName, 0);
+}
+
+bool archive::extractDataTo(const std::string& destFileName, const unsigned int threads)
+{
+  // A stream has only one read position, and libarchive uses it.
+  if (nullptr != m_stream)
+    return archiveLibarchive::extractDataTo(destFileName);
+
+  /* Check whether destination file already exists, we do not want to overwrite
+     existing files. */
+  if (libstriezel::filesystem::file::exists(destFileName))
+  {
+    std::cerr << "xz::archive::extractDataTo: error: destination file "
+              << destFileName << " already exists!" << std::endl;
+    return false;
+  }
+
+  lzma_stream strm = LZMA_STREAM_INIT;
+  #if LZMA_VERSION >= 50040002
+  // The multi-threaded decoder exists since liblzma 5.4.0.
+  lzma_mt options;
+  std::memset(&options, 0, sizeof(options));
+  options.flags = LZMA_CONCATENATED;
+  options.threads = (threads == 0) ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+  // Fall back to a single thread instead of using more than a quarter of
+  // the memory, but never stop because of the memory usage.
+  const uint64_t memory = lzma_physmem();
+  options.memlimit_threading = (memory > 0) ? memory / 4 : UINT64_MAX;
+  options.memlimit_stop = UINT64_MAX;
+  const lzma_ret initialized = lzma_stream_decoder_mt(&strm, &options);
+  #else
+  (void) threads;
+  const lzma_ret initialized = lzma_stream_decoder(&strm, UINT64_MAX, LZMA_CONCATENATED);
+  #endif
+  if (initialized != LZMA_OK)
+  {
+    std::cerr << "xz::archive::extractDataTo: error: Could not initialize liblzma!" << std::endl;
+    return false;
+  }
+
+  const int64_t expectedSize = loadBlockIndex() ? m_blockIndex.uncompressedSize() : -1;
+  libstriezel::archive::writeBehind destination;
+  if (!destination.open(destFileName, expectedSize))
+  {
+    std::cerr << "xz::archive::extractDataTo: error: destination file "
+              << destFileName << " could not be created/opened for writing!"
+              << std::endl;
+    lzma_end(&strm);
+    return false;
+  }
+
+  const CompressedReader reader = compressedReader();
+  std::vector<uint8_t> input(1024 * 1024);
+  int64_t readPosition = 0;
+  lzma_action action = LZMA_RUN;
+  lzma_ret ret = LZMA_OK;
+  bool success = true;
+  while (ret == LZMA_OK)
+  {
+    if ((strm.avail_in == 0) && (action == LZMA_RUN))
+    {
+      const int64_t bytesRead = reader(readPosition, input.data(), input.size());
+      if (bytesRead < 0)
+      {
+        success = false;
+        break;
+      }
+      // The decoder checks that the data ends after a complete stream.
+      if (bytesRead == 0)
+        action = LZMA_FINISH;
+      strm.next_in = input.data();
+      strm.avail_in = static_cast<std::size_t>(bytesRead);
+      readPosition += bytesRead;
+    }
+    // liblzma decompresses straight into the buffers of the writer.
+    strm.next_out = reinterpret_cast<uint8_t*>(destination.data());
+    strm.avail_out = destination.space();
+    ret = lzma_code(&strm, action);
+    const std::size_t produced = destination.space() - strm.avail_out;
+    if ((produced > 0) && !destination.produced(produced))
+    {
+      success = false;
+      break;
+    }
+  }
+  lzma_end(&strm);
+  if ((ret != LZMA_STREAM_END) || !destination.finish() || !success)
+  {
+    std::cerr << "xz::archive::extractDataTo: error: Could not extract data to file "
+              << destFileName << "." << std::endl;
+    filesystem::file::remove(destFileName);
+    return false;
+  }
+  return true;
+}
+
+int64_t archive::readAt(const int64_t offset, void* buffer, const std::size_t length)
+{
+  if (!loadBlockIndex())
+  {
+    std::cerr << "xz::archive::readAt: error: Could not read the index of the xz data!" << std::endl;
+    return -1;
+  }
+  const int64_t bytesRead = m_blockIndex.read(compressedReader(), offset, buffer, length);
+  // The reader moved the stream, so libarchive has to start over.
+  if (nullptr != m_stream)
+    reopen();
+  return bytesRead;
+}
+
+int64_t archive::uncompressedSize()
+{
+  return loadBlockIndex() ? m_blockIndex.uncompressedSize() : -1;
+}
+
+CompressedReader archive::compressedReader() const
+{
+  return libstriezel::archive::compressedReader(m_fileName, m_data, m_dataSize, m_stream);
+}
+
+bool archive::loadBlockIndex()
+{
+  if (m_blockIndexRead)
+    return m_blockIndex.loaded();
+  m_blockIndexRead = true;
+
+  int64_t size = -1;
+  if (nullptr != m_data)
+    size = static_cast<int64_t>(m_dataSize);
+  else if (nullptr != m_stream)
+    size = m_stream->seek(0, SEEK_END);
+  else
+  {
+    std::ifstream file(m_fileName, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+    if (file.good())
+      size = static_cast<int64_t>(file.tellg());
+  }
+  const bool success = (size > 0) && m_blockIndex.load(compressedReader(), size);
+  if (nullptr != m_stream)
+    reopen();
+  return success;
+}
+
 } // namespace
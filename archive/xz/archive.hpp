@@ -26,6 +26,7 @@
 #include <archive.h>
 #include "../archiveLibarchive.hpp"
 #include "../entryLibarchive.hpp"
+#include "blockIndex.hpp"
 
 namespace libstriezel::xz
 {
@@ -44,6 +45,27 @@ class archive: public libstriezel::archive::archiveLibarchive
     archive(const std::string& fileName);
 
 
+     /** \brief constructor - opens an xz archive in memory in read-only mode
+      *
+      * \param data  pointer to the start of the archive data - the data must
+      *              stay valid as long as the archive object exists
+      * \param size  size of the archive data in bytes
+      * \remarks This function throws an exception, if the data cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(const void* data, const std::size_t size);
+
+
+     /** \brief constructor - opens an xz archive from a stream in read-only mode
+      *
+      * \param stream  the stream that contains the archive - the stream must
+      *                stay valid as long as the archive object exists
+      * \remarks This function throws an exception, if the stream cannot be
+      *          opened as archive or a similar error occurs.
+      */
+    archive(libstriezel::archive::seekableStream& stream);
+
+
     /** \brief destructor
      */
     ~archive();
@@ -73,6 +95,55 @@ class archive: public libstriezel::archive::archiveLibarchive
      *         Returns false, if the extraction failed.
      */
     virtual bool extractTo(const std::string& destFileName, const std::string& archiveFilePath) override;
+
+
+    /** \brief Extracts the uncompressed data to the specified destination.
+     *
+     * \param destFileName  the destination file name - file must not exist yet
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     * \remarks Same as extractDataTo(destFileName, 0).
+     */
+    virtual bool extractDataTo(const std::string& destFileName) override;
+
+
+    /** \brief Extracts the uncompressed data to the specified destination.
+     *
+     * \param destFileName  the destination file name - file must not exist yet
+     * \param threads       number of threads to use, zero means one thread per
+     *                      processor core
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     * \remarks Data in memory or in a file is decompressed by liblzma
+     *          directly. Its decoder uses several threads for files with
+     *          several blocks, e.g. files created by xz -T, if liblzma is
+     *          version 5.4 or later. Data from a stream goes through
+     *          libarchive on a single thread.
+     */
+    bool extractDataTo(const std::string& destFileName, const unsigned int threads);
+
+
+    /** \brief Reads uncompressed data at any offset.
+     *
+     * \param offset  offset in the uncompressed data
+     * \param buffer  the buffer that gets the data
+     * \param length  number of bytes to read
+     * \return Returns the number of bytes that were read, which is less than
+     *         length only at the end of the data. Returns -1, if an error
+     *         occurred.
+     * \remarks The index at the end of the xz data tells which blocks hold
+     *          the requested data, and only those blocks are decompressed.
+     *          Files with a single block are decompressed from the start.
+     */
+    int64_t readAt(const int64_t offset, void* buffer, const std::size_t length);
+
+
+    /** \brief Gets the size of the uncompressed data from the xz index.
+     *
+     * \return Returns the size of the uncompressed data in bytes.
+     *         Returns -1, if the index cannot be read.
+     */
+    int64_t uncompressedSize();
   private:
     /** \brief Apply format support for xz archives.
      */
@@ -81,6 +152,24 @@ class archive: public libstriezel::archive::archiveLibarchive
     /** \brief Smoothen some edges on the entry data.
      */
     void postprocessEntry(const std::string& fileName);
+
+
+    /** \brief Gets a callback that reads the compressed data at any offset.
+     *
+     * \return Returns the callback.
+     */
+    CompressedReader compressedReader() const;
+
+
+    /** \brief Reads the block index, if it has not been read yet.
+     *
+     * \return Returns true, if the index is available.
+     */
+    bool loadBlockIndex();
+
+
+    blockIndex m_blockIndex; /**< index of the blocks, read on first use */
+    bool m_blockIndexRead; /**< whether reading the index has been tried */
 };
 
 } // namespace
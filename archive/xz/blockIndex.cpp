@@ -0,0 +1,241 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "blockIndex.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace libstriezel::xz
+{
+
+namespace
+{
+
+using libstriezel::archive::readFull;
+
+/// size of the chunks of compressed data that are read at once
+const std::size_t chunkBytes = 64 * 1024;
+
+/* Frees the options of the filters that lzma_block_header_decode() allocated. */
+void freeFilters(lzma_filter* filters)
+{
+  for (std::size_t i = 0; filters[i].id != LZMA_VLI_UNKNOWN; ++i)
+  {
+    std::free(filters[i].options);
+    filters[i].options = nullptr;
+  }
+}
+
+} // anonymous namespace
+
+blockIndex::blockIndex()
+: m_index(nullptr)
+{
+}
+
+blockIndex::~blockIndex()
+{
+  lzma_index_end(m_index, nullptr);
+  m_index = nullptr;
+}
+
+bool blockIndex::load(const CompressedReader& reader, const int64_t size)
+{
+  lzma_index_end(m_index, nullptr);
+  m_index = nullptr;
+
+  // The streams are read from the last to the first one, like xz --list.
+  lzma_index * combined = nullptr;
+  int64_t position = size;
+  lzma_vli padding = 0;
+  uint8_t buffer[LZMA_STREAM_HEADER_SIZE];
+  std::vector<uint8_t> indexData;
+  while (position > 0)
+  {
+    if ((position < 2 * LZMA_STREAM_HEADER_SIZE)
+        || (readFull(reader, position - LZMA_STREAM_HEADER_SIZE, buffer, sizeof(buffer)) != static_cast<int64_t>(sizeof(buffer))))
+      break;
+    // Stream padding consists of multiples of four null bytes.
+    if ((buffer[8] == 0) && (buffer[9] == 0) && (buffer[10] == 0) && (buffer[11] == 0))
+    {
+      padding += 4;
+      position -= 4;
+      continue;
+    }
+    lzma_stream_flags footer;
+    if (lzma_stream_footer_decode(&footer, buffer) != LZMA_OK)
+      break;
+    const int64_t indexEnd = position - LZMA_STREAM_HEADER_SIZE;
+    if (footer.backward_size > static_cast<lzma_vli>(indexEnd - LZMA_STREAM_HEADER_SIZE))
+      break;
+    const int64_t indexStart = indexEnd - static_cast<int64_t>(footer.backward_size);
+    indexData.resize(static_cast<std::size_t>(footer.backward_size));
+    if (readFull(reader, indexStart, indexData.data(), indexData.size()) != static_cast<int64_t>(indexData.size()))
+      break;
+    lzma_index * current = nullptr;
+    uint64_t memoryLimit = UINT64_MAX;
+    std::size_t inPosition = 0;
+    if (lzma_index_buffer_decode(&current, &memoryLimit, nullptr, indexData.data(),
+                                 &inPosition, indexData.size()) != LZMA_OK)
+      break;
+    // The blocks are between the stream header and the index.
+    const lzma_vli blocksSize = lzma_index_total_size(current);
+    lzma_stream_flags header;
+    if ((blocksSize + LZMA_STREAM_HEADER_SIZE > static_cast<lzma_vli>(indexStart))
+        || (readFull(reader, indexStart - static_cast<int64_t>(blocksSize) - LZMA_STREAM_HEADER_SIZE,
+                     buffer, sizeof(buffer)) != static_cast<int64_t>(sizeof(buffer)))
+        || (lzma_stream_header_decode(&header, buffer) != LZMA_OK)
+        || (lzma_stream_flags_compare(&header, &footer) != LZMA_OK)
+        || (lzma_index_stream_flags(current, &footer) != LZMA_OK)
+        || (lzma_index_stream_padding(current, padding) != LZMA_OK)
+        || ((nullptr != combined) && (lzma_index_cat(current, combined, nullptr) != LZMA_OK)))
+    {
+      lzma_index_end(current, nullptr);
+      break;
+    }
+    // lzma_index_cat() took over the index of the later streams.
+    combined = current;
+    padding = 0;
+    position = indexStart - static_cast<int64_t>(blocksSize) - LZMA_STREAM_HEADER_SIZE;
+  }
+  // Only a complete chain of streams from the start of the data is valid.
+  if ((position != 0) || (padding != 0) || (nullptr == combined))
+  {
+    lzma_index_end(combined, nullptr);
+    return false;
+  }
+  m_index = combined;
+  return true;
+}
+
+bool blockIndex::loaded() const
+{
+  return nullptr != m_index;
+}
+
+uint64_t blockIndex::blocks() const
+{
+  return (nullptr == m_index) ? 0 : lzma_index_block_count(m_index);
+}
+
+int64_t blockIndex::uncompressedSize() const
+{
+  return (nullptr == m_index) ? -1 : static_cast<int64_t>(lzma_index_uncompressed_size(m_index));
+}
+
+bool blockIndex::readBlock(const CompressedReader& reader, const lzma_index_iter& iter,
+                           uint64_t skip, uint8_t* buffer, const std::size_t length) const
+{
+  const int64_t blockStart = static_cast<int64_t>(iter.block.compressed_file_offset);
+  uint8_t header[LZMA_BLOCK_HEADER_SIZE_MAX];
+  if ((readFull(reader, blockStart, header, 1) != 1) || (header[0] == 0))
+    return false;
+  lzma_filter filters[LZMA_FILTERS_MAX + 1];
+  lzma_block block;
+  block.version = 0;
+  block.check = iter.stream.flags->check;
+  block.filters = filters;
+  block.header_size = lzma_block_header_size_decode(header[0]);
+  if ((readFull(reader, blockStart + 1, header + 1, block.header_size - 1) != static_cast<int64_t>(block.header_size - 1))
+      || (lzma_block_header_decode(&block, nullptr, header) != LZMA_OK))
+    return false;
+  lzma_stream strm = LZMA_STREAM_INIT;
+  const bool ready = (lzma_block_compressed_size(&block, iter.block.unpadded_size) == LZMA_OK)
+                  && (lzma_block_decoder(&strm, &block) == LZMA_OK);
+  freeFilters(filters);
+  if (!ready)
+  {
+    lzma_end(&strm);
+    return false;
+  }
+
+  std::vector<uint8_t> input(chunkBytes);
+  std::vector<uint8_t> discard(skip > 0 ? chunkBytes : 0);
+  int64_t readPosition = blockStart + block.header_size;
+  const int64_t blockEnd = blockStart + static_cast<int64_t>(iter.block.total_size);
+  std::size_t filled = 0;
+  lzma_ret ret = LZMA_OK;
+  while ((filled < length) && (ret == LZMA_OK))
+  {
+    if ((strm.avail_in == 0) && (readPosition < blockEnd))
+    {
+      const std::size_t chunk = static_cast<std::size_t>(std::min<int64_t>(blockEnd - readPosition, input.size()));
+      const int64_t bytesRead = reader(readPosition, input.data(), chunk);
+      if (bytesRead <= 0)
+        break;
+      strm.next_in = input.data();
+      strm.avail_in = static_cast<std::size_t>(bytesRead);
+      readPosition += bytesRead;
+    }
+    if (skip > 0)
+    {
+      strm.next_out = discard.data();
+      strm.avail_out = static_cast<std::size_t>(std::min<uint64_t>(skip, discard.size()));
+    }
+    else
+    {
+      strm.next_out = buffer + filled;
+      strm.avail_out = length - filled;
+    }
+    const std::size_t before = strm.avail_out;
+    ret = lzma_code(&strm, LZMA_RUN);
+    const std::size_t produced = before - strm.avail_out;
+    if (skip > 0)
+      skip -= produced;
+    else
+      filled += produced;
+  }
+  lzma_end(&strm);
+  return filled == length;
+}
+
+int64_t blockIndex::read(const CompressedReader& reader, const int64_t offset,
+                         void* buffer, const std::size_t length) const
+{
+  if ((nullptr == m_index) || (offset < 0) || (nullptr == buffer))
+    return -1;
+  if ((length == 0) || (offset >= uncompressedSize()))
+    return 0;
+
+  lzma_index_iter iter;
+  lzma_index_iter_init(&iter, m_index);
+  if (lzma_index_iter_locate(&iter, static_cast<lzma_vli>(offset)))
+    return -1;
+  uint8_t * out = static_cast<uint8_t*>(buffer);
+  std::size_t filled = 0;
+  uint64_t position = static_cast<uint64_t>(offset);
+  while (filled < length)
+  {
+    const uint64_t skip = position - iter.block.uncompressed_file_offset;
+    const std::size_t chunk = static_cast<std::size_t>(
+        std::min<uint64_t>(iter.block.uncompressed_size - skip, length - filled));
+    if (!readBlock(reader, iter, skip, out + filled, chunk))
+      return -1;
+    filled += chunk;
+    position += chunk;
+    // The next block continues the data, even in the next stream.
+    if ((filled < length) && lzma_index_iter_next(&iter, LZMA_INDEX_ITER_NONEMPTY_BLOCK))
+      break;
+  }
+  return static_cast<int64_t>(filled);
+}
+
+} // namespace
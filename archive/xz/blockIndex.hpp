@@ -0,0 +1,133 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_XZ_BLOCKINDEX_HPP
+#define LIBSTRIEZEL_XZ_BLOCKINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <lzma.h>
+#include "../compressedReader.hpp"
+
+namespace libstriezel::xz
+{
+
+using libstriezel::archive::CompressedReader;
+
+
+/** \brief index of the blocks in an xz file
+ *
+ * Every xz stream ends with an index that lists the compressed and the
+ * uncompressed size of each of its blocks. Blocks are independent of each
+ * other, so any block can be decompressed on its own. Files that were
+ * compressed with several threads (xz -T) consist of many blocks, which
+ * allows cheap random access.
+ */
+class blockIndex
+{
+  public:
+    /** \brief constructor - creates an empty index
+     */
+    blockIndex();
+
+
+    /** \brief destructor
+     */
+    ~blockIndex();
+
+
+    /* Delete unwanted default copy constructor, assignment operator and
+       move constructor. */
+    blockIndex(const blockIndex& op) = delete;
+    blockIndex & operator=(const blockIndex& op) = delete;
+    blockIndex(const blockIndex&& op) = delete;
+
+
+    /** \brief Reads the indexes of all streams from the end of the data.
+     *
+     * \param reader  callback that reads the compressed data
+     * \param size    size of the compressed data in bytes
+     * \return Returns true, if the index was read.
+     *         Returns false, if the data is no intact xz data.
+     * \remarks Only the stream headers, footers and indexes are read, not
+     *          the blocks. Concatenated streams and stream padding are
+     *          supported.
+     */
+    bool load(const CompressedReader& reader, const int64_t size);
+
+
+    /** \brief Checks whether the index has been loaded.
+     *
+     * \return Returns true, if the index has been loaded.
+     */
+    bool loaded() const;
+
+
+    /** \brief Gets the number of blocks.
+     *
+     * \return Returns the number of blocks in all streams.
+     */
+    uint64_t blocks() const;
+
+
+    /** \brief Gets the size of the uncompressed data.
+     *
+     * \return Returns the size of the uncompressed data in bytes.
+     *         Returns -1, if the index has not been loaded.
+     */
+    int64_t uncompressedSize() const;
+
+
+    /** \brief Reads uncompressed data at a given offset.
+     *
+     * \param reader  callback that reads the compressed data
+     * \param offset  offset in the uncompressed data
+     * \param buffer  the buffer that gets the data
+     * \param length  number of bytes to read
+     * \return Returns the number of bytes that were read, which is less than
+     *         length only at the end of the data. Returns -1, if an error
+     *         occurred or the index has not been loaded.
+     * \remarks Only the blocks that contain the requested data are
+     *          decompressed, starting at the start of the first one.
+     */
+    int64_t read(const CompressedReader& reader, const int64_t offset,
+                 void* buffer, const std::size_t length) const;
+  private:
+    /** \brief Decompresses data of the block the iterator points to.
+     *
+     * \param reader  callback that reads the compressed data
+     * \param iter    iterator that points to the block
+     * \param skip    number of uncompressed bytes to skip at the start
+     * \param buffer  the buffer that gets the data
+     * \param length  number of bytes to read from the block
+     * \return Returns true, if the data was decompressed.
+     *         Returns false, if an error occurred.
+     */
+    bool readBlock(const CompressedReader& reader, const lzma_index_iter& iter,
+                   uint64_t skip, uint8_t* buffer, const std::size_t length) const;
+
+
+    lzma_index * m_index; /**< the combined index of all streams, or nullptr */
+}; // class
+
+} // namespace
+
+#endif // LIBSTRIEZEL_XZ_BLOCKINDEX_HPP
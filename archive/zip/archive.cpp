@@ -19,18 +19,172 @@
 */
 
 #include "archive.hpp"
+#include <algorithm> //for std::stable_sort()
+#include <atomic> //for std::atomic
 #include <cerrno> //for errno
 #include <cstring> //for memset()
-#include <fstream> //for std::ofstream
 #include <iostream> //for std::cerr
+#include <limits> //for std::numeric_limits
 #include <memory> //for std::unique_ptr
 #include <sstream> //for ostringstream to convert int to string
 #include <stdexcept> //for standard exception classes
+#include <thread> //for std::thread
+#include <fcntl.h> //for open()
+#if defined(_WIN32)
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+#include <zlib.h> //for crc32()
+#include "../../filesystem/directory.hpp"
 #include "../../filesystem/file.hpp"
+#include "../compressedReader.hpp"
+#include "../copyRange.hpp"
+#include "../signatures.hpp"
+#include "../writeBehind.hpp"
 
 namespace libstriezel::zip
 {
 
+namespace
+{
+
+/* Converts a path within the archive to a path of the local file system. */
+std::string nativePath(std::string name)
+{
+  std::replace(name.begin(), name.end(), '/', libstriezel::filesystem::pathDelimiter);
+  return name;
+}
+
+/* Checks whether an entry name stays within the destination directory: it
+   must be relative, must not start with a drive and must not have ".." as
+   one of its parts. Backslashes count as separators, too, because Windows
+   treats them so. */
+bool isSafePath(const std::string& name)
+{
+  if (name.empty() || (name[0] == '/') || (name[0] == '\\')
+      || ((name.size() > 1) && (name[1] == ':')))
+    return false;
+  std::string::size_type start = 0;
+  while (true)
+  {
+    const std::string::size_type end = name.find_first_of("/\\", start);
+    if (name.compare(start, (end == std::string::npos) ? std::string::npos : end - start, "..") == 0)
+      return false;
+    if (end == std::string::npos)
+      return true;
+    start = end + 1;
+  }
+}
+
+/* Creates a directory and all of its parents, unless it already exists. */
+bool ensureDirectory(const std::string& dirName)
+{
+  const std::string dir = libstriezel::filesystem::unslashify(dirName);
+  return libstriezel::filesystem::directory::exists(dir)
+      || libstriezel::filesystem::directory::createRecursive(dir);
+}
+
+/* Computes the CRC-32 of a range of a file. Returns -1, if the range could
+   not be read completely. */
+int64_t crcOfRange(const int fd, const int64_t offset, const int64_t size)
+{
+  const libstriezel::archive::CompressedReader reader = libstriezel::archive::descriptorReader(fd);
+  const std::size_t bufferSize = 1024 * 1024;
+  std::unique_ptr<unsigned char[]> buffer(new unsigned char[bufferSize]);
+  uLong crc = crc32(0L, Z_NULL, 0);
+  int64_t done = 0;
+  while (done < size)
+  {
+    const std::size_t wanted = static_cast<std::size_t>(std::min<int64_t>(size - done, bufferSize));
+    if (libstriezel::archive::readFull(reader, offset + done, buffer.get(), wanted) != static_cast<int64_t>(wanted))
+      return -1;
+    crc = crc32(crc, buffer.get(), static_cast<uInt>(wanted));
+    done += static_cast<int64_t>(wanted);
+  }
+  return static_cast<int64_t>(crc & 0xFFFFFFFFu);
+}
+
+/// state of a libzip source that reads from a seekable stream
+struct StreamSource
+{
+  libstriezel::archive::seekableStream * stream; /**< the stream that contains the archive */
+  zip_int64_t size; /**< size of the stream in bytes */
+  zip_int64_t position; /**< current read position */
+  zip_error_t error; /**< last error */
+};
+
+zip_int64_t streamSourceCallback(void* userdata, void* data, zip_uint64_t len, zip_source_cmd_t cmd)
+{
+  StreamSource * source = static_cast<StreamSource*>(userdata);
+  switch (cmd)
+  {
+    case ZIP_SOURCE_OPEN:
+         if (source->stream->seek(0, SEEK_SET) != 0)
+         {
+           zip_error_set(&source->error, ZIP_ER_SEEK, 0);
+           return -1;
+         }
+         source->position = 0;
+         return 0;
+    case ZIP_SOURCE_READ:
+         {
+           const int64_t bytesRead = source->stream->read(data, static_cast<std::size_t>(len));
+           if (bytesRead < 0)
+           {
+             zip_error_set(&source->error, ZIP_ER_READ, 0);
+             return -1;
+           }
+           source->position += bytesRead;
+           return bytesRead;
+         }
+    case ZIP_SOURCE_CLOSE:
+         return 0;
+    case ZIP_SOURCE_STAT:
+         {
+           zip_stat_t * stats = ZIP_SOURCE_GET_ARGS(zip_stat_t, data, len, &source->error);
+           if (nullptr == stats)
+             return -1;
+           zip_stat_init(stats);
+           stats->size = static_cast<zip_uint64_t>(source->size);
+           stats->valid |= ZIP_STAT_SIZE;
+           return sizeof(zip_stat_t);
+         }
+    case ZIP_SOURCE_ERROR:
+         return zip_error_to_data(&source->error, data, len);
+    case ZIP_SOURCE_FREE:
+         zip_error_fini(&source->error);
+         delete source;
+         return 0;
+    case ZIP_SOURCE_SEEK:
+         {
+           const zip_int64_t newPosition = zip_source_seek_compute_offset(
+               static_cast<zip_uint64_t>(source->position), static_cast<zip_uint64_t>(source->size),
+               data, len, &source->error);
+           if (newPosition < 0)
+             return -1;
+           if (source->stream->seek(newPosition, SEEK_SET) != newPosition)
+           {
+             zip_error_set(&source->error, ZIP_ER_SEEK, 0);
+             return -1;
+           }
+           source->position = newPosition;
+           return 0;
+         }
+    case ZIP_SOURCE_TELL:
+         return source->position;
+    case ZIP_SOURCE_SUPPORTS:
+         return zip_source_make_command_bitmap(ZIP_SOURCE_OPEN, ZIP_SOURCE_READ,
+                    ZIP_SOURCE_CLOSE, ZIP_SOURCE_STAT, ZIP_SOURCE_ERROR, ZIP_SOURCE_FREE,
+                    ZIP_SOURCE_SEEK, ZIP_SOURCE_TELL, ZIP_SOURCE_SUPPORTS, -1);
+    default:
+         zip_error_set(&source->error, ZIP_ER_OPNOTSUPP, 0);
+         return -1;
+  }
+}
+
+} // anonymous namespace
+
 struct DeleterZipFile {
   void operator()(zip_file* fp) const
   {
@@ -40,12 +194,39 @@ struct DeleterZipFile {
 };
 
 
-archive::archive(const std::string& fileName)
-: m_archive(nullptr)
+archive::archive(const std::string& fileName, const bool nativeListing)
+: m_archive(nullptr),
+  m_directory(nullptr),
+  m_nativeListing(false),
+  m_directoryRead(false),
+  m_fileName(fileName),
+  m_data(nullptr),
+  m_dataSize(0),
+  m_stream(nullptr)
+{
+  if (nativeListing)
+  {
+    try
+    {
+      m_directory = std::make_unique<centralDirectory>(fileName);
+      m_nativeListing = true;
+      m_directoryRead = true;
+      return;
+    }
+    catch (const std::exception&)
+    {
+      // libzip may still be able to open it, or gives a better error message
+      m_directory = nullptr;
+    }
+  }
+  m_archive = openFile(fileName);
+}
+
+struct zip * archive::openFile(const std::string& fileName)
 {
   int errorCode = 0;
-  m_archive = zip_open(fileName.c_str(), 0 /*ZIP_RDONLY*/, &errorCode);
-  if (m_archive == nullptr)
+  struct zip * handle = zip_open(fileName.c_str(), 0 /*ZIP_RDONLY*/, &errorCode);
+  if (handle == nullptr)
   {
     // error handling: throw
     std::string msg;
@@ -91,6 +272,82 @@ archive::archive(const std::string& fileName)
     msg = "ZIP error: " + msg;
     throw std::runtime_error(msg);
   }
+  return handle;
+}
+
+archive::archive(const void* data, const std::size_t size)
+: m_archive(nullptr),
+  m_directory(nullptr),
+  m_nativeListing(false),
+  m_directoryRead(false),
+  m_fileName(std::string()),
+  m_data(data),
+  m_dataSize(size),
+  m_stream(nullptr)
+{
+  if (nullptr == data)
+    throw std::runtime_error("ZIP error: Archive data must not be null.");
+  zip_error_t error;
+  zip_error_init(&error);
+  zip_source_t * source = zip_source_buffer_create(data, size, 0, &error);
+  if (nullptr == source)
+  {
+    const std::string msg = std::string("ZIP error: ") + zip_error_strerror(&error);
+    zip_error_fini(&error);
+    throw std::runtime_error(msg);
+  }
+  zip_error_fini(&error);
+  openFromSource(source);
+}
+
+archive::archive(libstriezel::archive::seekableStream& stream)
+: m_archive(nullptr),
+  m_directory(nullptr),
+  m_nativeListing(false),
+  m_directoryRead(false),
+  m_fileName(std::string()),
+  m_data(nullptr),
+  m_dataSize(0),
+  m_stream(&stream)
+{
+  const int64_t size = stream.seek(0, SEEK_END);
+  if (size < 0)
+    throw std::runtime_error("ZIP error: The stream is not seekable.");
+  StreamSource * state = new StreamSource;
+  state->stream = &stream;
+  state->size = size;
+  state->position = 0;
+  zip_error_init(&state->error);
+  zip_error_t error;
+  zip_error_init(&error);
+  zip_source_t * source = zip_source_function_create(streamSourceCallback, state, &error);
+  if (nullptr == source)
+  {
+    const std::string msg = std::string("ZIP error: ") + zip_error_strerror(&error);
+    zip_error_fini(&error);
+    zip_error_fini(&state->error);
+    delete state;
+    throw std::runtime_error(msg);
+  }
+  zip_error_fini(&error);
+  // The source owns the state from here on and deletes it on ZIP_SOURCE_FREE.
+  openFromSource(source);
+}
+
+void archive::openFromSource(zip_source_t* source)
+{
+  zip_error_t error;
+  zip_error_init(&error);
+  m_archive = zip_open_from_source(source, ZIP_RDONLY, &error);
+  if (m_archive == nullptr)
+  {
+    // The source is only taken over by a successfully opened archive.
+    zip_source_free(source);
+    const std::string msg = std::string("ZIP error: ") + zip_error_strerror(&error);
+    zip_error_fini(&error);
+    throw std::runtime_error(msg);
+  }
+  zip_error_fini(&error);
 }
 
 archive::~archive()
@@ -117,11 +374,26 @@ archive::~archive()
 
 int64_t archive::numEntries() const
 {
+   if (m_nativeListing)
+     return m_directory->numEntries();
    return zip_get_num_entries(m_archive, 0);
 }
 
 std::vector<entry> archive::entries() const
 {
+    if (m_nativeListing)
+    {
+      std::vector<entry> result;
+      result.reserve(static_cast<std::size_t>(m_directory->numEntries()));
+      m_directory->forEachEntry([this, &result](const libstriezel::archive::entryView& view)
+      {
+        const std::size_t i = static_cast<std::size_t>(view.index);
+        result.push_back(entry(std::string(view.name), static_cast<int>(view.index), view.size,
+                               m_directory->sizeCompressed(i), view.m_time, m_directory->crc(i)));
+        return true;
+      });
+      return result;
+    }
     const auto num = numEntries();
     std::vector<entry> result;
     struct zip_stat sb;
@@ -139,6 +411,96 @@ std::vector<entry> archive::entries() const
     return result;
 }
 
+bool archive::forEachEntry(const libstriezel::archive::EntryVisitor& visitor) const
+{
+  if (m_nativeListing)
+    return m_directory->forEachEntry(visitor);
+  const auto num = numEntries();
+  if (num < 0)
+    return false;
+  struct zip_stat sb;
+  zip_stat_init(&sb);
+  for (int64_t i = 0; i < num; ++i)
+  {
+    if (zip_stat_index(m_archive, i, 0, &sb) != 0)
+      return false;
+    const std::string_view name = ((sb.valid & ZIP_STAT_NAME) != 0) && (sb.name != nullptr)
+                                  ? std::string_view(sb.name) : std::string_view();
+    const int64_t size = ((sb.valid & ZIP_STAT_SIZE) != 0)
+                         && (sb.size <= static_cast<zip_uint64_t>(std::numeric_limits<int64_t>::max()))
+                         ? static_cast<int64_t>(sb.size) : -1;
+    const std::time_t mtime = ((sb.valid & ZIP_STAT_MTIME) != 0) ? sb.mtime : static_cast<std::time_t>(-1);
+    // same rule as zip::entry::isDirectory()
+    const bool directory = (size == 0) && !name.empty() && (name.back() == '/');
+    const libstriezel::archive::entryView view { i, name, size, mtime, directory, false };
+    if (!visitor(view))
+      return false;
+  }
+  return true;
+}
+
+bool archive::fillEntryTable(libstriezel::archive::entryTable& table) const
+{
+  if (m_nativeListing)
+  {
+    m_directory->fillEntryTable(table);
+    return true;
+  }
+  table.clear();
+  const auto num = numEntries();
+  if (num < 0)
+    return false;
+  table.reserve(static_cast<std::size_t>(num));
+  struct zip_stat sb;
+  zip_stat_init(&sb);
+  for (int64_t i = 0; i < num; ++i)
+  {
+    if (zip_stat_index(m_archive, i, 0, &sb) != 0)
+    {
+      table.clear();
+      return false;
+    }
+    const entry e(sb);
+    const libstriezel::archive::entryView view { i, e.name(), e.size(), e.m_time(),
+                                                 e.isDirectory(), false };
+    table.add(view, e.sizeCompressed(), e.crc());
+  }
+  return true;
+}
+
+int64_t archive::indexOf(const std::string& name) const
+{
+  if (m_nativeListing)
+    return m_directory->locate(name);
+  return zip_name_locate(m_archive, name.c_str(), 0);
+}
+
+bool archive::openLibzip() const
+{
+  if (m_archive != nullptr)
+    return true;
+  try
+  {
+    m_archive = openFile(m_fileName);
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << "zip::archive::openLibzip: error: " << ex.what() << std::endl;
+    return false;
+  }
+  // The indices of both readers only match, if they see the same entries.
+  if (m_nativeListing && (zip_get_num_entries(m_archive, 0) != m_directory->numEntries()))
+  {
+    std::cerr << "zip::archive::openLibzip: error: libzip and the native reader "
+              << "do not see the same entries in " << m_fileName
+              << ", so entries are listed by libzip from now on." << std::endl;
+    m_nativeListing = false;
+    m_directory = nullptr;
+    return false;
+  }
+  return true;
+}
+
 bool archive::extractTo(const std::string& destFileName, int64_t index) const
 {
   const auto num = numEntries();
@@ -157,67 +519,454 @@ bool archive::extractTo(const std::string& destFileName, int64_t index) const
     return false;
   }
 
-  // open/create destination file
-  std::ofstream destination;
-  destination.open(destFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-  if (!destination.good() || !destination.is_open())
-  {
-    std::cerr << "zip::archive::extractTo: error: destination file "
-              << destFileName << " could not be created/opened for writing!"
-              << std::endl;
+  // Stored entries need no decompression, so the kernel can copy them.
+  const int64_t dataOffset = storedDataOffset(index);
+  if (dataOffset >= 0)
+    return copyStored(destFileName, dataOffset, m_directory->size(static_cast<std::size_t>(index)),
+                      m_directory->crc(static_cast<std::size_t>(index)));
+  if (!openLibzip())
     return false;
-  }
 
   // open file inside archive and wrap it in unique_ptr to make sure it gets closed
   std::unique_ptr<zip_file, DeleterZipFile> file(zip_fopen_index(m_archive, index, 0));
   if (nullptr == file)
   {
     std::cerr << "zip::archive::extractTo: error: " << getError() << std::endl;
-    destination.close();
-    filesystem::file::remove(destFileName);
     return false;
   }
 
-  // one megabyte should be enough for incremental buffer
-  const unsigned int bufferSize = 1024 * 1024;
-  char buffer[bufferSize];
-  zip_int64_t bytesRead = 1;
+  // open/create destination file
+  int64_t expectedSize = -1;
+  struct zip_stat sb;
+  zip_stat_init(&sb);
+  if ((zip_stat_index(m_archive, index, 0, &sb) == 0) && ((sb.valid & ZIP_STAT_SIZE) != 0))
+    expectedSize = static_cast<int64_t>(sb.size);
+  libstriezel::archive::writeBehind destination;
+  if (!destination.open(destFileName, expectedSize))
+  {
+    std::cerr << "zip::archive::extractTo: error: destination file "
+              << destFileName << " could not be created/opened for writing!"
+              << std::endl;
+    return false;
+  }
 
+  // libzip decompresses straight into the buffers of the writer.
+  zip_int64_t bytesRead = 1;
   while (bytesRead > 0)
   {
-    bytesRead = zip_fread(file.get(), buffer, bufferSize);
+    bytesRead = zip_fread(file.get(), destination.data(), destination.space());
     if (bytesRead < 0)
     {
       std::cerr << "zip::archive::extractTo: error while reading data from archive: "
                 << getError() << std::endl;
-      destination.close();
+      destination.finish();
       filesystem::file::remove(destFileName);
-      // close zip file - unique_ptr deleter handles zip_fclose()
-      file = nullptr;
       return false;
     }
-    destination.write(buffer, bytesRead);
-    if (!destination.good())
+    if (!destination.produced(static_cast<std::size_t>(bytesRead)))
     {
       std::cerr << "zip::archive::extractTo: error: Could not write data to file "
                 << destFileName << "." << std::endl;
-      destination.close();
+      destination.finish();
       filesystem::file::remove(destFileName);
-      // close zip file - unique_ptr deleter handles zip_fclose()
-      file = nullptr;
       return false;
     }
   }
 
   // close zip file - unique_ptr deleter handles zip_fclose()
   file = nullptr;
-  // close destination file
-  destination.close();
+  // write remaining data and close destination file
+  if (!destination.finish())
+  {
+    std::cerr << "zip::archive::extractTo: error: Could not write data to file "
+              << destFileName << "." << std::endl;
+    filesystem::file::remove(destFileName);
+    return false;
+  }
+  return true;
+}
+
+const centralDirectory * archive::directory() const
+{
+  if (!m_directoryRead && !m_fileName.empty())
+  {
+    m_directoryRead = true;
+    try
+    {
+      m_directory = std::make_unique<centralDirectory>(m_fileName);
+    }
+    catch (const std::exception&)
+    {
+      // libzip can read some archives that the native reader rejects.
+      m_directory = nullptr;
+    }
+    // The indices of both readers only match, if they see the same entries.
+    if ((m_directory != nullptr) && (m_archive != nullptr)
+        && (zip_get_num_entries(m_archive, 0) != m_directory->numEntries()))
+      m_directory = nullptr;
+  }
+  return m_directory.get();
+}
+
+int64_t archive::storedDataOffset(const int64_t index) const
+{
+  const centralDirectory * cd = directory();
+  if ((cd == nullptr) || (index >= cd->numEntries()))
+    return -1;
+  const std::size_t i = static_cast<std::size_t>(index);
+  if ((cd->method(i) != 0) || cd->isEncrypted(i) || (cd->size(i) != cd->sizeCompressed(i)))
+    return -1;
+  return cd->dataOffset(i);
+}
+
+bool archive::copyStored(const std::string& destFileName, const int64_t dataOffset,
+                         const int64_t size, const uint32_t crc) const
+{
+  #if defined(_WIN32)
+  const int source = _open(m_fileName.c_str(), _O_RDONLY | _O_BINARY);
+  #else
+  const int source = open(m_fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  #endif
+  if (source < 0)
+  {
+    std::cerr << "zip::archive::extractTo: error: Could not open archive file "
+              << m_fileName << "!" << std::endl;
+    return false;
+  }
+  bool success = libstriezel::archive::copyToNewFile(source, { { dataOffset, size } }, destFileName);
+  // The kernel does not check the data, so its CRC-32 is checked here. The
+  // range was just read by the copy, so it is usually still cached.
+  if (success && (crcOfRange(source, dataOffset, size) != static_cast<int64_t>(crc)))
+  {
+    std::cerr << "zip::archive::extractTo: error: CRC-32 of the data in "
+              << destFileName << " does not match!" << std::endl;
+    filesystem::file::remove(destFileName);
+    success = false;
+  }
+  #if defined(_WIN32)
+  _close(source);
+  #else
+  close(source);
+  #endif
+  return success;
+}
+
+bool archive::extractToSink(int64_t index, const libstriezel::archive::Sink& sink) const
+{
+  const auto num = numEntries();
+  if (((num >= 0) && (index >= num)) || (index < 0))
+  {
+    std::cerr << "zip::archive::extractToSink: error: invalid index!" << std::endl;
+    return false;
+  }
+  if (!openLibzip())
+    return false;
+
+  // open file inside archive and wrap it in unique_ptr to make sure it gets closed
+  std::unique_ptr<zip_file, DeleterZipFile> file(zip_fopen_index(m_archive, index, 0));
+  if (nullptr == file)
+  {
+    std::cerr << "zip::archive::extractToSink: error: " << getError() << std::endl;
+    return false;
+  }
+
+  std::vector<char> buffer(64 * 1024);
+  zip_int64_t bytesRead = 1;
+  while (bytesRead > 0)
+  {
+    bytesRead = zip_fread(file.get(), buffer.data(), buffer.size());
+    if (bytesRead < 0)
+    {
+      std::cerr << "zip::archive::extractToSink: error while reading data from archive: "
+                << getError() << std::endl;
+      return false;
+    }
+    if ((bytesRead > 0) && !sink(buffer.data(), static_cast<std::size_t>(bytesRead)))
+    {
+      std::cerr << "zip::archive::extractToSink: error: The data was not accepted by the sink!"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool archive::extractToBuffer(int64_t index, std::vector<uint8_t>& buffer) const
+{
+  buffer.clear();
+  if (!openLibzip())
+    return false;
+  zip_stat_t stats;
+  zip_stat_init(&stats);
+  if ((index < 0) || (zip_stat_index(m_archive, index, 0, &stats) != 0)
+      || ((stats.valid & ZIP_STAT_SIZE) == 0))
+  {
+    // size is unknown, let the vector grow as needed
+    if (extractToSink(index, libstriezel::archive::vectorSink(buffer)))
+      return true;
+    buffer.clear();
+    return false;
+  }
+
+  /* One byte more than announced lets the read detect entries whose data is
+     longer than the central directory claims. */
+  buffer.resize(static_cast<std::size_t>(stats.size) + 1);
+  std::size_t size = 0;
+  if (!extractToBuffer(index, buffer.data(), buffer.size(), size))
+  {
+    buffer.clear();
+    return false;
+  }
+  if (size != stats.size)
+  {
+    std::cerr << "zip::archive::extractToBuffer: error: Size of data does not"
+              << " match the size in the central directory!" << std::endl;
+    buffer.clear();
+    return false;
+  }
+  buffer.resize(size);
+  return true;
+}
+
+bool archive::extractToBuffer(int64_t index, void* buffer, const std::size_t capacity,
+                              std::size_t& size) const
+{
+  size = 0;
+  const auto num = numEntries();
+  if (((num >= 0) && (index >= num)) || (index < 0))
+  {
+    std::cerr << "zip::archive::extractToBuffer: error: invalid index!" << std::endl;
+    return false;
+  }
+  if (!openLibzip())
+    return false;
+
+  // open file inside archive and wrap it in unique_ptr to make sure it gets closed
+  std::unique_ptr<zip_file, DeleterZipFile> file(zip_fopen_index(m_archive, index, 0));
+  if (nullptr == file)
+  {
+    std::cerr << "zip::archive::extractToBuffer: error: " << getError() << std::endl;
+    return false;
+  }
+
+  // libzip decompresses straight into the buffer of the caller
+  char * data = static_cast<char*>(buffer);
+  zip_int64_t bytesRead = 1;
+  while ((bytesRead > 0) && (size < capacity))
+  {
+    bytesRead = zip_fread(file.get(), data + size, capacity - size);
+    if (bytesRead < 0)
+    {
+      std::cerr << "zip::archive::extractToBuffer: error while reading data from archive: "
+                << getError() << std::endl;
+      return false;
+    }
+    size += static_cast<std::size_t>(bytesRead);
+  }
+  if (size == capacity)
+  {
+    // The buffer is full, so there must not be any more data.
+    char probe = '\0';
+    bytesRead = zip_fread(file.get(), &probe, 1);
+    if (bytesRead != 0)
+    {
+      std::cerr << "zip::archive::extractToBuffer: error: Buffer is too small!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::map<std::string, bool> archive::extractMany(const std::map<std::string, std::string>& files,
+                                                 const unsigned int threads) const
+{
+  std::map<std::string, bool> result;
+  std::vector<std::pair<int64_t, std::string> > jobs;
+  std::vector<std::string> jobNames;
+  for (const auto& item : files)
+  {
+    const int64_t index = indexOf(item.first);
+    if (index < 0)
+    {
+      std::cerr << "zip::archive::extractMany: error: file " << item.first
+                << " does not exist in archive!" << std::endl;
+      result[item.first] = false;
+    }
+    else
+    {
+      jobs.push_back(std::make_pair(index, item.second));
+      jobNames.push_back(item.first);
+    }
+  } // for
+  const std::vector<char> success = extractParallel(jobs, threads);
+  for (std::size_t i = 0; i < jobs.size(); ++i)
+  {
+    result[jobNames[i]] = (success[i] != 0);
+  }
+  return result;
+}
+
+bool archive::extractAll(const std::string& destDirectory, const unsigned int threads) const
+{
+  if (!ensureDirectory(destDirectory))
+  {
+    std::cerr << "zip::archive::extractAll: error: Could not create directory "
+              << destDirectory << "!" << std::endl;
+    return false;
+  }
+  const std::string destPrefix = libstriezel::filesystem::slashify(destDirectory);
+
+  bool allValid = true;
+  std::vector<std::pair<int64_t, std::string> > jobs;
+  for (const auto& e : entries())
+  {
+    const std::string& name = e.name();
+    // Do not write outside of the destination directory.
+    if (!isSafePath(name))
+    {
+      std::cerr << "zip::archive::extractAll: error: Entry " << name
+                << " has an invalid path and is not extracted!" << std::endl;
+      allValid = false;
+      continue;
+    }
+    if (e.isDirectory())
+    {
+      if (!ensureDirectory(destPrefix + nativePath(name)))
+      {
+        std::cerr << "zip::archive::extractAll: error: Could not create directory "
+                  << destPrefix + name << "!" << std::endl;
+        allValid = false;
+      }
+      continue;
+    }
+    // Not every ZIP file has entries for all of its directories.
+    const auto lastSlash = name.rfind('/');
+    if ((lastSlash != std::string::npos)
+        && !ensureDirectory(destPrefix + nativePath(name.substr(0, lastSlash))))
+    {
+      std::cerr << "zip::archive::extractAll: error: Could not create directory for "
+                << name << "!" << std::endl;
+      allValid = false;
+      continue;
+    }
+    jobs.push_back(std::make_pair(e.index(), destPrefix + nativePath(name)));
+  } // for
+
+  const std::vector<char> success = extractParallel(jobs, threads);
+  return allValid && (std::find(success.begin(), success.end(), 0) == success.end());
+}
+
+std::vector<char> archive::extractParallel(const std::vector<std::pair<int64_t, std::string> >& jobs,
+                                           unsigned int threads) const
+{
+  std::vector<char> success(jobs.size(), 0);
+  if (jobs.empty() || !openLibzip())
+    return success;
+
+  // largest files first, so that no thread gets a big file at the very end
+  std::vector<std::pair<int64_t, std::size_t> > order;
+  struct zip_stat sb;
+  zip_stat_init(&sb);
+  for (std::size_t i = 0; i < jobs.size(); ++i)
+  {
+    int64_t size = 0;
+    if ((zip_stat_index(m_archive, jobs[i].first, 0, &sb) == 0) && ((sb.valid & ZIP_STAT_SIZE) != 0))
+      size = static_cast<int64_t>(sb.size);
+    order.push_back(std::make_pair(size, i));
+  }
+  std::stable_sort(order.begin(), order.end(),
+      [](const std::pair<int64_t, std::size_t>& a, const std::pair<int64_t, std::size_t>& b)
+      {
+        return a.first > b.first;
+      });
+
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned int>(std::min<std::size_t>(threads, jobs.size()));
+  // A stream has only one read position, so it cannot be shared by threads.
+  if (nullptr != m_stream)
+    threads = 1;
+
+  std::atomic<std::size_t> next(0);
+  // Every worker takes the next job from the list until there are no more.
+  const auto work = [&jobs, &order, &success, &next](const archive& handle)
+  {
+    std::size_t current = next++;
+    while (current < order.size())
+    {
+      const std::size_t job = order[current].second;
+      success[job] = handle.extractTo(jobs[job].second, jobs[job].first) ? 1 : 0;
+      current = next++;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int i = 1; i < threads; ++i)
+  {
+    workers.push_back(std::thread([this, &work]()
+    {
+      try
+      {
+        if (nullptr != m_data)
+        {
+          const archive handle(m_data, m_dataSize);
+          work(handle);
+        }
+        else
+        {
+          const archive handle(m_fileName);
+          work(handle);
+        }
+      }
+      catch (const std::exception& ex)
+      {
+        // The other threads take over the jobs of this one.
+        std::cerr << "zip::archive::extractParallel: error: " << ex.what() << std::endl;
+      }
+    }));
+  } // for
+  // The calling thread uses the existing handle.
+  work(*this);
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+  return success;
+}
+
+bool archive::extractAllToSinks(const std::function<libstriezel::archive::Sink(const entry&)>& sinkFor) const
+{
+  if (!openLibzip())
+    return false;
+  const auto num = numEntries();
+  if (num < 0)
+  {
+    std::cerr << "zip::archive::extractAllToSinks: error: " << getError() << std::endl;
+    return false;
+  }
+
+  struct zip_stat sb;
+  zip_stat_init(&sb);
+  for (int64_t i = 0; i < num; ++i)
+  {
+    if (zip_stat_index(m_archive, i, 0, &sb) != 0)
+    {
+      std::cerr << "zip::archive::extractAllToSinks: error: " << getError() << std::endl;
+      return false;
+    }
+    const entry e(sb);
+    if (e.isDirectory())
+      continue;
+    if (!extractToSink(i, sinkFor(e)))
+      return false;
+  } // for
   return true;
 }
 
 std::string archive::getError() const
 {
+  if (m_archive == nullptr)
+    return "The archive has not been opened by libzip.";
   int zipErr = 0;
   int sysErr = 0;
   zip_error_get(m_archive, &zipErr, &sysErr);
@@ -235,19 +984,9 @@ std::string archive::getError() const
 
 bool archive::isZip(const std::string& fileName)
 {
-  std::ifstream stream;
-  stream.open(fileName, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good() || !stream.is_open())
-    return false;
-
-  uint32_t start = 0;
-  stream.read(reinterpret_cast<char*>(&start), 4);
-  if (!stream.good() || stream.gcount() != 4)
-    return false;
-  stream.close();
-
-  /* magic literal for ZIP files is 50 4B 03 04.*/
-  return (start == 0x04034B50);
+  char head[4];
+  const std::size_t size = libstriezel::archive::signatures::readHead(fileName, head, sizeof(head));
+  return libstriezel::archive::signatures::isZip(head, size);
 }
 
 } // namespace
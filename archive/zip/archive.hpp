@@ -21,10 +21,19 @@
 #ifndef LIBSTRIEZEL_ZIP_ARCHIVE_HPP
 #define LIBSTRIEZEL_ZIP_ARCHIVE_HPP
 
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <zip.h>
+#include "centralDirectory.hpp"
 #include "entry.hpp"
+#include "../entryTable.hpp"
+#include "../entryView.hpp"
+#include "../seekableStream.hpp"
+#include "../sink.hpp"
 
 namespace libstriezel::zip
 {
@@ -34,11 +43,37 @@ class archive
   public:
      /** \brief constructor - opens a ZIP archive in read-only mode
       *
-      * \param fileName  -  file name of the .zip archive
+      * \param fileName       -  file name of the .zip archive
+      * \param nativeListing  -  if true, the central directory is read by
+      *                          the own reader of this library and libzip is
+      *                          only used once data is extracted
       * \remarks This function throws an exception, if the file does not
       *          exist or a similar error occurs.
+      *          With native listing, names are not converted from CP437 to
+      *          UTF-8, but returned just as they are stored in the archive.
       */
-    archive(const std::string& fileName);
+    archive(const std::string& fileName, const bool nativeListing = false);
+
+
+     /** \brief constructor - opens a ZIP archive in memory in read-only mode
+      *
+      * \param data  pointer to the start of the archive data - the data must
+      *              stay valid as long as the archive object exists
+      * \param size  size of the archive data in bytes
+      * \remarks This function throws an exception, if the data cannot be
+      *          opened as ZIP archive or a similar error occurs.
+      */
+    archive(const void* data, const std::size_t size);
+
+
+     /** \brief constructor - opens a ZIP archive from a stream in read-only mode
+      *
+      * \param stream  the stream that contains the archive - the stream must
+      *                stay valid as long as the archive object exists
+      * \remarks This function throws an exception, if the stream cannot be
+      *          opened as ZIP archive or a similar error occurs.
+      */
+    archive(libstriezel::archive::seekableStream& stream);
 
 
     /** \brief destructor
@@ -69,16 +104,134 @@ class archive
     std::vector<entry> entries() const;
 
 
+    /** \brief Passes all entries of the ZIP archive to a visitor, one at a time.
+     *
+     * \param visitor  callback that gets a view of each entry
+     * \return Returns true, if all entries were visited.
+     *         Returns false, if an error occurred or the visitor stopped.
+     * \remarks Unlike entries(), this does not build a list of entries. The
+     *          names in the views point into the central directory data that
+     *          is held by libzip.
+     */
+    bool forEachEntry(const libstriezel::archive::EntryVisitor& visitor) const;
+
+
+    /** \brief Fills a compact table with all entries of the ZIP archive.
+     *
+     * \param table  the table, its previous content is removed
+     * \return Returns true, if all entries were added.
+     *         Returns false, if an error occurred.
+     * \remarks Unlike forEachEntry(), this also stores the compressed sizes
+     *          and the CRC-32 values of the entries. The row of an entry in
+     *          the table is its index in the archive.
+     */
+    bool fillEntryTable(libstriezel::archive::entryTable& table) const;
+
+
+    /** \brief Gets the index of the entry with the given name.
+     *
+     * \param name  the exact name of the entry
+     * \return Returns the index of the first entry with that name.
+     *         Returns -1, if there is no such entry.
+     */
+    int64_t indexOf(const std::string& name) const;
+
+
     /** \brief Extracts the file at a given index to the specified destination.
      *
      * \param destFileName  the destination file name - file must not exist yet
      * \param index         index of the entry that shall be extracted
      * \return Returns true, if the file could be extracted successfully.
      *         Returns false, if the extraction failed.
+     * \remarks Stored (uncompressed) entries of ZIP files are copied by the
+     *          kernel straight from the archive file, without libzip. The
+     *          copied data is read once more to check its CRC-32, and the
+     *          destination file is removed, if the CRC-32 does not match.
      */
     bool extractTo(const std::string& destFileName, int64_t index) const;
 
 
+    /** \brief Extracts the file at a given index and passes its data to a sink.
+     *
+     * \param index  index of the entry that shall be extracted
+     * \param sink   callback that receives the data chunk by chunk
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed or the sink aborted it.
+     */
+    bool extractToSink(int64_t index, const libstriezel::archive::Sink& sink) const;
+
+
+    /** \brief Extracts the file at a given index into a memory buffer.
+     *
+     * \param index   index of the entry that shall be extracted
+     * \param buffer  vector that will hold the data of the file
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed.
+     * \remarks The vector is sized according to the central directory, and
+     *          libzip decompresses straight into it.
+     */
+    bool extractToBuffer(int64_t index, std::vector<uint8_t>& buffer) const;
+
+
+    /** \brief Extracts the file at a given index into a preallocated buffer.
+     *
+     * \param index     index of the entry that shall be extracted
+     * \param buffer    pointer to the start of the buffer
+     * \param capacity  size of the buffer in bytes
+     * \param size      variable that will hold the size of the data
+     * \return Returns true, if the file could be extracted successfully.
+     *         Returns false, if the extraction failed or if the data does not
+     *         fit into the buffer.
+     */
+    bool extractToBuffer(int64_t index, void* buffer, const std::size_t capacity,
+                         std::size_t& size) const;
+
+
+    /** \brief Extracts several files to the specified destinations.
+     *
+     * \param files    maps the path of each file within the archive to the
+     *                 destination file name - destination files must not exist yet
+     * \param threads  number of threads to use, zero means one thread per
+     *                 processor core
+     * \return Returns a map that contains an element for every requested file.
+     *         Its value is true, if the file could be extracted successfully,
+     *         or false, if the extraction failed.
+     * \remarks Every thread opens its own handle of the archive, because
+     *          libzip handles must not be shared between threads. Larger
+     *          files are extracted first to balance the load. Archives that
+     *          are read from a stream always use a single thread.
+     */
+    std::map<std::string, bool> extractMany(const std::map<std::string, std::string>& files,
+                                            const unsigned int threads = 0) const;
+
+
+    /** \brief Extracts all entries of the archive into a directory.
+     *
+     * \param destDirectory  the destination directory - it is created, if it
+     *                       does not exist yet
+     * \param threads        number of threads to use, zero means one thread per
+     *                       processor core
+     * \return Returns true, if all entries could be extracted successfully.
+     *         Returns false, if at least one entry could not be extracted.
+     * \remarks Entries with absolute paths or with ".." as path component are
+     *          not extracted and cause a return value of false.
+     */
+    bool extractAll(const std::string& destDirectory, const unsigned int threads = 0) const;
+
+
+    /** \brief Extracts all files within the ZIP archive in a single pass and
+     * passes their data to sinks, without extracting them to disk.
+     *
+     * \param sinkFor  callback that gets the entry of each file and returns
+     *                 the sink for the data of that file
+     * \return Returns true, if all files could be extracted successfully.
+     *         Returns false, if an error occurred or a sink aborted.
+     * \remarks Directories are skipped. The data is passed to the sinks
+     *          straight from the decompression buffer.
+     */
+    bool extractAllToSinks(const std::function<libstriezel::archive::Sink(const entry&)>& sinkFor) const;
+
+
     /** \brief Checks whether a file may be a ZIP archive.
      *
      * \param fileName  file name of the potential ZIP archive
@@ -87,6 +240,83 @@ class archive
      */
     static bool isZip(const std::string& fileName);
   private:
+    /** \brief Extracts files using several threads.
+     *
+     * \param jobs     pairs of entry index and destination file name
+     * \param threads  number of threads to use, zero means one thread per
+     *                 processor core
+     * \return Returns a vector with one element for every job. The element is
+     *         non-zero, if the file was extracted successfully.
+     */
+    std::vector<char> extractParallel(const std::vector<std::pair<int64_t, std::string> >& jobs,
+                                      unsigned int threads) const;
+
+
+    /** \brief Opens the archive from a libzip source.
+     *
+     * \param source  the source - it belongs to the archive afterwards
+     * \remarks This function throws an exception, if the source cannot be
+     *          opened as ZIP archive.
+     */
+    void openFromSource(zip_source_t* source);
+
+
+    /** \brief Opens a ZIP file with libzip.
+     *
+     * \param fileName  file name of the .zip archive
+     * \return Returns the libzip handle of the archive.
+     * \remarks This function throws an exception, if the file cannot be
+     *          opened.
+     */
+    static struct zip * openFile(const std::string& fileName);
+
+
+    /** \brief Opens the archive with libzip, if that has not happened yet.
+     *
+     * \return Returns true, if libzip has opened the archive.
+     *         Returns false, if an error occurred.
+     * \remarks Archives with native listing are opened by libzip only when
+     *          data has to be extracted. Their indices are only passed to
+     *          libzip, if libzip sees as many entries as the native reader.
+     *          Otherwise the function fails and the archive lists its
+     *          entries with libzip from then on.
+     */
+    bool openLibzip() const;
+
+
+    /** \brief Gets the central directory read by the native reader.
+     *
+     * \return Returns the central directory. Returns nullptr, if the archive
+     *         is not a file or the native reader cannot read it.
+     * \remarks Archives without native listing read the central directory
+     *          during the first call.
+     */
+    const centralDirectory * directory() const;
+
+
+    /** \brief Gets the position of the data of a stored entry in the file.
+     *
+     * \param index  index of the entry
+     * \return Returns the offset of the data in the archive file. Returns -1,
+     *         if the entry is compressed or encrypted, or if its data cannot
+     *         be copied directly for another reason.
+     */
+    int64_t storedDataOffset(const int64_t index) const;
+
+
+    /** \brief Copies the data of a stored entry into a new file.
+     *
+     * \param destFileName  the destination file name - file must not exist yet
+     * \param dataOffset    offset of the data in the archive file
+     * \param size          size of the data in bytes
+     * \param crc           expected CRC-32 of the data
+     * \return Returns true, if the data was copied successfully and its
+     *         CRC-32 matches. Returns false, if an error occurred.
+     */
+    bool copyStored(const std::string& destFileName, const int64_t dataOffset,
+                    const int64_t size, const uint32_t crc) const;
+
+
     /** \brief Gets the error message for the archive.
      *
      * \return Returns a string containing the error message.
@@ -95,7 +325,14 @@ class archive
     std::string getError() const;
 
 
-    struct zip * m_archive; /**< zip archive handle */
+    mutable struct zip * m_archive; /**< zip archive handle, nullptr while libzip is not needed */
+    mutable std::unique_ptr<centralDirectory> m_directory; /**< central directory of the native reader, or nullptr */
+    mutable bool m_nativeListing; /**< whether entries are listed by the native reader */
+    mutable bool m_directoryRead; /**< whether the native reader has been tried */
+    std::string m_fileName; /**< file name of the archive, empty for other sources */
+    const void * m_data; /**< start of archive data in memory, or nullptr */
+    std::size_t m_dataSize; /**< size of archive data in memory */
+    libstriezel::archive::seekableStream * m_stream; /**< stream that contains the archive, or nullptr */
 };
 
 } // namespace
@@ -0,0 +1,400 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "centralDirectory.hpp"
+#include <limits>
+#include <stdexcept>
+
+namespace libstriezel::zip
+{
+
+namespace
+{
+
+/// signature of the end of central directory record
+const uint32_t signatureEnd = 0x06054b50;
+/// signature of the ZIP64 end of central directory locator
+const uint32_t signatureLocator64 = 0x07064b50;
+/// signature of the ZIP64 end of central directory record
+const uint32_t signatureEnd64 = 0x06064b50;
+/// signature of a central directory record
+const uint32_t signatureRecord = 0x02014b50;
+/// size of the end of central directory record without comment
+const std::size_t endSize = 22;
+/// size of the ZIP64 end of central directory locator
+const std::size_t locator64Size = 20;
+/// size of the ZIP64 end of central directory record without extensible data
+const std::size_t end64Size = 56;
+/// size of a central directory record without name, extra field and comment
+const std::size_t recordSize = 46;
+/// signature of a local file header
+const uint32_t signatureLocal = 0x04034b50;
+/// size of a local file header without name and extra field
+const std::size_t localSize = 30;
+/// header id of the ZIP64 extended information extra field
+const uint16_t extraZip64 = 0x0001;
+
+uint16_t le16(const unsigned char* p)
+{
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t le32(const unsigned char* p)
+{
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+       | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t le64(const unsigned char* p)
+{
+  return static_cast<uint64_t>(le32(p)) | (static_cast<uint64_t>(le32(p + 4)) << 32);
+}
+
+/* Converts an MS-DOS date (high word) and time (low word) to time_t in the
+   local time zone, just like libzip does it. */
+std::time_t dosToTime(const uint32_t dosTime)
+{
+  const uint32_t date = dosTime >> 16;
+  const uint32_t time = dosTime & 0xFFFF;
+  struct tm tm = {};
+  tm.tm_isdst = -1;
+  tm.tm_year = static_cast<int>(((date >> 9) & 127) + 1980 - 1900);
+  tm.tm_mon = static_cast<int>(((date >> 5) & 15)) - 1;
+  tm.tm_mday = static_cast<int>(date & 31);
+  tm.tm_hour = static_cast<int>((time >> 11) & 31);
+  tm.tm_min = static_cast<int>((time >> 5) & 63);
+  tm.tm_sec = static_cast<int>((time << 1) & 62);
+  return mktime(&tm);
+}
+
+/// remembers the last converted minute, because mktime() is slow
+class timeConverter
+{
+  public:
+    timeConverter()
+    : m_minute(std::numeric_limits<uint32_t>::max()),
+      m_time(0)
+    {
+    }
+
+    std::time_t convert(const uint32_t dosTime)
+    {
+      // The lowest five bits hold the seconds divided by two.
+      const uint32_t minute = dosTime >> 5;
+      if (minute != m_minute)
+      {
+        m_time = dosToTime(dosTime & ~static_cast<uint32_t>(31));
+        m_minute = minute;
+      }
+      return m_time + static_cast<std::time_t>((dosTime & 31) * 2);
+    }
+  private:
+    uint32_t m_minute;
+    std::time_t m_time;
+};
+
+/* Throws the exception for invalid archives. */
+[[noreturn]] void invalid(const std::string& reason)
+{
+  throw std::runtime_error("libstriezel::zip::centralDirectory: " + reason);
+}
+
+} // anonymous namespace
+
+centralDirectory::centralDirectory(const std::string& fileName)
+: m_data(nullptr),
+  m_size(0),
+  m_file(nullptr),
+  m_nameOffsets(std::vector<uint64_t>()),
+  m_nameLengths(std::vector<uint16_t>()),
+  m_sizes(std::vector<int64_t>()),
+  m_compressedSizes(std::vector<int64_t>()),
+  m_crcs(std::vector<uint32_t>()),
+  m_dosTimes(std::vector<uint32_t>()),
+  m_methods(std::vector<uint16_t>()),
+  m_flags(std::vector<uint16_t>()),
+  m_localOffsets(std::vector<int64_t>()),
+  m_index(libstriezel::archive::entryIndex())
+{
+  m_file = std::make_unique<libstriezel::archive::fileMapping>(fileName);
+  m_data = m_file->data();
+  m_size = m_file->size();
+  parse();
+}
+
+centralDirectory::centralDirectory(const void* data, const std::size_t size)
+: m_data(static_cast<const unsigned char*>(data)),
+  m_size(size),
+  m_file(nullptr),
+  m_nameOffsets(std::vector<uint64_t>()),
+  m_nameLengths(std::vector<uint16_t>()),
+  m_sizes(std::vector<int64_t>()),
+  m_compressedSizes(std::vector<int64_t>()),
+  m_crcs(std::vector<uint32_t>()),
+  m_dosTimes(std::vector<uint32_t>()),
+  m_methods(std::vector<uint16_t>()),
+  m_flags(std::vector<uint16_t>()),
+  m_localOffsets(std::vector<int64_t>()),
+  m_index(libstriezel::archive::entryIndex())
+{
+  if (nullptr == data)
+    invalid("Archive data must not be null!");
+  parse();
+}
+
+void centralDirectory::parse()
+{
+  if (m_size < endSize)
+    invalid("Data is too small for a ZIP archive.");
+
+  // The end record is followed by a comment of up to 65535 bytes.
+  const std::size_t lowest = (m_size > endSize + 0xFFFF) ? m_size - endSize - 0xFFFF : 0;
+  std::size_t endPos = m_size - endSize;
+  bool found = false;
+  while (true)
+  {
+    if ((le32(m_data + endPos) == signatureEnd)
+        && (endPos + endSize + le16(m_data + endPos + 20) <= m_size))
+    {
+      found = true;
+      break;
+    }
+    if (endPos == lowest)
+      break;
+    --endPos;
+  }
+  if (!found)
+    invalid("End of central directory record not found.");
+
+  const unsigned char * end = m_data + endPos;
+  uint64_t count = le16(end + 10);
+  uint64_t directorySize = le32(end + 12);
+  uint64_t directoryOffset = le32(end + 16);
+  if ((le16(end + 4) != 0) || (le16(end + 6) != 0))
+    invalid("Split archives are not supported.");
+
+  // ZIP64 archives have a locator right in front of the end record.
+  if ((endPos >= locator64Size) && (le32(end - locator64Size) == signatureLocator64))
+  {
+    const uint64_t end64Pos = le64(end - locator64Size + 8);
+    if ((end64Pos > endPos - locator64Size) || (endPos - locator64Size - end64Pos < end64Size)
+        || (le32(m_data + end64Pos) != signatureEnd64))
+      invalid("ZIP64 end of central directory record is invalid.");
+    const unsigned char * end64 = m_data + end64Pos;
+    count = le64(end64 + 32);
+    directorySize = le64(end64 + 40);
+    directoryOffset = le64(end64 + 48);
+    endPos = static_cast<std::size_t>(end64Pos);
+  }
+  if ((directoryOffset > endPos) || (directorySize > endPos - directoryOffset))
+    invalid("Central directory is outside of the archive.");
+  // Every record needs at least 46 bytes, so a wrong count is detected
+  // before it allocates memory.
+  if (count > directorySize / recordSize)
+    invalid("Central directory is too small for its number of entries.");
+
+  // The records are read once from start to end.
+  if (m_file != nullptr)
+    m_file->adviseSequential(static_cast<std::size_t>(directoryOffset), static_cast<std::size_t>(directorySize));
+
+  const std::size_t n = static_cast<std::size_t>(count);
+  m_nameOffsets.resize(n);
+  m_nameLengths.resize(n);
+  m_sizes.resize(n);
+  m_compressedSizes.resize(n);
+  m_crcs.resize(n);
+  m_dosTimes.resize(n);
+  m_methods.resize(n);
+  m_flags.resize(n);
+  m_localOffsets.resize(n);
+
+  const uint64_t directoryEnd = directoryOffset + directorySize;
+  uint64_t pos = directoryOffset;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if ((directoryEnd - pos < recordSize) || (le32(m_data + pos) != signatureRecord))
+      invalid("Central directory record " + std::to_string(i) + " is invalid.");
+    const unsigned char * record = m_data + pos;
+    const uint16_t nameLength = le16(record + 28);
+    const uint16_t extraLength = le16(record + 30);
+    const uint16_t commentLength = le16(record + 32);
+    const uint64_t total = recordSize + nameLength + extraLength + commentLength;
+    if (directoryEnd - pos < total)
+      invalid("Central directory record " + std::to_string(i) + " is truncated.");
+
+    uint64_t compressedSize = le32(record + 20);
+    uint64_t size = le32(record + 24);
+    uint64_t localOffset = le32(record + 42);
+    // Values that do not fit into 32 bits are in the ZIP64 extra field.
+    if ((size == 0xFFFFFFFF) || (compressedSize == 0xFFFFFFFF) || (localOffset == 0xFFFFFFFF))
+    {
+      const unsigned char * extra = record + recordSize + nameLength;
+      const unsigned char * extraEnd = extra + extraLength;
+      while (extraEnd - extra >= 4)
+      {
+        const uint16_t id = le16(extra);
+        const uint16_t length = le16(extra + 2);
+        const unsigned char * field = extra + 4;
+        if (extraEnd - field < length)
+          break;
+        if (id == extraZip64)
+        {
+          const unsigned char * fieldEnd = field + length;
+          if ((size == 0xFFFFFFFF) && (fieldEnd - field >= 8))
+          {
+            size = le64(field);
+            field += 8;
+          }
+          if ((compressedSize == 0xFFFFFFFF) && (fieldEnd - field >= 8))
+          {
+            compressedSize = le64(field);
+            field += 8;
+          }
+          if ((localOffset == 0xFFFFFFFF) && (fieldEnd - field >= 8))
+            localOffset = le64(field);
+          break;
+        }
+        extra = field + length;
+      } // while
+    }
+    const uint64_t maxValue = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    if ((size > maxValue) || (compressedSize > maxValue) || (localOffset > maxValue))
+      invalid("Central directory record " + std::to_string(i) + " has invalid sizes.");
+
+    m_nameOffsets[i] = pos + recordSize;
+    m_nameLengths[i] = nameLength;
+    m_sizes[i] = static_cast<int64_t>(size);
+    m_compressedSizes[i] = static_cast<int64_t>(compressedSize);
+    m_crcs[i] = le32(record + 16);
+    m_dosTimes[i] = (static_cast<uint32_t>(le16(record + 14)) << 16) | le16(record + 12);
+    m_methods[i] = le16(record + 10);
+    m_flags[i] = le16(record + 8);
+    m_localOffsets[i] = static_cast<int64_t>(localOffset);
+    pos += total;
+  } // for
+}
+
+int64_t centralDirectory::numEntries() const
+{
+  return static_cast<int64_t>(m_sizes.size());
+}
+
+std::string_view centralDirectory::name(const std::size_t index) const
+{
+  return std::string_view(reinterpret_cast<const char*>(m_data + m_nameOffsets[index]), m_nameLengths[index]);
+}
+
+int64_t centralDirectory::size(const std::size_t index) const
+{
+  return m_sizes[index];
+}
+
+int64_t centralDirectory::sizeCompressed(const std::size_t index) const
+{
+  return m_compressedSizes[index];
+}
+
+uint32_t centralDirectory::crc(const std::size_t index) const
+{
+  return m_crcs[index];
+}
+
+uint16_t centralDirectory::method(const std::size_t index) const
+{
+  return m_methods[index];
+}
+
+int64_t centralDirectory::localHeaderOffset(const std::size_t index) const
+{
+  return m_localOffsets[index];
+}
+
+bool centralDirectory::isEncrypted(const std::size_t index) const
+{
+  return (m_flags[index] & 1) != 0;
+}
+
+int64_t centralDirectory::dataOffset(const std::size_t index) const
+{
+  const uint64_t offset = static_cast<uint64_t>(m_localOffsets[index]);
+  if ((offset > m_size) || (m_size - offset < localSize)
+      || (le32(m_data + offset) != signatureLocal))
+    return -1;
+  // Name and extra field of the local header may differ from the ones in
+  // the central directory.
+  const uint64_t start = offset + localSize + le16(m_data + offset + 26) + le16(m_data + offset + 28);
+  if ((start > m_size) || (m_size - start < static_cast<uint64_t>(m_compressedSizes[index])))
+    return -1;
+  return static_cast<int64_t>(start);
+}
+
+std::time_t centralDirectory::m_time(const std::size_t index) const
+{
+  return dosToTime(m_dosTimes[index]);
+}
+
+bool centralDirectory::isDirectory(const std::size_t index) const
+{
+  return (m_sizes[index] == 0) && (m_nameLengths[index] > 0)
+      && (m_data[m_nameOffsets[index] + m_nameLengths[index] - 1] == '/');
+}
+
+int64_t centralDirectory::locate(const std::string_view name) const
+{
+  if (m_index.size() != m_sizes.size())
+  {
+    m_index.clear();
+    // The first entry with a name wins, like in zip_name_locate().
+    for (std::size_t i = 0; i < m_sizes.size(); ++i)
+      m_index.add(this->name(i));
+  }
+  return m_index.find(name);
+}
+
+bool centralDirectory::forEachEntry(const libstriezel::archive::EntryVisitor& visitor) const
+{
+  timeConverter times;
+  for (std::size_t i = 0; i < m_sizes.size(); ++i)
+  {
+    const libstriezel::archive::entryView view { static_cast<int64_t>(i), name(i), m_sizes[i],
+                                                 times.convert(m_dosTimes[i]), isDirectory(i), false };
+    if (!visitor(view))
+      return false;
+  }
+  return true;
+}
+
+void centralDirectory::fillEntryTable(libstriezel::archive::entryTable& table) const
+{
+  table.clear();
+  std::size_t nameBytes = 0;
+  for (const uint16_t length : m_nameLengths)
+    nameBytes += length;
+  table.reserve(m_sizes.size(), nameBytes);
+  timeConverter times;
+  for (std::size_t i = 0; i < m_sizes.size(); ++i)
+  {
+    const libstriezel::archive::entryView view { static_cast<int64_t>(i), name(i), m_sizes[i],
+                                                 times.convert(m_dosTimes[i]), isDirectory(i), false };
+    table.add(view, m_compressedSizes[i], m_crcs[i]);
+  }
+}
+
+} // namespace
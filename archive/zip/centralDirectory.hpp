@@ -0,0 +1,223 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_ZIP_CENTRALDIRECTORY_HPP
+#define LIBSTRIEZEL_ZIP_CENTRALDIRECTORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../entryIndex.hpp"
+#include "../entryTable.hpp"
+#include "../entryView.hpp"
+#include "../fileMapping.hpp"
+
+namespace libstriezel::zip
+{
+
+/** \brief reads the central directory of a ZIP archive without libzip
+ *
+ * The file is mapped into memory and the records of the central directory
+ * are parsed into arrays. Names are not copied, they point into the mapped
+ * file. ZIP64 archives are supported, split archives are not.
+ */
+class centralDirectory
+{
+  public:
+    /** \brief constructor - maps a ZIP file into memory and parses its
+     * central directory
+     *
+     * \param fileName  -  file name of the ZIP archive
+     * \remarks This function throws an exception, if the file cannot be
+     *          mapped or has no valid central directory.
+     */
+    centralDirectory(const std::string& fileName);
+
+
+    /** \brief constructor - parses the central directory of a ZIP archive in
+     * memory
+     *
+     * \param data  pointer to the start of the archive data - the data must
+     *              stay valid as long as the object exists
+     * \param size  size of the archive data in bytes
+     * \remarks This function throws an exception, if the data has no valid
+     *          central directory.
+     */
+    centralDirectory(const void* data, const std::size_t size);
+
+
+    /* Delete unwanted default copy constructor, assignment operator and
+       move constructor. */
+    centralDirectory(const centralDirectory& op) = delete;
+    centralDirectory & operator=(const centralDirectory& op) = delete;
+    centralDirectory(const centralDirectory&& op) = delete;
+
+
+    /** \brief Returns the number of entries in the archive.
+     *
+     * \return Returns the number of entries.
+     */
+    int64_t numEntries() const;
+
+
+    /** \brief Gets the name of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the name as stored in the archive, without any
+     *         conversion of the character set. The view points into the
+     *         archive data.
+     */
+    std::string_view name(const std::size_t index) const;
+
+
+    /** \brief Gets the uncompressed size of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the uncompressed size in bytes.
+     */
+    int64_t size(const std::size_t index) const;
+
+
+    /** \brief Gets the compressed size of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the compressed size in bytes.
+     */
+    int64_t sizeCompressed(const std::size_t index) const;
+
+
+    /** \brief Gets the CRC-32 of the data of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the CRC-32 of the uncompressed data.
+     */
+    uint32_t crc(const std::size_t index) const;
+
+
+    /** \brief Gets the compression method of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the compression method, e.g. 0 for stored data or 8
+     *         for deflated data.
+     */
+    uint16_t method(const std::size_t index) const;
+
+
+    /** \brief Gets the offset of the local header of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the offset of the local header from the start of
+     *         the archive.
+     */
+    int64_t localHeaderOffset(const std::size_t index) const;
+
+
+    /** \brief Checks whether the data of an entry is encrypted.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns true, if the entry is encrypted.
+     */
+    bool isEncrypted(const std::size_t index) const;
+
+
+    /** \brief Gets the offset of the data of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the offset of the first byte after the local header
+     *         from the start of the archive. Returns -1, if the local
+     *         header is invalid or the data does not fit into the archive.
+     * \remarks Unlike the other functions, this reads the local header.
+     */
+    int64_t dataOffset(const std::size_t index) const;
+
+
+    /** \brief Gets the modification time of an entry.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns the modification time, converted from the MS-DOS
+     *         time in the local time zone, just like libzip does it.
+     */
+    std::time_t m_time(const std::size_t index) const;
+
+
+    /** \brief Checks whether an entry is a directory.
+     *
+     * \param index  index of the entry, must be less than numEntries()
+     * \return Returns true, if the entry has a size of zero and a name that
+     *         ends with a slash. Returns false otherwise.
+     */
+    bool isDirectory(const std::size_t index) const;
+
+
+    /** \brief Gets the index of the entry with the given name.
+     *
+     * \param name  the exact name of the entry
+     * \return Returns the index of the first entry with that name.
+     *         Returns -1, if there is no such entry.
+     * \remarks The index of the names is built during the first call.
+     */
+    int64_t locate(const std::string_view name) const;
+
+
+    /** \brief Passes all entries to a visitor, one at a time.
+     *
+     * \param visitor  callback that gets a view of each entry
+     * \return Returns true, if all entries were visited.
+     *         Returns false, if the visitor stopped.
+     */
+    bool forEachEntry(const libstriezel::archive::EntryVisitor& visitor) const;
+
+
+    /** \brief Fills a compact table with all entries.
+     *
+     * \param table  the table, its previous content is removed
+     */
+    void fillEntryTable(libstriezel::archive::entryTable& table) const;
+  private:
+    /** \brief Finds and parses the end of central directory record and all
+     * records of the central directory.
+     *
+     * \remarks This function throws an exception, if the data is not valid.
+     */
+    void parse();
+
+
+    const unsigned char * m_data; /**< start of the archive data */
+    std::size_t m_size; /**< size of the archive data */
+    std::unique_ptr<libstriezel::archive::fileMapping> m_file; /**< the mapped file, or nullptr for data in memory */
+    std::vector<uint64_t> m_nameOffsets; /**< offsets of the names in the data */
+    std::vector<uint16_t> m_nameLengths; /**< lengths of the names */
+    std::vector<int64_t> m_sizes; /**< uncompressed sizes */
+    std::vector<int64_t> m_compressedSizes; /**< compressed sizes */
+    std::vector<uint32_t> m_crcs; /**< CRC-32 values */
+    std::vector<uint32_t> m_dosTimes; /**< MS-DOS date (high word) and time (low word) */
+    std::vector<uint16_t> m_methods; /**< compression methods */
+    std::vector<uint16_t> m_flags; /**< general purpose bit flags */
+    std::vector<int64_t> m_localOffsets; /**< offsets of the local headers */
+    mutable libstriezel::archive::entryIndex m_index; /**< index of the names for locate() */
+};
+
+} // namespace
+
+#endif // LIBSTRIEZEL_ZIP_CENTRALDIRECTORY_HPP
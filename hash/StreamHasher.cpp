@@ -0,0 +1,207 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "StreamHasher.hpp"
+#include <cstring>
+
+namespace libstriezel::hash
+{
+
+namespace
+{
+
+/** \brief Appends data to a block buffer and processes every block that is
+ * complete afterwards. Full blocks are processed straight from the data
+ * without copying them into the buffer first.
+ *
+ * \param buffer   buffer for the incomplete block
+ * \param fill     number of bytes in the buffer
+ * \param data     pointer to the data
+ * \param length   length of the data in bytes
+ * \param process  function that processes a single block
+ */
+template<std::size_t blockSize, typename ProcessFunction>
+void feed(uint8_t* buffer, std::size_t& fill, const uint8_t* data, std::size_t length,
+          ProcessFunction process)
+{
+  if (fill > 0)
+  {
+    const std::size_t missing = blockSize - fill;
+    if (length < missing)
+    {
+      std::memcpy(buffer + fill, data, length);
+      fill += length;
+      return;
+    }
+    std::memcpy(buffer + fill, data, missing);
+    process(buffer);
+    data += missing;
+    length -= missing;
+    fill = 0;
+  }
+  while (length >= blockSize)
+  {
+    process(data);
+    data += blockSize;
+    length -= blockSize;
+  }
+  if (length > 0)
+  {
+    std::memcpy(buffer, data, length);
+    fill = length;
+  }
+}
+
+/** \brief Writes a 64 bit value in big endian byte order.
+ *
+ * \param value        the value
+ * \param destination  pointer to the first of eight destination bytes
+ */
+void writeBigEndian(const uint64_t value, uint8_t* destination)
+{
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    destination[i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+  }
+}
+
+/// algorithms with 64 byte blocks and 32 bit words
+const unsigned int algorithms32 = sha1 | sha224 | sha256;
+/// algorithms with 128 byte blocks and 64 bit words
+const unsigned int algorithms64 = sha384 | sha512;
+
+} // anonymous namespace
+
+StreamHasher::StreamHasher(const unsigned int algorithms)
+: m_algorithms(algorithms & allAlgorithms),
+  m_length(0),
+  m_fill32(0),
+  m_fill64(0)
+{
+  reset();
+}
+
+unsigned int StreamHasher::algorithms() const
+{
+  return m_algorithms;
+}
+
+void StreamHasher::reset()
+{
+  m_length = 0;
+  m_fill32 = 0;
+  m_fill64 = 0;
+  SHA1::initializeState(m_sha1);
+  SHA224::initializeState(m_sha224);
+  SHA256::initializeState(m_sha256);
+  SHA384::initializeState(m_sha384);
+  SHA512::initializeState(m_sha512);
+}
+
+void StreamHasher::processBlock32(const uint8_t* block)
+{
+  SHA256::MessageBlock msgBlock;
+  std::memcpy(msgBlock.words, block, 64);
+  // conversion to host byte order is shared by all three algorithms
+  msgBlock.reverseBlock();
+  if ((m_algorithms & sha1) != 0)
+    SHA1::processBlock(m_sha1, msgBlock);
+  if ((m_algorithms & sha224) != 0)
+    SHA224::processBlock(m_sha224, msgBlock);
+  if ((m_algorithms & sha256) != 0)
+    SHA256::processBlock(m_sha256, msgBlock);
+}
+
+void StreamHasher::processBlock64(const uint8_t* block)
+{
+  SHA512::MessageBlock msgBlock;
+  std::memcpy(msgBlock.words, block, 128);
+  msgBlock.reverseBlock();
+  if ((m_algorithms & sha384) != 0)
+    SHA384::processBlock(m_sha384, msgBlock);
+  if ((m_algorithms & sha512) != 0)
+    SHA512::processBlock(m_sha512, msgBlock);
+}
+
+void StreamHasher::update(const void* data, const std::size_t length)
+{
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  m_length += length;
+  if ((m_algorithms & algorithms32) != 0)
+  {
+    feed<64>(m_buffer32, m_fill32, bytes, length,
+             [this](const uint8_t* block) { processBlock32(block); });
+  }
+  if ((m_algorithms & algorithms64) != 0)
+  {
+    feed<128>(m_buffer64, m_fill64, bytes, length,
+              [this](const uint8_t* block) { processBlock64(block); });
+  }
+}
+
+Digests StreamHasher::finish()
+{
+  Digests result;
+  if ((m_algorithms & algorithms32) != 0)
+  {
+    // padding: single one bit, zeros, 64 bit message length in bits
+    m_buffer32[m_fill32++] = 0x80;
+    if (m_fill32 > 56)
+    {
+      std::memset(m_buffer32 + m_fill32, 0, 64 - m_fill32);
+      processBlock32(m_buffer32);
+      m_fill32 = 0;
+    }
+    std::memset(m_buffer32 + m_fill32, 0, 56 - m_fill32);
+    writeBigEndian(m_length << 3, m_buffer32 + 56);
+    processBlock32(m_buffer32);
+
+    if ((m_algorithms & sha1) != 0)
+      std::memcpy(result.sha1.hash, m_sha1, sizeof(m_sha1));
+    if ((m_algorithms & sha224) != 0)
+      result.sha224 = SHA224::MessageDigest(m_sha224);
+    if ((m_algorithms & sha256) != 0)
+      std::memcpy(result.sha256.hash, m_sha256, sizeof(m_sha256));
+  }
+  if ((m_algorithms & algorithms64) != 0)
+  {
+    // padding: single one bit, zeros, 128 bit message length in bits
+    m_buffer64[m_fill64++] = 0x80;
+    if (m_fill64 > 112)
+    {
+      std::memset(m_buffer64 + m_fill64, 0, 128 - m_fill64);
+      processBlock64(m_buffer64);
+      m_fill64 = 0;
+    }
+    std::memset(m_buffer64 + m_fill64, 0, 112 - m_fill64);
+    writeBigEndian(m_length >> 61, m_buffer64 + 112);
+    writeBigEndian(m_length << 3, m_buffer64 + 120);
+    processBlock64(m_buffer64);
+
+    if ((m_algorithms & sha384) != 0)
+      result.sha384 = SHA384::MessageDigest(m_sha384);
+    if ((m_algorithms & sha512) != 0)
+      std::memcpy(result.sha512.hash, m_sha512, sizeof(m_sha512));
+  }
+  reset();
+  return result;
+}
+
+} // namespace
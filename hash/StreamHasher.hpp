@@ -0,0 +1,136 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_HASH_STREAMHASHER_HPP
+#define LIBSTRIEZEL_HASH_STREAMHASHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "sha1/sha1.hpp"
+#include "sha224/sha224.hpp"
+#include "sha256/sha256.hpp"
+#include "sha384/sha384.hpp"
+#include "sha512/sha512.hpp"
+
+namespace libstriezel::hash
+{
+
+/** \brief flags for the hash algorithms a StreamHasher can compute,
+ * can be combined with bitwise or
+ */
+enum Algorithm : unsigned int
+{
+  sha1   = 1,
+  sha224 = 2,
+  sha256 = 4,
+  sha384 = 8,
+  sha512 = 16,
+
+  /** all of the above */
+  allAlgorithms = sha1 | sha224 | sha256 | sha384 | sha512
+};
+
+
+/** \brief message digests of a single message
+ *
+ * \remarks Digests of algorithms that were not requested are "null" digests.
+ */
+struct Digests
+{
+  SHA1::MessageDigest sha1;
+  SHA224::MessageDigest sha224;
+  SHA256::MessageDigest sha256;
+  SHA384::MessageDigest sha384;
+  SHA512::MessageDigest sha512;
+};
+
+
+/** \brief Computes one or more message digests of data that arrives in
+ * chunks of arbitrary size, e.g. straight from a decompression buffer.
+ */
+class StreamHasher
+{
+  public:
+    /** \brief constructor
+     *
+     * \param algorithms  the algorithms to compute, combination of Algorithm flags
+     */
+    explicit StreamHasher(const unsigned int algorithms);
+
+
+    /** \brief Gets the algorithms this hasher computes.
+     *
+     * \return Returns a combination of Algorithm flags.
+     */
+    unsigned int algorithms() const;
+
+
+    /** \brief Resets the hasher to the state of an empty message.
+     */
+    void reset();
+
+
+    /** \brief Appends data to the message.
+     *
+     * \param data    pointer to the data
+     * \param length  length of the data in bytes
+     */
+    void update(const void* data, const std::size_t length);
+
+
+    /** \brief Finishes the message and gets the message digests.
+     *
+     * \return Returns the message digests of all data passed to update()
+     *         since construction or the last call to reset().
+     * \remarks The hasher is reset afterwards, so it can be used for the
+     *          next message right away.
+     */
+    Digests finish();
+  private:
+    /** \brief Processes one 64 byte block for SHA-1, SHA-224 and SHA-256.
+     *
+     * \param block  pointer to the block
+     */
+    void processBlock32(const uint8_t* block);
+
+
+    /** \brief Processes one 128 byte block for SHA-384 and SHA-512.
+     *
+     * \param block  pointer to the block
+     */
+    void processBlock64(const uint8_t* block);
+
+
+    unsigned int m_algorithms; /**< algorithms to compute */
+    uint64_t m_length; /**< message length in bytes */
+    uint32_t m_sha1[5]; /**< SHA-1 state */
+    uint32_t m_sha224[8]; /**< SHA-224 state */
+    uint32_t m_sha256[8]; /**< SHA-256 state */
+    uint64_t m_sha384[8]; /**< SHA-384 state */
+    uint64_t m_sha512[8]; /**< SHA-512 state */
+    uint8_t m_buffer32[64]; /**< incomplete block for the 32 bit algorithms */
+    std::size_t m_fill32; /**< number of bytes in m_buffer32 */
+    uint8_t m_buffer64[128]; /**< incomplete block for the 64 bit algorithms */
+    std::size_t m_fill64; /**< number of bytes in m_buffer64 */
+};
+
+} // namespace
+
+#endif // LIBSTRIEZEL_HASH_STREAMHASHER_HPP
@@ -0,0 +1,116 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "FileSourceUtility.hpp"
+#include <vector>
+#include "afalg.hpp"
+#include "../sha1/FileSourceUtility.hpp"
+#include "../sha224/FileSourceUtility.hpp"
+#include "../sha256/FileSourceUtility.hpp"
+#include "../sha384/FileSourceUtility.hpp"
+#include "../sha512/FileSourceUtility.hpp"
+
+namespace libstriezel::hash
+{
+
+namespace
+{
+
+/** \brief Computes the digest of a file with the selected backend.
+ *
+ * \param algorithm   kernel name of the algorithm, e.g. "sha256"
+ * \param digestSize  size of the digest in bytes
+ * \param fileName    name of the file
+ * \param backend     the implementation that shall compute the hash
+ * \param library     function that computes the digest in the library
+ * \return Returns the message digest on success.
+ *         Returns the "null" message digest, if an error occurred.
+ */
+template<typename Digest>
+Digest computeWithBackend(const std::string& algorithm, const std::size_t digestSize,
+                          const std::string& fileName, const Backend backend,
+                          Digest (*library)(const std::string&))
+{
+  if (backend != Backend::library)
+  {
+    std::vector<uint8_t> raw;
+    Digest md;
+    if (afalg::computeFromFile(algorithm, digestSize, fileName, raw)
+        && md.fromHexString(afalg::toHexString(raw)))
+      return md;
+    if (backend == Backend::kernel)
+      return Digest();
+  }
+  return library(fileName);
+}
+
+} // anonymous namespace
+
+} // namespace
+
+namespace SHA1
+{
+
+MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend)
+{
+  return libstriezel::hash::computeWithBackend<MessageDigest>("sha1", 20, fileName, backend, SHA1::computeFromFile);
+}
+
+} // namespace
+
+namespace SHA224
+{
+
+MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend)
+{
+  return libstriezel::hash::computeWithBackend<MessageDigest>("sha224", 28, fileName, backend, SHA224::computeFromFile);
+}
+
+} // namespace
+
+namespace SHA256
+{
+
+MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend)
+{
+  return libstriezel::hash::computeWithBackend<MessageDigest>("sha256", 32, fileName, backend, SHA256::computeFromFile);
+}
+
+} // namespace
+
+namespace SHA384
+{
+
+MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend)
+{
+  return libstriezel::hash::computeWithBackend<MessageDigest>("sha384", 48, fileName, backend, SHA384::computeFromFile);
+}
+
+} // namespace
+
+namespace SHA512
+{
+
+MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend)
+{
+  return libstriezel::hash::computeWithBackend<MessageDigest>("sha512", 64, fileName, backend, SHA512::computeFromFile);
+}
+
+} // namespace
@@ -0,0 +1,115 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_HASH_KERNEL_FILESOURCEUTILITY_HPP
+#define LIBSTRIEZEL_HASH_KERNEL_FILESOURCEUTILITY_HPP
+
+#include <string>
+#include "../sha1/sha1.hpp"
+#include "../sha224/sha224.hpp"
+#include "../sha256/sha256.hpp"
+#include "../sha384/sha384.hpp"
+#include "../sha512/sha512.hpp"
+
+namespace libstriezel::hash
+{
+
+/** \brief enumeration of implementations that can compute a hash */
+enum class Backend
+{
+  /** use the kernel implementation, if available, and fall back to the
+      implementation of the library otherwise */
+  automatic,
+
+  /** use the kernel implementation via AF_ALG only */
+  kernel,
+
+  /** use the implementation of the library only */
+  library
+};
+
+} // namespace
+
+namespace SHA1
+{
+  /** \brief computes and returns the message digest of the given file's contents
+   *
+   * \param fileName    name of the file
+   * \param backend     the implementation that shall compute the hash
+   * \return Returns the SHA1 message digest on success.
+   *         Returns the "null" message digest (i.e. all bits set to zero),
+   *         if an error occurred.
+   */
+  MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend);
+} // namespace
+
+namespace SHA224
+{
+  /** \brief computes and returns the message digest of the given file's contents
+   *
+   * \param fileName    name of the file
+   * \param backend     the implementation that shall compute the hash
+   * \return Returns the SHA224 message digest on success.
+   *         Returns the "null" message digest (i.e. all bits set to zero),
+   *         if an error occurred.
+   */
+  MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend);
+} // namespace
+
+namespace SHA256
+{
+  /** \brief computes and returns the message digest of the given file's contents
+   *
+   * \param fileName    name of the file
+   * \param backend     the implementation that shall compute the hash
+   * \return Returns the SHA256 message digest on success.
+   *         Returns the "null" message digest (i.e. all bits set to zero),
+   *         if an error occurred.
+   */
+  MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend);
+} // namespace
+
+namespace SHA384
+{
+  /** \brief computes and returns the message digest of the given file's contents
+   *
+   * \param fileName    name of the file
+   * \param backend     the implementation that shall compute the hash
+   * \return Returns the SHA384 message digest on success.
+   *         Returns the "null" message digest (i.e. all bits set to zero),
+   *         if an error occurred.
+   */
+  MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend);
+} // namespace
+
+namespace SHA512
+{
+  /** \brief computes and returns the message digest of the given file's contents
+   *
+   * \param fileName    name of the file
+   * \param backend     the implementation that shall compute the hash
+   * \return Returns the SHA512 message digest on success.
+   *         Returns the "null" message digest (i.e. all bits set to zero),
+   *         if an error occurred.
+   */
+  MessageDigest computeFromFile(const std::string& fileName, const libstriezel::hash::Backend backend);
+} // namespace
+
+#endif // LIBSTRIEZEL_HASH_KERNEL_FILESOURCEUTILITY_HPP
@@ -0,0 +1,223 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "afalg.hpp"
+#if defined(__linux__) || defined(linux)
+  #if defined(__has_include)
+    #if __has_include(<linux/if_alg.h>)
+      #define LIBSTRIEZEL_HAS_AF_ALG
+    #endif
+  #endif
+#endif
+
+#if defined(LIBSTRIEZEL_HAS_AF_ALG)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/if_alg.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifndef AF_ALG
+#define AF_ALG 38
+#endif
+#endif
+
+namespace libstriezel::hash::afalg
+{
+
+#if defined(LIBSTRIEZEL_HAS_AF_ALG)
+namespace
+{
+
+/// closes the wrapped file descriptor when it goes out of scope
+class Descriptor
+{
+  public:
+    explicit Descriptor(const int fd)
+    : m_fd(fd)
+    {
+    }
+
+    ~Descriptor()
+    {
+      if (m_fd >= 0)
+        close(m_fd);
+    }
+
+    Descriptor(const Descriptor& op) = delete;
+    Descriptor & operator=(const Descriptor& op) = delete;
+
+    int get() const
+    {
+      return m_fd;
+    }
+
+    bool valid() const
+    {
+      return m_fd >= 0;
+    }
+  private:
+    int m_fd;
+};
+
+/** \brief Creates a transformation socket bound to the given hash algorithm.
+ *
+ * \param algorithm  kernel name of the algorithm
+ * \return Returns the socket descriptor in case of success.
+ *         Returns -1, if an error occurred.
+ */
+int bindHashSocket(const std::string& algorithm)
+{
+  struct sockaddr_alg address;
+  if (algorithm.empty() || (algorithm.size() >= sizeof(address.salg_name)))
+    return -1;
+  std::memset(&address, 0, sizeof(address));
+  address.salg_family = AF_ALG;
+  std::memcpy(address.salg_type, "hash", 5);
+  std::memcpy(address.salg_name, algorithm.c_str(), algorithm.size() + 1);
+
+  const int fd = socket(AF_ALG, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return -1;
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+  {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+} // anonymous namespace
+#endif
+
+bool isAvailable(const std::string& algorithm)
+{
+  #if defined(LIBSTRIEZEL_HAS_AF_ALG)
+  const Descriptor transform(bindHashSocket(algorithm));
+  return transform.valid();
+  #else
+  (void) algorithm;
+  return false;
+  #endif
+}
+
+bool computeFromFile(const std::string& algorithm, const std::size_t digestSize,
+                     const std::string& fileName, std::vector<uint8_t>& digest)
+{
+  #if defined(LIBSTRIEZEL_HAS_AF_ALG)
+  const Descriptor transform(bindHashSocket(algorithm));
+  if (!transform.valid())
+    return false;
+  const Descriptor operation(accept(transform.get(), nullptr, nullptr));
+  if (!operation.valid())
+    return false;
+  const Descriptor file(open(fileName.c_str(), O_RDONLY | O_CLOEXEC));
+  if (!file.valid())
+    return false;
+  struct stat status;
+  if ((fstat(file.get(), &status) != 0) || !S_ISREG(status.st_mode))
+    return false;
+
+  /* splice() needs a pipe on one side of the transfer, so the file contents
+     take the route file -> pipe -> socket. Only page references are moved
+     that way, the data itself never lands in user space. */
+  int pipeFds[2];
+  if (pipe2(pipeFds, O_CLOEXEC) != 0)
+    return false;
+  const Descriptor pipeRead(pipeFds[0]);
+  const Descriptor pipeWrite(pipeFds[1]);
+  // Larger pipes mean fewer system calls, but the default size works, too.
+  fcntl(pipeWrite.get(), F_SETPIPE_SZ, 1024 * 1024);
+  const int pipeSize = fcntl(pipeWrite.get(), F_GETPIPE_SZ);
+  const std::size_t chunkSize = pipeSize > 0 ? static_cast<std::size_t>(pipeSize) : 65536;
+
+  loff_t offset = 0;
+  while (true)
+  {
+    const ssize_t bytesIn = splice(file.get(), &offset, pipeWrite.get(), nullptr,
+                                   chunkSize, SPLICE_F_MOVE);
+    if (bytesIn < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    // end of file
+    if (bytesIn == 0)
+      break;
+    ssize_t remaining = bytesIn;
+    while (remaining > 0)
+    {
+      /* SPLICE_F_MORE becomes MSG_MORE on the socket, and that tells the
+         kernel that the hash is not finished yet. */
+      const ssize_t bytesOut = splice(pipeRead.get(), nullptr, operation.get(),
+                                      nullptr, remaining,
+                                      SPLICE_F_MOVE | SPLICE_F_MORE);
+      if (bytesOut < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      if (bytesOut == 0)
+        return false;
+      remaining -= bytesOut;
+    } // while
+  } // while
+
+  // An empty message without MSG_MORE finalizes the hash.
+  if (send(operation.get(), nullptr, 0, 0) < 0)
+    return false;
+  digest.resize(digestSize);
+  ssize_t bytesRead = -1;
+  do
+  {
+    bytesRead = read(operation.get(), digest.data(), digestSize);
+  } while ((bytesRead < 0) && (errno == EINTR));
+  if ((bytesRead < 0) || (static_cast<std::size_t>(bytesRead) != digestSize))
+  {
+    digest.clear();
+    return false;
+  }
+  return true;
+  #else
+  (void) algorithm;
+  (void) digestSize;
+  (void) fileName;
+  (void) digest;
+  return false;
+  #endif
+}
+
+std::string toHexString(const std::vector<uint8_t>& digest)
+{
+  const char cHexDigits[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+  std::string result;
+  result.reserve(digest.size() * 2);
+  for (const uint8_t byte : digest)
+  {
+    result.push_back(cHexDigits[byte >> 4]);
+    result.push_back(cHexDigits[byte & 0x0F]);
+  }
+  return result;
+}
+
+} // namespace
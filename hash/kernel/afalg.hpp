@@ -0,0 +1,67 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_HASH_KERNEL_AFALG_HPP
+#define LIBSTRIEZEL_HASH_KERNEL_AFALG_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace libstriezel::hash::afalg
+{
+
+/** \brief Checks whether the kernel crypto API offers a hash algorithm via
+ * the AF_ALG socket interface.
+ *
+ * \param algorithm  kernel name of the algorithm, e.g. "sha256"
+ * \return Returns true, if the algorithm can be used through AF_ALG.
+ *         Returns false, if not. Always returns false on systems other than
+ *         Linux.
+ */
+bool isAvailable(const std::string& algorithm);
+
+
+/** \brief Computes the message digest of a file's contents with the hash
+ * implementation of the kernel.
+ *
+ * \param algorithm  kernel name of the algorithm, e.g. "sha256"
+ * \param digestSize size of the algorithm's digest in bytes
+ * \param fileName   name of the file
+ * \param digest     vector that will hold the raw message digest bytes
+ * \return Returns true, if the digest could be computed.
+ *         Returns false, if an error occurred.
+ * \remarks The file contents are moved to the kernel via splice(), so they
+ *          are never copied into user space.
+ */
+bool computeFromFile(const std::string& algorithm, const std::size_t digestSize,
+                     const std::string& fileName, std::vector<uint8_t>& digest);
+
+
+/** \brief Converts raw digest bytes into a lower case hexadecimal string.
+ *
+ * \param digest   the raw digest bytes
+ * \return Returns the hexadecimal representation of the digest.
+ */
+std::string toHexString(const std::vector<uint8_t>& digest);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_HASH_KERNEL_AFALG_HPP
@@ -153,64 +153,68 @@ uint32_t f_t(const uint8_t t, const uint32_t x, const uint32_t y, const uint32_t
   throw std::invalid_argument("f_t(): values of t have to be less than 80!");
 }
 
-MessageDigest computeFromSource(MessageSource& source)
+void initializeState(uint32_t state[5])
 {
-  MessageBlock msgBlock;
+  //set initial value
+  state[0] = 0x67452301;
+  state[1] = 0xefcdab89;
+  state[2] = 0x98badcfe;
+  state[3] = 0x10325476;
+  state[4] = 0xc3d2e1f0;
+}
 
+void processBlock(uint32_t hash[5], const MessageBlock& msgBlock)
+{
   uint32_t msg_schedule[80];
   uint32_t a, b, c, d, e;
   uint32_t temp1;
-  MessageDigest H;
-
-  H.setToNull();
-
-  //setup stuff should have been done before this, so go on with hash initialization
+  unsigned int t; //Laufvariable
 
-  //set initial value
-  H.hash[0] = 0x67452301;
-  H.hash[1] = 0xefcdab89;
-  H.hash[2] = 0x98badcfe;
-  H.hash[3] = 0x10325476;
-  H.hash[4] = 0xc3d2e1f0;
+  // 1. prepare message schedule
+  for (t=0; t<16; ++t)
+  {
+    msg_schedule[t] = msgBlock.words[t];
+  }//for t
+  for (t=16; t<80; ++t)
+  {
+    msg_schedule[t] = SHA1_256::rotl(1, msg_schedule[t-3] ^ msg_schedule[t-8] ^ msg_schedule[t-14] ^ msg_schedule[t-16]);
+  }//for run
+
+  // 2. init. working vars
+  a = hash[0];
+  b = hash[1];
+  c = hash[2];
+  d = hash[3];
+  e = hash[4];
+
+  // 3. for loop
+  for (t=0; t<80; ++t)
+  {
+    temp1 = SHA1_256::rotl(5, a) + f_t(t, b, c, d) + e + sha1_k[t] + msg_schedule[t];
+    e = d;
+    d = c;
+    c = SHA1_256::rotl(30, b);
+    b = a;
+    a = temp1;
+  }//for t
+
+  // 4. compute next intermediate hash value
+  hash[0] = a + hash[0];
+  hash[1] = b + hash[1];
+  hash[2] = c + hash[2];
+  hash[3] = d + hash[3];
+  hash[4] = e + hash[4];
+}
 
-  unsigned int t; //Laufvariable
+MessageDigest computeFromSource(MessageSource& source)
+{
+  MessageBlock msgBlock;
+  MessageDigest H;
 
+  initializeState(H.hash);
   while (source.getNextMessageBlock(msgBlock))
   {
-    // 1. prepare message schedule
-    for (t=0; t<16; ++t)
-    {
-      msg_schedule[t] = msgBlock.words[t];
-    }//for t
-    for (t=16; t<80; ++t)
-    {
-      msg_schedule[t] = SHA1_256::rotl(1, msg_schedule[t-3] ^ msg_schedule[t-8] ^ msg_schedule[t-14] ^ msg_schedule[t-16]);
-    }//for run
-
-    // 2. init. working vars
-    a = H.hash[0];
-    b = H.hash[1];
-    c = H.hash[2];
-    d = H.hash[3];
-    e = H.hash[4];
-
-    // 3. for loop
-    for (t=0; t<80; ++t)
-    {
-      temp1 = SHA1_256::rotl(5, a) + f_t(t, b, c, d) + e + sha1_k[t] + msg_schedule[t];
-      e = d;
-      d = c;
-      c = SHA1_256::rotl(30, b);
-      b = a;
-      a = temp1;
-    }//for t
-
-    // 4. compute next intermediate hash value
-    H.hash[0] = a + H.hash[0];
-    H.hash[1] = b + H.hash[1];
-    H.hash[2] = c + H.hash[2];
-    H.hash[3] = d + H.hash[3];
-    H.hash[4] = e + H.hash[4];
+    processBlock(H.hash, msgBlock);
   }//while message blocks are there
 
   return H;
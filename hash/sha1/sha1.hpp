@@ -77,6 +77,25 @@ namespace SHA1
    *         if an error occurred.
    */
   MessageDigest computeFromSource(MessageSource& source);
+
+
+  /** \brief sets the hash state to the initial hash value of SHA1
+   *
+   * \param state   the hash state that shall be initialized
+   */
+  void initializeState(uint32_t state[5]);
+
+
+  /** \brief processes a single message block and updates the hash state
+   *
+   * \param hash     the current hash state
+   * \param msgBlock the next message block, words already converted to host
+   *                 byte order by reverseBlock()
+   * \remarks This is the compression function of SHA1. Callers that feed
+   *          data incrementally (e.g. from a decompression buffer) can use it
+   *          together with initializeState() instead of computeFromSource().
+   */
+  void processBlock(uint32_t hash[5], const MessageBlock& msgBlock);
 }//SHA1 namespace
 
 #endif // LIBSTRIEZEL_SHA_1_HPP
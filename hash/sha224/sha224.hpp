@@ -98,6 +98,25 @@ namespace SHA224
    *         if an error occurred.
    */
   MessageDigest computeFromSource(MessageSource& source);
+
+
+  /** \brief sets the hash state to the initial hash value of SHA224
+   *
+   * \param state   the hash state that shall be initialized
+   */
+  void initializeState(uint32_t state[8]);
+
+
+  /** \brief processes a single message block and updates the hash state
+   *
+   * \param hash     the current hash state
+   * \param msgBlock the next message block, words already converted to host
+   *                 byte order by reverseBlock()
+   * \remarks This is the compression function of SHA224. Callers that feed
+   *          data incrementally (e.g. from a decompression buffer) can use it
+   *          together with initializeState() instead of computeFromSource().
+   */
+  void processBlock(uint32_t hash[8], const MessageBlock& msgBlock);
 } //namespace
 
 #endif // LIBSTRIEZEL_SHA224_HPP
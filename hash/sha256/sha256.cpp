@@ -165,92 +165,96 @@ bool isValidHash(const std::string& hash)
   return true;
 }
 
-MessageDigest computeFromSource(MessageSource& source)
+void initializeState(uint32_t state[8])
 {
-  MessageBlock msgBlock;
+  //set initial value
+  state[0] = 0x6a09e667;
+  state[1] = 0xbb67ae85;
+  state[2] = 0x3c6ef372;
+  state[3] = 0xa54ff53a;
+  state[4] = 0x510e527f;
+  state[5] = 0x9b05688c;
+  state[6] = 0x1f83d9ab;
+  state[7] = 0x5be0cd19;
+}
 
+void processBlock(uint32_t hash[8], const MessageBlock& msgBlock)
+{
   uint32_t msg_schedule[64];
   uint32_t a, b, c, d, e, f, g, h;
   uint32_t temp1, temp2;
-  MessageDigest H;
-
-  H.setToNull();
+  unsigned int t; //loop variable
 
-  //setup stuff should have been done before this, so go on with hash initialization
+  // 1. prepare message schedule
+  for (t=0; t<16; ++t)
+  {
+    msg_schedule[t] = msgBlock.words[t];
+  }//for t
+  #ifdef SHA256_DEBUG
+  for (t=0; t<16; ++t)
+  {
+    std::dec(std::cout);
+    std::cout << "W["<<t<<"] = ";
+    std::hex(std::cout);
+    std::cout <<msg_schedule[t]<<"\n";
+  }//for
+  #endif
+  for (t=16; t<64; ++t)
+  {
+    msg_schedule[t] = sigmaOne(msg_schedule[t-2]) + msg_schedule[t-7] + sigmaZero(msg_schedule[t-15]) + msg_schedule[t-16];
+  }//for run
 
-  //set initial value
-  H.hash[0] = 0x6a09e667;
-  H.hash[1] = 0xbb67ae85;
-  H.hash[2] = 0x3c6ef372;
-  H.hash[3] = 0xa54ff53a;
-  H.hash[4] = 0x510e527f;
-  H.hash[5] = 0x9b05688c;
-  H.hash[6] = 0x1f83d9ab;
-  H.hash[7] = 0x5be0cd19;
+  // 2. init. working vars
+  a = hash[0];
+  b = hash[1];
+  c = hash[2];
+  d = hash[3];
+  e = hash[4];
+  f = hash[5];
+  g = hash[6];
+  h = hash[7];
 
-  unsigned int t; //loop variable
-
-  while (source.getNextMessageBlock(msgBlock))
+  // 3. for loop
+  for (t=0; t<64; ++t)
   {
-    // 1. prepare message schedule
-    for (t=0; t<16; ++t)
-    {
-      msg_schedule[t] = msgBlock.words[t];
-    }//for t
+    temp1 = h + CapitalSigmaOne(e) + SHA1_256::Ch(e, f, g) + sha256_k[t] + msg_schedule[t];
+    temp2 = CapitalSigmaZero(a) + SHA1_256::Maj(a, b, c);
+    h = g;
+    g = f;
+    f = e;
+    e = d + temp1;
+    d = c;
+    c = b;
+    b = a;
+    a = temp1 + temp2;
     #ifdef SHA256_DEBUG
-    for (t=0; t<16; ++t)
-    {
-      std::dec(std::cout);
-      std::cout << "W["<<t<<"] = ";
-      std::hex(std::cout);
-      std::cout <<msg_schedule[t]<<"\n";
-    }//for
+    std::dec(std::cout);
+    std::cout << "t="<<t<<": a to h: ";
+    std::hex(std::cout);
+    std::cout <<a<<" "<<b<<" "<<c<<" "<<d<<" "<<e<<" "<<f<<" "<<g<<" "<<h<<"\n";
     #endif
-    for (t=16; t<64; ++t)
-    {
-      msg_schedule[t] = sigmaOne(msg_schedule[t-2]) + msg_schedule[t-7] + sigmaZero(msg_schedule[t-15]) + msg_schedule[t-16];
-    }//for run
+  }//for t
 
-    // 2. init. working vars
-    a = H.hash[0];
-    b = H.hash[1];
-    c = H.hash[2];
-    d = H.hash[3];
-    e = H.hash[4];
-    f = H.hash[5];
-    g = H.hash[6];
-    h = H.hash[7];
+  // 4. compute next intermediate hash value
+  hash[0] = a + hash[0];
+  hash[1] = b + hash[1];
+  hash[2] = c + hash[2];
+  hash[3] = d + hash[3];
+  hash[4] = e + hash[4];
+  hash[5] = f + hash[5];
+  hash[6] = g + hash[6];
+  hash[7] = h + hash[7];
+}
 
-    // 3. for loop
-    for (t=0; t<64; ++t)
-    {
-      temp1 = h + CapitalSigmaOne(e) + SHA1_256::Ch(e, f, g) + sha256_k[t] + msg_schedule[t];
-      temp2 = CapitalSigmaZero(a) + SHA1_256::Maj(a, b, c);
-      h = g;
-      g = f;
-      f = e;
-      e = d + temp1;
-      d = c;
-      c = b;
-      b = a;
-      a = temp1 + temp2;
-      #ifdef SHA256_DEBUG
-      std::dec(std::cout);
-      std::cout << "t="<<t<<": a to h: ";
-      std::hex(std::cout);
-      std::cout <<a<<" "<<b<<" "<<c<<" "<<d<<" "<<e<<" "<<f<<" "<<g<<" "<<h<<"\n";
-      #endif
-    }//for t
+MessageDigest computeFromSource(MessageSource& source)
+{
+  MessageBlock msgBlock;
+  MessageDigest H;
 
-    // 4. compute next intermediate hash value
-    H.hash[0] = a + H.hash[0];
-    H.hash[1] = b + H.hash[1];
-    H.hash[2] = c + H.hash[2];
-    H.hash[3] = d + H.hash[3];
-    H.hash[4] = e + H.hash[4];
-    H.hash[5] = f + H.hash[5];
-    H.hash[6] = g + H.hash[6];
-    H.hash[7] = h + H.hash[7];
+  initializeState(H.hash);
+  while (source.getNextMessageBlock(msgBlock))
+  {
+    processBlock(H.hash, msgBlock);
   }//while message blocks are there
 
   return H;
@@ -148,90 +148,96 @@ bool MessageDigest::operator<(const MessageDigest& other) const
 }
 
 
-MessageDigest computeFromSource(MessageSource& source)
+void initializeState(uint64_t state[8])
 {
-  MessageBlock msgBlock;
+  //set initial value
+  state[0] = 0xcbbb9d5dc1059ed8;
+  state[1] = 0x629a292a367cd507;
+  state[2] = 0x9159015a3070dd17;
+  state[3] = 0x152fecd8f70e5939;
+  state[4] = 0x67332667ffc00b31;
+  state[5] = 0x8eb44a8768581511;
+  state[6] = 0xdb0c2e0d64f98fa7;
+  state[7] = 0x47b5481dbefa4fa4;
+}
 
+void processBlock(uint64_t hash[8], const MessageBlock& msgBlock)
+{
   uint64_t msg_schedule[80];
   uint64_t a, b, c, d, e, f, g, h;
   uint64_t temp1, temp2;
-  uint64_t hash[8];
-
-  //setup stuff should have been done before this, so go on with hash initialization
-
-  //set initial value
-  hash[0] = 0xcbbb9d5dc1059ed8;
-  hash[1] = 0x629a292a367cd507;
-  hash[2] = 0x9159015a3070dd17;
-  hash[3] = 0x152fecd8f70e5939;
-  hash[4] = 0x67332667ffc00b31;
-  hash[5] = 0x8eb44a8768581511;
-  hash[6] = 0xdb0c2e0d64f98fa7;
-  hash[7] = 0x47b5481dbefa4fa4;
-
   unsigned int t; //loop variable
 
-  while (source.getNextMessageBlock(msgBlock))
+  // 1. prepare message schedule
+  for (t=0; t<16; ++t)
   {
-    // 1. prepare message schedule
-    for (t=0; t<16; ++t)
-    {
-      msg_schedule[t] = msgBlock.words[t];
-    }//for t
+    msg_schedule[t] = msgBlock.words[t];
+  }//for t
+  #ifdef SHA384_DEBUG
+  for (t=0; t<16; ++t)
+  {
+    std::dec(std::cout);
+    std::cout << "W["<<t<<"] = ";
+    std::hex(std::cout);
+    std::cout <<msg_schedule[t]<<"\n";
+  }//for
+  #endif
+  for (t=16; t<80; ++t)
+  {
+    msg_schedule[t] = SHA512::sigmaOne(msg_schedule[t-2]) + msg_schedule[t-7] + SHA512::sigmaZero(msg_schedule[t-15]) + msg_schedule[t-16];
+  }//for run
+
+  // 2. init. working vars
+  a = hash[0];
+  b = hash[1];
+  c = hash[2];
+  d = hash[3];
+  e = hash[4];
+  f = hash[5];
+  g = hash[6];
+  h = hash[7];
+
+  // 3. for loop
+  for (t=0; t<80; ++t)
+  {
+    temp1 = h + SHA512::CapitalSigmaOne(e) + SHA512::Ch(e, f, g) + SHA512::sha512_k[t] + msg_schedule[t];
+    temp2 = SHA512::CapitalSigmaZero(a) + SHA512::Maj(a, b, c);
+    h = g;
+    g = f;
+    f = e;
+    e = d + temp1;
+    d = c;
+    c = b;
+    b = a;
+    a = temp1 + temp2;
     #ifdef SHA384_DEBUG
-    for (t=0; t<16; ++t)
-    {
-      std::dec(std::cout);
-      std::cout << "W["<<t<<"] = ";
-      std::hex(std::cout);
-      std::cout <<msg_schedule[t]<<"\n";
-    }//for
+    std::dec(std::cout);
+    std::cout << "t="<<t<<": a to h: ";
+    std::hex(std::cout);
+    std::cout <<a<<" "<<b<<" "<<c<<" "<<d<<" "<<e<<" "<<f<<" "<<g<<" "<<h<<"\n";
     #endif
-    for (t=16; t<80; ++t)
-    {
-      msg_schedule[t] = SHA512::sigmaOne(msg_schedule[t-2]) + msg_schedule[t-7] + SHA512::sigmaZero(msg_schedule[t-15]) + msg_schedule[t-16];
-    }//for run
-
-    // 2. init. working vars
-    a = hash[0];
-    b = hash[1];
-    c = hash[2];
-    d = hash[3];
-    e = hash[4];
-    f = hash[5];
-    g = hash[6];
-    h = hash[7];
-
-    // 3. for loop
-    for (t=0; t<80; ++t)
-    {
-      temp1 = h + SHA512::CapitalSigmaOne(e) + SHA512::Ch(e, f, g) + SHA512::sha512_k[t] + msg_schedule[t];
-      temp2 = SHA512::CapitalSigmaZero(a) + SHA512::Maj(a, b, c);
-      h = g;
-      g = f;
-      f = e;
-      e = d + temp1;
-      d = c;
-      c = b;
-      b = a;
-      a = temp1 + temp2;
-      #ifdef SHA384_DEBUG
-      std::dec(std::cout);
-      std::cout << "t="<<t<<": a to h: ";
-      std::hex(std::cout);
-      std::cout <<a<<" "<<b<<" "<<c<<" "<<d<<" "<<e<<" "<<f<<" "<<g<<" "<<h<<"\n";
-      #endif
-    }//for t
-
-    // 4. compute next intermediate hash value
-    hash[0] = a + hash[0];
-    hash[1] = b + hash[1];
-    hash[2] = c + hash[2];
-    hash[3] = d + hash[3];
-    hash[4] = e + hash[4];
-    hash[5] = f + hash[5];
-    hash[6] = g + hash[6];
-    hash[7] = h + hash[7];
+  }//for t
+
+  // 4. compute next intermediate hash value
+  hash[0] = a + hash[0];
+  hash[1] = b + hash[1];
+  hash[2] = c + hash[2];
+  hash[3] = d + hash[3];
+  hash[4] = e + hash[4];
+  hash[5] = f + hash[5];
+  hash[6] = g + hash[6];
+  hash[7] = h + hash[7];
+}
+
+MessageDigest computeFromSource(MessageSource& source)
+{
+  MessageBlock msgBlock;
+  uint64_t hash[8];
+
+  initializeState(hash);
+  while (source.getNextMessageBlock(msgBlock))
+  {
+    processBlock(hash, msgBlock);
   }//while message blocks are there
 
   return MessageDigest(hash);
@@ -138,90 +138,96 @@ bool MessageDigest::operator<(const MessageDigest& other) const
 }
 
 
-MessageDigest computeFromSource(MessageSource& source)
+void initializeState(uint64_t state[8])
 {
-  MessageBlock msgBlock;
+  //set initial value
+  state[0] = 0x6a09e667f3bcc908;
+  state[1] = 0xbb67ae8584caa73b;
+  state[2] = 0x3c6ef372fe94f82b;
+  state[3] = 0xa54ff53a5f1d36f1;
+  state[4] = 0x510e527fade682d1;
+  state[5] = 0x9b05688c2b3e6c1f;
+  state[6] = 0x1f83d9abfb41bd6b;
+  state[7] = 0x5be0cd19137e2179;
+}
 
+void processBlock(uint64_t hash[8], const MessageBlock& msgBlock)
+{
   uint64_t msg_schedule[80];
   uint64_t a, b, c, d, e, f, g, h;
   uint64_t temp1, temp2;
-  MessageDigest H;
-
-  //setup stuff should have been done before this, so go on with hash initialization
-
-  //set initial value
-  H.hash[0] = 0x6a09e667f3bcc908;
-  H.hash[1] = 0xbb67ae8584caa73b;
-  H.hash[2] = 0x3c6ef372fe94f82b;
-  H.hash[3] = 0xa54ff53a5f1d36f1;
-  H.hash[4] = 0x510e527fade682d1;
-  H.hash[5] = 0x9b05688c2b3e6c1f;
-  H.hash[6] = 0x1f83d9abfb41bd6b;
-  H.hash[7] = 0x5be0cd19137e2179;
-
   unsigned int t; //loop variable
 
-  while (source.getNextMessageBlock(msgBlock))
+  // 1. prepare message schedule
+  for (t=0; t<16; ++t)
   {
-    // 1. prepare message schedule
-    for (t=0; t<16; ++t)
-    {
-      msg_schedule[t] = msgBlock.words[t];
-    }//for t
+    msg_schedule[t] = msgBlock.words[t];
+  }//for t
+  #ifdef SHA512_DEBUG
+  for (t=0; t<16; ++t)
+  {
+    std::dec(std::cout);
+    std::cout << "W["<<t<<"] = ";
+    std::hex(std::cout);
+    std::cout <<msg_schedule[t]<<"\n";
+  }//for
+  #endif
+  for (t=16; t<80; ++t)
+  {
+    msg_schedule[t] = sigmaOne(msg_schedule[t-2]) + msg_schedule[t-7] + sigmaZero(msg_schedule[t-15]) + msg_schedule[t-16];
+  }//for run
+
+  // 2. init. working vars
+  a = hash[0];
+  b = hash[1];
+  c = hash[2];
+  d = hash[3];
+  e = hash[4];
+  f = hash[5];
+  g = hash[6];
+  h = hash[7];
+
+  // 3. for loop
+  for (t=0; t<80; ++t)
+  {
+    temp1 = h + CapitalSigmaOne(e) + SHA512::Ch(e, f, g) + sha512_k[t] + msg_schedule[t];
+    temp2 = CapitalSigmaZero(a) + SHA512::Maj(a, b, c);
+    h = g;
+    g = f;
+    f = e;
+    e = d + temp1;
+    d = c;
+    c = b;
+    b = a;
+    a = temp1 + temp2;
     #ifdef SHA512_DEBUG
-    for (t=0; t<16; ++t)
-    {
-      std::dec(std::cout);
-      std::cout << "W["<<t<<"] = ";
-      std::hex(std::cout);
-      std::cout <<msg_schedule[t]<<"\n";
-    }//for
+    std::dec(std::cout);
+    std::cout << "t="<<t<<": a to h: ";
+    std::hex(std::cout);
+    std::cout <<a<<" "<<b<<" "<<c<<" "<<d<<" "<<e<<" "<<f<<" "<<g<<" "<<h<<"\n";
     #endif
-    for (t=16; t<80; ++t)
-    {
-      msg_schedule[t] = sigmaOne(msg_schedule[t-2]) + msg_schedule[t-7] + sigmaZero(msg_schedule[t-15]) + msg_schedule[t-16];
-    }//for run
-
-    // 2. init. working vars
-    a = H.hash[0];
-    b = H.hash[1];
-    c = H.hash[2];
-    d = H.hash[3];
-    e = H.hash[4];
-    f = H.hash[5];
-    g = H.hash[6];
-    h = H.hash[7];
-
-    // 3. for loop
-    for (t=0; t<80; ++t)
-    {
-      temp1 = h + CapitalSigmaOne(e) + SHA512::Ch(e, f, g) + sha512_k[t] + msg_schedule[t];
-      temp2 = CapitalSigmaZero(a) + SHA512::Maj(a, b, c);
-      h = g;
-      g = f;
-      f = e;
-      e = d + temp1;
-      d = c;
-      c = b;
-      b = a;
-      a = temp1 + temp2;
-      #ifdef SHA512_DEBUG
-      std::dec(std::cout);
-      std::cout << "t="<<t<<": a to h: ";
-      std::hex(std::cout);
-      std::cout <<a<<" "<<b<<" "<<c<<" "<<d<<" "<<e<<" "<<f<<" "<<g<<" "<<h<<"\n";
-      #endif
-    }//for t
-
-    // 4. compute next intermediate hash value
-    H.hash[0] = a + H.hash[0];
-    H.hash[1] = b + H.hash[1];
-    H.hash[2] = c + H.hash[2];
-    H.hash[3] = d + H.hash[3];
-    H.hash[4] = e + H.hash[4];
-    H.hash[5] = f + H.hash[5];
-    H.hash[6] = g + H.hash[6];
-    H.hash[7] = h + H.hash[7];
+  }//for t
+
+  // 4. compute next intermediate hash value
+  hash[0] = a + hash[0];
+  hash[1] = b + hash[1];
+  hash[2] = c + hash[2];
+  hash[3] = d + hash[3];
+  hash[4] = e + hash[4];
+  hash[5] = f + hash[5];
+  hash[6] = g + hash[6];
+  hash[7] = h + hash[7];
+}
+
+MessageDigest computeFromSource(MessageSource& source)
+{
+  MessageBlock msgBlock;
+  MessageDigest H;
+
+  initializeState(H.hash);
+  while (source.getNextMessageBlock(msgBlock))
+  {
+    processBlock(H.hash, msgBlock);
   }//while message blocks are there
 
   return H;
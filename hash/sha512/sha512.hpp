@@ -80,6 +80,25 @@ namespace SHA512
    *         if an error occurred.
    */
   MessageDigest computeFromSource(MessageSource& source);
+
+
+  /** \brief sets the hash state to the initial hash value of SHA512
+   *
+   * \param state   the hash state that shall be initialized
+   */
+  void initializeState(uint64_t state[8]);
+
+
+  /** \brief processes a single message block and updates the hash state
+   *
+   * \param hash     the current hash state
+   * \param msgBlock the next message block, words already converted to host
+   *                 byte order by reverseBlock()
+   * \remarks This is the compression function of SHA512. Callers that feed
+   *          data incrementally (e.g. from a decompression buffer) can use it
+   *          together with initializeState() instead of computeFromSource().
+   */
+  void processBlock(uint64_t hash[8], const MessageBlock& msgBlock);
 }//SHA512 namespace
 
 #endif // SHA512_HPP_INCLUDED
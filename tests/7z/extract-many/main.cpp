@@ -0,0 +1,399 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include <lzma.h>
+#include "../../../archive/7z/archive.hpp"
+#include "../../../archive/7z/folders.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+
+/* An item of the test archive. Items with folder -1 have no data. */
+struct item
+{
+  std::string name;
+  std::string content;
+  int folder;
+  bool directory;
+};
+
+/* Creates compressible text that is different for every seed. */
+std::string createText(const std::size_t size, uint32_t seed)
+{
+  std::string text(size, ' ');
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    text[i] = ((seed >> 16) % 3 == 0) ? static_cast<char>('a' + (seed >> 20) % 26)
+                                       : static_cast<char>('0' + (i / 1000) % 10);
+  }
+  return text;
+}
+
+/* Appends a number in the variable length encoding of 7z. */
+void putNumber(std::vector<uint8_t>& out, const uint64_t value)
+{
+  unsigned int extra = 0;
+  while ((extra < 8) && (value >= (static_cast<uint64_t>(1) << (7 * (extra + 1)))))
+    ++extra;
+  uint8_t first = 0;
+  for (unsigned int i = 0; i < extra; ++i)
+    first |= static_cast<uint8_t>(0x80 >> i);
+  if (extra < 8)
+    first |= static_cast<uint8_t>(value >> (8 * extra));
+  out.push_back(first);
+  for (unsigned int i = 0; i < extra; ++i)
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void putLittle(std::vector<uint8_t>& out, const uint64_t value, const unsigned int bytes)
+{
+  for (unsigned int i = 0; i < bytes; ++i)
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+/* Appends a property with a bit vector, most significant bit first. */
+void putBits(std::vector<uint8_t>& out, const uint8_t id, const std::vector<bool>& bits)
+{
+  std::vector<uint8_t> bytes((bits.size() + 7) / 8, 0);
+  for (std::size_t i = 0; i < bits.size(); ++i)
+  {
+    if (bits[i])
+      bytes[i / 8] |= static_cast<uint8_t>(0x80 >> (i % 8));
+  }
+  out.push_back(id);
+  putNumber(out, bytes.size());
+  out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+/* Compresses data with LZMA1 or LZMA2 and without any container. */
+bool compressRaw(const lzma_vli filterId, const std::string& data, std::vector<uint8_t>& packed,
+                 std::vector<uint8_t>& properties)
+{
+  lzma_options_lzma options;
+  if (lzma_lzma_preset(&options, 1))
+    return false;
+  lzma_filter filters[2] = { { filterId, &options }, { LZMA_VLI_UNKNOWN, nullptr } };
+  uint32_t propertySize = 0;
+  if (lzma_properties_size(&propertySize, &filters[0]) != LZMA_OK)
+    return false;
+  properties.assign(propertySize, 0);
+  if (lzma_properties_encode(&filters[0], properties.data()) != LZMA_OK)
+    return false;
+  packed.assign(data.size() + data.size() / 2 + 1024, 0);
+  std::size_t size = 0;
+  if (lzma_raw_buffer_encode(filters, nullptr, reinterpret_cast<const uint8_t*>(data.data()),
+                             data.size(), packed.data(), &size, packed.size()) != LZMA_OK)
+    return false;
+  packed.resize(size);
+  return true;
+}
+
+/* Builds a 7z archive whose files are compressed with LZMA2 in the given
+   number of folders. If encodeHeader is true, the header gets compressed
+   with LZMA, like 7-Zip does it by default. */
+bool buildArchive(const std::vector<item>& items, const int folders, const bool encodeHeader,
+                  std::vector<uint8_t>& result)
+{
+  std::vector<uint8_t> packedData;
+  std::vector<uint64_t> packSizes;
+  std::vector<uint64_t> unpackSizes;
+  std::vector<uint8_t> folderProperties;
+  std::vector<std::vector<uint64_t> > streamSizes(folders);
+  for (int f = 0; f < folders; ++f)
+  {
+    std::string data;
+    for (const auto& i : items)
+    {
+      if (i.folder == f)
+      {
+        data += i.content;
+        streamSizes[f].push_back(i.content.size());
+      }
+    }
+    std::vector<uint8_t> packed;
+    if (!compressRaw(LZMA_FILTER_LZMA2, data, packed, folderProperties))
+      return false;
+    packedData.insert(packedData.end(), packed.begin(), packed.end());
+    packSizes.push_back(packed.size());
+    unpackSizes.push_back(data.size());
+  }
+
+  std::vector<uint8_t> header;
+  header.push_back(0x01); // kHeader
+  header.push_back(0x04); // kMainStreamsInfo
+  header.push_back(0x06); // kPackInfo
+  putNumber(header, 0);
+  putNumber(header, folders);
+  header.push_back(0x09); // kSize
+  for (const auto size : packSizes)
+    putNumber(header, size);
+  header.push_back(0x00);
+  header.push_back(0x07); // kUnPackInfo
+  header.push_back(0x0B); // kFolder
+  putNumber(header, folders);
+  header.push_back(0x00);
+  for (int f = 0; f < folders; ++f)
+  {
+    putNumber(header, 1);
+    header.push_back(0x21); // one byte id, with properties
+    header.push_back(0x21); // LZMA2
+    putNumber(header, folderProperties.size());
+    header.insert(header.end(), folderProperties.begin(), folderProperties.end());
+  }
+  header.push_back(0x0C); // kCodersUnPackSize
+  for (const auto size : unpackSizes)
+    putNumber(header, size);
+  header.push_back(0x00);
+  header.push_back(0x08); // kSubStreamsInfo
+  header.push_back(0x0D); // kNumUnPackStream
+  for (const auto& sizes : streamSizes)
+    putNumber(header, sizes.size());
+  header.push_back(0x09); // kSize
+  for (const auto& sizes : streamSizes)
+  {
+    for (std::size_t i = 0; i + 1 < sizes.size(); ++i)
+      putNumber(header, sizes[i]);
+  }
+  header.push_back(0x00);
+  header.push_back(0x00);
+
+  header.push_back(0x05); // kFilesInfo
+  putNumber(header, items.size());
+  std::vector<bool> emptyStream;
+  std::vector<bool> emptyFile;
+  for (const auto& i : items)
+  {
+    emptyStream.push_back(i.folder < 0);
+    if (i.folder < 0)
+      emptyFile.push_back(!i.directory);
+  }
+  putBits(header, 0x0E, emptyStream);
+  putBits(header, 0x0F, emptyFile);
+  std::vector<uint8_t> names;
+  names.push_back(0x00); // not external
+  for (const auto& i : items)
+  {
+    for (const char c : i.name)
+      putLittle(names, static_cast<uint8_t>(c), 2);
+    putLittle(names, 0, 2);
+  }
+  header.push_back(0x11); // kName
+  putNumber(header, names.size());
+  header.insert(header.end(), names.begin(), names.end());
+  header.push_back(0x00);
+  header.push_back(0x00);
+
+  if (encodeHeader)
+  {
+    std::vector<uint8_t> packed;
+    std::vector<uint8_t> properties;
+    if (!compressRaw(LZMA_FILTER_LZMA1, std::string(header.begin(), header.end()), packed, properties))
+      return false;
+    std::vector<uint8_t> encoded;
+    encoded.push_back(0x17); // kEncodedHeader
+    encoded.push_back(0x06); // kPackInfo
+    putNumber(encoded, packedData.size());
+    putNumber(encoded, 1);
+    encoded.push_back(0x09);
+    putNumber(encoded, packed.size());
+    encoded.push_back(0x00);
+    encoded.push_back(0x07); // kUnPackInfo
+    encoded.push_back(0x0B);
+    putNumber(encoded, 1);
+    encoded.push_back(0x00);
+    putNumber(encoded, 1);
+    encoded.push_back(0x23); // three byte id, with properties
+    encoded.push_back(0x03); // LZMA
+    encoded.push_back(0x01);
+    encoded.push_back(0x01);
+    putNumber(encoded, properties.size());
+    encoded.insert(encoded.end(), properties.begin(), properties.end());
+    encoded.push_back(0x0C);
+    putNumber(encoded, header.size());
+    encoded.push_back(0x00);
+    encoded.push_back(0x00);
+    packedData.insert(packedData.end(), packed.begin(), packed.end());
+    header.swap(encoded);
+  }
+
+  std::vector<uint8_t> startHeader;
+  putLittle(startHeader, packedData.size(), 8);
+  putLittle(startHeader, header.size(), 8);
+  putLittle(startHeader, lzma_crc32(header.data(), header.size(), 0), 4);
+  const std::string signature("7z\xBC\xAF\x27\x1C\x00\x04", 8);
+  result.assign(signature.begin(), signature.end());
+  putLittle(result, lzma_crc32(startHeader.data(), startHeader.size(), 0), 4);
+  result.insert(result.end(), startHeader.begin(), startHeader.end());
+  result.insert(result.end(), packedData.begin(), packedData.end());
+  result.insert(result.end(), header.begin(), header.end());
+  return true;
+}
+
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/* Extracts some files with the given number of threads and checks them. */
+bool checkExtraction(libstriezel::sevenZip::archive& archive, const std::vector<item>& items,
+                     const std::string& directory, const unsigned int threads)
+{
+  std::map<std::string, std::string> files;
+  for (const std::string name : { "b.txt", "c.txt", "e.txt", "empty.txt", "f.txt" })
+    files[name] = directory + libstriezel::filesystem::pathDelimiter + name;
+  files["missing.txt"] = directory + libstriezel::filesystem::pathDelimiter + "missing.txt";
+
+  const std::map<std::string, bool> results = archive.extractMany(files, threads);
+  bool success = true;
+  for (const auto& file : files)
+  {
+    const auto iter = results.find(file.first);
+    const bool expected = file.first != "missing.txt";
+    if ((iter == results.end()) || (iter->second != expected))
+    {
+      std::cout << "Error: Unexpected result for " << file.first << " with "
+                << threads << " thread(s)!" << std::endl;
+      success = false;
+    }
+    if (!expected)
+      continue;
+    for (const auto& i : items)
+    {
+      if ((i.name == file.first) && (readFile(file.second) != i.content))
+      {
+        std::cout << "Error: Content of " << file.first << " is wrong after extraction with "
+                  << threads << " thread(s)!" << std::endl;
+        success = false;
+      }
+    }
+    libstriezel::filesystem::file::remove(file.second);
+  }
+  return success;
+}
+
+int main()
+{
+  const std::vector<item> items = {
+    { "dir", "", -1, true },
+    { "a.txt", createText(300000, 1), 0, false },
+    { "b.txt", createText(200000, 2), 0, false },
+    { "empty.txt", "", -1, false },
+    { "c.txt", createText(250000, 3), 1, false },
+    { "d.txt", createText(100000, 4), 2, false },
+    { "e.txt", createText(150000, 5), 2, false },
+    { "f.txt", createText(50000, 6), 3, false }
+  };
+  const std::vector<int64_t> expectedFolders = { -1, 0, 0, -1, 1, 2, 2, 3 };
+
+  std::string tempDirName;
+  if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  tempDirName = libstriezel::filesystem::unslashify(tempDirName);
+
+  for (const bool encodeHeader : { false, true })
+  {
+    std::vector<uint8_t> data;
+    if (!buildArchive(items, 4, encodeHeader, data))
+    {
+      std::cout << "Error: Could not create the test archive!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+
+    // folders of the files
+    std::vector<int64_t> folders;
+    const libstriezel::sevenZip::CompressedReader reader =
+        libstriezel::archive::compressedReader("", data.data(), data.size(), nullptr);
+    if (!libstriezel::sevenZip::readFolders(reader, folders) || (folders != expectedFolders))
+    {
+      std::cout << "Error: readFolders() did not find the expected folders!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+    // damaged header
+    std::vector<uint8_t> damaged(data);
+    damaged[damaged.size() - 3] ^= 0x55;
+    const libstriezel::sevenZip::CompressedReader damagedReader =
+        libstriezel::archive::compressedReader("", damaged.data(), damaged.size(), nullptr);
+    if (libstriezel::sevenZip::readFolders(damagedReader, folders))
+    {
+      std::cout << "Error: readFolders() accepted a damaged header!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+
+    const std::string archiveFileName = tempDirName + libstriezel::filesystem::pathDelimiter + "test.7z";
+    {
+      std::ofstream stream(archiveFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+      stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    try
+    {
+      libstriezel::sevenZip::archive fromMemory(data.data(), data.size());
+      libstriezel::sevenZip::archive fromFile(archiveFileName);
+      for (const unsigned int threads : { 1u, 2u, 4u, 0u })
+      {
+        if (!checkExtraction(fromMemory, items, tempDirName, threads)
+            || !checkExtraction(fromFile, items, tempDirName, threads))
+        {
+          libstriezel::filesystem::file::remove(archiveFileName);
+          libstriezel::filesystem::directory::remove(tempDirName);
+          return 1;
+        }
+      }
+      // the archive is still usable after the extraction
+      const std::string destFile = tempDirName + libstriezel::filesystem::pathDelimiter + "a.txt";
+      if (!fromFile.extractTo(destFile, "a.txt") || (readFile(destFile) != items[1].content))
+      {
+        std::cout << "Error: Could not extract a.txt after extractMany()!" << std::endl;
+        libstriezel::filesystem::file::remove(destFile);
+        libstriezel::filesystem::file::remove(archiveFileName);
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      libstriezel::filesystem::file::remove(destFile);
+    }
+    catch (const std::exception& ex)
+    {
+      std::cout << "Error: An exception occurred while working with the 7z archive: "
+                << ex.what() << std::endl;
+      libstriezel::filesystem::file::remove(archiveFileName);
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+    libstriezel::filesystem::file::remove(archiveFileName);
+  }
+  libstriezel::filesystem::directory::remove(tempDirName);
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::7z::archive::extractMany() was successful." << std::endl;
+  return 0;
+}
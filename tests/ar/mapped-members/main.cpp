@@ -0,0 +1,298 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include <archive.h>
+#include <archive_entry.h>
+#include "../../../archive/ar/archive.hpp"
+#include "../../../archive/ar/mappedArchive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../testData.hpp"
+
+/* A member of the test archive: first = name, second = content. */
+typedef std::pair<std::string, std::string> item;
+
+/* function that sets the format of libarchive's writer */
+typedef int (*FormatSetter)(struct archive*);
+
+/* Creates an ar archive with libarchive's writer in the given format. */
+bool createArchive(const std::vector<item>& items, const FormatSetter setFormat, std::vector<char>& data)
+{
+  struct archive * a = archive_write_new();
+  if (setFormat(a) != ARCHIVE_OK)
+  {
+    archive_write_free(a);
+    return false;
+  }
+  archive_write_set_bytes_per_block(a, 0);
+  data.assign(4 * 1024 * 1024, '\0');
+  std::size_t used = 0;
+  if (archive_write_open_memory(a, data.data(), data.size(), &used) != ARCHIVE_OK)
+  {
+    archive_write_free(a);
+    return false;
+  }
+  bool success = true;
+  for (const auto& i : items)
+  {
+    struct archive_entry * entry = archive_entry_new();
+    archive_entry_set_pathname(entry, i.first.c_str());
+    archive_entry_set_mtime(entry, 1700000000 + static_cast<time_t>(i.first.size()), 0);
+    archive_entry_set_filetype(entry, AE_IFREG);
+    archive_entry_set_perm(entry, 0644);
+    archive_entry_set_size(entry, static_cast<la_int64_t>(i.second.size()));
+    success = success && (archive_write_header(a, entry) == ARCHIVE_OK);
+    if (success && !i.second.empty())
+      success = archive_write_data(a, i.second.data(), i.second.size()) == static_cast<la_ssize_t>(i.second.size());
+    archive_entry_free(entry);
+  }
+  success = (archive_write_close(a) == ARCHIVE_OK) && success;
+  archive_write_free(a);
+  data.resize(used);
+  return success;
+}
+
+/* Lists the entries of an archive in memory with libarchive. */
+std::vector<libstriezel::archive::entryLibarchive> listWithLibarchive(const std::vector<char>& data)
+{
+  std::vector<libstriezel::archive::entryLibarchive> result;
+  struct archive * a = archive_read_new();
+  archive_read_support_format_ar(a);
+  if (archive_read_open_memory(a, data.data(), data.size()) == ARCHIVE_OK)
+  {
+    struct archive_entry * ent = nullptr;
+    while (archive_read_next_header(a, &ent) == ARCHIVE_OK)
+      result.emplace_back(ent);
+  }
+  archive_read_free(a);
+  return result;
+}
+
+/* Creates a member header with the given name, size and magic bytes. */
+std::string header(const std::string& name, const std::string& size, const std::string& magic)
+{
+  std::string result(60, ' ');
+  result.replace(0, name.size(), name);
+  result.replace(48, size.size(), size);
+  result.replace(58, 2, magic);
+  return result;
+}
+
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/* Checks listing, member views and extraction of an archive. */
+bool checkArchive(libstriezel::ar::archive& ar, const std::vector<char>& data, const bool inMemory,
+                  const std::vector<item>& items, const std::string& tempDir)
+{
+  const auto expected = listWithLibarchive(data);
+  const auto entries = ar.entries();
+  if (entries.size() != expected.size())
+  {
+    std::cout << "Error: Archive has " << entries.size() << " entries, but libarchive lists "
+              << expected.size() << " entries!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if ((entries[i].name() != expected[i].name()) || (entries[i].size() != expected[i].size())
+        || (entries[i].m_time() != expected[i].m_time())
+        || (entries[i].isDirectory() != expected[i].isDirectory())
+        || (entries[i].isSymLink() != expected[i].isSymLink()))
+    {
+      std::cout << "Error: Entry " << i << " (" << entries[i].name()
+                << ") does not match the entry of libarchive (" << expected[i].name()
+                << ")!" << std::endl;
+      return false;
+    }
+  }
+
+  const std::string destFile = tempDir + libstriezel::filesystem::pathDelimiter + "extracted.dat";
+  for (const auto& i : items)
+  {
+    const void * memberData = nullptr;
+    std::size_t memberSize = 0;
+    if (!ar.memberData(i.first, memberData, memberSize)
+        || (std::string(static_cast<const char*>(memberData), memberSize) != i.second))
+    {
+      std::cout << "Error: View of member " << i.first << " is wrong!" << std::endl;
+      return false;
+    }
+    // views point into the archive data itself, if it is in memory
+    if (inMemory && ((static_cast<const char*>(memberData) < data.data())
+        || (static_cast<const char*>(memberData) + memberSize > data.data() + data.size())))
+    {
+      std::cout << "Error: View of member " << i.first << " is a copy!" << std::endl;
+      return false;
+    }
+    if (!ar.extractTo(destFile, i.first))
+    {
+      std::cout << "Error: Could not extract " << i.first << "!" << std::endl;
+      return false;
+    }
+    const std::string content = readFile(destFile);
+    // existing files are not overwritten
+    const bool overwritten = ar.extractTo(destFile, i.first);
+    libstriezel::filesystem::file::remove(destFile);
+    if (content != i.second)
+    {
+      std::cout << "Error: Content of extracted file " << i.first << " is wrong!" << std::endl;
+      return false;
+    }
+    if (overwritten)
+    {
+      std::cout << "Error: extractTo() overwrote an existing file!" << std::endl;
+      return false;
+    }
+  }
+
+  const void * memberData = nullptr;
+  std::size_t memberSize = 0;
+  if (ar.memberData("does-not-exist.txt", memberData, memberSize))
+  {
+    std::cout << "Error: Got a view of a member that does not exist!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  const std::string longName = "a-file-with-a-name-longer-than-sixteen-characters.dat";
+  const std::string otherLongName = "another-long-name.txt";
+  const std::vector<item> members = {
+    { "a.txt", "Hello, ar!\n" },
+    { "odd.bin", randomData(1001, 1) },
+    { "empty", "" },
+    { longName, randomData(60001, 2) },
+    { otherLongName, "odd" },
+    { "last.txt", "end" }
+  };
+  // GNU archives keep long names in the string table, which comes first.
+  std::vector<item> gnuMembers = members;
+  gnuMembers.insert(gnuMembers.begin(), { "//", longName + "/\n" + otherLongName + "/\n" });
+
+  std::string tempDirName;
+  if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  tempDirName = libstriezel::filesystem::unslashify(tempDirName);
+
+  struct formatCase
+  {
+    std::string name;
+    FormatSetter setFormat;
+    const std::vector<item>* items;
+  };
+  const std::vector<formatCase> formats = {
+    { "BSD", archive_write_set_format_ar_bsd, &members },
+    { "GNU", archive_write_set_format_ar_svr4, &gnuMembers }
+  };
+  for (const auto& format : formats)
+  {
+    std::cout << "Checking " << format.name << " archive ..." << std::endl;
+    std::vector<char> data;
+    if (!createArchive(*format.items, format.setFormat, data))
+    {
+      std::cout << "Error: Could not create the ar archive!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+
+    const std::string arFileName = tempDirName + libstriezel::filesystem::pathDelimiter + "test.a";
+    {
+      std::ofstream stream(arFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+      stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    bool success = false;
+    try
+    {
+      // All members are found by the native reader.
+      const libstriezel::ar::mappedArchive mapped(data.data(), data.size());
+      success = mapped.members().size() == format.items->size();
+      if (!success)
+        std::cout << "Error: Native reader found " << mapped.members().size()
+                  << " members instead of " << format.items->size() << "!" << std::endl;
+      libstriezel::ar::archive fromFile(arFileName);
+      libstriezel::ar::archive fromMemory(data.data(), data.size());
+      success = success && checkArchive(fromFile, data, false, members, tempDirName)
+             && checkArchive(fromMemory, data, true, members, tempDirName);
+    }
+    catch (const std::exception& ex)
+    {
+      std::cout << "Error: An exception occurred while working with the archive: "
+                << ex.what() << std::endl;
+    }
+    libstriezel::filesystem::file::remove(arFileName);
+    if (!success)
+    {
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+  }
+  libstriezel::filesystem::directory::remove(tempDirName);
+
+  // The native reader rejects damaged archives.
+  const std::string signature = "!<arch>\n";
+  const std::vector<std::string> damaged = {
+    signature,
+    signature + "short",
+    signature + header("a.txt/", "99", "`\n"),
+    signature + header("a.txt/", "5", "X\n") + "Hello\n",
+    signature + header("/5", "5", "`\n") + "Hello\n",
+    signature + header("#1/200", "5", "`\n") + "Hello\n"
+  };
+  for (std::size_t i = 0; i < damaged.size(); ++i)
+  {
+    bool thrown = false;
+    std::size_t count = 0;
+    try
+    {
+      const libstriezel::ar::mappedArchive mapped(damaged[i].data(), damaged[i].size());
+      count = mapped.members().size();
+    }
+    catch (const std::exception&)
+    {
+      thrown = true;
+    }
+    // An archive with just the signature is valid, but empty.
+    if ((i == 0) ? (thrown || (count != 0)) : !thrown)
+    {
+      std::cout << "Error: Unexpected result for damaged archive " << i << "!" << std::endl;
+      return 1;
+    }
+  }
+
+  //Everything is OK.
+  std::cout << "Test for native reading of ar archives was successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include "../../../archive/format.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+
+using libstriezel::archive::format;
+
+/* List of test files in tar file directory:
+     first = file name, second = the format that shall be detected
+*/
+const std::vector<std::pair<std::string, format> > fileCases = {
+  { "test_zero.dat" , format::unknown},
+  { "test_128.dat" , format::unknown},
+  { "test_256.dat" , format::unknown},
+  { "test_257.dat" , format::unknown},
+  { "test_258.dat" , format::unknown},
+  { "test_posix_tar.dat" , format::tar},
+  { "test_gnu_tar.dat" , format::tar},
+  { "grep-2.0.tar" , format::tar}
+};
+
+/* Creates a buffer of the given size that contains the given bytes at the
+   given offset. All other bytes are zero. */
+std::vector<char> buffer(const std::size_t size, const std::size_t offset, const std::string& bytes)
+{
+  std::vector<char> result(size, '\0');
+  std::memcpy(result.data() + offset, bytes.data(), bytes.size());
+  return result;
+}
+
+/* Expected parameters: 1 - directory that contains the tar files */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc > 1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  // detection from files
+  for (const auto& item : fileCases)
+  {
+    const std::string fileName = tarDirectory + libstriezel::filesystem::pathDelimiter + item.first;
+    if (!libstriezel::filesystem::file::exists(fileName))
+    {
+      std::cout << "Error: File " << fileName << " does not exist!" << std::endl;
+      return 1;
+    }
+    const format detected = libstriezel::archive::detectFormat(fileName);
+    std::cout << "detectFormat(" << fileName << ") = "
+              << libstriezel::archive::formatName(detected) << std::endl;
+    if (detected != item.second)
+    {
+      std::cout << "Error: Expected format " << libstriezel::archive::formatName(item.second)
+                << " for file " << fileName << "!" << std::endl;
+      return 1;
+    }
+  }
+
+  // detection from memory
+  const std::vector<std::pair<std::vector<char>, format> > bufferCases = {
+    { buffer(512, 0, std::string("7z\xBC\xAF\x27\x1C", 6)), format::sevenZip },
+    { buffer(512, 0, "!<arch>"), format::ar },
+    { buffer(512, 0, std::string("MSCF\0\0\0\0", 8)), format::cab },
+    { buffer(512, 0, "\x1F\x8B"), format::gzip },
+    { buffer(512, 0, "ISc("), format::installShield },
+    { buffer(0x8006, 0x8001, "CD001"), format::iso9660 },
+    { buffer(0x8000, 0, ""), format::unknown },
+    { buffer(512, 0, std::string("Rar!\x1a\x07\0", 7)), format::rar },
+    { buffer(512, 257, std::string("ustar\0", 6)), format::tar },
+    { buffer(512, 0, std::string("\xFD\x37\x7A\x58\x5A\x00", 6)), format::xz },
+    { buffer(512, 0, "PK\x03\x04"), format::zip },
+    { buffer(1, 0, "P"), format::unknown }
+  };
+  for (const auto& item : bufferCases)
+  {
+    const format detected = libstriezel::archive::detectFormat(item.first.data(), item.first.size());
+    if (detected != item.second)
+    {
+      std::cout << "Error: Buffer was detected as " << libstriezel::archive::formatName(detected)
+                << ", but it should be " << libstriezel::archive::formatName(item.second)
+                << "!" << std::endl;
+      return 1;
+    }
+  }
+
+  // files that do not exist have no format
+  if (libstriezel::archive::detectFormat(tarDirectory + libstriezel::filesystem::pathDelimiter + "does-not-exist.tar")
+      != format::unknown)
+  {
+    std::cout << "Error: A file that does not exist has a known format!" << std::endl;
+    return 1;
+  }
+
+  //Everything is OK.
+  std::cout << "Tests for libstriezel::archive::detectFormat() were successful." << std::endl;
+  return 0;
+}
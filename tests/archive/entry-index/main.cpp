@@ -0,0 +1,235 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../../archive/entryIndex.hpp"
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+
+using libstriezel::archive::entryIndex;
+
+/* Prints the ids of a query result and compares them to the expected ids. */
+bool checkIds(const std::vector<std::size_t>& ids, const std::vector<std::size_t>& expected, const std::string& query)
+{
+  if (ids == expected)
+    return true;
+  std::cout << "Error: " << query << " returned the ids";
+  for (const auto id : ids)
+    std::cout << " " << id;
+  std::cout << ", but the expected ids are";
+  for (const auto id : expected)
+    std::cout << " " << id;
+  std::cout << "!" << std::endl;
+  return false;
+}
+
+/* Compares the children of a directory to the expected paths. */
+bool checkChildren(const entryIndex& index, const std::string& directory, const std::vector<std::string_view>& expected)
+{
+  const auto children = index.children(directory);
+  if (children == expected)
+    return true;
+  std::cout << "Error: children(\"" << directory << "\") returned";
+  for (const auto& child : children)
+    std::cout << " " << child;
+  std::cout << "!" << std::endl;
+  return false;
+}
+
+/* Tests the index with a small, hand-made list of names. */
+bool testNames()
+{
+  entryIndex index;
+  const std::vector<std::string> names = {
+    "doc/",                 // 0
+    "doc/readme.txt",       // 1
+    "src/main.cpp",         // 2, src/ has no entry of its own
+    "src/util/string.cpp",  // 3
+    "src/util/string.hpp",  // 4
+    "src/main.cpp",         // 5, duplicate of 2
+    "srcfile.txt",          // 6
+    "LICENSE"               // 7
+  };
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    if (index.add(names[i]) != i)
+    {
+      std::cout << "Error: add() returned the wrong id for " << names[i] << "!" << std::endl;
+      return false;
+    }
+  }
+  if (index.size() != names.size())
+  {
+    std::cout << "Error: Index has " << index.size() << " entries!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    if (index.name(i) != names[i])
+    {
+      std::cout << "Error: Name of id " << i << " is " << index.name(i) << "!" << std::endl;
+      return false;
+    }
+  }
+
+  // lookups, the first of several equal names wins
+  if ((index.find("src/main.cpp") != 2) || (index.find("doc/") != 0) || (index.find("LICENSE") != 7))
+  {
+    std::cout << "Error: find() returned a wrong id!" << std::endl;
+    return false;
+  }
+  if (index.contains("doc") || index.contains("src/") || index.contains("src/util/string")
+      || index.contains("") || (index.find("missing") != -1))
+  {
+    std::cout << "Error: Index contains names that were never added!" << std::endl;
+    return false;
+  }
+
+  // directories
+  if (!index.isDirectory("") || !index.isDirectory("doc") || !index.isDirectory("src/")
+      || !index.isDirectory("src/util") || index.isDirectory("LICENSE") || index.isDirectory("nope"))
+  {
+    std::cout << "Error: isDirectory() returned a wrong result!" << std::endl;
+    return false;
+  }
+  if (!checkChildren(index, "", { "doc", "src", "srcfile.txt", "LICENSE" })
+      || !checkChildren(index, "src/", { "src/main.cpp", "src/util" })
+      || !checkChildren(index, "src/util", { "src/util/string.cpp", "src/util/string.hpp" })
+      || !checkChildren(index, "LICENSE", { })
+      || !checkChildren(index, "nope", { }))
+    return false;
+
+  // prefix and pattern queries
+  if (!checkIds(index.withPrefix(""), { 0, 1, 2, 3, 4, 5, 6, 7 }, "withPrefix(\"\")")
+      || !checkIds(index.withPrefix("src"), { 2, 3, 4, 5, 6 }, "withPrefix(\"src\")")
+      || !checkIds(index.withPrefix("src/"), { 2, 3, 4, 5 }, "withPrefix(\"src/\")")
+      || !checkIds(index.withPrefix("src/util/string."), { 3, 4 }, "withPrefix(\"src/util/string.\")")
+      || !checkIds(index.withPrefix("doc"), { 0, 1 }, "withPrefix(\"doc\")")
+      || !checkIds(index.withPrefix("x/y"), { }, "withPrefix(\"x/y\")"))
+    return false;
+  if (!checkIds(index.match("src/*.cpp"), { 2, 5 }, "match(\"src/*.cpp\")")
+      || !checkIds(index.match("src/**.cpp"), { 2, 3, 5 }, "match(\"src/**.cpp\")")
+      || !checkIds(index.match("*/util/string.?pp"), { 3, 4 }, "match(\"*/util/string.?pp\")")
+      || !checkIds(index.match("*.txt"), { 6 }, "match(\"*.txt\")")
+      || !checkIds(index.match("**.txt"), { 1, 6 }, "match(\"**.txt\")")
+      || !checkIds(index.match("LICENSE"), { 7 }, "match(\"LICENSE\")")
+      || !checkIds(index.match("LICENS"), { }, "match(\"LICENS\")"))
+    return false;
+
+  // many names make the tables grow
+  entryIndex large;
+  for (unsigned int i = 0; i < 5000; ++i)
+    large.add("dir" + std::to_string(i % 7) + "/file" + std::to_string(i));
+  for (unsigned int i = 0; i < 5000; ++i)
+  {
+    if (large.find("dir" + std::to_string(i % 7) + "/file" + std::to_string(i)) != static_cast<int64_t>(i))
+    {
+      std::cout << "Error: Large index does not find file " << i << "!" << std::endl;
+      return false;
+    }
+  }
+  if ((large.children("dir3").size() != 714) || (large.withPrefix("dir6/").size() != 714))
+  {
+    std::cout << "Error: Large index has wrong directory sizes!" << std::endl;
+    return false;
+  }
+
+  index.clear();
+  if ((index.size() != 0) || index.contains("LICENSE") || !index.children("").empty())
+  {
+    std::cout << "Error: Index is not empty after clear()!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/* Expected parameters: 1 - directory that contains the .tar file */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  if (!testNames())
+    return 1;
+
+  const std::string tarFileName = tarDirectory + libstriezel::filesystem::pathDelimiter + "grep-2.0.tar";
+  try
+  {
+    libstriezel::tar::archive tarFile(tarFileName, true);
+    const auto entries = tarFile.entries();
+    const entryIndex& index = tarFile.index();
+    if (index.size() != entries.size())
+    {
+      std::cout << "Error: Index of " << tarFileName << " has " << index.size()
+                << " entries, but the archive has " << entries.size() << "!" << std::endl;
+      return 1;
+    }
+    // compare the queries with a scan over all entries
+    std::vector<std::size_t> expected;
+    std::vector<std::string_view> expectedChildren;
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+      const std::string& name = entries[i].name();
+      if (!tarFile.contains(name) || (index.name(i) != name))
+      {
+        std::cout << "Error: Index does not contain " << name << "!" << std::endl;
+        return 1;
+      }
+      if (name.compare(0, 9, "grep-2.0/") == 0)
+      {
+        expected.push_back(i);
+        const std::string_view rest = std::string_view(name).substr(9);
+        const auto slash = rest.find('/');
+        if (!rest.empty() && ((slash == std::string_view::npos) || (slash + 1 == rest.size())))
+          expectedChildren.push_back(std::string_view(name).substr(0, name.size() - (rest.back() == '/' ? 1 : 0)));
+      }
+    }
+    if (!checkIds(index.withPrefix("grep-2.0/"), expected, "withPrefix(\"grep-2.0/\")"))
+      return 1;
+    if (!checkChildren(index, "grep-2.0", expectedChildren))
+      return 1;
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the tar file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Tests for libstriezel::archive::entryIndex were successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,212 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../archive/entryTable.hpp"
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+
+using libstriezel::archive::entryTable;
+using libstriezel::archive::entryView;
+
+/* Tests the table with a few hand-made entries. */
+bool testRows()
+{
+  entryTable table;
+  if (!table.empty() || (table.size() != 0))
+  {
+    std::cout << "Error: New table is not empty!" << std::endl;
+    return false;
+  }
+  table.reserve(3, 32);
+  table.add(entryView { 0, "dir/", 0, 1000, true, false });
+  table.add(entryView { 7, "dir/file.txt", 1234, 2000, false, false });
+  // the optional columns start with the third row
+  table.add(entryView { 8, "dir/link", -1, -1, false, true }, 99, 0xDEADBEEF);
+  if (table.size() != 3)
+  {
+    std::cout << "Error: Table has " << table.size() << " rows instead of 3!" << std::endl;
+    return false;
+  }
+  if ((table.name(0) != "dir/") || (table.name(1) != "dir/file.txt") || (table.name(2) != "dir/link"))
+  {
+    std::cout << "Error: Table has wrong names!" << std::endl;
+    return false;
+  }
+  if ((table.entrySize(0) != 0) || (table.entrySize(1) != 1234) || (table.entrySize(2) != -1)
+      || (table.m_time(0) != 1000) || (table.m_time(1) != 2000) || (table.m_time(2) != -1))
+  {
+    std::cout << "Error: Table has wrong sizes or times!" << std::endl;
+    return false;
+  }
+  if (!table.isDirectory(0) || table.isDirectory(1) || table.isDirectory(2)
+      || table.isSymLink(0) || table.isSymLink(1) || !table.isSymLink(2))
+  {
+    std::cout << "Error: Table has wrong flags!" << std::endl;
+    return false;
+  }
+  if ((table.compressedSize(0) != -1) || (table.compressedSize(1) != -1) || (table.compressedSize(2) != 99)
+      || (table.crc(0) != 0) || (table.crc(1) != 0) || (table.crc(2) != 0xDEADBEEF))
+  {
+    std::cout << "Error: Table has wrong compressed sizes or CRC values!" << std::endl;
+    return false;
+  }
+  // views use the row as index, entries are created on demand
+  const entryView view = table.view(1);
+  if ((view.index != 1) || (view.name != "dir/file.txt") || (view.size != 1234))
+  {
+    std::cout << "Error: View of row 1 is wrong!" << std::endl;
+    return false;
+  }
+  const libstriezel::archive::entry e = table.at(2);
+  if ((e.name() != "dir/link") || !e.isSymLink() || e.isDirectory() || (e.size() != -1))
+  {
+    std::cout << "Error: Entry of row 2 is wrong!" << std::endl;
+    return false;
+  }
+  if (table.memoryUsage() == 0)
+  {
+    std::cout << "Error: Table claims to use no memory!" << std::endl;
+    return false;
+  }
+  table.clear();
+  if (!table.empty() || (table.compressedSize(0) != -1))
+  {
+    std::cout << "Error: Table is not empty after clear()!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/* Tests the optional columns when the first row already has values and when
+   values show up after rows without them. */
+bool testOptionalColumns()
+{
+  entryTable table;
+  // first row carries both values
+  table.add(entryView { 0, "a.txt", 100, 1000, false, false }, 50, 0x12345678);
+  table.add(entryView { 1, "b.txt", 200, 1000, false, false });
+  // compressed size without CRC and vice versa
+  table.add(entryView { 2, "c.txt", 300, 1000, false, false }, 150);
+  table.add(entryView { 3, "d.txt", 0, 1000, false, false }, -1, 0xCAFE);
+  if ((table.compressedSize(0) != 50) || (table.crc(0) != 0x12345678))
+  {
+    std::cout << "Error: Table lost compressed size or CRC of row 0!" << std::endl;
+    return false;
+  }
+  if ((table.compressedSize(1) != -1) || (table.crc(1) != 0)
+      || (table.compressedSize(2) != 150) || (table.crc(2) != 0)
+      || (table.compressedSize(3) != -1) || (table.crc(3) != 0xCAFE))
+  {
+    std::cout << "Error: Table has wrong compressed sizes or CRC values after row 0!" << std::endl;
+    return false;
+  }
+
+  // values that only show up after several rows without them
+  entryTable late;
+  late.add(entryView { 0, "a", 1, 1000, false, false });
+  late.add(entryView { 1, "b", 2, 1000, false, false });
+  late.add(entryView { 2, "c", 3, 1000, false, false }, -1, 0xBEEF);
+  late.add(entryView { 3, "d", 4, 1000, false, false }, 7);
+  late.add(entryView { 4, "e", 5, 1000, false, false });
+  if ((late.compressedSize(0) != -1) || (late.compressedSize(1) != -1) || (late.compressedSize(2) != -1)
+      || (late.compressedSize(3) != 7) || (late.compressedSize(4) != -1)
+      || (late.crc(0) != 0) || (late.crc(1) != 0) || (late.crc(2) != 0xBEEF)
+      || (late.crc(3) != 0) || (late.crc(4) != 0))
+  {
+    std::cout << "Error: Table has wrong compressed sizes or CRC values for late values!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/* Compares a table to the entries of an archive. */
+bool matches(const entryTable& table, const std::vector<libstriezel::archive::entryLibarchive>& entries, const std::string& kind)
+{
+  if (table.size() != entries.size())
+  {
+    std::cout << "Error: Table of " << kind << " archive has " << table.size()
+              << " rows, but there are " << entries.size() << " entries!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if ((table.name(i) != entries[i].name()) || (table.entrySize(i) != entries[i].size())
+        || (table.m_time(i) != entries[i].m_time())
+        || (table.isDirectory(i) != entries[i].isDirectory())
+        || (table.isSymLink(i) != entries[i].isSymLink()))
+    {
+      std::cout << "Error: Row " << i << " of " << kind << " archive does not match "
+                << entries[i].name() << "!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Expected parameters: 1 - directory that contains the .tar file */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  if (!testRows() || !testOptionalColumns())
+    return 1;
+
+  const std::string tarFileName = tarDirectory + libstriezel::filesystem::pathDelimiter + "grep-2.0.tar";
+  try
+  {
+    libstriezel::tar::archive eagerTar(tarFileName);
+    const auto entries = eagerTar.entries();
+    entryTable table;
+    if (!eagerTar.fillEntryTable(table) || !matches(table, entries, "eager"))
+      return 1;
+
+    // a lazy archive fills the table straight from the headers
+    libstriezel::tar::archive lazyTar(tarFileName, true);
+    if (!lazyTar.fillEntryTable(table) || !matches(table, entries, "lazy"))
+      return 1;
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the tar file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Tests for libstriezel::archive::entryTable were successful." << std::endl;
+  return 0;
+}
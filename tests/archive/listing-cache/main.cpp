@@ -0,0 +1,285 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../../archive/listingCache.hpp"
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+
+/* Checks that the entries of an archive match the expected entries. */
+bool sameEntries(libstriezel::tar::archive& tarFile, const std::vector<libstriezel::archive::entryLibarchive>& expected, const std::string& kind)
+{
+  const auto entries = tarFile.entries();
+  if (entries.size() != expected.size())
+  {
+    std::cout << "Error: " << kind << " archive has " << entries.size() << " entries, but "
+              << expected.size() << " were expected!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if ((entries[i].name() != expected[i].name()) || (entries[i].size() != expected[i].size())
+        || (entries[i].m_time() != expected[i].m_time())
+        || (entries[i].isDirectory() != expected[i].isDirectory()))
+    {
+      std::cout << "Error: Entry " << i << " of " << kind << " archive does not match "
+                << expected[i].name() << "!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Flips one byte in the middle of a file. */
+bool damage(const std::string& fileName)
+{
+  std::fstream stream(fileName, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+  stream.seekg(0, std::ios_base::end);
+  const std::streamoff size = stream.tellg();
+  if (size < 2)
+    return false;
+  stream.seekg(size / 2);
+  char c = 0;
+  stream.read(&c, 1);
+  c = static_cast<char>(c ^ 0x55);
+  stream.seekp(size / 2);
+  stream.write(&c, 1);
+  return stream.good();
+}
+
+/* Expected parameters: 1 - directory that contains the .tar file */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string tarFileName = tarDirectory + libstriezel::filesystem::pathDelimiter + "grep-2.0.tar";
+  if (libstriezel::archive::sidecarName(tarFileName) != tarFileName + ".listing")
+  {
+    std::cout << "Error: Unexpected name of the sidecar file!" << std::endl;
+    return 1;
+  }
+
+  std::string cacheFileName;
+  if (!libstriezel::filesystem::file::createTemp(cacheFileName))
+  {
+    std::cout << "Error: Could not create a temporary file for the cache!" << std::endl;
+    return 1;
+  }
+
+  int result = 0;
+  try
+  {
+    libstriezel::tar::archive eagerTar(tarFileName);
+    const auto expected = eagerTar.entries();
+
+    // The empty temporary file is no valid cache, so the headers are read.
+    {
+      libstriezel::tar::archive firstTar(tarFileName, true);
+      if (firstTar.useListingCache(cacheFileName))
+      {
+        std::cout << "Error: An empty cache file was accepted!" << std::endl;
+        result = 1;
+      }
+      else if (!sameEntries(firstTar, expected, "first"))
+        result = 1;
+    }
+
+    // The second time the entries come from the cache.
+    if (result == 0)
+    {
+      libstriezel::tar::archive cachedTar(tarFileName, true);
+      if (!cachedTar.useListingCache(cacheFileName))
+      {
+        std::cout << "Error: Valid cache file was not used!" << std::endl;
+        result = 1;
+      }
+      else if (!sameEntries(cachedTar, expected, "cached"))
+        result = 1;
+      else
+      {
+        // extraction still works with the cached header offsets
+        const std::string name = expected.back().name();
+        std::vector<uint8_t> cachedData;
+        std::vector<uint8_t> directData;
+        libstriezel::tar::archive directTar(tarFileName);
+        if (!cachedTar.extractToBuffer(name, cachedData) || !directTar.extractToBuffer(name, directData)
+            || (cachedData != directData))
+        {
+          std::cout << "Error: Extraction of " << name << " from cached archive failed!" << std::endl;
+          result = 1;
+        }
+      }
+    }
+
+    // A listing for another state of the file is rejected.
+    if (result == 0)
+    {
+      libstriezel::archive::listingKey key;
+      libstriezel::archive::entryTable table;
+      std::vector<int64_t> offsets;
+      if (!libstriezel::archive::getListingKey(tarFileName, key)
+          || !libstriezel::archive::loadListing(cacheFileName, key, table, offsets)
+          || (table.size() != expected.size()) || (offsets.size() != expected.size()))
+      {
+        std::cout << "Error: Could not load the cache file directly!" << std::endl;
+        result = 1;
+      }
+      key.size += 1;
+      if ((result == 0) && libstriezel::archive::loadListing(cacheFileName, key, table, offsets))
+      {
+        std::cout << "Error: Cache file was accepted for a file of another size!" << std::endl;
+        result = 1;
+      }
+      key.size -= 1;
+      key.m_time += 1;
+      if ((result == 0) && libstriezel::archive::loadListing(cacheFileName, key, table, offsets))
+      {
+        std::cout << "Error: Cache file was accepted for a changed file!" << std::endl;
+        result = 1;
+      }
+      // changes within the same second are detected, too
+      key.m_time -= 1;
+      key.m_timeNanoseconds += 1;
+      if ((result == 0) && libstriezel::archive::loadListing(cacheFileName, key, table, offsets))
+      {
+        std::cout << "Error: Cache file was accepted for a file changed within one second!" << std::endl;
+        result = 1;
+      }
+      key.m_timeNanoseconds -= 1;
+      key.c_timeNanoseconds += 1;
+      if ((result == 0) && libstriezel::archive::loadListing(cacheFileName, key, table, offsets))
+      {
+        std::cout << "Error: Cache file was accepted for a file with another status change time!" << std::endl;
+        result = 1;
+      }
+    }
+
+    // Damaged cache files are rejected, too.
+    if (result == 0)
+    {
+      libstriezel::tar::archive damagedTar(tarFileName, true);
+      if (!damage(cacheFileName) || damagedTar.loadListing(cacheFileName))
+      {
+        std::cout << "Error: Damaged cache file was accepted!" << std::endl;
+        result = 1;
+      }
+    }
+
+    // The listing is saved with the state of the file that was listed, so a
+    // change between listing and saving makes the saved listing invalid.
+    if (result == 0)
+    {
+      std::string copyName;
+      std::string content;
+      if (!libstriezel::filesystem::file::createTemp(copyName)
+          || !libstriezel::filesystem::file::readIntoString(tarFileName, content))
+      {
+        std::cout << "Error: Could not create a copy of the archive!" << std::endl;
+        result = 1;
+      }
+      else
+      {
+        std::ofstream(copyName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc) << content;
+        {
+          libstriezel::tar::archive listedTar(copyName);
+          // More zero blocks at the end keep the archive valid.
+          std::ofstream(copyName, std::ios_base::out | std::ios_base::binary | std::ios_base::app)
+              << std::string(1024, '\0');
+          if (!listedTar.saveListing(cacheFileName))
+          {
+            std::cout << "Error: Could not save the listing of the changed archive!" << std::endl;
+            result = 1;
+          }
+        }
+        libstriezel::tar::archive changedTar(copyName, true);
+        if ((result == 0) && changedTar.loadListing(cacheFileName))
+        {
+          std::cout << "Error: Listing from before the change of the archive was accepted!" << std::endl;
+          result = 1;
+        }
+        libstriezel::filesystem::file::remove(copyName);
+      }
+    }
+
+    // Several threads may replace the same file at once.
+    if (result == 0)
+    {
+      const std::string first(100000, 'a');
+      const std::string second(50000, 'b');
+      std::vector<std::thread> threads;
+      std::vector<char> replaced(8, 0);
+      for (std::size_t i = 0; i < replaced.size(); ++i)
+      {
+        threads.emplace_back([&, i]()
+        {
+          bool success = true;
+          for (int round = 0; round < 20; ++round)
+            success = libstriezel::archive::replaceFile(cacheFileName, (i % 2 == 0) ? first : second) && success;
+          replaced[i] = success ? 1 : 0;
+        });
+      }
+      for (auto& t : threads)
+        t.join();
+      std::ifstream stream(cacheFileName, std::ios_base::in | std::ios_base::binary);
+      const std::string content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+      stream.close();
+      if ((std::find(replaced.begin(), replaced.end(), 0) != replaced.end())
+          || ((content != first) && (content != second)))
+      {
+        std::cout << "Error: Concurrent replacement of the cache file failed!" << std::endl;
+        result = 1;
+      }
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the tar file: "
+              << ex.what() << std::endl;
+    result = 1;
+  } //try-catch
+  libstriezel::filesystem::file::remove(cacheFileName);
+  if (result != 0)
+    return result;
+
+  //Everything is OK.
+  std::cout << "Tests for the listing cache were successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,274 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <archive.h>
+#include <archive_entry.h>
+#include "../../../archive/tar/archive.hpp"
+#include "../../../archive/traversal.hpp"
+#include "../../../filesystem/directory.hpp"
+
+la_ssize_t appendData(struct archive *, void * clientData, const void * buffer, size_t length)
+{
+  std::vector<char> * data = static_cast<std::vector<char>*>(clientData);
+  const char * bytes = static_cast<const char*>(buffer);
+  data->insert(data->end(), bytes, bytes + length);
+  return static_cast<la_ssize_t>(length);
+}
+
+/* Writes an archive into memory. The format has to be set by the setup
+   function. Returns true in case of success. */
+bool createArchive(int (*setup)(struct archive *), int (*filter)(struct archive *),
+                   const std::vector<std::pair<std::string, std::vector<char> > >& files,
+                   std::vector<char>& result)
+{
+  result.clear();
+  struct archive * a = archive_write_new();
+  if (nullptr == a)
+    return false;
+  bool success = (setup(a) == ARCHIVE_OK)
+      && ((nullptr == filter) || (filter(a) == ARCHIVE_OK))
+      && (archive_write_open(a, &result, nullptr, appendData, nullptr) == ARCHIVE_OK);
+  for (const auto& file : files)
+  {
+    if (!success)
+      break;
+    struct archive_entry * ent = archive_entry_new();
+    archive_entry_set_pathname(ent, file.first.c_str());
+    archive_entry_set_size(ent, static_cast<la_int64_t>(file.second.size()));
+    archive_entry_set_filetype(ent, AE_IFREG);
+    archive_entry_set_perm(ent, 0644);
+    success = (archive_write_header(a, ent) == ARCHIVE_OK)
+        && (archive_write_data(a, file.second.data(), file.second.size())
+            == static_cast<la_ssize_t>(file.second.size()));
+    archive_entry_free(ent);
+  }
+  success = (archive_write_close(a) == ARCHIVE_OK) && success;
+  archive_write_free(a);
+  return success;
+}
+
+/* Expected parameters: 1 - directory that contains the .tar file */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string tarFileName = tarDirectory + libstriezel::filesystem::pathDelimiter + "grep-2.0.tar";
+
+  std::ifstream stream(tarFileName, std::ios_base::in | std::ios_base::binary);
+  const std::vector<char> content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  stream.close();
+  if (content.empty())
+  {
+    std::cout << "Error: Could not read " << tarFileName << "!" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    libstriezel::tar::archive tarFile(tarFileName);
+    const auto expected = tarFile.entries();
+
+    /* Build the nesting in memory:
+       outer.tar
+        +- grep-2.0.tar.gz  (gzip-compressed copy of the tar file)
+        +- grep.zip
+        |   +- grep-2.0.tar
+        +- readme.txt
+    */
+    std::vector<char> gzipped;
+    std::vector<char> zipped;
+    std::vector<char> outer;
+    const std::vector<char> readme = { 'H', 'e', 'l', 'l', 'o', '\n' };
+    if (!createArchive(archive_write_set_format_raw, archive_write_add_filter_gzip,
+                       { { "data", content } }, gzipped)
+        || !createArchive(archive_write_set_format_zip, nullptr,
+                          { { "grep-2.0.tar", content } }, zipped)
+        || !createArchive(archive_write_set_format_pax_restricted, nullptr,
+                          { { "grep-2.0.tar.gz", gzipped }, { "grep.zip", zipped },
+                            { "readme.txt", readme } }, outer))
+    {
+      std::cout << "Error: Could not create the nested test archives!" << std::endl;
+      return 1;
+    }
+
+    std::vector<libstriezel::archive::nestedEntry> records;
+    const auto collect = [&records](const libstriezel::archive::nestedEntry& record)
+    {
+      records.push_back(record);
+      return true;
+    };
+
+    // full traversal
+    const libstriezel::archive::traversalLimits limits;
+    if (!libstriezel::archive::traverse(outer.data(), outer.size(), limits, collect))
+    {
+      std::cout << "Error: Traversal of the nested archives failed!" << std::endl;
+      return 1;
+    }
+    // three outer entries, plus the nested tar and its entries on two paths
+    if (records.size() != 3 + 2 * (1 + expected.size()))
+    {
+      std::cout << "Error: Traversal found " << records.size() << " entries, but "
+                << 3 + 2 * (1 + expected.size()) << " were expected!" << std::endl;
+      return 1;
+    }
+    unsigned int found = 0;
+    for (const auto& record : records)
+    {
+      if (record.path.empty() || (record.path.back() != record.info.name()))
+      {
+        std::cout << "Error: Path of entry " << record.info.name() << " does not end with its name!" << std::endl;
+        return 1;
+      }
+      const bool shouldBeArchive = (record.path.back() == "grep-2.0.tar.gz")
+          || (record.path.back() == "grep.zip") || (record.path.back() == "grep-2.0.tar");
+      if (record.isArchive != shouldBeArchive)
+      {
+        std::cout << "Error: Entry " << record.info.name() << " was "
+                  << (record.isArchive ? "" : "not ") << "detected as archive!" << std::endl;
+        return 1;
+      }
+      if ((record.path.size() == 3) && (record.path.back() == "grep-2.0/COPYING"))
+      {
+        ++found;
+        if (((record.path[0] != "grep-2.0.tar.gz") || (record.path[1] != "grep-2.0.tar"))
+            && ((record.path[0] != "grep.zip") || (record.path[1] != "grep-2.0.tar")))
+        {
+          std::cout << "Error: Path of nested entry grep-2.0/COPYING is wrong!" << std::endl;
+          return 1;
+        }
+        for (const auto& e : expected)
+        {
+          if ((e.name() == "grep-2.0/COPYING") && (e.size() != record.info.size()))
+          {
+            std::cout << "Error: Size of nested entry grep-2.0/COPYING is wrong!" << std::endl;
+            return 1;
+          }
+        }
+      }
+    } // for
+    if (found != 2)
+    {
+      std::cout << "Error: grep-2.0/COPYING was found " << found << " times instead of twice!" << std::endl;
+      return 1;
+    }
+
+    // ZIP files that do not fit into the buffer are read as stream
+    const std::size_t fullCount = records.size();
+    records.clear();
+    libstriezel::archive::traversalLimits streamed;
+    streamed.maxBufferSize = 1024;
+    if (!libstriezel::archive::traverse(outer.data(), outer.size(), streamed, collect)
+        || (records.size() != fullCount))
+    {
+      std::cout << "Error: Traversal with small buffer found " << records.size()
+                << " entries instead of " << fullCount << "!" << std::endl;
+      return 1;
+    }
+
+    // depth limit
+    records.clear();
+    libstriezel::archive::traversalLimits flat;
+    flat.maxDepth = 1;
+    if (!libstriezel::archive::traverse(outer.data(), outer.size(), flat, collect))
+    {
+      std::cout << "Error: Traversal with depth limit failed!" << std::endl;
+      return 1;
+    }
+    for (const auto& record : records)
+    {
+      if ((record.path.size() > 2) || ((record.path.size() == 2) && record.isArchive))
+      {
+        std::cout << "Error: Traversal went deeper than allowed!" << std::endl;
+        return 1;
+      }
+    }
+    if (records.size() != 5)
+    {
+      std::cout << "Error: Traversal with depth limit found " << records.size()
+                << " entries instead of five!" << std::endl;
+      return 1;
+    }
+
+    // size limit
+    libstriezel::archive::traversalLimits small;
+    small.maxTotalSize = content.size() / 2;
+    if (libstriezel::archive::traverse(outer.data(), outer.size(), small, collect))
+    {
+      std::cout << "Error: Traversal did not stop at the size limit!" << std::endl;
+      return 1;
+    }
+
+    // callback can stop the traversal
+    unsigned int calls = 0;
+    const bool stopped = !libstriezel::archive::traverse(outer.data(), outer.size(), limits,
+        [&calls](const libstriezel::archive::nestedEntry&) { ++calls; return false; });
+    if (!stopped || (calls != 1))
+    {
+      std::cout << "Error: Callback could not stop the traversal!" << std::endl;
+      return 1;
+    }
+
+    // data that is not an archive
+    if (libstriezel::archive::traverse(readme.data(), readme.size(), limits, collect))
+    {
+      std::cout << "Error: Traversal of non-archive data succeeded!" << std::endl;
+      return 1;
+    }
+
+    // traversal of the file itself
+    records.clear();
+    if (!libstriezel::archive::traverse(tarFileName, limits, collect)
+        || (records.size() != expected.size()))
+    {
+      std::cout << "Error: Traversal of " << tarFileName << " failed!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the tar file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::archive::traverse() was successful." << std::endl;
+  return 0;
+}
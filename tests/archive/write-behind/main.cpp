@@ -0,0 +1,155 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "../../../archive/writeBehind.hpp"
+#include "../../../filesystem/file.hpp"
+
+using libstriezel::archive::writeBehind;
+
+/* Creates deterministic test data of the given size. */
+std::string testData(const std::size_t size)
+{
+  std::string result(size, '\0');
+  uint32_t state = 12345;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    state = state * 1103515245 + 12345;
+    result[i] = static_cast<char>(state >> 24);
+  }
+  return result;
+}
+
+/* Writes the data with a writer in chunks of varying size and checks the
+   content of the file afterwards. */
+bool writeAndCheck(writeBehind& writer, const std::string& data, const int64_t expectedSize,
+                   const std::string& description)
+{
+  std::string fileName;
+  if (!libstriezel::filesystem::file::createTemp(fileName)
+      || !libstriezel::filesystem::file::remove(fileName))
+  {
+    std::cout << "Error: Could not get a name for a temporary file!" << std::endl;
+    return false;
+  }
+  if (!writer.open(fileName, expectedSize))
+  {
+    std::cout << "Error: Could not create file for " << description << "!" << std::endl;
+    return false;
+  }
+
+  std::size_t pos = 0;
+  std::size_t step = 1;
+  while (pos < data.size())
+  {
+    // odd chunk sizes, like a decompressor would produce them
+    const std::size_t chunk = std::min({ step, writer.space(), data.size() - pos });
+    std::memcpy(writer.data(), data.data() + pos, chunk);
+    if (!writer.produced(chunk))
+    {
+      std::cout << "Error: Writer did not accept data for " << description << "!" << std::endl;
+      writer.finish();
+      libstriezel::filesystem::file::remove(fileName);
+      return false;
+    }
+    pos += chunk;
+    step = (step * 7 + 3) % 100000 + 1;
+  }
+  if (!writer.finish())
+  {
+    std::cout << "Error: Writer failed to finish " << description << "!" << std::endl;
+    libstriezel::filesystem::file::remove(fileName);
+    return false;
+  }
+
+  std::string content;
+  const bool read = libstriezel::filesystem::file::readIntoString(fileName, content);
+  libstriezel::filesystem::file::remove(fileName);
+  if (!read || (content != data))
+  {
+    std::cout << "Error: File content for " << description << " is not correct! It has "
+              << content.size() << " bytes instead of " << data.size() << "." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  // small file, written without a separate thread
+  {
+    writeBehind writer;
+    if (!writeAndCheck(writer, testData(1000), 1000, "small file"))
+      return 1;
+  }
+  // empty file
+  {
+    writeBehind writer;
+    if (!writeAndCheck(writer, std::string(), 0, "empty file"))
+      return 1;
+  }
+  // several turns through a small ring of buffers on a separate thread
+  {
+    writeBehind writer(64 * 1024, 3);
+    const std::string data = testData(3 * 1024 * 1024 + 17);
+    if (!writeAndCheck(writer, data, static_cast<int64_t>(data.size()), "large file"))
+      return 1;
+  }
+  // unknown size uses the separate thread, too
+  {
+    writeBehind writer(64 * 1024, 2);
+    if (!writeAndCheck(writer, testData(500000), -1, "file of unknown size"))
+      return 1;
+  }
+  // A wrong expected size must not change the size of the file.
+  {
+    writeBehind writer(64 * 1024, 4);
+    if (!writeAndCheck(writer, testData(200000), 5000000, "file with too large size hint"))
+      return 1;
+    if (!writeAndCheck(writer, testData(300000), 100, "file with too small size hint"))
+      return 1;
+  }
+
+  // existing files are not overwritten
+  std::string fileName;
+  if (!libstriezel::filesystem::file::createTemp(fileName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return 1;
+  }
+  {
+    writeBehind writer;
+    const bool opened = writer.open(fileName, 10);
+    writer.finish();
+    libstriezel::filesystem::file::remove(fileName);
+    if (opened)
+    {
+      std::cout << "Error: Writer opened an existing file!" << std::endl;
+      return 1;
+    }
+  }
+
+  //Everything is OK.
+  std::cout << "Tests for libstriezel::archive::writeBehind were successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "../../../archive/gzip/archive.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../testData.hpp"
+
+/* Compresses data as one gzip member and appends it to result. */
+bool compressMember(const uint8_t* data, const std::size_t size, std::vector<uint8_t>& result)
+{
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  if (deflateInit2(&strm, 6, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+  const std::size_t start = result.size();
+  result.resize(start + deflateBound(&strm, size));
+  strm.next_in = const_cast<Bytef*>(data);
+  strm.avail_in = static_cast<uInt>(size);
+  strm.next_out = result.data() + start;
+  strm.avail_out = static_cast<uInt>(result.size() - start);
+  const int ret = deflate(&strm, Z_FINISH);
+  result.resize(start + strm.total_out);
+  deflateEnd(&strm);
+  return ret == Z_STREAM_END;
+}
+
+/* Reads at several offsets and compares the data with the original. */
+bool checkReads(libstriezel::gzip::archive& gz, const std::vector<uint8_t>& original,
+                const std::vector<int64_t>& offsets, const std::string& description)
+{
+  std::vector<uint8_t> buffer(70000);
+  for (const int64_t offset : offsets)
+  {
+    const int64_t bytesRead = gz.readAt(offset, buffer.data(), buffer.size());
+    const int64_t available = static_cast<int64_t>(original.size()) - offset;
+    const int64_t expected = std::min<int64_t>(std::max<int64_t>(available, 0), buffer.size());
+    if (bytesRead != expected)
+    {
+      std::cout << "Error: readAt(" << offset << ") read " << bytesRead << " instead of "
+                << expected << " bytes (" << description << ")!" << std::endl;
+      return false;
+    }
+    if (std::memcmp(buffer.data(), original.data() + offset, static_cast<std::size_t>(expected)) != 0)
+    {
+      std::cout << "Error: readAt(" << offset << ") returned wrong data ("
+                << description << ")!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  // two members, the boundary is not at a multiple of anything
+  const std::vector<uint8_t> original = compressibleData<std::vector<uint8_t> >(3000000, 12345);
+  const std::size_t boundary = 1900037;
+  std::vector<uint8_t> compressed;
+  if (!compressMember(original.data(), boundary, compressed)
+      || !compressMember(original.data() + boundary, original.size() - boundary, compressed))
+  {
+    std::cout << "Error: Could not compress test data!" << std::endl;
+    return 1;
+  }
+
+  const std::vector<int64_t> offsets = {
+    0, 1, 32767, 32768, 100000, 65536 * 7 + 3, 1000000,
+    static_cast<int64_t>(boundary) - 1000, static_cast<int64_t>(boundary),
+    static_cast<int64_t>(boundary) + 1, 2500000, 2999999, 3000000, 3000001
+  };
+
+  // data in memory, first without an index and then with an index
+  {
+    libstriezel::gzip::archive gz(compressed.data(), compressed.size());
+    if (!checkReads(gz, original, { 0, 123456, static_cast<int64_t>(boundary) + 17 }, "memory, no index"))
+      return 1;
+    if (!gz.buildIndex(65536))
+    {
+      std::cout << "Error: Could not build index for data in memory!" << std::endl;
+      return 1;
+    }
+    if (!checkReads(gz, original, offsets, "memory, index"))
+      return 1;
+    // Sequential extraction still works after random access.
+    std::vector<uint8_t> all;
+    if (!gz.extractToBuffer(all) || (all != original))
+    {
+      std::cout << "Error: Extraction after readAt() failed!" << std::endl;
+      return 1;
+    }
+  }
+
+  // file with an index that is saved and loaded again
+  std::string gzName;
+  if (!libstriezel::filesystem::file::createTemp(gzName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return 1;
+  }
+  {
+    std::ofstream stream(gzName, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+    stream.close();
+    if (!stream.good())
+    {
+      std::cout << "Error: Could not write temporary file " << gzName << "!" << std::endl;
+      libstriezel::filesystem::file::remove(gzName);
+      return 1;
+    }
+  }
+  const std::string indexName = libstriezel::gzip::checkpointIndex::indexFileName(gzName);
+  int result = 0;
+  {
+    libstriezel::gzip::archive gz(gzName);
+    if (gz.loadIndex())
+    {
+      std::cout << "Error: Index was loaded before it was saved!" << std::endl;
+      result = 1;
+    }
+    else if (!gz.buildIndex(65536) || !gz.saveIndex())
+    {
+      std::cout << "Error: Could not build and save index for " << gzName << "!" << std::endl;
+      result = 1;
+    }
+    else if (!checkReads(gz, original, offsets, "file, built index"))
+      result = 1;
+  }
+  if (result == 0)
+  {
+    libstriezel::gzip::archive gz(gzName);
+    if (!gz.loadIndex())
+    {
+      std::cout << "Error: Could not load index " << indexName << "!" << std::endl;
+      result = 1;
+    }
+    else if (!checkReads(gz, original, offsets, "file, loaded index"))
+      result = 1;
+  }
+  if (result == 0)
+  {
+    // A damaged index must not be used.
+    std::fstream stream(indexName, std::ios::in | std::ios::out | std::ios::binary);
+    stream.seekp(100);
+    stream.put('\x7F');
+    stream.close();
+    libstriezel::gzip::archive gz(gzName);
+    if (gz.loadIndex())
+    {
+      std::cout << "Error: Damaged index " << indexName << " was loaded!" << std::endl;
+      result = 1;
+    }
+  }
+  libstriezel::filesystem::file::remove(indexName);
+  libstriezel::filesystem::file::remove(gzName);
+  if (result != 0)
+    return result;
+
+  //Everything is OK.
+  std::cout << "Tests for libstriezel::gzip::archive::readAt() were successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,271 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "../../../archive/gzip/archive.hpp"
+#include "../../../archive/gzip/members.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../testData.hpp"
+
+/* Compresses data as one gzip member and appends it to result. With bgzf set,
+   the header gets the BC subfield of BGZF. */
+bool compressMember(const uint8_t* data, const std::size_t size, const int level,
+                    const bool bgzf, std::vector<uint8_t>& result)
+{
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  if (deflateInit2(&strm, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+  unsigned char extra[6] = { 'B', 'C', 2, 0, 0, 0 };
+  gz_header header;
+  std::memset(&header, 0, sizeof(header));
+  header.os = 3;
+  header.extra = extra;
+  header.extra_len = sizeof(extra);
+  if (bgzf && (deflateSetHeader(&strm, &header) != Z_OK))
+  {
+    deflateEnd(&strm);
+    return false;
+  }
+  const std::size_t start = result.size();
+  result.resize(start + deflateBound(&strm, size) + 64);
+  strm.next_in = const_cast<Bytef*>(data);
+  strm.avail_in = static_cast<uInt>(size);
+  strm.next_out = result.data() + start;
+  strm.avail_out = static_cast<uInt>(result.size() - start);
+  const int ret = deflate(&strm, Z_FINISH);
+  result.resize(start + strm.total_out);
+  deflateEnd(&strm);
+  if (bgzf)
+  {
+    // BSIZE is the size of the whole member minus one.
+    const std::size_t blockSize = strm.total_out - 1;
+    result[start + 16] = static_cast<uint8_t>(blockSize & 0xFF);
+    result[start + 17] = static_cast<uint8_t>(blockSize >> 8);
+  }
+  return ret == Z_STREAM_END;
+}
+
+/* Writes the compressed data to a temporary file, extracts it with the given
+   number of threads and compares the result with the expected data. */
+bool check(const std::vector<uint8_t>& compressed, const std::vector<uint8_t>& expected,
+           const bool shallSucceed, const std::string& description)
+{
+  std::string gzName;
+  std::string destName;
+  if (!libstriezel::filesystem::file::createTemp(gzName) || !libstriezel::filesystem::file::createTemp(destName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return false;
+  }
+  libstriezel::filesystem::file::remove(destName);
+  {
+    std::ofstream stream(gzName, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+  }
+  bool result = true;
+  for (const unsigned int threads : { 1u, 4u, 0u })
+  {
+    libstriezel::gzip::archive gz(gzName);
+    const bool success = gz.extractTo(destName, threads);
+    if (success != shallSucceed)
+    {
+      std::cout << "Error: Extraction of " << description << " with " << threads << " thread(s) "
+                << (success ? "succeeded" : "failed") << " unexpectedly!" << std::endl;
+      result = false;
+      break;
+    }
+    if (success)
+    {
+      std::ifstream stream(destName, std::ios::in | std::ios::binary);
+      const std::vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+      stream.close();
+      if (data != expected)
+      {
+        std::cout << "Error: Extracted data of " << description << " with " << threads
+                  << " thread(s) does not match!" << std::endl;
+        result = false;
+        break;
+      }
+    }
+    libstriezel::filesystem::file::remove(destName);
+  }
+  libstriezel::filesystem::file::remove(destName);
+  libstriezel::filesystem::file::remove(gzName);
+  return result;
+}
+
+/* Finds the members of data in memory. */
+std::vector<int64_t> membersOf(const std::vector<uint8_t>& data, const bool scan)
+{
+  return libstriezel::gzip::findMembers(
+      [&data](const int64_t offset, void* buffer, const std::size_t size) -> int64_t
+      {
+        if (offset >= static_cast<int64_t>(data.size()))
+          return 0;
+        const std::size_t count = std::min(size, data.size() - static_cast<std::size_t>(offset));
+        std::memcpy(buffer, data.data() + offset, count);
+        return static_cast<int64_t>(count);
+      }, scan);
+}
+
+/* Decompresses data in memory with the given candidates on two threads and
+   compares the result with the expected data. */
+bool checkCandidates(const std::vector<uint8_t>& compressed, const std::vector<int64_t>& candidates,
+                     const std::vector<uint8_t>& expected, const bool shallSucceed,
+                     const std::string& description)
+{
+  std::vector<uint8_t> data;
+  const bool success = libstriezel::gzip::inflateMembers(
+      [&compressed]()
+      {
+        return [&compressed](const int64_t offset, void* buffer, const std::size_t size) -> int64_t
+        {
+          if (offset >= static_cast<int64_t>(compressed.size()))
+            return 0;
+          const std::size_t count = std::min(size, compressed.size() - static_cast<std::size_t>(offset));
+          std::memcpy(buffer, compressed.data() + offset, count);
+          return static_cast<int64_t>(count);
+        };
+      },
+      candidates, 2,
+      [&data](const void* bytes, const std::size_t size)
+      {
+        data.insert(data.end(), static_cast<const uint8_t*>(bytes), static_cast<const uint8_t*>(bytes) + size);
+        return true;
+      });
+  if (success != shallSucceed)
+  {
+    std::cout << "Error: Decompression of " << description << " "
+              << (success ? "succeeded" : "failed") << " unexpectedly!" << std::endl;
+    return false;
+  }
+  if (success && (data != expected))
+  {
+    std::cout << "Error: Decompressed data of " << description << " does not match!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  const std::vector<uint8_t> original = compressibleData<std::vector<uint8_t> >(4000000, 4711);
+
+  // BGZF: blocks of less than 64 KiB of uncompressed data
+  std::vector<uint8_t> bgzf;
+  for (std::size_t offset = 0; offset < original.size(); offset += 65280)
+  {
+    if (!compressMember(original.data() + offset, std::min<std::size_t>(65280, original.size() - offset),
+                        6, true, bgzf))
+    {
+      std::cout << "Error: Could not compress BGZF test data!" << std::endl;
+      return 1;
+    }
+  }
+  // BGZF files end with an empty block.
+  if (!compressMember(nullptr, 0, 6, true, bgzf))
+    return 1;
+  if (!check(bgzf, original, true, "BGZF data"))
+    return 1;
+  // BGZF members are found without a scan.
+  if (membersOf(bgzf, false).size() != (original.size() + 65279) / 65280 + 1)
+  {
+    std::cout << "Error: Members of BGZF data were not found!" << std::endl;
+    return 1;
+  }
+
+  // Concatenated members of different sizes. Stored blocks (level zero)
+  // contain gzip signatures that are no members.
+  std::vector<uint8_t> withSignatures(original);
+  for (std::size_t i = 1000; i + 4 < withSignatures.size(); i += 99991)
+  {
+    std::memcpy(withSignatures.data() + i, "\x1F\x8B\x08\x00", 4);
+  }
+  std::vector<uint8_t> concatenated;
+  std::vector<int64_t> starts;
+  const std::vector<std::size_t> boundaries = { 0, 1, 70000, 900000, 2500001, withSignatures.size() };
+  for (std::size_t i = 0; i + 1 < boundaries.size(); ++i)
+  {
+    starts.push_back(static_cast<int64_t>(concatenated.size()));
+    if (!compressMember(withSignatures.data() + boundaries[i], boundaries[i + 1] - boundaries[i],
+                        (i % 2 == 0) ? 0 : 6, false, concatenated))
+    {
+      std::cout << "Error: Could not compress test data!" << std::endl;
+      return 1;
+    }
+  }
+  if (!check(concatenated, withSignatures, true, "concatenated members"))
+    return 1;
+  // Only a scan finds the members. Most signatures within the stored blocks
+  // are no candidates, because their data cannot be decompressed.
+  const std::vector<int64_t> candidates = membersOf(concatenated, true);
+  const std::size_t signatures = (withSignatures.size() - 1000) / 99991;
+  if (!membersOf(concatenated, false).empty()
+      || !std::includes(candidates.begin(), candidates.end(), starts.begin(), starts.end())
+      || (candidates.size() - starts.size() > signatures / 4))
+  {
+    std::cout << "Error: Wrong members were found in concatenated members!" << std::endl;
+    return 1;
+  }
+
+  // Data after the last member is ignored.
+  std::vector<uint8_t> trailing(concatenated);
+  trailing.insert(trailing.end(), { 0, 0, 0, 0, 0, 0, 0, 0 });
+  if (!check(trailing, withSignatures, true, "members with trailing data"))
+    return 1;
+
+  // Members that the scan missed are decompressed after the candidates.
+  if (!checkCandidates(concatenated, { starts[0], starts[1], starts[3] }, withSignatures, true,
+                       "members with missing candidates")
+      || !checkCandidates(concatenated, { starts[0], starts[1] }, withSignatures, true,
+                          "members without the last candidates"))
+    return 1;
+  // A damaged member after the last candidate makes the decompression fail.
+  std::vector<uint8_t> damagedTail(concatenated);
+  damagedTail[(starts[3] + starts[4]) / 2] ^= 0x55;
+  if (!checkCandidates(damagedTail, { starts[0], starts[1] }, withSignatures, false,
+                       "damaged member after the candidates"))
+    return 1;
+
+  // single member
+  std::vector<uint8_t> single;
+  if (!compressMember(original.data(), original.size(), 6, false, single)
+      || !check(single, original, true, "single member"))
+    return 1;
+
+  // A damaged member in the middle makes the extraction fail.
+  std::vector<uint8_t> damaged(concatenated);
+  damaged[damaged.size() / 2] ^= 0x55;
+  if (!check(damaged, withSignatures, false, "damaged members"))
+    return 1;
+
+  //Everything is OK.
+  std::cout << "Tests for parallel extraction of gzip members were successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <zlib.h>
+#include "../../../archive/gzip/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+
+/* Computes the CRC-32 of some data. */
+uint32_t crc(const std::vector<uint8_t>& data)
+{
+  return static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0), data.data(), static_cast<uInt>(data.size())));
+}
+
+std::vector<uint8_t> readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/* Reads the CRC-32 from the trailer of a gzip file with a single member. */
+uint32_t trailerCrc(const std::string& fileName)
+{
+  const std::vector<uint8_t> data = readFile(fileName);
+  if (data.size() < 8)
+    return 0;
+  const uint8_t * trailer = data.data() + data.size() - 8;
+  return static_cast<uint32_t>(trailer[0]) | (static_cast<uint32_t>(trailer[1]) << 8)
+       | (static_cast<uint32_t>(trailer[2]) << 16) | (static_cast<uint32_t>(trailer[3]) << 24);
+}
+
+/* Expected parameters: 1 - directory that contains the .gz file */
+
+int main(int argc, char** argv)
+{
+  std::string gzDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    gzDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(gzDirectory))
+    {
+      std::cout << "Error: Directory " << gzDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (gzip directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string gzFileName = gzDirectory + libstriezel::filesystem::pathDelimiter + "zlib.tar.gz";
+
+  try
+  {
+    libstriezel::gzip::archive gzipFile(gzFileName);
+
+    // extractTo() gives the reference data
+    std::string tempDirName;
+    if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+    {
+      std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+      return 1;
+    }
+    const std::string destFile = libstriezel::filesystem::slashify(tempDirName) + "zlib.tar";
+    if (!gzipFile.extractTo(destFile))
+    {
+      std::cout << "Error: Could not extract file from gzip file!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+    const std::vector<uint8_t> reference = readFile(destFile);
+    libstriezel::filesystem::file::remove(destFile);
+    libstriezel::filesystem::directory::remove(tempDirName);
+    if (reference.empty() || (crc(reference) != trailerCrc(gzFileName)))
+    {
+      std::cout << "Error: CRC-32 of extracted file does not match the gzip trailer!" << std::endl;
+      return 1;
+    }
+
+    // extraction into a growable buffer
+    std::vector<uint8_t> data;
+    if (!gzipFile.extractToBuffer(data) || (data != reference) || (crc(data) != crc(reference)))
+    {
+      std::cout << "Error: Data in buffer does not match the extracted file!" << std::endl;
+      return 1;
+    }
+
+    // extraction into a sink
+    std::vector<uint8_t> sinkData;
+    std::size_t chunks = 0;
+    const bool sinkSuccess = gzipFile.extractToSink(
+        [&sinkData, &chunks](const void* chunk, const std::size_t size)
+        {
+          const uint8_t * bytes = static_cast<const uint8_t*>(chunk);
+          sinkData.insert(sinkData.end(), bytes, bytes + size);
+          ++chunks;
+          return true;
+        });
+    if (!sinkSuccess || (chunks < 2) || (sinkData != reference) || (crc(sinkData) != crc(reference)))
+    {
+      std::cout << "Error: Data passed to the sink does not match the extracted file!" << std::endl;
+      return 1;
+    }
+
+    // A sink that stops after the first chunk aborts the extraction part-way.
+    std::size_t calls = 0;
+    if (gzipFile.extractToSink([&calls](const void*, const std::size_t) { return ++calls < 2; })
+        || (calls != 2))
+    {
+      std::cout << "Error: Aborted extraction was not stopped or reported as success!" << std::endl;
+      return 1;
+    }
+    // The archive still works after the abort.
+    data.clear();
+    if (!gzipFile.extractToBuffer(data) || (data != reference))
+    {
+      std::cout << "Error: Extraction after an aborted extraction failed!" << std::endl;
+      return 1;
+    }
+
+    // extraction into a preallocated buffer
+    std::vector<uint8_t> fixed(reference.size() + 10, 0);
+    std::size_t size = 0;
+    if (!gzipFile.extractToBuffer(fixed.data(), fixed.size(), size)
+        || (size != reference.size()) || !std::equal(reference.begin(), reference.end(), fixed.begin()))
+    {
+      std::cout << "Error: Extraction into preallocated buffer failed!" << std::endl;
+      return 1;
+    }
+    if (gzipFile.extractToBuffer(fixed.data(), reference.size() - 1, size))
+    {
+      std::cout << "Error: Extraction into a buffer that is too small succeeded!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the gzip file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::gzip::archive::extractToBuffer() and extractToSink() was successful." << std::endl;
+  return 0;
+}
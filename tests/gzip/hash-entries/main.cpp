@@ -0,0 +1,120 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include "../../../archive/gzip/archive.hpp"
+#include "../../../archive/hashEntries.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../../hash/sha1/FileSourceUtility.hpp"
+#include "../../../hash/sha256/FileSourceUtility.hpp"
+
+/* Expected parameters: 1 - directory that contains the .gz file */
+
+int main(int argc, char** argv)
+{
+  std::string gzDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    gzDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(gzDirectory))
+    {
+      std::cout << "Error: Directory " << gzDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (gzip directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string gzFileName = gzDirectory + libstriezel::filesystem::pathDelimiter + "zlib.tar.gz";
+
+  try
+  {
+    libstriezel::gzip::archive gzipFile(gzFileName);
+
+    std::vector<std::pair<libstriezel::archive::entry, libstriezel::hash::Digests> > hashes;
+    if (!libstriezel::archive::hashEntries(gzipFile, libstriezel::hash::sha1 | libstriezel::hash::sha256, hashes))
+    {
+      std::cout << "Error: Could not compute hashes of the entry!" << std::endl;
+      return 1;
+    }
+    if ((hashes.size() != 1) || (hashes[0].first.name() != "zlib.tar"))
+    {
+      std::cout << "Error: Expected one hashed entry named zlib.tar, but got "
+                << hashes.size() << " entries!" << std::endl;
+      return 1;
+    }
+
+    //compare with hashes of the extracted file
+    std::string tempDirName;
+    if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+    {
+      std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+      return 1;
+    }
+    const std::string destFile = libstriezel::filesystem::slashify(tempDirName) + "zlib.tar";
+    if (!gzipFile.extractTo(destFile))
+    {
+      std::cout << "Error: Could not extract file from gzip file!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+    const SHA1::MessageDigest sha1 = SHA1::computeFromFile(destFile);
+    const SHA256::MessageDigest sha256 = SHA256::computeFromFile(destFile);
+    libstriezel::filesystem::file::remove(destFile);
+    libstriezel::filesystem::directory::remove(tempDirName);
+    const auto& digests = hashes[0].second;
+    if ((sha1 != digests.sha1) || (sha256 != digests.sha256))
+    {
+      std::cout << "Error: Hash of the entry does not match the hash of the extracted file!" << std::endl
+                << "SHA-256 is: " << digests.sha256.toHexString() << std::endl
+                << "Expected:   " << sha256.toHexString() << std::endl;
+      return 1;
+    }
+    //algorithms that were not requested stay null
+    if (!digests.sha224.isNull() || !digests.sha384.isNull() || !digests.sha512.isNull())
+    {
+      std::cout << "Error: Hash of an algorithm that was not requested is not null!" << std::endl;
+      return 1;
+    }
+    //same hash as in the test of extractTo()
+    const std::string mdExpected = "8f9046a4b67c9cf5bc708077ade99d947114b34a4c57d0fdab396589f71c6b2e";
+    if (digests.sha256.toHexString() != mdExpected)
+    {
+      std::cout << "Error: Hash of zlib.tar is wrong!" << std::endl
+                << "Hash is:  " << digests.sha256.toHexString() << std::endl
+                << "Expected: " << mdExpected << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the gzip file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::archive::hashEntries() with gzip archives was successful." << std::endl;
+  return 0;
+}
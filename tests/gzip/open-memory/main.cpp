@@ -0,0 +1,205 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "../../../archive/gzip/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+
+/// stream that hands out the data of a memory buffer in small pieces
+class chunkedStream: public libstriezel::archive::seekableStream
+{
+  public:
+    chunkedStream(const std::vector<uint8_t>& data)
+    : m_data(data),
+      m_position(0)
+    {
+    }
+
+    int64_t read(void* buffer, const std::size_t size) override
+    {
+      // small pieces make sure that reads across chunk borders are tested
+      const std::size_t count = std::min<std::size_t>(std::min<std::size_t>(size, 1000), m_data.size() - m_position);
+      std::copy(m_data.begin() + m_position, m_data.begin() + m_position + count, static_cast<uint8_t*>(buffer));
+      m_position += count;
+      return static_cast<int64_t>(count);
+    }
+
+    int64_t seek(const int64_t offset, const int whence) override
+    {
+      int64_t target = offset;
+      if (whence == SEEK_CUR)
+        target += static_cast<int64_t>(m_position);
+      else if (whence == SEEK_END)
+        target += static_cast<int64_t>(m_data.size());
+      if ((target < 0) || (target > static_cast<int64_t>(m_data.size())))
+        return -1;
+      m_position = static_cast<std::size_t>(target);
+      return target;
+    }
+  private:
+    const std::vector<uint8_t>& m_data;
+    std::size_t m_position;
+};
+
+std::vector<uint8_t> readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/* Checks that an archive has the same listing and data as the one opened from
+   file. */
+bool checkArchive(libstriezel::gzip::archive& gzipFile, const std::vector<libstriezel::archive::entry>& expected,
+                  const std::vector<uint8_t>& reference, const std::string& kind)
+{
+  const auto entries = gzipFile.entries();
+  // The name of the file is not known, so only the size has to match.
+  if ((entries.size() != 1) || (expected.size() != 1) || (entries[0].size() != expected[0].size())
+      || (entries[0].name() != "data"))
+  {
+    std::cout << "Error: Listing of gzip data opened from " << kind
+              << " does not match the listing of the file!" << std::endl;
+    return false;
+  }
+
+  // Extract twice to make sure that the data can be read again.
+  for (int i = 0; i < 2; ++i)
+  {
+    std::vector<uint8_t> data;
+    if (!gzipFile.extractToBuffer(data) || (data != reference))
+    {
+      std::cout << "Error: Data extracted from gzip data opened from " << kind
+                << " does not match the data of the file!" << std::endl;
+      return false;
+    }
+  }
+
+  std::string tempDirName;
+  if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+  {
+    std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+    return false;
+  }
+  const std::string destFile = libstriezel::filesystem::slashify(tempDirName) + "data";
+  const bool extracted = gzipFile.extractTo(destFile);
+  const std::vector<uint8_t> data = readFile(destFile);
+  libstriezel::filesystem::file::remove(destFile);
+  libstriezel::filesystem::directory::remove(tempDirName);
+  if (!extracted || (data != reference))
+  {
+    std::cout << "Error: File extracted from gzip data opened from " << kind
+              << " does not match the data of the file!" << std::endl;
+    return false;
+  }
+
+  // Random access has to seek in the compressed data.
+  if (!gzipFile.buildIndex(64 * 1024))
+  {
+    std::cout << "Error: Could not build index for gzip data opened from " << kind << "!" << std::endl;
+    return false;
+  }
+  const std::size_t length = 3000;
+  for (const std::size_t offset : { reference.size() - length, std::size_t(0), reference.size() / 2, reference.size() / 3 })
+  {
+    std::vector<uint8_t> part(length, 0);
+    if ((gzipFile.readAt(static_cast<int64_t>(offset), part.data(), length) != static_cast<int64_t>(length))
+        || !std::equal(part.begin(), part.end(), reference.begin() + offset))
+    {
+      std::cout << "Error: Data read at offset " << offset << " from gzip data opened from "
+                << kind << " is wrong!" << std::endl;
+      return false;
+    }
+  }
+  // Sequential extraction still works after random access.
+  std::vector<uint8_t> again;
+  if (!gzipFile.extractToBuffer(again) || (again != reference))
+  {
+    std::cout << "Error: Extraction after random access to gzip data opened from " << kind
+              << " failed!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/* Expected parameters: 1 - directory that contains the .gz file */
+
+int main(int argc, char** argv)
+{
+  std::string gzDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    gzDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(gzDirectory))
+    {
+      std::cout << "Error: Directory " << gzDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (gzip directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string gzFileName = gzDirectory + libstriezel::filesystem::pathDelimiter + "zlib.tar.gz";
+
+  const std::vector<uint8_t> content = readFile(gzFileName);
+  if (content.empty())
+  {
+    std::cout << "Error: Could not read " << gzFileName << "!" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    libstriezel::gzip::archive gzipFile(gzFileName);
+    const auto expected = gzipFile.entries();
+    std::vector<uint8_t> reference;
+    if (!gzipFile.extractToBuffer(reference) || (reference.size() < 10000))
+    {
+      std::cout << "Error: Could not extract data from " << gzFileName << "!" << std::endl;
+      return 1;
+    }
+
+    libstriezel::gzip::archive memoryGzip(content.data(), content.size());
+    if (!checkArchive(memoryGzip, expected, reference, "memory"))
+      return 1;
+
+    chunkedStream chunks(content);
+    libstriezel::gzip::archive streamGzip(chunks);
+    if (!checkArchive(streamGzip, expected, reference, "stream"))
+      return 1;
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the gzip file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for opening gzip data from memory and streams was successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../filesystem/file.hpp"
+#include "../../../hash/kernel/afalg.hpp"
+#include "../../../hash/kernel/FileSourceUtility.hpp"
+#include "../../../hash/sha1/FileSourceUtility.hpp"
+#include "../../../hash/sha224/FileSourceUtility.hpp"
+#include "../../../hash/sha256/FileSourceUtility.hpp"
+#include "../../../hash/sha384/FileSourceUtility.hpp"
+#include "../../../hash/sha512/FileSourceUtility.hpp"
+
+using libstriezel::hash::Backend;
+
+/* Checks that all backends agree on the digest of the given file. If the
+   kernel does not offer the algorithm, the kernel-only backend has to return
+   the null digest, while the automatic backend has to fall back to the
+   library implementation. */
+template<typename Digest>
+bool checkBackends(const std::string& algorithm, const std::string& fileName,
+                   Digest (*compute)(const std::string&, const Backend))
+{
+  const Digest lib = compute(fileName, Backend::library);
+  const Digest automatic = compute(fileName, Backend::automatic);
+  const Digest kernel = compute(fileName, Backend::kernel);
+  const bool available = libstriezel::hash::afalg::isAvailable(algorithm);
+
+  std::cout << algorithm << ": library " << lib.toHexString() << std::endl;
+  if (lib.isNull())
+  {
+    std::cout << "ERROR: Library implementation failed!" << std::endl;
+    return false;
+  }
+  if (automatic != lib)
+  {
+    std::cout << "ERROR: Digest of automatic backend is "
+              << automatic.toHexString() << "!" << std::endl;
+    return false;
+  }
+  if (available && (kernel != lib))
+  {
+    std::cout << "ERROR: Digest of kernel backend is "
+              << kernel.toHexString() << "!" << std::endl;
+    return false;
+  }
+  if (!available && !kernel.isNull())
+  {
+    std::cout << "ERROR: Kernel backend returned a digest, although "
+              << algorithm << " is not available via AF_ALG!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  std::cout << "Info: Kernel hash via AF_ALG is "
+            << (libstriezel::hash::afalg::isAvailable("sha256") ? "" : "NOT ")
+            << "available." << std::endl;
+
+  std::string fileName;
+  if (!libstriezel::filesystem::file::createTemp(fileName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return 1;
+  }
+
+  // sizes around the block boundaries plus something larger than the pipe
+  const std::vector<std::size_t> sizes = { 0, 1, 55, 56, 64, 111, 112, 128, 1000, 3 * 1024 * 1024 + 17 };
+  for (const std::size_t size : sizes)
+  {
+    std::ofstream stream;
+    stream.open(fileName, std::ios_base::trunc | std::ios_base::binary | std::ios_base::out);
+    if (!stream.good() || !stream.is_open())
+    {
+      std::cout << "Error: Could not open temporary file!" << std::endl;
+      libstriezel::filesystem::file::remove(fileName);
+      return 1;
+    }
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      stream.put(static_cast<char>((i * 7) % 251));
+    }
+    stream.close();
+
+    std::cout << "Message of " << size << " byte(s):" << std::endl;
+    if (!checkBackends<SHA1::MessageDigest>("sha1", fileName, SHA1::computeFromFile)
+        || !checkBackends<SHA224::MessageDigest>("sha224", fileName, SHA224::computeFromFile)
+        || !checkBackends<SHA256::MessageDigest>("sha256", fileName, SHA256::computeFromFile)
+        || !checkBackends<SHA384::MessageDigest>("sha384", fileName, SHA384::computeFromFile)
+        || !checkBackends<SHA512::MessageDigest>("sha512", fileName, SHA512::computeFromFile))
+    {
+      libstriezel::filesystem::file::remove(fileName);
+      return 1;
+    }
+  } // for
+
+  // A file that does not exist must not yield a digest in any backend.
+  libstriezel::filesystem::file::remove(fileName);
+  if (!SHA256::computeFromFile(fileName, Backend::automatic).isNull()
+      || !SHA256::computeFromFile(fileName, Backend::kernel).isNull())
+  {
+    std::cout << "ERROR: Got a digest for a non-existent file!" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Test for hash backends was successful." << std::endl;
+  return 0;
+}
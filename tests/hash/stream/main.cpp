@@ -0,0 +1,123 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../hash/StreamHasher.hpp"
+#include "../../../hash/sha1/BufferSourceUtility.hpp"
+#include "../../../hash/sha224/BufferSourceUtility.hpp"
+#include "../../../hash/sha256/BufferSourceUtility.hpp"
+#include "../../../hash/sha384/BufferSourceUtility.hpp"
+#include "../../../hash/sha512/BufferSourceUtility.hpp"
+
+using namespace libstriezel::hash;
+
+/* Feeds the data to a StreamHasher in chunks of the given size and compares
+   the result with the digests of the buffer-based implementations. */
+bool checkChunked(std::vector<uint8_t>& data, const std::size_t chunkSize)
+{
+  StreamHasher hasher(allAlgorithms);
+  std::size_t offset = 0;
+  while (offset < data.size())
+  {
+    const std::size_t len = std::min(chunkSize, data.size() - offset);
+    hasher.update(data.data() + offset, len);
+    offset += len;
+  }
+  const Digests digests = hasher.finish();
+
+  const uint64_t bits = static_cast<uint64_t>(data.size()) * 8;
+  bool success = true;
+  if (digests.sha1 != SHA1::computeFromBuffer(data.data(), bits))
+  {
+    std::cout << "ERROR: SHA-1 mismatch for size " << data.size() << ", chunk size "
+              << chunkSize << ": " << digests.sha1.toHexString() << std::endl;
+    success = false;
+  }
+  if (digests.sha224 != SHA224::computeFromBuffer(data.data(), bits))
+  {
+    std::cout << "ERROR: SHA-224 mismatch for size " << data.size() << ", chunk size "
+              << chunkSize << ": " << digests.sha224.toHexString() << std::endl;
+    success = false;
+  }
+  if (digests.sha256 != SHA256::computeFromBuffer(data.data(), bits))
+  {
+    std::cout << "ERROR: SHA-256 mismatch for size " << data.size() << ", chunk size "
+              << chunkSize << ": " << digests.sha256.toHexString() << std::endl;
+    success = false;
+  }
+  if (digests.sha384 != SHA384::computeFromBuffer(data.data(), bits))
+  {
+    std::cout << "ERROR: SHA-384 mismatch for size " << data.size() << ", chunk size "
+              << chunkSize << ": " << digests.sha384.toHexString() << std::endl;
+    success = false;
+  }
+  if (digests.sha512 != SHA512::computeFromBuffer(data.data(), bits))
+  {
+    std::cout << "ERROR: SHA-512 mismatch for size " << data.size() << ", chunk size "
+              << chunkSize << ": " << digests.sha512.toHexString() << std::endl;
+    success = false;
+  }
+  return success;
+}
+
+int main()
+{
+  // known answer: SHA-256 of "abc"
+  StreamHasher abc(sha256);
+  abc.update("a", 1);
+  abc.update("bc", 2);
+  const Digests abcDigests = abc.finish();
+  if (abcDigests.sha256.toHexString() != "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad")
+  {
+    std::cout << "ERROR: SHA-256 of \"abc\" is " << abcDigests.sha256.toHexString()
+              << "!" << std::endl;
+    return 1;
+  }
+  // algorithms that were not requested have to stay null
+  if (!abcDigests.sha1.isNull() || !abcDigests.sha512.isNull())
+  {
+    std::cout << "ERROR: Digest of algorithm that was not requested is not null!"
+              << std::endl;
+    return 1;
+  }
+
+  // sizes around the block and padding boundaries of both block sizes
+  const std::vector<std::size_t> sizes = { 0, 1, 55, 56, 63, 64, 65, 111, 112,
+                                           119, 120, 127, 128, 129, 1000, 100000 };
+  const std::vector<std::size_t> chunkSizes = { 1, 7, 64, 100, 128, 4096 };
+  for (const auto size : sizes)
+  {
+    std::vector<uint8_t> data(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      data[i] = static_cast<uint8_t>((i * 131 + 17) & 0xFF);
+    }
+    for (const auto chunkSize : chunkSizes)
+    {
+      if (!checkChunked(data, chunkSize))
+        return 1;
+    }
+  }
+
+  std::cout << "Passed: StreamHasher matches buffer-based implementations." << std::endl;
+  return 0;
+}
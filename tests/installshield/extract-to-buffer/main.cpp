@@ -0,0 +1,166 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <zlib.h>
+#include "../../../archive/installshield/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+
+/* Computes the CRC-32 of some data. */
+uint32_t crc(const std::vector<uint8_t>& data)
+{
+  return static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0), data.data(), static_cast<uInt>(data.size())));
+}
+
+std::vector<uint8_t> readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/* Expected parameters: 1 - directory that contains the InstallShield files */
+
+int main(int argc, char** argv)
+{
+  std::string installShieldDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    installShieldDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(installShieldDirectory))
+    {
+      std::cout << "Error: Directory " << installShieldDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (InstallShield directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string instShieldFileName = installShieldDirectory + libstriezel::filesystem::pathDelimiter + "data1.cab";
+
+  try
+  {
+    libstriezel::installshield::archive instShieldFile(instShieldFileName);
+
+    std::string tempDirName;
+    if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+    {
+      std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+      return 1;
+    }
+    const std::string destFile = libstriezel::filesystem::slashify(tempDirName) + "extracted.dat";
+
+    int64_t largest = -1;
+    std::size_t largestChunks = 0;
+    int filesSoFar = 0;
+    const bool visited = instShieldFile.forEachEntry(
+        [&](const libstriezel::archive::entryView& view)
+        {
+          if (view.directory)
+            return true;
+          // extractTo() gives the reference data
+          if (!instShieldFile.extractTo(destFile, view.index))
+          {
+            std::cout << "Error: Could not extract file " << view.name << "!" << std::endl;
+            return false;
+          }
+          const std::vector<uint8_t> reference = readFile(destFile);
+          libstriezel::filesystem::file::remove(destFile);
+
+          // extraction into a growable buffer
+          std::vector<uint8_t> data;
+          if (!instShieldFile.extractToBuffer(view.index, data) || (data != reference)
+              || (crc(data) != crc(reference)))
+          {
+            std::cout << "Error: Data of " << view.name << " in buffer does not match!" << std::endl;
+            return false;
+          }
+
+          // extraction into a sink
+          std::vector<uint8_t> sinkData;
+          std::size_t chunks = 0;
+          const bool sinkSuccess = instShieldFile.extractToSink(view.index,
+              [&sinkData, &chunks](const void* chunk, const std::size_t size)
+              {
+                const uint8_t * bytes = static_cast<const uint8_t*>(chunk);
+                sinkData.insert(sinkData.end(), bytes, bytes + size);
+                ++chunks;
+                return true;
+              });
+          if (!sinkSuccess || (sinkData != reference) || (crc(sinkData) != crc(reference)))
+          {
+            std::cout << "Error: Data of " << view.name << " passed to the sink does not match!" << std::endl;
+            return false;
+          }
+
+          // extraction into a preallocated buffer
+          std::vector<uint8_t> fixed(reference.size() + 10, 0);
+          std::size_t size = 0;
+          if (!instShieldFile.extractToBuffer(view.index, fixed.data(), fixed.size(), size)
+              || (size != reference.size()) || !std::equal(reference.begin(), reference.end(), fixed.begin()))
+          {
+            std::cout << "Error: Extraction of " << view.name << " into preallocated buffer failed!" << std::endl;
+            return false;
+          }
+
+          if (chunks > largestChunks)
+          {
+            largest = view.index;
+            largestChunks = chunks;
+          }
+          // The cabinet is large, so some files are enough.
+          return ++filesSoFar < 250;
+        });
+    libstriezel::filesystem::directory::remove(tempDirName);
+    if (!visited && (filesSoFar < 250))
+      return 1;
+
+    // A sink that stops after the first chunk aborts the extraction part-way.
+    if (largestChunks < 2)
+    {
+      std::cout << "Error: No file is passed to the sink in several chunks!" << std::endl;
+      return 1;
+    }
+    std::size_t calls = 0;
+    if (instShieldFile.extractToSink(largest, [&calls](const void*, const std::size_t) { return ++calls < 2; })
+        || (calls != 2))
+    {
+      std::cout << "Error: Aborted extraction was not stopped or reported as success!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the InstallShield cabinet: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::installshield::archive::extractToBuffer() and extractToSink() was successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,307 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <archive.h>
+#include <archive_entry.h>
+#include "../../../archive/iso9660/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../testData.hpp"
+
+/* A file of the test image. Files with empty content are directories,
+   unless their name is empty.txt or they have a link target. */
+struct item
+{
+  std::string name;
+  std::string content;
+  std::string target;
+};
+
+/* Creates an ISO 9660 image with libarchive's writer. The options are the
+   ones of the iso9660 format of libarchive, e.g. "!rockridge". */
+bool createImage(const std::vector<item>& items, const std::string& options, std::vector<char>& image)
+{
+  struct archive * a = archive_write_new();
+  if ((archive_write_set_format_iso9660(a) != ARCHIVE_OK)
+      || (!options.empty() && (archive_write_set_options(a, options.c_str()) != ARCHIVE_OK)))
+  {
+    archive_write_free(a);
+    return false;
+  }
+  image.assign(8 * 1024 * 1024, '\0');
+  std::size_t used = 0;
+  if (archive_write_open_memory(a, image.data(), image.size(), &used) != ARCHIVE_OK)
+  {
+    archive_write_free(a);
+    return false;
+  }
+  bool success = true;
+  // Every entry gets another time, so the listing shows mix-ups.
+  time_t m_time = 1700000000;
+  for (const auto& i : items)
+  {
+    struct archive_entry * entry = archive_entry_new();
+    archive_entry_set_pathname(entry, i.name.c_str());
+    const bool directory = i.content.empty() && (i.name != "empty.txt") && i.target.empty();
+    if (!i.target.empty())
+    {
+      archive_entry_set_filetype(entry, AE_IFLNK);
+      archive_entry_set_symlink(entry, i.target.c_str());
+    }
+    else
+      archive_entry_set_filetype(entry, directory ? AE_IFDIR : AE_IFREG);
+    archive_entry_set_perm(entry, directory ? 0755 : 0644);
+    archive_entry_set_size(entry, static_cast<la_int64_t>(i.content.size()));
+    archive_entry_set_mtime(entry, m_time, 0);
+    m_time += 3601;
+    success = success && (archive_write_header(a, entry) == ARCHIVE_OK);
+    if (success && !i.content.empty())
+      success = archive_write_data(a, i.content.data(), i.content.size()) == static_cast<la_ssize_t>(i.content.size());
+    archive_entry_free(entry);
+  }
+  success = (archive_write_close(a) == ARCHIVE_OK) && success;
+  archive_write_free(a);
+  image.resize(used);
+  return success;
+}
+
+/* Lists the entries of an image in memory with libarchive. */
+std::vector<libstriezel::archive::entryLibarchive> listWithLibarchive(const std::vector<char>& data)
+{
+  std::vector<libstriezel::archive::entryLibarchive> result;
+  struct archive * a = archive_read_new();
+  archive_read_support_format_iso9660(a);
+  if (archive_read_open_memory(a, data.data(), data.size()) == ARCHIVE_OK)
+  {
+    struct archive_entry * ent = nullptr;
+    while (archive_read_next_header(a, &ent) == ARCHIVE_OK)
+      result.emplace_back(ent);
+  }
+  archive_read_free(a);
+  return result;
+}
+
+/* Checks that the native listing matches the listing of libarchive. */
+bool checkListing(libstriezel::archive::iso9660::archive& iso, const std::vector<char>& data)
+{
+  const auto expected = listWithLibarchive(data);
+  const auto entries = iso.entries();
+  if (entries.size() != expected.size())
+  {
+    std::cout << "Error: Image has " << entries.size() << " entries, but libarchive lists "
+              << expected.size() << " entries!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if ((entries[i].name() != expected[i].name()) || (entries[i].size() != expected[i].size())
+        || (entries[i].m_time() != expected[i].m_time())
+        || (entries[i].isDirectory() != expected[i].isDirectory())
+        || (entries[i].isSymLink() != expected[i].isSymLink()))
+    {
+      std::cout << "Error: Entry " << i << " (" << entries[i].name()
+                << ") does not match the entry of libarchive (" << expected[i].name()
+                << ")!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/* Checks extraction, random access and extents of all files of the image.
+   Only the compressed files have no extents. */
+bool checkImage(libstriezel::archive::iso9660::archive& iso, const std::string& tempDir,
+                const std::vector<std::string>& compressed, const unsigned int expectedFiles)
+{
+  unsigned int files = 0;
+  for (const auto& e : iso.entries())
+  {
+    if (e.isDirectory() || e.isSymLink())
+      continue;
+    ++files;
+    // libarchive reads the data of the file for comparison.
+    std::vector<uint8_t> expected;
+    if (!iso.extractToBuffer(e.name(), expected))
+    {
+      std::cout << "Error: libarchive could not read " << e.name() << "!" << std::endl;
+      return false;
+    }
+
+    const bool expectExtents = std::find(compressed.begin(), compressed.end(), e.name()) == compressed.end();
+    std::vector<libstriezel::archive::iso9660::extent> extents;
+    if (iso.fileExtents(e.name(), extents) != expectExtents)
+    {
+      std::cout << "Error: Unexpected result of fileExtents() for " << e.name() << "!" << std::endl;
+      return false;
+    }
+    int64_t total = 0;
+    for (const auto& ext : extents)
+      total += ext.size;
+    if (expectExtents && (total != static_cast<int64_t>(expected.size())))
+    {
+      std::cout << "Error: The extents of " << e.name() << " have a size of " << total
+                << " bytes instead of " << expected.size() << " bytes!" << std::endl;
+      return false;
+    }
+
+    const std::string destFile = tempDir + libstriezel::filesystem::pathDelimiter + "extracted.dat";
+    if (!iso.extractTo(destFile, e.name()))
+    {
+      std::cout << "Error: Could not extract " << e.name() << "!" << std::endl;
+      return false;
+    }
+    const std::string content = readFile(destFile);
+    libstriezel::filesystem::file::remove(destFile);
+    if (content != std::string(expected.begin(), expected.end()))
+    {
+      std::cout << "Error: Content of extracted file " << e.name() << " is wrong!" << std::endl;
+      return false;
+    }
+
+    // random access, including a read beyond the end of the file
+    const std::vector<std::pair<int64_t, std::size_t> > ranges = {
+      { 0, 10 }, { 1, 5000 }, { static_cast<int64_t>(content.size()) / 2, 70000 },
+      { static_cast<int64_t>(content.size()), 10 }
+    };
+    for (const auto& range : ranges)
+    {
+      std::vector<char> buffer(range.second);
+      const int64_t bytesRead = iso.readAt(e.name(), range.first, buffer.data(), buffer.size());
+      const std::size_t start = std::min(static_cast<std::size_t>(range.first), content.size());
+      const std::size_t count = std::min(range.second, content.size() - start);
+      if ((bytesRead != static_cast<int64_t>(count))
+          || !std::equal(buffer.begin(), buffer.begin() + count, content.begin() + start))
+      {
+        std::cout << "Error: readAt(" << e.name() << ", " << range.first << ", "
+                  << range.second << ") returned wrong data!" << std::endl;
+        return false;
+      }
+    }
+  }
+  if (files != expectedFiles)
+  {
+    std::cout << "Error: Expected " << expectedFiles << " files, but found " << files << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  const std::vector<item> items = {
+    { "dir", "" },
+    { "dir/sub", "" },
+    { "a.txt", "Hello, ISO 9660!\n" },
+    { "empty.txt", "" },
+    { "dir/b.bin", compressibleData(300000, 1) },
+    { "dir/sub/c.txt", std::string(70001, 'c') },
+    { "link", "", "a.txt" }
+  };
+
+  std::string tempDirName;
+  if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  tempDirName = libstriezel::filesystem::unslashify(tempDirName);
+
+  // first = options for libarchive, second = files that get compressed
+  const std::vector<std::pair<std::string, std::vector<std::string> > > variants = {
+    { "", {} }, // Rock Ridge and Joliet
+    { "!rockridge", {} }, // Joliet
+    { "!rockridge,!joliet", {} }, // plain ISO 9660 names
+    // zisofs only compresses files that get smaller, and only libarchive
+    // can decompress them
+    { "zisofs", { "dir/sub/c.txt" } }
+  };
+  for (const auto& variant : variants)
+  {
+    std::cout << "Checking image with options \"" << variant.first << "\" ..." << std::endl;
+    // Some versions of libarchive cannot read all zisofs files they write,
+    // so that image only gets files that it handles well.
+    std::vector<item> content;
+    unsigned int files = 0;
+    for (const auto& i : items)
+    {
+      // Only Rock Ridge has symbolic links.
+      if (!i.target.empty() && (variant.first != ""))
+        continue;
+      if ((variant.first != "zisofs") || (i.name != "dir/b.bin"))
+      {
+        content.push_back(i);
+        if (!i.content.empty() || (i.name == "empty.txt"))
+          ++files;
+      }
+    }
+    std::vector<char> data;
+    if (!createImage(content, variant.first, data))
+    {
+      // Builds of libarchive without zlib do not support zisofs.
+      if (variant.first == "zisofs")
+        continue;
+      std::cout << "Error: Could not create the ISO image!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+    const std::string imageFileName = tempDirName + libstriezel::filesystem::pathDelimiter + "test.iso";
+    {
+      std::ofstream stream(imageFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+      stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    bool success = false;
+    try
+    {
+      libstriezel::archive::iso9660::archive fromFile(imageFileName);
+      libstriezel::archive::iso9660::archive fromMemory(data.data(), data.size());
+      success = checkListing(fromFile, data) && checkListing(fromMemory, data)
+             && checkImage(fromFile, tempDirName, variant.second, files)
+             && checkImage(fromMemory, tempDirName, variant.second, files);
+    }
+    catch (const std::exception& ex)
+    {
+      std::cout << "Error: An exception occurred while working with the image: "
+                << ex.what() << std::endl;
+    }
+    libstriezel::filesystem::file::remove(imageFileName);
+    if (!success)
+    {
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+  }
+  libstriezel::filesystem::directory::remove(tempDirName);
+
+  //Everything is OK.
+  std::cout << "Test for native reading of ISO 9660 images was successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <iostream>
+#include <map>
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../../hash/sha256/sha256.hpp"
+#include "../../../hash/sha256/FileSourceUtility.hpp"
+
+/* Expected parameters: 1 - directory that contains the .tar file */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string tarFileName = tarDirectory + libstriezel::filesystem::pathDelimiter + "grep-2.0.tar";
+
+  try
+  {
+    libstriezel::tar::archive tarFile(tarFileName);
+
+    std::string tempDirName;
+    if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+    {
+      std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+      return 1;
+    }
+    const std::string tempDir = libstriezel::filesystem::slashify(tempDirName);
+
+    //request every file - in reverse order, the archive order must not matter
+    std::map<std::string, std::string> files;
+    std::map<std::string, int64_t> sizes;
+    const auto entries = tarFile.entries();
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+    {
+      if (!it->isDirectory())
+      {
+        files[it->name()] = tempDir + std::to_string(files.size()) + ".dat";
+        sizes[it->name()] = it->size();
+      }
+    }
+    //... plus one file that does not exist
+    files["grep-2.0/does-not-exist.txt"] = tempDir + "missing.dat";
+
+    const auto result = tarFile.extractMany(files);
+    if (result.size() != files.size())
+    {
+      std::cout << "Error: Expected " << files.size() << " results, but got "
+                << result.size() << "!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+    for (const auto& item : result)
+    {
+      const std::string& destFile = files[item.first];
+      if (item.first == "grep-2.0/does-not-exist.txt")
+      {
+        if (item.second || libstriezel::filesystem::file::exists(destFile))
+        {
+          std::cout << "Error: Extraction of non-existing file succeeded!" << std::endl;
+          libstriezel::filesystem::directory::remove(tempDirName);
+          return 1;
+        }
+        continue;
+      }
+      if (!item.second)
+      {
+        std::cout << "Error: Could not extract file " << item.first
+                  << " from tar archive!" << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      //check size
+      if (libstriezel::filesystem::file::getSize64(destFile) != sizes[item.first])
+      {
+        std::cout << "Error: File size of extracted file " << item.first
+                  << " does not match its size specified in the archive!" << std::endl;
+        libstriezel::filesystem::file::remove(destFile);
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      //check content of one file in detail
+      if (item.first == "grep-2.0/COPYING")
+      {
+        const std::string mdExpected = "91df39d1816bfb17a4dda2d3d2c83b1f6f2d38d53e53e41e8f97ad5ac46a0cad";
+        const SHA256::MessageDigest md = SHA256::computeFromFile(destFile);
+        if (mdExpected != md.toHexString())
+        {
+          std::cout << "Error: Hash of extracted file is wrong!" << std::endl
+                    << "Hash is:  " << md.toHexString() << std::endl
+                    << "Expected: " << mdExpected << std::endl;
+          libstriezel::filesystem::file::remove(destFile);
+          libstriezel::filesystem::directory::remove(tempDirName);
+          return 1;
+        }
+      }
+      libstriezel::filesystem::file::remove(destFile);
+    } //for
+    libstriezel::filesystem::directory::remove(tempDirName);
+    if (result.find("grep-2.0/COPYING") == result.end())
+    {
+      std::cout << "Error: File grep-2.0/COPYING was not extracted!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the tar file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::tar::archive::extractMany() was successful." << std::endl;
+  return 0;
+}
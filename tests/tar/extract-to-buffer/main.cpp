@@ -0,0 +1,148 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../hash/sha256/sha256.hpp"
+#include "../../../hash/sha256/BufferSourceUtility.hpp"
+
+/* Expected parameters: 1 - directory that contains the .tar file */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string tarFileName = tarDirectory + libstriezel::filesystem::pathDelimiter + "grep-2.0.tar";
+  const std::string fileName = "grep-2.0/COPYING";
+
+  try
+  {
+    libstriezel::tar::archive tarFile(tarFileName);
+
+    int64_t expectedSize = -1;
+    for (const auto& entry : tarFile.entries())
+    {
+      if (entry.name() == fileName)
+        expectedSize = entry.size();
+    }
+    if (expectedSize <= 0)
+    {
+      std::cout << "Error: Archive does not contain " << fileName << "!" << std::endl;
+      return 1;
+    }
+
+    // extraction into a growable buffer
+    std::vector<uint8_t> data;
+    if (!tarFile.extractToBuffer(fileName, data))
+    {
+      std::cout << "Error: Could not extract " << fileName << " into a buffer!" << std::endl;
+      return 1;
+    }
+    if (static_cast<int64_t>(data.size()) != expectedSize)
+    {
+      std::cout << "Error: Size of extracted data does not match the size "
+                << "specified in the archive!" << std::endl;
+      return 1;
+    }
+    const std::string mdExpected = "91df39d1816bfb17a4dda2d3d2c83b1f6f2d38d53e53e41e8f97ad5ac46a0cad";
+    const SHA256::MessageDigest md = SHA256::computeFromBuffer(data.data(), data.size() * 8);
+    if (mdExpected != md.toHexString())
+    {
+      std::cout << "Error: Hash of extracted data is wrong!" << std::endl
+                << "Hash is:  " << md.toHexString() << std::endl
+                << "Expected: " << mdExpected << std::endl;
+      return 1;
+    }
+
+    // extraction into a callback
+    std::vector<uint8_t> sinkData;
+    unsigned int chunks = 0;
+    const bool sinkSuccess = tarFile.extractToSink(fileName,
+        [&sinkData, &chunks](const void* chunk, const std::size_t size)
+        {
+          const uint8_t * bytes = static_cast<const uint8_t*>(chunk);
+          sinkData.insert(sinkData.end(), bytes, bytes + size);
+          ++chunks;
+          return true;
+        });
+    if (!sinkSuccess || (chunks == 0) || (sinkData != data))
+    {
+      std::cout << "Error: Data passed to the sink does not match!" << std::endl;
+      return 1;
+    }
+
+    // a sink can abort the extraction
+    if (tarFile.extractToSink(fileName, [](const void*, const std::size_t) { return false; }))
+    {
+      std::cout << "Error: Aborted extraction was reported as success!" << std::endl;
+      return 1;
+    }
+
+    // extraction into a preallocated buffer that is large enough
+    std::vector<uint8_t> fixed(data.size() + 10, 0);
+    std::size_t size = 0;
+    if (!tarFile.extractToBuffer(fileName, fixed.data(), fixed.size(), size)
+        || (size != data.size()) || !std::equal(data.begin(), data.end(), fixed.begin()))
+    {
+      std::cout << "Error: Extraction into preallocated buffer failed!" << std::endl;
+      return 1;
+    }
+
+    // extraction into a preallocated buffer that is too small
+    if (tarFile.extractToBuffer(fileName, fixed.data(), data.size() - 1, size))
+    {
+      std::cout << "Error: Extraction into a buffer that is too small succeeded!" << std::endl;
+      return 1;
+    }
+
+    // extraction of a file that does not exist
+    if (tarFile.extractToBuffer("grep-2.0/does-not-exist.txt", data) || !data.empty())
+    {
+      std::cout << "Error: Extraction of non-existing file succeeded!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the tar file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::tar::archive::extractToBuffer() was successful." << std::endl;
+  return 0;
+}
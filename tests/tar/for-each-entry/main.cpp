@@ -0,0 +1,180 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+
+/// name, size and type of an entry, copied from an entryView
+struct visited
+{
+  std::string name;
+  int64_t size;
+  bool directory;
+};
+
+/* Visits all entries of the archive and copies them into a vector. Returns
+   false, if the visit was not complete. */
+bool visitAll(libstriezel::tar::archive& tarFile, std::vector<visited>& result)
+{
+  result.clear();
+  return tarFile.forEachEntry([&result](const libstriezel::archive::entryView& view)
+  {
+    if (view.index != static_cast<int64_t>(result.size()))
+      return false;
+    result.push_back({ std::string(view.name), view.size, view.directory });
+    return true;
+  });
+}
+
+/* Checks that the visited entries match the entries of the archive. */
+bool matches(const std::vector<visited>& seen, const std::vector<libstriezel::archive::entryLibarchive>& expected, const std::string& kind)
+{
+  if (seen.size() != expected.size())
+  {
+    std::cout << "Error: forEachEntry() of " << kind << " archive visited " << seen.size()
+              << " entries, but there are " << expected.size() << "!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < seen.size(); ++i)
+  {
+    if ((seen[i].name != expected[i].name()) || (seen[i].size != expected[i].size())
+        || (seen[i].directory != expected[i].isDirectory()))
+    {
+      std::cout << "Error: Visited entry " << i << " (" << seen[i].name << ") of " << kind
+                << " archive does not match " << expected[i].name() << "!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Expected parameters: 1 - directory that contains the .tar file */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string tarFileName = tarDirectory + libstriezel::filesystem::pathDelimiter + "grep-2.0.tar";
+
+  try
+  {
+    libstriezel::tar::archive eagerTar(tarFileName);
+    const auto expected = eagerTar.entries();
+    if (expected.empty())
+    {
+      std::cout << "Error: " << tarFileName << " has no entries!" << std::endl;
+      return 1;
+    }
+
+    // visiting a lazily opened archive reads the headers without listing them
+    libstriezel::tar::archive lazyTar(tarFileName, true);
+    std::vector<visited> seen;
+    if (!visitAll(lazyTar, seen))
+    {
+      std::cout << "Error: forEachEntry() of lazy archive failed!" << std::endl;
+      return 1;
+    }
+    if (!matches(seen, expected, "lazy"))
+      return 1;
+
+    // the visitor can stop early, and the next visit starts at the beginning
+    std::size_t count = 0;
+    if (lazyTar.forEachEntry([&count](const libstriezel::archive::entryView&) { return ++count < 2; }))
+    {
+      std::cout << "Error: forEachEntry() does not report a stopped visit!" << std::endl;
+      return 1;
+    }
+    if (count != std::min<std::size_t>(2, expected.size()))
+    {
+      std::cout << "Error: Visitor was called " << count << " times after it stopped!" << std::endl;
+      return 1;
+    }
+    if (!visitAll(lazyTar, seen) || !matches(seen, expected, "lazy"))
+      return 1;
+
+    // entries() of the lazy archive lists them on first use
+    const auto lazyEntries = lazyTar.entries();
+    if (lazyEntries.size() != expected.size())
+    {
+      std::cout << "Error: Lazy archive has " << lazyEntries.size() << " entries, but "
+                << expected.size() << " were expected!" << std::endl;
+      return 1;
+    }
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+      if ((lazyEntries[i].name() != expected[i].name()) || (lazyEntries[i].size() != expected[i].size()))
+      {
+        std::cout << "Error: Entry " << i << " of lazy archive does not match!" << std::endl;
+        return 1;
+      }
+    }
+    if (!lazyTar.contains(expected.back().name()))
+    {
+      std::cout << "Error: Lazy archive does not contain " << expected.back().name() << "!" << std::endl;
+      return 1;
+    }
+
+    // visiting an eagerly opened archive uses the list of entries
+    if (!visitAll(eagerTar, seen) || !matches(seen, expected, "eager"))
+      return 1;
+
+    // lookups on a lazy archive list the entries, too
+    libstriezel::tar::archive lookupTar(tarFileName, true);
+    std::vector<uint8_t> data;
+    if (!lookupTar.extractToBuffer(expected.back().name(), data))
+    {
+      std::cout << "Error: Could not extract " << expected.back().name()
+                << " from lazy archive!" << std::endl;
+      return 1;
+    }
+    if ((expected.back().size() >= 0) && (data.size() != static_cast<std::size_t>(expected.back().size())))
+    {
+      std::cout << "Error: Extracted data of lazy archive has the wrong size!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the tar file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Tests for lazy tape archives and forEachEntry() were successful." << std::endl;
+  return 0;
+}
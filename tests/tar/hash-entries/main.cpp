@@ -0,0 +1,145 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <iostream>
+#include "../../../archive/hashEntries.hpp"
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../../hash/sha1/FileSourceUtility.hpp"
+#include "../../../hash/sha256/FileSourceUtility.hpp"
+
+/* Expected parameters: 1 - directory that contains the .tar file */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string tarFileName = tarDirectory + libstriezel::filesystem::pathDelimiter + "grep-2.0.tar";
+
+  try
+  {
+    libstriezel::tar::archive tarFile(tarFileName);
+
+    std::vector<std::pair<libstriezel::archive::entryLibarchive, libstriezel::hash::Digests> > hashes;
+    if (!libstriezel::archive::hashEntries(tarFile, libstriezel::hash::sha1 | libstriezel::hash::sha256, hashes))
+    {
+      std::cout << "Error: Could not compute hashes of entries!" << std::endl;
+      return 1;
+    }
+
+    //every file has to be there, but no directory or symbolic link
+    std::size_t fileCount = 0;
+    for (const auto& e : tarFile.entries())
+    {
+      if (!e.isDirectory() && !e.isSymLink())
+        ++fileCount;
+    }
+    if (hashes.size() != fileCount)
+    {
+      std::cout << "Error: Expected " << fileCount << " hashed entries, but got "
+                << hashes.size() << "!" << std::endl;
+      return 1;
+    }
+
+    //compare with hashes of extracted files
+    std::string tempDirName;
+    if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+    {
+      std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+      return 1;
+    }
+    bool foundCopying = false;
+    for (const auto& item : hashes)
+    {
+      const auto& e = item.first;
+      const std::string destFile = libstriezel::filesystem::slashify(tempDirName) + e.basename();
+      if (!tarFile.extractTo(destFile, e.name()))
+      {
+        std::cout << "Error: Could not extract file " << e.name()
+                  << " from tar archive!" << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      const SHA1::MessageDigest sha1 = SHA1::computeFromFile(destFile);
+      const SHA256::MessageDigest sha256 = SHA256::computeFromFile(destFile);
+      libstriezel::filesystem::file::remove(destFile);
+      if ((sha1 != item.second.sha1) || (sha256 != item.second.sha256))
+      {
+        std::cout << "Error: Hash of entry " << e.name() << " does not match the hash"
+                  << " of the extracted file!" << std::endl
+                  << "SHA-256 is: " << item.second.sha256.toHexString() << std::endl
+                  << "Expected:   " << sha256.toHexString() << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      //algorithms that were not requested stay null
+      if (!item.second.sha512.isNull())
+      {
+        std::cout << "Error: SHA-512 hash of entry " << e.name() << " is not null!"
+                  << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      if (e.name() == "grep-2.0/COPYING")
+      {
+        foundCopying = true;
+        const std::string mdExpected = "91df39d1816bfb17a4dda2d3d2c83b1f6f2d38d53e53e41e8f97ad5ac46a0cad";
+        if (item.second.sha256.toHexString() != mdExpected)
+        {
+          std::cout << "Error: Hash of grep-2.0/COPYING is wrong!" << std::endl
+                    << "Hash is:  " << item.second.sha256.toHexString() << std::endl
+                    << "Expected: " << mdExpected << std::endl;
+          libstriezel::filesystem::directory::remove(tempDirName);
+          return 1;
+        }
+      }
+    } //for
+    libstriezel::filesystem::directory::remove(tempDirName);
+    if (!foundCopying)
+    {
+      std::cout << "Error: Entry grep-2.0/COPYING was not hashed!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the tar file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::archive::hashEntries() with tar archives was successful." << std::endl;
+  return 0;
+}
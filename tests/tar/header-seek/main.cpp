@@ -0,0 +1,208 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <archive.h>
+#include <archive_entry.h>
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../testData.hpp"
+
+/* tar archive that records where libarchive starts to read */
+class recordingArchive : public libstriezel::tar::archive
+{
+  public:
+    recordingArchive(const std::string& fileName)
+    : libstriezel::tar::archive(fileName),
+      offsets(std::vector<int64_t>())
+    {
+    }
+
+    using libstriezel::tar::archive::supportsHeaderSeek;
+
+    /* Gets the offset of the header of the entry with the given index. */
+    int64_t headerOffset(const std::size_t index) const
+    {
+      return m_headerOffsets.at(index);
+    }
+
+    std::vector<int64_t> offsets; /* offsets of all openSource() calls */
+  protected:
+    int openSource(const int64_t offset = 0) override
+    {
+      offsets.push_back(offset);
+      return libstriezel::tar::archive::openSource(offset);
+    }
+};
+
+/* Creates a tar archive with libarchive's writer, optionally compressed
+   with gzip. */
+bool createArchive(const std::vector<std::pair<std::string, std::string> >& files,
+                   const bool gzip, const std::string& fileName)
+{
+  struct archive * a = archive_write_new();
+  archive_write_set_format_pax_restricted(a);
+  if (gzip)
+    archive_write_add_filter_gzip(a);
+  if (archive_write_open_filename(a, fileName.c_str()) != ARCHIVE_OK)
+  {
+    archive_write_free(a);
+    return false;
+  }
+  bool success = true;
+  for (const auto& file : files)
+  {
+    struct archive_entry * entry = archive_entry_new();
+    archive_entry_set_pathname(entry, file.first.c_str());
+    archive_entry_set_filetype(entry, AE_IFREG);
+    archive_entry_set_perm(entry, 0644);
+    archive_entry_set_size(entry, static_cast<la_int64_t>(file.second.size()));
+    success = success && (archive_write_header(a, entry) == ARCHIVE_OK);
+    if (success && !file.second.empty())
+      success = archive_write_data(a, file.second.data(), file.second.size()) == static_cast<la_ssize_t>(file.second.size());
+    archive_entry_free(entry);
+  }
+  success = (archive_write_close(a) == ARCHIVE_OK) && success;
+  archive_write_free(a);
+  return success;
+}
+
+/* Extracts the entries in the given order and checks their data. Returns
+   false, if the data of an entry is wrong. */
+bool checkExtraction(recordingArchive& tar, const std::vector<std::pair<std::string, std::string> >& files,
+                     const std::vector<std::size_t>& order, const bool seekExpected)
+{
+  for (const std::size_t idx : order)
+  {
+    const auto& file = files[idx];
+    tar.offsets.clear();
+    std::vector<uint8_t> buffer;
+    if (!tar.extractToBuffer(file.first, buffer)
+        || (std::string(buffer.begin(), buffer.end()) != file.second))
+    {
+      std::cout << "Error: Data of " << file.first << " is wrong!" << std::endl;
+      return false;
+    }
+    if (seekExpected)
+    {
+      // The archive is opened exactly once, right at the header of the entry.
+      if ((tar.offsets.size() != 1) || (tar.offsets[0] != tar.headerOffset(idx)))
+      {
+        std::cout << "Error: Extraction of " << file.first
+                  << " did not start at the header of the entry!" << std::endl;
+        return false;
+      }
+    }
+    else
+    {
+      // Compressed data is always read from the start.
+      for (const int64_t offset : tar.offsets)
+      {
+        if (offset != 0)
+        {
+          std::cout << "Error: Extraction of " << file.first
+                    << " started in the middle of compressed data!" << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  std::vector<std::pair<std::string, std::string> > files;
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    files.emplace_back("dir/file" + std::to_string(i) + ".bin", randomData(1000 + i * 12345, i));
+  }
+  // last, first, middle - and everything again
+  const std::vector<std::size_t> order = { 7, 0, 4, 7, 0, 4, 3, 6, 1, 1, 5, 2 };
+
+  std::string tempDirName;
+  if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  tempDirName = libstriezel::filesystem::unslashify(tempDirName);
+
+  bool success = true;
+  for (const bool gzip : { false, true })
+  {
+    const std::string tarFileName = tempDirName + libstriezel::filesystem::pathDelimiter
+                                  + (gzip ? "test.tar.gz" : "test.tar");
+    if (!createArchive(files, gzip, tarFileName))
+    {
+      std::cout << "Error: Could not create the tar archive!" << std::endl;
+      success = false;
+      break;
+    }
+    try
+    {
+      recordingArchive tar(tarFileName);
+      if (tar.supportsHeaderSeek() == gzip)
+      {
+        std::cout << "Error: Header seek shall only be supported for uncompressed archives!"
+                  << std::endl;
+        success = false;
+      }
+      success = success && checkExtraction(tar, files, order, !gzip);
+
+      // extraction to files gets the same data
+      const std::string destFile = tempDirName + libstriezel::filesystem::pathDelimiter + "extracted.dat";
+      for (std::size_t i = 0; success && (i < order.size()); ++i)
+      {
+        const auto& file = files[order[i]];
+        success = tar.extractTo(destFile, file.first);
+        std::ifstream stream(destFile, std::ios_base::in | std::ios_base::binary);
+        const std::string content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        stream.close();
+        libstriezel::filesystem::file::remove(destFile);
+        if (!success || (content != file.second))
+        {
+          std::cout << "Error: Extracted file " << file.first << " is wrong!" << std::endl;
+          success = false;
+        }
+      }
+    }
+    catch (const std::exception& ex)
+    {
+      std::cout << "Error: An exception occurred while working with the archive: "
+                << ex.what() << std::endl;
+      success = false;
+    }
+    libstriezel::filesystem::file::remove(tarFileName);
+    if (!success)
+      break;
+  }
+  libstriezel::filesystem::directory::remove(tempDirName);
+  if (!success)
+    return 1;
+
+  //Everything is OK.
+  std::cout << "Test for extraction with header seeking was successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,289 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include <archive.h>
+#include <archive_entry.h>
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../testData.hpp"
+
+/* An entry of the test archive. */
+struct item
+{
+  std::string name;
+  char type; // 'f' = file, 'd' = directory, 's' = symbolic link, 'h' = hard link
+  std::string content; // data of files, target of links
+};
+
+/* Creates a tar archive with libarchive's writer in the given format. */
+bool createArchive(const std::vector<item>& items, const int format, std::vector<char>& data)
+{
+  struct archive * a = archive_write_new();
+  if (archive_write_set_format(a, format) != ARCHIVE_OK)
+  {
+    archive_write_free(a);
+    return false;
+  }
+  archive_write_set_bytes_in_last_block(a, 1);
+  data.assign(4 * 1024 * 1024, '\0');
+  std::size_t used = 0;
+  if (archive_write_open_memory(a, data.data(), data.size(), &used) != ARCHIVE_OK)
+  {
+    archive_write_free(a);
+    return false;
+  }
+  bool success = true;
+  for (const auto& i : items)
+  {
+    struct archive_entry * entry = archive_entry_new();
+    archive_entry_set_pathname(entry, i.name.c_str());
+    archive_entry_set_mtime(entry, 1700000000 + static_cast<time_t>(i.name.size()), 0);
+    switch (i.type)
+    {
+      case 'd':
+           archive_entry_set_filetype(entry, AE_IFDIR);
+           archive_entry_set_perm(entry, 0755);
+           break;
+      case 's':
+           archive_entry_set_filetype(entry, AE_IFLNK);
+           archive_entry_set_perm(entry, 0777);
+           archive_entry_set_symlink(entry, i.content.c_str());
+           break;
+      case 'h':
+           archive_entry_set_filetype(entry, AE_IFREG);
+           archive_entry_set_perm(entry, 0644);
+           archive_entry_set_hardlink(entry, i.content.c_str());
+           break;
+      default:
+           archive_entry_set_filetype(entry, AE_IFREG);
+           archive_entry_set_perm(entry, 0644);
+           archive_entry_set_size(entry, static_cast<la_int64_t>(i.content.size()));
+           break;
+    }
+    success = success && (archive_write_header(a, entry) == ARCHIVE_OK);
+    if (success && (i.type == 'f') && !i.content.empty())
+      success = archive_write_data(a, i.content.data(), i.content.size()) == static_cast<la_ssize_t>(i.content.size());
+    archive_entry_free(entry);
+  }
+  success = (archive_write_close(a) == ARCHIVE_OK) && success;
+  archive_write_free(a);
+  data.resize(used);
+  return success;
+}
+
+/* Lists the entries of an archive in memory with libarchive. */
+std::vector<libstriezel::archive::entryLibarchive> listWithLibarchive(const std::vector<char>& data)
+{
+  std::vector<libstriezel::archive::entryLibarchive> result;
+  struct archive * a = archive_read_new();
+  archive_read_support_format_tar(a);
+  archive_read_support_format_gnutar(a);
+  if (archive_read_open_memory(a, data.data(), data.size()) == ARCHIVE_OK)
+  {
+    struct archive_entry * ent = nullptr;
+    while (archive_read_next_header(a, &ent) == ARCHIVE_OK)
+      result.emplace_back(ent);
+  }
+  archive_read_free(a);
+  return result;
+}
+
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/* Checks the listing and the extraction of all files of an archive. */
+bool checkArchive(libstriezel::tar::archive& tar, const std::vector<char>& data,
+                  const std::vector<item>& items, const std::string& tempDir)
+{
+  const auto expected = listWithLibarchive(data);
+  const auto entries = tar.entries();
+  if (entries.size() != expected.size())
+  {
+    std::cout << "Error: Archive has " << entries.size() << " entries, but libarchive lists "
+              << expected.size() << " entries!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if ((entries[i].name() != expected[i].name()) || (entries[i].size() != expected[i].size())
+        || (entries[i].m_time() != expected[i].m_time())
+        || (entries[i].isDirectory() != expected[i].isDirectory())
+        || (entries[i].isSymLink() != expected[i].isSymLink()))
+    {
+      std::cout << "Error: Entry " << i << " (" << entries[i].name()
+                << ") does not match the entry of libarchive (" << expected[i].name()
+                << ")!" << std::endl;
+      return false;
+    }
+  }
+
+  // single files
+  const std::string destFile = tempDir + libstriezel::filesystem::pathDelimiter + "extracted.dat";
+  for (const auto& i : items)
+  {
+    if (i.type != 'f')
+      continue;
+    if (!tar.extractTo(destFile, i.name))
+    {
+      std::cout << "Error: Could not extract " << i.name << "!" << std::endl;
+      return false;
+    }
+    const std::string content = readFile(destFile);
+    libstriezel::filesystem::file::remove(destFile);
+    if (content != i.content)
+    {
+      std::cout << "Error: Content of extracted file " << i.name << " is wrong!" << std::endl;
+      return false;
+    }
+  }
+
+  // several files at once, including links that libarchive extracts
+  for (const unsigned int threads : { 1u, 2u, 4u })
+  {
+    std::map<std::string, std::string> files;
+    std::map<std::string, std::string> contents;
+    unsigned int number = 0;
+    for (const auto& i : items)
+    {
+      if (i.type == 'd')
+        continue;
+      const std::string name = tempDir + libstriezel::filesystem::pathDelimiter
+                             + "many_" + std::to_string(number++) + ".dat";
+      files[i.name] = name;
+      if (i.type == 'f')
+        contents[name] = i.content;
+    }
+    files["does/not/exist.txt"] = tempDir + libstriezel::filesystem::pathDelimiter + "missing.dat";
+    const auto result = tar.extractMany(files, threads);
+    for (const auto& file : files)
+    {
+      const auto iter = result.find(file.first);
+      const bool shouldWork = file.first != "does/not/exist.txt";
+      if ((iter == result.end()) || (iter->second != shouldWork))
+      {
+        std::cout << "Error: Unexpected result of extractMany() with " << threads
+                  << " threads for " << file.first << "!" << std::endl;
+        return false;
+      }
+      const auto content = contents.find(file.second);
+      if ((content != contents.end()) && (readFile(file.second) != content->second))
+      {
+        std::cout << "Error: extractMany() with " << threads << " threads extracted wrong data for "
+                  << file.first << "!" << std::endl;
+        return false;
+      }
+      libstriezel::filesystem::file::remove(file.second);
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  const std::string longDir = "a-directory-with-a-rather-long-name/that-contains-another-directory-with-a-long-name";
+  const std::vector<item> items = {
+    { "dir/", 'd', "" },
+    { "dir/a.txt", 'f', "Hello, tar!\n" },
+    { "dir/empty.txt", 'f', "" },
+    { "dir/block.bin", 'f', randomData(512, 1) },
+    { "dir/big.bin", 'f', randomData(300001, 2) },
+    { "dir/link", 's', "a.txt" },
+    { "dir/hardlink", 'h', "dir/a.txt" },
+    { longDir + "/", 'd', "" },
+    { longDir + "/file-with-a-long-name-that-does-not-fit-into-one-hundred-bytes.txt", 'f', randomData(1000, 3) },
+    { "last.txt", 'f', "end" }
+  };
+
+  std::string tempDirName;
+  if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  tempDirName = libstriezel::filesystem::unslashify(tempDirName);
+
+  const std::vector<std::pair<int, std::string> > formats = {
+    { ARCHIVE_FORMAT_TAR_USTAR, "ustar" },
+    { ARCHIVE_FORMAT_TAR_PAX_RESTRICTED, "restricted pax" },
+    { ARCHIVE_FORMAT_TAR_PAX_INTERCHANGE, "pax" },
+    { ARCHIVE_FORMAT_TAR_GNUTAR, "GNU tar" }
+  };
+  for (const auto& format : formats)
+  {
+    std::cout << "Checking " << format.second << " archive ..." << std::endl;
+    std::vector<char> data;
+    if (!createArchive(items, format.first, data))
+    {
+      std::cout << "Error: Could not create the tar archive!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+    // The headers of all these archives can be read without libarchive.
+    std::vector<libstriezel::tar::header> headers;
+    const libstriezel::tar::CompressedReader reader =
+        libstriezel::archive::compressedReader("", data.data(), data.size(), nullptr);
+    if (!libstriezel::tar::readHeaders(reader, headers) || (headers.size() != items.size()))
+    {
+      std::cout << "Error: Could not read the headers of the archive natively!" << std::endl;
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+
+    const std::string tarFileName = tempDirName + libstriezel::filesystem::pathDelimiter + "test.tar";
+    {
+      std::ofstream stream(tarFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+      stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    bool success = false;
+    try
+    {
+      libstriezel::tar::archive fromFile(tarFileName);
+      libstriezel::tar::archive fromMemory(data.data(), data.size());
+      success = checkArchive(fromFile, data, items, tempDirName)
+             && checkArchive(fromMemory, data, items, tempDirName);
+    }
+    catch (const std::exception& ex)
+    {
+      std::cout << "Error: An exception occurred while working with the archive: "
+                << ex.what() << std::endl;
+    }
+    libstriezel::filesystem::file::remove(tarFileName);
+    if (!success)
+    {
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+  }
+  libstriezel::filesystem::directory::remove(tempDirName);
+
+  //Everything is OK.
+  std::cout << "Test for native reading of tar headers was successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../hash/sha256/sha256.hpp"
+#include "../../../hash/sha256/BufferSourceUtility.hpp"
+
+/// stream that hands out the data of a memory buffer in small pieces
+class chunkedStream: public libstriezel::archive::seekableStream
+{
+  public:
+    chunkedStream(const std::vector<uint8_t>& data)
+    : m_data(data),
+      m_position(0)
+    {
+    }
+
+    int64_t read(void* buffer, const std::size_t size) override
+    {
+      // small pieces make sure that reads across chunk borders are tested
+      const std::size_t count = std::min<std::size_t>(std::min<std::size_t>(size, 1000), m_data.size() - m_position);
+      std::copy(m_data.begin() + m_position, m_data.begin() + m_position + count, static_cast<uint8_t*>(buffer));
+      m_position += count;
+      return static_cast<int64_t>(count);
+    }
+
+    int64_t seek(const int64_t offset, const int whence) override
+    {
+      int64_t target = offset;
+      if (whence == SEEK_CUR)
+        target += static_cast<int64_t>(m_position);
+      else if (whence == SEEK_END)
+        target += static_cast<int64_t>(m_data.size());
+      if ((target < 0) || (target > static_cast<int64_t>(m_data.size())))
+        return -1;
+      m_position = static_cast<std::size_t>(target);
+      return target;
+    }
+  private:
+    const std::vector<uint8_t>& m_data;
+    std::size_t m_position;
+};
+
+/* Checks that an archive has the same entries as the one opened from file and
+   that the data of grep-2.0/COPYING is correct. */
+bool checkArchive(libstriezel::tar::archive& tarFile, const std::vector<libstriezel::archive::entryLibarchive>& expected, const std::string& kind)
+{
+  const auto entries = tarFile.entries();
+  if (entries.size() != expected.size())
+  {
+    std::cout << "Error: Archive opened from " << kind << " has " << entries.size()
+              << " entries, but the file has " << expected.size() << "!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if ((entries[i].name() != expected[i].name()) || (entries[i].size() != expected[i].size()))
+    {
+      std::cout << "Error: Entry " << i << " of archive opened from " << kind
+                << " does not match the entry of the file!" << std::endl;
+      return false;
+    }
+  }
+
+  std::vector<uint8_t> data;
+  if (!tarFile.extractToBuffer("grep-2.0/COPYING", data))
+  {
+    std::cout << "Error: Could not extract grep-2.0/COPYING from archive opened from "
+              << kind << "!" << std::endl;
+    return false;
+  }
+  const std::string mdExpected = "91df39d1816bfb17a4dda2d3d2c83b1f6f2d38d53e53e41e8f97ad5ac46a0cad";
+  const SHA256::MessageDigest md = SHA256::computeFromBuffer(data.data(), data.size() * 8);
+  if (mdExpected != md.toHexString())
+  {
+    std::cout << "Error: Hash of data extracted from archive opened from " << kind
+              << " is wrong!" << std::endl
+              << "Hash is:  " << md.toHexString() << std::endl
+              << "Expected: " << mdExpected << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/* Expected parameters: 1 - directory that contains the .tar file */
+
+int main(int argc, char** argv)
+{
+  std::string tarDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    tarDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(tarDirectory))
+    {
+      std::cout << "Error: Directory " << tarDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (tar directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string tarFileName = tarDirectory + libstriezel::filesystem::pathDelimiter + "grep-2.0.tar";
+
+  std::ifstream stream(tarFileName, std::ios_base::in | std::ios_base::binary);
+  const std::vector<uint8_t> content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  stream.close();
+  if (content.empty())
+  {
+    std::cout << "Error: Could not read " << tarFileName << "!" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    libstriezel::tar::archive tarFile(tarFileName);
+    const auto expected = tarFile.entries();
+
+    libstriezel::tar::archive memoryTar(content.data(), content.size());
+    if (!checkArchive(memoryTar, expected, "memory"))
+      return 1;
+
+    chunkedStream chunks(content);
+    libstriezel::tar::archive streamTar(chunks);
+    if (!checkArchive(streamTar, expected, "stream"))
+      return 1;
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the tar file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for opening tape archives from memory was successful." << std::endl;
+  return 0;
+}
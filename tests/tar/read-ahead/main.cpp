@@ -0,0 +1,284 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include <archive.h>
+#include <archive_entry.h>
+#include <lzma.h>
+#include <zlib.h>
+#include "../../../archive/readAhead.hpp"
+#include "../../../archive/tar/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../testData.hpp"
+
+using libstriezel::archive::format;
+
+/* Creates an uncompressed tar archive with libarchive's writer. */
+bool createTar(const std::map<std::string, std::string>& files, std::string& data)
+{
+  struct archive * a = archive_write_new();
+  archive_write_set_format_pax_restricted(a);
+  std::vector<char> buffer(16 * 1024 * 1024);
+  std::size_t used = 0;
+  if (archive_write_open_memory(a, buffer.data(), buffer.size(), &used) != ARCHIVE_OK)
+  {
+    archive_write_free(a);
+    return false;
+  }
+  bool success = true;
+  for (const auto& file : files)
+  {
+    struct archive_entry * entry = archive_entry_new();
+    archive_entry_set_pathname(entry, file.first.c_str());
+    archive_entry_set_filetype(entry, AE_IFREG);
+    archive_entry_set_perm(entry, 0644);
+    archive_entry_set_size(entry, static_cast<la_int64_t>(file.second.size()));
+    success = success && (archive_write_header(a, entry) == ARCHIVE_OK);
+    if (success && !file.second.empty())
+      success = archive_write_data(a, file.second.data(), file.second.size()) == static_cast<la_ssize_t>(file.second.size());
+    archive_entry_free(entry);
+  }
+  success = (archive_write_close(a) == ARCHIVE_OK) && success;
+  archive_write_free(a);
+  data.assign(buffer.data(), used);
+  return success;
+}
+
+/* Compresses data into a single gzip member. */
+std::string gzip(const std::string& data)
+{
+  std::string result(compressBound(static_cast<uLong>(data.size())) + 64, '\0');
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  // 15 + 16: gzip header, maximum window size
+  deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+  stream.avail_out = static_cast<uInt>(result.size());
+  deflate(&stream, Z_FINISH);
+  result.resize(stream.total_out);
+  deflateEnd(&stream);
+  return result;
+}
+
+/* Compresses data into a single xz stream. */
+std::string xz(const std::string& data)
+{
+  std::string result(lzma_stream_buffer_bound(data.size()), '\0');
+  std::size_t used = 0;
+  lzma_easy_buffer_encode(1, LZMA_CHECK_CRC64, nullptr, reinterpret_cast<const uint8_t*>(data.data()),
+                          data.size(), reinterpret_cast<uint8_t*>(&result[0]), &used, result.size());
+  result.resize(used);
+  return result;
+}
+
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/* Decompresses data with readAhead, either from memory or from a file. */
+bool decompress(const std::string& compressed, const format type, const std::string& fileName,
+                std::string& result)
+{
+  // small buffers, so that the ring wraps around several times
+  libstriezel::archive::readAhead reader(64 * 1024, 2);
+  const bool opened = fileName.empty() ? reader.open(compressed.data(), compressed.size(), type)
+                                       : reader.open(fileName, type);
+  if (!opened)
+    return false;
+  result.clear();
+  const void * data = nullptr;
+  int64_t bytes = 0;
+  while ((bytes = reader.next(data)) > 0)
+    result.append(static_cast<const char*>(data), static_cast<std::size_t>(bytes));
+  return bytes == 0;
+}
+
+/* Checks listing and extraction of a compressed tar archive. */
+bool checkArchive(libstriezel::tar::archive& tar, const std::map<std::string, std::string>& files,
+                  const std::string& tempDir)
+{
+  const auto entries = tar.entries();
+  if (entries.size() != files.size())
+  {
+    std::cout << "Error: Archive has " << entries.size() << " entries instead of "
+              << files.size() << "!" << std::endl;
+    return false;
+  }
+  for (const auto& e : entries)
+  {
+    const auto iter = files.find(e.name());
+    if ((iter == files.end()) || (e.size() != static_cast<int64_t>(iter->second.size())))
+    {
+      std::cout << "Error: Unexpected entry " << e.name() << "!" << std::endl;
+      return false;
+    }
+  }
+
+  // The last file needs a pass over the whole archive, the first one stops
+  // the decompressor early.
+  const std::string destFile = tempDir + libstriezel::filesystem::pathDelimiter + "extracted.dat";
+  for (const std::string& name : { files.rbegin()->first, files.begin()->first })
+  {
+    if (!tar.extractTo(destFile, name))
+    {
+      std::cout << "Error: Could not extract " << name << "!" << std::endl;
+      return false;
+    }
+    const std::string content = readFile(destFile);
+    libstriezel::filesystem::file::remove(destFile);
+    if (content != files.at(name))
+    {
+      std::cout << "Error: Content of extracted file " << name << " is wrong!" << std::endl;
+      return false;
+    }
+  }
+
+  std::map<std::string, std::string> destinations;
+  for (const auto& file : files)
+    destinations[file.first] = tempDir + libstriezel::filesystem::pathDelimiter + "many_" + file.first;
+  const auto result = tar.extractMany(destinations);
+  for (const auto& file : files)
+  {
+    const auto iter = result.find(file.first);
+    const std::string content = readFile(destinations[file.first]);
+    libstriezel::filesystem::file::remove(destinations[file.first]);
+    if ((iter == result.end()) || !iter->second || (content != file.second))
+    {
+      std::cout << "Error: extractMany() failed for " << file.first << "!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  const std::map<std::string, std::string> files = {
+    { "a.txt", "Hello, compressed tar!\n" },
+    { "b.bin", compressibleData(1500000, 1) },
+    { "c.bin", compressibleData(700001, 2) },
+    { "empty.txt", "" },
+    { "z.bin", compressibleData(2100000, 3) }
+  };
+  std::string tar;
+  if (!createTar(files, tar))
+  {
+    std::cout << "Error: Could not create the tar archive!" << std::endl;
+    return 1;
+  }
+
+  std::string tempDirName;
+  if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  tempDirName = libstriezel::filesystem::unslashify(tempDirName);
+
+  // Concatenated members and streams are one piece of data.
+  const std::size_t half = tar.size() / 2;
+  const std::vector<std::pair<std::string, format> > variants = {
+    { gzip(tar), format::gzip },
+    { gzip(tar.substr(0, half)) + gzip(tar.substr(half)), format::gzip },
+    { xz(tar), format::xz },
+    { xz(tar.substr(0, half)) + xz(tar.substr(half)), format::xz }
+  };
+  const std::string fileName = tempDirName + libstriezel::filesystem::pathDelimiter + "test.tar.compressed";
+  for (const auto& variant : variants)
+  {
+    std::cout << "Checking " << ((variant.second == format::gzip) ? "gzip" : "xz")
+              << " data of " << variant.first.size() << " bytes ..." << std::endl;
+    {
+      std::ofstream stream(fileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+      stream.write(variant.first.data(), static_cast<std::streamsize>(variant.first.size()));
+    }
+
+    bool success = true;
+    std::string decompressed;
+    for (const std::string& source : { std::string(), fileName })
+    {
+      if (!decompress(variant.first, variant.second, source, decompressed) || (decompressed != tar))
+      {
+        std::cout << "Error: readAhead did not decompress the data correctly!" << std::endl;
+        success = false;
+      }
+    }
+    // Truncated data is an error.
+    const std::string truncated = variant.first.substr(0, variant.first.size() - 100);
+    if (success && decompress(truncated, variant.second, std::string(), decompressed))
+    {
+      std::cout << "Error: readAhead did not detect truncated data!" << std::endl;
+      success = false;
+    }
+
+    try
+    {
+      libstriezel::tar::archive fromFile(fileName);
+      libstriezel::tar::archive fromMemory(variant.first.data(), variant.first.size());
+      success = success && checkArchive(fromFile, files, tempDirName)
+                && checkArchive(fromMemory, files, tempDirName);
+    }
+    catch (const std::exception& ex)
+    {
+      std::cout << "Error: An exception occurred while working with the archive: "
+                << ex.what() << std::endl;
+      success = false;
+    }
+    libstriezel::filesystem::file::remove(fileName);
+    if (!success)
+    {
+      libstriezel::filesystem::directory::remove(tempDirName);
+      return 1;
+    }
+  }
+  libstriezel::filesystem::directory::remove(tempDirName);
+
+  // readAhead removes one layer of compression, and libarchive must not
+  // remove another one, because that is not what the file contains.
+  const std::string twice = gzip(gzip(tar));
+  try
+  {
+    libstriezel::tar::archive nested(twice.data(), twice.size());
+    if (!nested.entries().empty())
+    {
+      std::cout << "Error: Data that was compressed twice was listed as tar archive!" << std::endl;
+      return 1;
+    }
+  }
+  catch (const std::exception&)
+  {
+    // That is fine, the data is no tar archive.
+  }
+
+  //Everything is OK.
+  std::cout << "Test for reading compressed tar archives with readAhead was successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_TESTS_TESTDATA_HPP
+#define LIBSTRIEZEL_TESTS_TESTDATA_HPP
+
+#include <cstdint>
+#include <string>
+
+// This header provides generated test data for tests that build their
+// archives in memory instead of downloading them.
+
+/* Creates data that deflate and LZMA can barely compress, e.g. to get
+   compressed blocks of a predictable size. Every seed gives other data.
+   Container is std::string or std::vector<uint8_t>. */
+template<typename Container = std::string>
+Container randomData(const std::size_t size, uint32_t seed)
+{
+  Container data(size, 0);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    data[i] = static_cast<typename Container::value_type>(seed >> 16);
+  }
+  return data;
+}
+
+/* Creates data that compresses well, but has no long repetitions: about
+   every fourth byte is a random letter, the other bytes change slowly with
+   the position. Every seed gives other data. Container is std::string or
+   std::vector<uint8_t>. */
+template<typename Container = std::string>
+Container compressibleData(const std::size_t size, uint32_t seed)
+{
+  Container data(size, 0);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    data[i] = ((seed >> 16) % 4 == 0) ? static_cast<typename Container::value_type>('a' + (seed >> 20) % 26)
+                                       : static_cast<typename Container::value_type>(i >> 10);
+  }
+  return data;
+}
+
+#endif // LIBSTRIEZEL_TESTS_TESTDATA_HPP
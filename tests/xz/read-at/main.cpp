@@ -0,0 +1,196 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <lzma.h>
+#include "../../../archive/xz/archive.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../testData.hpp"
+
+/* Compresses data as one xz stream and appends it to result. A new block
+   starts every blockSize bytes, like xz -T does it. */
+bool compressStream(const uint8_t* data, const std::size_t size, const std::size_t blockSize,
+                    std::vector<uint8_t>& result)
+{
+  lzma_stream strm = LZMA_STREAM_INIT;
+  if (lzma_easy_encoder(&strm, 1, LZMA_CHECK_CRC64) != LZMA_OK)
+    return false;
+  uint8_t buffer[65536];
+  std::size_t position = 0;
+  lzma_ret ret = LZMA_OK;
+  do
+  {
+    const std::size_t chunk = std::min(blockSize, size - position);
+    const lzma_action action = (position + chunk == size) ? LZMA_FINISH : LZMA_FULL_FLUSH;
+    strm.next_in = data + position;
+    strm.avail_in = chunk;
+    position += chunk;
+    do
+    {
+      strm.next_out = buffer;
+      strm.avail_out = sizeof(buffer);
+      ret = lzma_code(&strm, action);
+      result.insert(result.end(), buffer, buffer + (sizeof(buffer) - strm.avail_out));
+    } while (ret == LZMA_OK);
+  } while (ret == LZMA_STREAM_END && position < size);
+  lzma_end(&strm);
+  return ret == LZMA_STREAM_END;
+}
+
+/* Reads at several offsets and compares the data with the original. */
+bool checkReads(libstriezel::xz::archive& xz, const std::vector<uint8_t>& original,
+                const std::string& description)
+{
+  if (xz.uncompressedSize() != static_cast<int64_t>(original.size()))
+  {
+    std::cout << "Error: Index of " << description << " has size " << xz.uncompressedSize()
+              << " instead of " << original.size() << "!" << std::endl;
+    return false;
+  }
+  const int64_t size = static_cast<int64_t>(original.size());
+  const std::vector<int64_t> offsets = { 0, 1, 99999, 100000, 100001, 654321, size / 2, size - 1000, size - 1, size, size + 1 };
+  std::vector<uint8_t> buffer(250000);
+  for (const int64_t offset : offsets)
+  {
+    const int64_t bytesRead = xz.readAt(offset, buffer.data(), buffer.size());
+    const int64_t expected = std::min<int64_t>(std::max<int64_t>(size - offset, 0), buffer.size());
+    if ((bytesRead != expected)
+        || (std::memcmp(buffer.data(), original.data() + std::min(offset, size), static_cast<std::size_t>(expected)) != 0))
+    {
+      std::cout << "Error: readAt(" << offset << ") of " << description << " returned "
+                << bytesRead << " bytes or wrong data!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Extracts the data with different numbers of threads and compares it with
+   the original data. */
+bool checkExtraction(libstriezel::xz::archive& xz, const std::vector<uint8_t>& original,
+                     const bool shallSucceed, const std::string& description)
+{
+  std::string destName;
+  if (!libstriezel::filesystem::file::createTemp(destName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return false;
+  }
+  bool result = true;
+  for (const unsigned int threads : { 1u, 4u, 0u })
+  {
+    libstriezel::filesystem::file::remove(destName);
+    const bool success = xz.extractDataTo(destName, threads);
+    if (success != shallSucceed)
+    {
+      std::cout << "Error: Extraction of " << description << " with " << threads << " thread(s) "
+                << (success ? "succeeded" : "failed") << " unexpectedly!" << std::endl;
+      result = false;
+      break;
+    }
+    if (!success)
+      continue;
+    std::ifstream stream(destName, std::ios::in | std::ios::binary);
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if (data != original)
+    {
+      std::cout << "Error: Extracted data of " << description << " with " << threads
+                << " thread(s) does not match!" << std::endl;
+      result = false;
+      break;
+    }
+  }
+  libstriezel::filesystem::file::remove(destName);
+  return result;
+}
+
+int main()
+{
+  const std::vector<uint8_t> original = compressibleData<std::vector<uint8_t> >(3000000, 2026);
+  // two streams with stream padding in between, and blocks of 100000 bytes
+  const std::size_t split = 1234567;
+  std::vector<uint8_t> twoStreams;
+  if (!compressStream(original.data(), split, 100000, twoStreams))
+  {
+    std::cout << "Error: Could not compress test data!" << std::endl;
+    return 1;
+  }
+  twoStreams.insert(twoStreams.end(), 4, 0);
+  if (!compressStream(original.data() + split, original.size() - split, 100000, twoStreams))
+  {
+    std::cout << "Error: Could not compress test data!" << std::endl;
+    return 1;
+  }
+
+  {
+    libstriezel::xz::archive xz(twoStreams.data(), twoStreams.size());
+    if (!checkReads(xz, original, "data in memory") || !checkExtraction(xz, original, true, "data in memory"))
+      return 1;
+  }
+
+  // the same data in a file
+  std::string xzName;
+  if (!libstriezel::filesystem::file::createTemp(xzName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return 1;
+  }
+  {
+    std::ofstream stream(xzName, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(twoStreams.data()), twoStreams.size());
+  }
+  int result = 0;
+  {
+    libstriezel::xz::archive xz(xzName);
+    if (!checkReads(xz, original, "file") || !checkExtraction(xz, original, true, "file"))
+      result = 1;
+  }
+  libstriezel::filesystem::file::remove(xzName);
+  if (result != 0)
+    return result;
+
+  // a single block
+  std::vector<uint8_t> single;
+  if (!compressStream(original.data(), original.size(), original.size(), single))
+    return 1;
+  {
+    libstriezel::xz::archive xz(single.data(), single.size());
+    if (!checkReads(xz, original, "single block") || !checkExtraction(xz, original, true, "single block"))
+      return 1;
+  }
+
+  // Damaged blocks make the extraction fail.
+  std::vector<uint8_t> damaged(twoStreams);
+  damaged[damaged.size() / 3] ^= 0x55;
+  {
+    libstriezel::xz::archive xz(damaged.data(), damaged.size());
+    if (!checkExtraction(xz, original, false, "damaged data"))
+      return 1;
+  }
+
+  //Everything is OK.
+  std::cout << "Tests for libstriezel::xz::archive::readAt() were successful." << std::endl;
+  return 0;
+}
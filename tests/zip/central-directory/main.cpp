@@ -0,0 +1,397 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#if defined(_WIN32)
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+#include "../../../archive/copyRange.hpp"
+#include "../../../archive/entryTable.hpp"
+#include "../../../archive/zip/centralDirectory.hpp"
+#include "../../../filesystem/file.hpp"
+
+using libstriezel::zip::centralDirectory;
+
+/* data of an entry in a test archive */
+struct testEntry
+{
+  std::string name;
+  std::string data;
+  uint32_t crc;
+};
+
+const std::vector<testEntry> testEntries = {
+  { "readme.txt", "This is a test.\n", 0x12345678 },
+  { "dir/", "", 0 },
+  { "dir/empty.dat", "", 0 },
+  { "dir/numbers.txt", "0123456789", 0xA684C7C6 },
+  // Duplicate names are allowed in ZIP files, the first one shall be found.
+  { "readme.txt", "second", 0x0BADF00D }
+};
+
+/* MS-DOS time and date of 2020-05-17 12:34:56 */
+const uint16_t dosTime = (12 << 11) | (34 << 5) | (56 / 2);
+const uint16_t dosDate = ((2020 - 1980) << 9) | (5 << 5) | 17;
+
+void put16(std::string& out, const uint16_t value)
+{
+  out.push_back(static_cast<char>(value & 0xFF));
+  out.push_back(static_cast<char>(value >> 8));
+}
+
+void put32(std::string& out, const uint32_t value)
+{
+  put16(out, static_cast<uint16_t>(value & 0xFFFF));
+  put16(out, static_cast<uint16_t>(value >> 16));
+}
+
+void put64(std::string& out, const uint64_t value)
+{
+  put32(out, static_cast<uint32_t>(value & 0xFFFFFFFF));
+  put32(out, static_cast<uint32_t>(value >> 32));
+}
+
+/* Builds a ZIP archive with stored entries. If zip64 is true, then sizes,
+   offsets and counts are only present in the ZIP64 structures. */
+std::string buildZip(const bool zip64, const std::string& comment)
+{
+  std::string result;
+  std::vector<uint64_t> localOffsets;
+  for (const auto& item : testEntries)
+  {
+    localOffsets.push_back(result.size());
+    put32(result, 0x04034b50);
+    put16(result, 20);
+    put16(result, 0);
+    put16(result, 0);
+    put16(result, dosTime);
+    put16(result, dosDate);
+    put32(result, item.crc);
+    put32(result, static_cast<uint32_t>(item.data.size()));
+    put32(result, static_cast<uint32_t>(item.data.size()));
+    put16(result, static_cast<uint16_t>(item.name.size()));
+    put16(result, 0);
+    result += item.name;
+    result += item.data;
+  }
+
+  const uint64_t directoryOffset = result.size();
+  for (std::size_t i = 0; i < testEntries.size(); ++i)
+  {
+    const auto& item = testEntries[i];
+    put32(result, 0x02014b50);
+    put16(result, zip64 ? 45 : 20);
+    put16(result, zip64 ? 45 : 20);
+    put16(result, 0);
+    put16(result, 0);
+    put16(result, dosTime);
+    put16(result, dosDate);
+    put32(result, item.crc);
+    put32(result, zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(item.data.size()));
+    put32(result, zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(item.data.size()));
+    put16(result, static_cast<uint16_t>(item.name.size()));
+    put16(result, zip64 ? 28 : 0);
+    put16(result, 0);
+    put16(result, 0);
+    put16(result, 0);
+    put32(result, 0);
+    put32(result, zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(localOffsets[i]));
+    result += item.name;
+    if (zip64)
+    {
+      put16(result, 0x0001);
+      put16(result, 24);
+      put64(result, item.data.size());
+      put64(result, item.data.size());
+      put64(result, localOffsets[i]);
+    }
+  }
+  const uint64_t directorySize = result.size() - directoryOffset;
+
+  if (zip64)
+  {
+    const uint64_t end64Offset = result.size();
+    put32(result, 0x06064b50);
+    put64(result, 44);
+    put16(result, 45);
+    put16(result, 45);
+    put32(result, 0);
+    put32(result, 0);
+    put64(result, testEntries.size());
+    put64(result, testEntries.size());
+    put64(result, directorySize);
+    put64(result, directoryOffset);
+    // locator
+    put32(result, 0x07064b50);
+    put32(result, 0);
+    put64(result, end64Offset);
+    put32(result, 1);
+  }
+
+  put32(result, 0x06054b50);
+  put16(result, 0);
+  put16(result, 0);
+  put16(result, zip64 ? 0xFFFF : static_cast<uint16_t>(testEntries.size()));
+  put16(result, zip64 ? 0xFFFF : static_cast<uint16_t>(testEntries.size()));
+  put32(result, zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(directorySize));
+  put32(result, zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(directoryOffset));
+  put16(result, static_cast<uint16_t>(comment.size()));
+  result += comment;
+  return result;
+}
+
+/* Checks the content of a parsed central directory against testEntries. */
+bool check(const centralDirectory& cd, const std::string& description)
+{
+  if (cd.numEntries() != static_cast<int64_t>(testEntries.size()))
+  {
+    std::cout << "Error: " << description << " has " << cd.numEntries()
+              << " entries, but it should have " << testEntries.size() << "!" << std::endl;
+    return false;
+  }
+
+  std::tm expectedTm = std::tm();
+  expectedTm.tm_year = 2020 - 1900;
+  expectedTm.tm_mon = 4;
+  expectedTm.tm_mday = 17;
+  expectedTm.tm_hour = 12;
+  expectedTm.tm_min = 34;
+  expectedTm.tm_sec = 56;
+  expectedTm.tm_isdst = -1;
+  const std::time_t expectedTime = std::mktime(&expectedTm);
+
+  int64_t offset = 0;
+  for (std::size_t i = 0; i < testEntries.size(); ++i)
+  {
+    const auto& item = testEntries[i];
+    if ((cd.name(i) != item.name)
+        || (cd.size(i) != static_cast<int64_t>(item.data.size()))
+        || (cd.sizeCompressed(i) != static_cast<int64_t>(item.data.size()))
+        || (cd.crc(i) != item.crc) || (cd.method(i) != 0)
+        || (cd.localHeaderOffset(i) != offset)
+        || (cd.m_time(i) != expectedTime)
+        || (cd.isDirectory(i) != (item.name.back() == '/'))
+        || cd.isEncrypted(i)
+        || (cd.dataOffset(i) != offset + 30 + static_cast<int64_t>(item.name.size())))
+    {
+      std::cout << "Error: Entry " << i << " of " << description
+                << " has unexpected properties!" << std::endl;
+      return false;
+    }
+    offset += 30 + item.name.size() + item.data.size();
+  }
+
+  if ((cd.locate("readme.txt") != 0) || (cd.locate("dir/numbers.txt") != 3)
+      || (cd.locate("dir") != -1) || (cd.locate("missing.txt") != -1))
+  {
+    std::cout << "Error: locate() returned wrong indices for " << description << "!" << std::endl;
+    return false;
+  }
+
+  // visitor sees the same entries and can stop early
+  std::size_t visited = 0;
+  bool viewsMatch = true;
+  const bool complete = cd.forEachEntry([&](const libstriezel::archive::entryView& view)
+  {
+    viewsMatch = viewsMatch && (view.index == static_cast<int64_t>(visited))
+        && (view.name == cd.name(visited)) && (view.size == cd.size(visited))
+        && (view.m_time == expectedTime) && (view.directory == cd.isDirectory(visited));
+    ++visited;
+    return visited < 2;
+  });
+  if (complete || (visited != 2) || !viewsMatch)
+  {
+    std::cout << "Error: forEachEntry() did not work as expected for " << description << "!" << std::endl;
+    return false;
+  }
+
+  libstriezel::archive::entryTable table;
+  cd.fillEntryTable(table);
+  if (table.size() != testEntries.size())
+  {
+    std::cout << "Error: Entry table of " << description << " has wrong size!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < table.size(); ++i)
+  {
+    if ((table.name(i) != cd.name(i)) || (table.entrySize(i) != cd.size(i))
+        || (table.compressedSize(i) != cd.sizeCompressed(i)) || (table.crc(i) != cd.crc(i))
+        || (table.isDirectory(i) != cd.isDirectory(i)) || (table.m_time(i) != expectedTime))
+    {
+      std::cout << "Error: Row " << i << " of entry table of " << description
+                << " does not match the central directory!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Copies the data of all entries one after another into a new file with
+   copyRange() and checks the result. */
+bool checkCopy(const std::string& archiveName, const centralDirectory& cd)
+{
+  std::string destName;
+  if (!libstriezel::filesystem::file::createTemp(destName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return false;
+  }
+  #if defined(_WIN32)
+  const int source = _open(archiveName.c_str(), _O_RDONLY | _O_BINARY);
+  const int destination = _open(destName.c_str(), _O_WRONLY | _O_TRUNC | _O_BINARY);
+  #else
+  const int source = open(archiveName.c_str(), O_RDONLY);
+  const int destination = open(destName.c_str(), O_WRONLY | O_TRUNC);
+  #endif
+  bool success = (source >= 0) && (destination >= 0);
+  std::string expected;
+  for (std::size_t i = 0; success && (i < testEntries.size()); ++i)
+  {
+    success = libstriezel::archive::copyRange(source, cd.dataOffset(i), destination,
+                                              static_cast<int64_t>(expected.size()), cd.size(i));
+    expected += testEntries[i].data;
+  }
+  // The archive does not have that many bytes.
+  const bool beyondEnd = libstriezel::archive::copyRange(source, 10, destination,
+                                                         static_cast<int64_t>(expected.size()), 1000000);
+  #if defined(_WIN32)
+  _close(source);
+  _close(destination);
+  #else
+  close(source);
+  close(destination);
+  #endif
+  std::string content;
+  success = success && libstriezel::filesystem::file::readIntoString(destName, content);
+  libstriezel::filesystem::file::remove(destName);
+  if (!success || beyondEnd || (content.substr(0, expected.size()) != expected))
+  {
+    std::cout << "Error: copyRange() did not copy the entries of " << archiveName
+              << " correctly!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/* Returns true, if parsing the data throws an exception. */
+bool throws(const std::string& data)
+{
+  try
+  {
+    centralDirectory cd(data.data(), data.size());
+  }
+  catch (const std::exception&)
+  {
+    return true;
+  }
+  return false;
+}
+
+int main()
+{
+  const std::string plain = buildZip(false, "");
+  const std::string commented = buildZip(false, "PK\x05\x06" + std::string(1000, 'c'));
+  const std::string zip64 = buildZip(true, "ZIP64");
+
+  try
+  {
+    centralDirectory cdPlain(plain.data(), plain.size());
+    if (!check(cdPlain, "plain archive"))
+      return 1;
+    centralDirectory cdCommented(commented.data(), commented.size());
+    if (!check(cdCommented, "archive with comment"))
+      return 1;
+    centralDirectory cdZip64(zip64.data(), zip64.size());
+    if (!check(cdZip64, "ZIP64 archive"))
+      return 1;
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Error: Parsing a valid archive failed! " << ex.what() << std::endl;
+    return 1;
+  }
+
+  // parsing from a mapped file
+  std::string tempName;
+  if (!libstriezel::filesystem::file::createTemp(tempName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return 1;
+  }
+  {
+    std::ofstream stream(tempName, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream.write(zip64.data(), zip64.size());
+    stream.close();
+    if (!stream.good())
+    {
+      std::cout << "Error: Could not write temporary file " << tempName << "!" << std::endl;
+      libstriezel::filesystem::file::remove(tempName);
+      return 1;
+    }
+  }
+  try
+  {
+    centralDirectory cdFile(tempName);
+    if (!check(cdFile, "mapped file") || !checkCopy(tempName, cdFile))
+    {
+      libstriezel::filesystem::file::remove(tempName);
+      return 1;
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Error: Parsing the file " << tempName << " failed! " << ex.what() << std::endl;
+    libstriezel::filesystem::file::remove(tempName);
+    return 1;
+  }
+  libstriezel::filesystem::file::remove(tempName);
+
+  // invalid archives
+  if (!throws("") || !throws(std::string(100, '\0'))
+      || !throws(plain.substr(0, plain.size() - 1))
+      || !throws(plain.substr(plain.size() - 22))
+      || !throws(zip64.substr(zip64.size() - 70)))
+  {
+    std::cout << "Error: Invalid archive data was accepted!" << std::endl;
+    return 1;
+  }
+  try
+  {
+    centralDirectory cdMissing("does/not/exist.zip");
+    std::cout << "Error: A file that does not exist was opened!" << std::endl;
+    return 1;
+  }
+  catch (const std::exception&)
+  {
+    // expected
+  }
+
+  //Everything is OK.
+  std::cout << "Tests for libstriezel::zip::centralDirectory were successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,279 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../../hash/sha256/sha256.hpp"
+#include "../../../hash/sha256/FileSourceUtility.hpp"
+#include "../../../archive/zip/archive.hpp"
+
+/* Removes everything that was extracted from the archive. */
+void cleanUp(const std::vector<libstriezel::zip::entry>& entries, const std::string& tempDirName)
+{
+  const std::string prefix = libstriezel::filesystem::slashify(tempDirName);
+  // reverse order, so directories are empty before they get removed
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+  {
+    if (it->isDirectory())
+      libstriezel::filesystem::directory::remove(prefix + it->name());
+    else
+      libstriezel::filesystem::file::remove(prefix + it->name());
+  }
+  libstriezel::filesystem::directory::remove(tempDirName);
+}
+
+void put16(std::string& out, const uint16_t value)
+{
+  out.push_back(static_cast<char>(value & 0xFF));
+  out.push_back(static_cast<char>(value >> 8));
+}
+
+void put32(std::string& out, const uint32_t value)
+{
+  put16(out, static_cast<uint16_t>(value & 0xFFFF));
+  put16(out, static_cast<uint16_t>(value >> 16));
+}
+
+/* Builds a ZIP archive with stored entries from pairs of name and data. */
+std::string buildZip(const std::vector<std::pair<std::string, std::string> >& entries)
+{
+  std::string result;
+  std::string directory;
+  for (const auto& item : entries)
+  {
+    const uint32_t crc = static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0),
+        reinterpret_cast<const Bytef*>(item.second.data()), static_cast<uInt>(item.second.size())));
+    const uint32_t localOffset = static_cast<uint32_t>(result.size());
+    // local header and central directory header share most fields
+    std::string fields;
+    put16(fields, 0);
+    put16(fields, 0);
+    put16(fields, 0);
+    put16(fields, 0x21);
+    put32(fields, crc);
+    put32(fields, static_cast<uint32_t>(item.second.size()));
+    put32(fields, static_cast<uint32_t>(item.second.size()));
+    put16(fields, static_cast<uint16_t>(item.first.size()));
+    put16(fields, 0);
+
+    put32(result, 0x04034b50);
+    put16(result, 20);
+    result += fields + item.first + item.second;
+
+    put32(directory, 0x02014b50);
+    put16(directory, 20);
+    put16(directory, 20);
+    directory += fields;
+    put16(directory, 0);
+    put16(directory, 0);
+    put16(directory, 0);
+    put32(directory, 0);
+    put32(directory, localOffset);
+    directory += item.first;
+  }
+  const uint32_t directoryOffset = static_cast<uint32_t>(result.size());
+  result += directory;
+  put32(result, 0x06054b50);
+  put16(result, 0);
+  put16(result, 0);
+  put16(result, static_cast<uint16_t>(entries.size()));
+  put16(result, static_cast<uint16_t>(entries.size()));
+  put32(result, static_cast<uint32_t>(directory.size()));
+  put32(result, directoryOffset);
+  put16(result, 0);
+  return result;
+}
+
+/* Checks that extractAll() skips entries whose paths leave the destination
+   directory, no matter which separator they use. */
+bool checkUnsafePaths()
+{
+  const std::string zipData = buildZip({
+      { "good.txt", "good" },
+      { "../evil.txt", "evil" },
+      { "..\\evil.txt", "evil" },
+      { "sub\\..\\..\\evil.txt", "evil" },
+      { "C:evil.txt", "evil" },
+      { "\\evil.txt", "evil" }
+  });
+  std::string zipName;
+  std::string tempDirName;
+  if (!libstriezel::filesystem::file::createTemp(zipName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return false;
+  }
+  {
+    std::ofstream stream(zipName, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream.write(zipData.data(), zipData.size());
+  }
+  if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+  {
+    std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+    libstriezel::filesystem::file::remove(zipName);
+    return false;
+  }
+  const std::string prefix = libstriezel::filesystem::slashify(tempDirName);
+  bool success = true;
+  try
+  {
+    libstriezel::zip::archive zipFile(zipName);
+    if (zipFile.extractAll(tempDirName, 2))
+    {
+      std::cout << "Error: extractAll() did not report the entries with unsafe paths!" << std::endl;
+      success = false;
+    }
+    if (libstriezel::filesystem::file::getSize64(prefix + "good.txt") != 4)
+    {
+      std::cout << "Error: Entry with a safe path was not extracted!" << std::endl;
+      success = false;
+    }
+  }
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the ZIP file: "
+              << ex.what() << std::endl;
+    success = false;
+  }
+  libstriezel::filesystem::file::remove(prefix + "good.txt");
+  // Anything else in the directory was extracted although it should not.
+  if (!libstriezel::filesystem::directory::remove(tempDirName))
+  {
+    std::cout << "Error: An entry with an unsafe path was extracted!" << std::endl;
+    success = false;
+  }
+  libstriezel::filesystem::file::remove(zipName);
+  return success;
+}
+
+/* Expected parameters: 1 - directory that contains the zip files */
+
+int main(int argc, char** argv)
+{
+  std::string zipDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    zipDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(zipDirectory))
+    {
+      std::cout << "Error: Directory " << zipDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (ZIP directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string zipFileName = zipDirectory + libstriezel::filesystem::pathDelimiter + "zlib.zip";
+
+  try
+  {
+    libstriezel::zip::archive zipFile(zipFileName);
+    const auto entries = zipFile.entries();
+
+    std::string tempDirName;
+    if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+    {
+      std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+      return 1;
+    }
+    const std::string prefix = libstriezel::filesystem::slashify(tempDirName);
+
+    //extract everything with four threads
+    if (!zipFile.extractAll(tempDirName, 4))
+    {
+      std::cout << "Error: Could not extract all files from ZIP!" << std::endl;
+      cleanUp(entries, tempDirName);
+      return 1;
+    }
+
+    //every entry has to be there with the proper size
+    for (const auto& e : entries)
+    {
+      const std::string destName = prefix + e.name();
+      if (e.isDirectory())
+      {
+        if (!libstriezel::filesystem::directory::exists(destName))
+        {
+          std::cout << "Error: Directory " << e.name() << " was not created!" << std::endl;
+          cleanUp(entries, tempDirName);
+          return 1;
+        }
+      }
+      else if (libstriezel::filesystem::file::getSize64(destName) != e.size())
+      {
+        std::cout << "Error: File size of extracted file " << e.name()
+                  << " does not match its size specified in the archive!" << std::endl;
+        cleanUp(entries, tempDirName);
+        return 1;
+      }
+    } //for
+
+    //get SHA256 hash of one file - easier than checking content byte by byte
+    const std::string mdExpected = "ff988cbc9cbb5692400b37df2b80eb25afa6d6bf0d840a6dff5673ee7c190718";
+    const SHA256::MessageDigest md = SHA256::computeFromFile(prefix + "zlib-1.2.8/CMakeLists.txt");
+    if (mdExpected != md.toHexString())
+    {
+      std::cout << "Error: Hash of extracted file is wrong!" << std::endl
+                << "Hash is:  " << md.toHexString() << std::endl
+                << "Expected: " << mdExpected << std::endl;
+      cleanUp(entries, tempDirName);
+      return 1;
+    }
+
+    //extractMany() with several threads reports every file
+    const std::map<std::string, std::string> files = {
+      { "zlib-1.2.8/CMakeLists.txt", prefix + "one.txt" },
+      { "zlib-1.2.8/README", prefix + "two.txt" },
+      { "zlib-1.2.8/does-not-exist", prefix + "three.txt" }
+    };
+    const auto result = zipFile.extractMany(files, 2);
+    libstriezel::filesystem::file::remove(prefix + "one.txt");
+    libstriezel::filesystem::file::remove(prefix + "two.txt");
+    cleanUp(entries, tempDirName);
+    if ((result.size() != 3) || !result.at("zlib-1.2.8/CMakeLists.txt")
+        || !result.at("zlib-1.2.8/README") || result.at("zlib-1.2.8/does-not-exist"))
+    {
+      std::cout << "Error: Result of extractMany() is not as expected!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the ZIP file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  if (!checkUnsafePaths())
+    return 1;
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::zip::archive::extractAll() was successful." << std::endl;
+  return 0;
+}
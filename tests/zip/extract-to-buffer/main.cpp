@@ -0,0 +1,181 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <zlib.h>
+#include "../../../archive/zip/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+
+/* Computes the CRC-32 of some data. */
+uint32_t crc(const std::vector<uint8_t>& data)
+{
+  return static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0), data.data(), static_cast<uInt>(data.size())));
+}
+
+std::vector<uint8_t> readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/* Expected parameters: 1 - directory that contains the zip file */
+
+int main(int argc, char** argv)
+{
+  std::string zipDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    zipDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(zipDirectory))
+    {
+      std::cout << "Error: Directory " << zipDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (ZIP directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string zipFileName = zipDirectory + libstriezel::filesystem::pathDelimiter + "zlib.zip";
+
+  try
+  {
+    libstriezel::zip::archive zipFile(zipFileName);
+    libstriezel::archive::entryTable table;
+    if (!zipFile.fillEntryTable(table))
+    {
+      std::cout << "Error: Could not get the CRC-32 values of the entries!" << std::endl;
+      return 1;
+    }
+
+    std::string tempDirName;
+    if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+    {
+      std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+      return 1;
+    }
+    const std::string destFile = libstriezel::filesystem::slashify(tempDirName) + "extracted.dat";
+
+    int64_t largest = -1;
+    std::size_t largestChunks = 0;
+    for (const auto& e : zipFile.entries())
+    {
+      if (e.isDirectory())
+        continue;
+      // extractTo() gives the reference data
+      if (!zipFile.extractTo(destFile, e.index()))
+      {
+        std::cout << "Error: Could not extract file " << e.name() << " from ZIP!" << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      const std::vector<uint8_t> reference = readFile(destFile);
+      libstriezel::filesystem::file::remove(destFile);
+      if (crc(reference) != table.crc(static_cast<std::size_t>(e.index())))
+      {
+        std::cout << "Error: CRC-32 of extracted file " << e.name() << " is wrong!" << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+
+      // extraction into a growable buffer
+      std::vector<uint8_t> data;
+      if (!zipFile.extractToBuffer(e.index(), data) || (data != reference) || (crc(data) != crc(reference)))
+      {
+        std::cout << "Error: Data of " << e.name() << " in buffer does not match!" << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+
+      // extraction into a sink
+      std::vector<uint8_t> sinkData;
+      std::size_t chunks = 0;
+      const bool sinkSuccess = zipFile.extractToSink(e.index(),
+          [&sinkData, &chunks](const void* chunk, const std::size_t size)
+          {
+            const uint8_t * bytes = static_cast<const uint8_t*>(chunk);
+            sinkData.insert(sinkData.end(), bytes, bytes + size);
+            ++chunks;
+            return true;
+          });
+      if (!sinkSuccess || (sinkData != reference) || (crc(sinkData) != crc(reference)))
+      {
+        std::cout << "Error: Data of " << e.name() << " passed to the sink does not match!" << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+
+      // extraction into a preallocated buffer
+      std::vector<uint8_t> fixed(reference.size() + 10, 0);
+      std::size_t size = 0;
+      if (!zipFile.extractToBuffer(e.index(), fixed.data(), fixed.size(), size)
+          || (size != reference.size()) || !std::equal(reference.begin(), reference.end(), fixed.begin()))
+      {
+        std::cout << "Error: Extraction of " << e.name() << " into preallocated buffer failed!" << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      if (!reference.empty() && zipFile.extractToBuffer(e.index(), fixed.data(), reference.size() - 1, size))
+      {
+        std::cout << "Error: Extraction of " << e.name() << " into a buffer that is too small succeeded!" << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+
+      if (chunks > largestChunks)
+      {
+        largest = e.index();
+        largestChunks = chunks;
+      }
+    } //for
+    libstriezel::filesystem::directory::remove(tempDirName);
+
+    // A sink that stops after the first chunk aborts the extraction part-way.
+    if (largestChunks < 2)
+    {
+      std::cout << "Error: No entry is passed to the sink in several chunks!" << std::endl;
+      return 1;
+    }
+    std::size_t calls = 0;
+    if (zipFile.extractToSink(largest, [&calls](const void*, const std::size_t) { return ++calls < 2; })
+        || (calls != 2))
+    {
+      std::cout << "Error: Aborted extraction was not stopped or reported as success!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the ZIP file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::zip::archive::extractToBuffer() and extractToSink() was successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include "../../../archive/hashEntries.hpp"
+#include "../../../archive/zip/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../../hash/sha1/FileSourceUtility.hpp"
+#include "../../../hash/sha256/FileSourceUtility.hpp"
+
+/* Expected parameters: 1 - directory that contains the zip file */
+
+int main(int argc, char** argv)
+{
+  std::string zipDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    zipDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(zipDirectory))
+    {
+      std::cout << "Error: Directory " << zipDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (ZIP directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string zipFileName = zipDirectory + libstriezel::filesystem::pathDelimiter + "zlib.zip";
+
+  try
+  {
+    libstriezel::zip::archive zipFile(zipFileName);
+
+    std::vector<std::pair<libstriezel::zip::entry, libstriezel::hash::Digests> > hashes;
+    if (!libstriezel::archive::hashEntries(zipFile, libstriezel::hash::sha1 | libstriezel::hash::sha256, hashes))
+    {
+      std::cout << "Error: Could not compute hashes of entries!" << std::endl;
+      return 1;
+    }
+
+    //every file has to be there, but no directory
+    std::size_t fileCount = 0;
+    for (const auto& e : zipFile.entries())
+    {
+      if (!e.isDirectory())
+        ++fileCount;
+    }
+    if (hashes.size() != fileCount)
+    {
+      std::cout << "Error: Expected " << fileCount << " hashed entries, but got "
+                << hashes.size() << "!" << std::endl;
+      return 1;
+    }
+
+    //compare with hashes of extracted files
+    std::string tempDirName;
+    if (!libstriezel::filesystem::directory::createTemp(tempDirName))
+    {
+      std::cout << "Error: Could not create temporary directory for extraction!" << std::endl;
+      return 1;
+    }
+    bool foundCMakeLists = false;
+    for (const auto& item : hashes)
+    {
+      const auto& e = item.first;
+      const std::string destFile = libstriezel::filesystem::slashify(tempDirName) + "extracted.dat";
+      if (!zipFile.extractTo(destFile, e.index()))
+      {
+        std::cout << "Error: Could not extract file " << e.name()
+                  << " from ZIP!" << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      const SHA1::MessageDigest sha1 = SHA1::computeFromFile(destFile);
+      const SHA256::MessageDigest sha256 = SHA256::computeFromFile(destFile);
+      libstriezel::filesystem::file::remove(destFile);
+      if ((sha1 != item.second.sha1) || (sha256 != item.second.sha256))
+      {
+        std::cout << "Error: Hash of entry " << e.name() << " does not match the hash"
+                  << " of the extracted file!" << std::endl
+                  << "SHA-256 is: " << item.second.sha256.toHexString() << std::endl
+                  << "Expected:   " << sha256.toHexString() << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      //algorithms that were not requested stay null
+      if (!item.second.sha512.isNull())
+      {
+        std::cout << "Error: SHA-512 hash of entry " << e.name() << " is not null!"
+                  << std::endl;
+        libstriezel::filesystem::directory::remove(tempDirName);
+        return 1;
+      }
+      if (e.name() == "zlib-1.2.8/CMakeLists.txt")
+      {
+        foundCMakeLists = true;
+        const std::string mdExpected = "ff988cbc9cbb5692400b37df2b80eb25afa6d6bf0d840a6dff5673ee7c190718";
+        if (item.second.sha256.toHexString() != mdExpected)
+        {
+          std::cout << "Error: Hash of zlib-1.2.8/CMakeLists.txt is wrong!" << std::endl
+                    << "Hash is:  " << item.second.sha256.toHexString() << std::endl
+                    << "Expected: " << mdExpected << std::endl;
+          libstriezel::filesystem::directory::remove(tempDirName);
+          return 1;
+        }
+      }
+    } //for
+    libstriezel::filesystem::directory::remove(tempDirName);
+    if (!foundCMakeLists)
+    {
+      std::cout << "Error: Entry zlib-1.2.8/CMakeLists.txt was not hashed!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the ZIP file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for libstriezel::archive::hashEntries() with ZIP archives was successful." << std::endl;
+  return 0;
+}
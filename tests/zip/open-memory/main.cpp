@@ -0,0 +1,209 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <zlib.h>
+#include "../../../archive/zip/archive.hpp"
+#include "../../../filesystem/directory.hpp"
+
+/// stream that hands out the data of a memory buffer in small pieces
+class chunkedStream: public libstriezel::archive::seekableStream
+{
+  public:
+    chunkedStream(const std::vector<uint8_t>& data)
+    : m_data(data),
+      m_position(0),
+      m_seeks(0)
+    {
+    }
+
+    int64_t read(void* buffer, const std::size_t size) override
+    {
+      // small pieces make sure that reads across chunk borders are tested
+      const std::size_t count = std::min<std::size_t>(std::min<std::size_t>(size, 1000), m_data.size() - m_position);
+      std::copy(m_data.begin() + m_position, m_data.begin() + m_position + count, static_cast<uint8_t*>(buffer));
+      m_position += count;
+      return static_cast<int64_t>(count);
+    }
+
+    int64_t seek(const int64_t offset, const int whence) override
+    {
+      int64_t target = offset;
+      if (whence == SEEK_CUR)
+        target += static_cast<int64_t>(m_position);
+      else if (whence == SEEK_END)
+        target += static_cast<int64_t>(m_data.size());
+      if ((target < 0) || (target > static_cast<int64_t>(m_data.size())))
+        return -1;
+      m_position = static_cast<std::size_t>(target);
+      ++m_seeks;
+      return target;
+    }
+
+    std::size_t seeks() const
+    {
+      return m_seeks;
+    }
+  private:
+    const std::vector<uint8_t>& m_data;
+    std::size_t m_position;
+    std::size_t m_seeks; /**< number of successful seek operations */
+};
+
+/* Computes the CRC-32 of some data. */
+uint32_t crc(const std::vector<uint8_t>& data)
+{
+  return static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0), data.data(), static_cast<uInt>(data.size())));
+}
+
+/* Checks that an archive has the same entries as the one opened from file and
+   that the extracted data of the given entries is the same. */
+bool checkArchive(const libstriezel::zip::archive& zipFile, const libstriezel::zip::archive& reference,
+                  const std::vector<int64_t>& indices, const std::string& kind)
+{
+  const auto entries = zipFile.entries();
+  const auto expected = reference.entries();
+  if (entries.size() != expected.size())
+  {
+    std::cout << "Error: Archive opened from " << kind << " has " << entries.size()
+              << " entries, but the file has " << expected.size() << "!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if (!(entries[i] == expected[i]))
+    {
+      std::cout << "Error: Entry " << i << " of archive opened from " << kind
+                << " does not match the entry of the file!" << std::endl;
+      return false;
+    }
+  }
+
+  for (const int64_t index : indices)
+  {
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> expectedData;
+    if (!zipFile.extractToBuffer(index, data) || !reference.extractToBuffer(index, expectedData))
+    {
+      std::cout << "Error: Could not extract entry " << index << " from archive opened from "
+                << kind << "!" << std::endl;
+      return false;
+    }
+    if ((data != expectedData) || (crc(data) != expected[static_cast<std::size_t>(index)].crc()))
+    {
+      std::cout << "Error: Data of entry " << index << " extracted from archive opened from "
+                << kind << " is wrong!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Expected parameters: 1 - directory that contains the zip file */
+
+int main(int argc, char** argv)
+{
+  std::string zipDirectory = "";
+  if (argc>1 && argv[1] != nullptr)
+  {
+    zipDirectory = libstriezel::filesystem::unslashify(std::string(argv[1]));
+    if (!libstriezel::filesystem::directory::exists(zipDirectory))
+    {
+      std::cout << "Error: Directory " << zipDirectory << " does not exist!" << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << "Error: First argument (ZIP directory) is missing!" << std::endl;
+    return 1;
+  }
+
+  const std::string zipFileName = zipDirectory + libstriezel::filesystem::pathDelimiter + "zlib.zip";
+
+  std::ifstream stream(zipFileName, std::ios_base::in | std::ios_base::binary);
+  const std::vector<uint8_t> content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  stream.close();
+  if (content.empty())
+  {
+    std::cout << "Error: Could not read " << zipFileName << "!" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    const libstriezel::zip::archive zipFile(zipFileName);
+    std::vector<int64_t> files;
+    for (const auto& e : zipFile.entries())
+    {
+      if (!e.isDirectory())
+        files.push_back(e.index());
+    }
+    if (files.size() < 3)
+    {
+      std::cout << "Error: ZIP file has too few files for the test!" << std::endl;
+      return 1;
+    }
+
+    const libstriezel::zip::archive memoryZip(content.data(), content.size());
+    if (!checkArchive(memoryZip, zipFile, files, "memory"))
+      return 1;
+
+    chunkedStream chunks(content);
+    const libstriezel::zip::archive streamZip(chunks);
+    if (!checkArchive(streamZip, zipFile, files, "stream"))
+      return 1;
+
+    // Extraction in reverse order, with repeated and alternating entries, has
+    // to seek back and forth in the stream all the time.
+    std::vector<int64_t> jumps(files.rbegin(), files.rend());
+    const int64_t last = files.back();
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+      jumps.push_back(files.front());
+      jumps.push_back(last);
+      jumps.push_back(files[files.size() / 2]);
+      jumps.push_back(files[files.size() / 2]);
+    }
+    const std::size_t seeksBefore = chunks.seeks();
+    if (!checkArchive(streamZip, zipFile, jumps, "stream with many seek operations"))
+      return 1;
+    if (chunks.seeks() - seeksBefore < jumps.size())
+    {
+      std::cout << "Error: Extraction of " << jumps.size() << " entries from the stream "
+                << "did only " << chunks.seeks() - seeksBefore << " seek operations!" << std::endl;
+      return 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the ZIP file: "
+              << ex.what() << std::endl;
+    return 1;
+  } //try-catch
+
+  //Everything is OK.
+  std::cout << "Test for opening ZIP archives from memory and streams was successful." << std::endl;
+  return 0;
+}
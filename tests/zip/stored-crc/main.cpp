@@ -0,0 +1,213 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "../../../archive/zip/archive.hpp"
+#include "../../../filesystem/file.hpp"
+#include "../../testData.hpp"
+
+/* data of an entry in a test archive */
+struct testEntry
+{
+  std::string name;
+  std::string data;
+};
+
+void put16(std::string& out, const uint16_t value)
+{
+  out.push_back(static_cast<char>(value & 0xFF));
+  out.push_back(static_cast<char>(value >> 8));
+}
+
+void put32(std::string& out, const uint32_t value)
+{
+  put16(out, static_cast<uint16_t>(value & 0xFFFF));
+  put16(out, static_cast<uint16_t>(value >> 16));
+}
+
+/* Computes the CRC-32 of some data. */
+uint32_t crc(const std::string& data)
+{
+  return static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data.data()),
+                                     static_cast<uInt>(data.size())));
+}
+
+/* Builds a ZIP archive with stored entries. dataOffsets receives the offset
+   of the data of each entry. */
+std::string buildZip(const std::vector<testEntry>& entries, std::vector<std::size_t>& dataOffsets)
+{
+  std::string result;
+  std::vector<uint32_t> localOffsets;
+  dataOffsets.clear();
+  for (const auto& item : entries)
+  {
+    localOffsets.push_back(static_cast<uint32_t>(result.size()));
+    put32(result, 0x04034b50);
+    put16(result, 20);
+    put16(result, 0);
+    put16(result, 0);
+    put16(result, 0);
+    put16(result, 0x21);
+    put32(result, crc(item.data));
+    put32(result, static_cast<uint32_t>(item.data.size()));
+    put32(result, static_cast<uint32_t>(item.data.size()));
+    put16(result, static_cast<uint16_t>(item.name.size()));
+    put16(result, 0);
+    result += item.name;
+    dataOffsets.push_back(result.size());
+    result += item.data;
+  }
+
+  const uint32_t directoryOffset = static_cast<uint32_t>(result.size());
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    const auto& item = entries[i];
+    put32(result, 0x02014b50);
+    put16(result, 20);
+    put16(result, 20);
+    put16(result, 0);
+    put16(result, 0);
+    put16(result, 0);
+    put16(result, 0x21);
+    put32(result, crc(item.data));
+    put32(result, static_cast<uint32_t>(item.data.size()));
+    put32(result, static_cast<uint32_t>(item.data.size()));
+    put16(result, static_cast<uint16_t>(item.name.size()));
+    put16(result, 0);
+    put16(result, 0);
+    put16(result, 0);
+    put16(result, 0);
+    put32(result, 0);
+    put32(result, localOffsets[i]);
+    result += item.name;
+  }
+  const uint32_t directorySize = static_cast<uint32_t>(result.size()) - directoryOffset;
+
+  put32(result, 0x06054b50);
+  put16(result, 0);
+  put16(result, 0);
+  put16(result, static_cast<uint16_t>(entries.size()));
+  put16(result, static_cast<uint16_t>(entries.size()));
+  put32(result, directorySize);
+  put32(result, directoryOffset);
+  put16(result, 0);
+  return result;
+}
+
+/* Writes data to a file. Returns true in case of success. */
+bool writeFile(const std::string& fileName, const std::string& data)
+{
+  std::ofstream stream(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+  stream.close();
+  return stream.good();
+}
+
+/* Reads the whole content of a file. */
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios::in | std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+}
+
+/* Extracts every entry of a ZIP file and checks whether that succeeds for
+   exactly the entries that are not damaged. */
+bool checkExtraction(const std::string& zipName, const std::vector<testEntry>& entries,
+                     const std::vector<bool>& damaged, const std::string& description)
+{
+  const libstriezel::zip::archive zipFile(zipName, true);
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    const std::string destination = zipName + ".out";
+    const bool success = zipFile.extractTo(destination, static_cast<int64_t>(i));
+    const bool exists = libstriezel::filesystem::file::exists(destination);
+    const std::string data = exists ? readFile(destination) : std::string();
+    libstriezel::filesystem::file::remove(destination);
+    if (damaged[i])
+    {
+      if (success || exists)
+      {
+        std::cout << "Error: Damaged entry " << entries[i].name << " of " << description
+                  << " was extracted!" << std::endl;
+        return false;
+      }
+    }
+    else if (!success || (data != entries[i].data))
+    {
+      std::cout << "Error: Entry " << entries[i].name << " of " << description
+                << " was not extracted correctly!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  // The large entry spans several chunks of the CRC-32 check.
+  const std::vector<testEntry> entries = {
+    { "small.txt", "This is stored without compression.\n" },
+    { "empty.dat", "" },
+    { "large.dat", randomData(3 * 1024 * 1024 + 123, 40) }
+  };
+  std::vector<std::size_t> dataOffsets;
+  std::string zipData = buildZip(entries, dataOffsets);
+
+  std::string zipName;
+  if (!libstriezel::filesystem::file::createTemp(zipName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return 1;
+  }
+  int result = 0;
+  try
+  {
+    if (!writeFile(zipName, zipData)
+        || !checkExtraction(zipName, entries, { false, false, false }, "intact archive"))
+      result = 1;
+
+    // Stored data that does not match its CRC-32 must not be extracted.
+    if (result == 0)
+    {
+      zipData[dataOffsets[0] + 5] ^= 0x20;
+      zipData[dataOffsets[2] + 2 * 1024 * 1024] ^= 0x01;
+      if (!writeFile(zipName, zipData)
+          || !checkExtraction(zipName, entries, { true, false, true }, "damaged archive"))
+        result = 1;
+    }
+  } //try
+  catch (std::exception& ex)
+  {
+    std::cout << "Error: An exception occurred while working with the ZIP file: "
+              << ex.what() << std::endl;
+    result = 1;
+  } //try-catch
+  libstriezel::filesystem::file::remove(zipName);
+  if (result != 0)
+    return result;
+
+  //Everything is OK.
+  std::cout << "Test for the CRC-32 check of stored ZIP entries was successful." << std::endl;
+  return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the test suite for striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "../../../filesystem/file.hpp"
+#include "../../../zlib/CompressionFunctions.hpp"
+#include "../../../zlib/ParallelCompression.hpp"
+#include "../../testData.hpp"
+
+using libstriezel::zlib::Container;
+
+/* Decompresses a zlib or gzip stream with zlib itself. Returns false, if the
+   stream is invalid or has data after its end. */
+bool inflateAll(const std::vector<uint8_t>& compressed, const Container container, std::vector<uint8_t>& result)
+{
+  result.clear();
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  strm.next_in = Z_NULL;
+  strm.avail_in = 0;
+  if (inflateInit2(&strm, (container == Container::gzip) ? 16 + MAX_WBITS : MAX_WBITS) != Z_OK)
+    return false;
+  strm.next_in = const_cast<Bytef*>(compressed.data());
+  strm.avail_in = static_cast<uInt>(compressed.size());
+  uint8_t buffer[65536];
+  int ret = Z_OK;
+  do
+  {
+    strm.next_out = buffer;
+    strm.avail_out = sizeof(buffer);
+    ret = inflate(&strm, Z_NO_FLUSH);
+    result.insert(result.end(), buffer, buffer + (sizeof(buffer) - strm.avail_out));
+  } while (ret == Z_OK);
+  const bool complete = (ret == Z_STREAM_END) && (strm.avail_in == 0);
+  inflateEnd(&strm);
+  return complete;
+}
+
+int main()
+{
+  const std::vector<uint8_t> original = compressibleData<std::vector<uint8_t> >(3000000, 815);
+  const std::vector<std::size_t> sizes = { 0, 1, 32767, 65536, 65537, 200000, original.size() };
+  for (const Container container : { Container::zlib, Container::gzip })
+  {
+    for (const std::size_t size : sizes)
+    {
+      for (const int level : { 0, 1, 6, 9 })
+      {
+        // small blocks, so that there are many of them
+        std::vector<uint8_t> compressed;
+        if (!libstriezel::zlib::compressParallel(original.data(), size, compressed, container, level, 4, 65536))
+        {
+          std::cout << "Error: Could not compress " << size << " bytes with level " << level << "!" << std::endl;
+          return 1;
+        }
+        std::vector<uint8_t> decompressed;
+        if (!inflateAll(compressed, container, decompressed)
+            || (decompressed != std::vector<uint8_t>(original.begin(), original.begin() + size)))
+        {
+          std::cout << "Error: Compressed data of " << size << " bytes with level " << level
+                    << " does not decompress to the original data!" << std::endl;
+          return 1;
+        }
+      }
+    }
+  }
+
+  // The dictionaries keep the ratio close to the one of a single stream.
+  std::vector<uint8_t> parallel;
+  if (!libstriezel::zlib::compressParallel(original.data(), original.size(), parallel, Container::zlib, 6, 4, 65536))
+    return 1;
+  uLongf serialSize = compressBound(original.size());
+  std::vector<uint8_t> serial(serialSize);
+  if ((compress2(serial.data(), &serialSize, original.data(), original.size(), 6) != Z_OK)
+      || (parallel.size() > serialSize + serialSize / 50))
+  {
+    std::cout << "Error: Parallel compression needs " << parallel.size() << " bytes, but a single stream needs only "
+              << serialSize << " bytes!" << std::endl;
+    return 1;
+  }
+  // The existing decompression function handles the result, too.
+  std::vector<uint8_t> decompressed(original.size());
+  if (!libstriezel::zlib::decompress(parallel.data(), static_cast<uint32_t>(parallel.size()),
+                                     decompressed.data(), static_cast<uint32_t>(decompressed.size()))
+      || (decompressed != original))
+  {
+    std::cout << "Error: zlib::decompress() does not restore the original data!" << std::endl;
+    return 1;
+  }
+
+  // Invalid levels are rejected.
+  if (libstriezel::zlib::compressParallel(original.data(), 100, parallel, Container::zlib, 10))
+  {
+    std::cout << "Error: Compression level 10 was accepted!" << std::endl;
+    return 1;
+  }
+
+  // file to file, with sizes around the batch size of the file function
+  std::string sourceName;
+  std::string destName;
+  if (!libstriezel::filesystem::file::createTemp(sourceName) || !libstriezel::filesystem::file::createTemp(destName))
+  {
+    std::cout << "Error: Could not create temporary file!" << std::endl;
+    return 1;
+  }
+  int result = 0;
+  for (const std::size_t size : { std::size_t(0), std::size_t(5000), libstriezel::zlib::defaultBlockSize * 4,
+                                  original.size() })
+  {
+    {
+      std::ofstream stream(sourceName, std::ios::out | std::ios::binary | std::ios::trunc);
+      stream.write(reinterpret_cast<const char*>(original.data()), size);
+    }
+    libstriezel::filesystem::file::remove(destName);
+    if (!libstriezel::zlib::gzipFile(sourceName, destName, 6, 1))
+    {
+      std::cout << "Error: Could not compress file with " << size << " bytes!" << std::endl;
+      result = 1;
+      break;
+    }
+    std::ifstream stream(destName, std::ios::in | std::ios::binary);
+    const std::vector<uint8_t> compressed((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    stream.close();
+    std::vector<uint8_t> fileData;
+    if (!inflateAll(compressed, Container::gzip, fileData)
+        || (fileData != std::vector<uint8_t>(original.begin(), original.begin() + size)))
+    {
+      std::cout << "Error: Compressed file with " << size << " bytes does not decompress to the original data!" << std::endl;
+      result = 1;
+      break;
+    }
+    // Existing files are not overwritten.
+    if (libstriezel::zlib::gzipFile(sourceName, destName))
+    {
+      std::cout << "Error: Existing file " << destName << " was overwritten!" << std::endl;
+      result = 1;
+      break;
+    }
+  }
+  libstriezel::filesystem::file::remove(sourceName);
+  libstriezel::filesystem::file::remove(destName);
+  if (result != 0)
+    return result;
+
+  //Everything is OK.
+  std::cout << "Tests for libstriezel::zlib::compressParallel() were successful." << std::endl;
+  return 0;
+}
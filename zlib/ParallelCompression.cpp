@@ -0,0 +1,311 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#include "ParallelCompression.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <zlib.h>
+#include "../filesystem/file.hpp"
+
+namespace libstriezel::zlib
+{
+
+namespace
+{
+
+/// size of the window of deflate, i.e. the maximum distance of a match
+const std::size_t windowSize = 32768;
+
+/* Compresses one block as raw deflate data. Blocks that are not the last one
+   end with a sync flush, so that the next block starts at a byte boundary.
+   Returns true in case of success. */
+bool deflateBlock(z_stream& strm, const uint8_t * dictionary, const std::size_t dictionarySize,
+                  const uint8_t * data, const std::size_t size, const bool last, std::vector<uint8_t>& output)
+{
+  if (deflateReset(&strm) != Z_OK)
+    return false;
+  if ((dictionarySize > 0)
+      && (deflateSetDictionary(&strm, dictionary, static_cast<uInt>(dictionarySize)) != Z_OK))
+    return false;
+  // The bound does not cover the marker of the sync flush.
+  output.resize(deflateBound(&strm, static_cast<uLong>(size)) + 16);
+  strm.next_in = const_cast<Bytef*>(data);
+  strm.avail_in = static_cast<uInt>(size);
+  std::size_t used = 0;
+  int ret = Z_OK;
+  do
+  {
+    if (used == output.size())
+      output.resize(output.size() * 2);
+    strm.next_out = output.data() + used;
+    strm.avail_out = static_cast<uInt>(output.size() - used);
+    ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+    used = output.size() - strm.avail_out;
+    if ((ret != Z_OK) && (ret != Z_STREAM_END) && (ret != Z_BUF_ERROR))
+      return false;
+  } while (last ? (ret != Z_STREAM_END) : (strm.avail_out == 0));
+  output.resize(used);
+  return true;
+}
+
+/* Compresses data in blocks on several threads and appends the raw deflate
+   data to result. The dictionarySize bytes in front of data are the
+   dictionary of the first block. With last set, the final block ends the
+   deflate stream. check is updated with the checksum of the data. */
+bool deflateBlocks(const uint8_t * data, const std::size_t size, const std::size_t dictionarySize,
+                   const bool last, const int level, unsigned int threads, const std::size_t blockSize,
+                   const Container container, uLong& check, std::vector<uint8_t>& result)
+{
+  // Even empty data needs a block to end the stream.
+  const std::size_t count = std::max<std::size_t>(1, (size + blockSize - 1) / blockSize);
+  std::vector<std::vector<uint8_t> > outputs(count);
+  std::vector<uLong> checks(count, 0);
+  std::vector<char> success(count, 0);
+  threads = static_cast<unsigned int>(std::min<std::size_t>(threads, count));
+
+  std::atomic<std::size_t> next(0);
+  // Every worker takes the next block until there are no more.
+  const auto work = [&]()
+  {
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    // negative window bits: raw deflate data without header and trailer
+    if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      return;
+    std::size_t current = next++;
+    while (current < count)
+    {
+      const std::size_t start = current * blockSize;
+      const std::size_t length = std::min(blockSize, size - std::min(start, size));
+      // The end of the previous block is the dictionary.
+      const std::size_t dictionaryLength = std::min(windowSize, start + dictionarySize);
+      if (container == Container::gzip)
+        checks[current] = crc32(0, data + start, static_cast<uInt>(length));
+      else
+        checks[current] = adler32(1, data + start, static_cast<uInt>(length));
+      success[current] = deflateBlock(strm, data + start - dictionaryLength, dictionaryLength, data + start,
+                                      length, last && (current + 1 == count), outputs[current]) ? 1 : 0;
+      current = next++;
+    }
+    deflateEnd(&strm);
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int i = 1; i < threads; ++i)
+  {
+    workers.push_back(std::thread(work));
+  }
+  // The calling thread compresses blocks, too.
+  work();
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (success[i] == 0)
+      return false;
+    const std::size_t length = std::min(blockSize, size - std::min(i * blockSize, size));
+    if (container == Container::gzip)
+      check = crc32_combine(check, checks[i], static_cast<z_off_t>(length));
+    else
+      check = adler32_combine(check, checks[i], static_cast<z_off_t>(length));
+    result.insert(result.end(), outputs[i].begin(), outputs[i].end());
+  }
+  return true;
+}
+
+/* Appends the header of the container. */
+void putHeader(std::vector<uint8_t>& result, const Container container, const int level)
+{
+  if (container == Container::gzip)
+  {
+    // no name, no time stamp, extra flags like zlib, unknown operating system
+    const uint8_t extraFlags = (level == 9) ? 2 : ((level < 2) ? 4 : 0);
+    const uint8_t header[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, extraFlags, 255 };
+    result.insert(result.end(), header, header + sizeof(header));
+    return;
+  }
+  // 32 KiB window, the level flags like zlib, and a multiple of 31
+  const unsigned int levelFlags = (level < 2) ? 0 : ((level < 6) ? 1 : ((level == 6) ? 2 : 3));
+  unsigned int header = (0x78 << 8) | (levelFlags << 6);
+  header += 31 - (header % 31);
+  result.push_back(static_cast<uint8_t>(header >> 8));
+  result.push_back(static_cast<uint8_t>(header & 0xFF));
+}
+
+/* Appends the trailer of the container. */
+void putTrailer(std::vector<uint8_t>& result, const Container container, const uLong check, const uint64_t size)
+{
+  if (container == Container::gzip)
+  {
+    // CRC-32 and size modulo 2^32, both in little endian byte order
+    for (unsigned int i = 0; i < 4; ++i)
+      result.push_back(static_cast<uint8_t>((check >> (8 * i)) & 0xFF));
+    for (unsigned int i = 0; i < 4; ++i)
+      result.push_back(static_cast<uint8_t>((size >> (8 * i)) & 0xFF));
+    return;
+  }
+  // Adler-32 in big endian byte order
+  for (int i = 3; i >= 0; --i)
+    result.push_back(static_cast<uint8_t>((check >> (8 * i)) & 0xFF));
+}
+
+/* Checks the compression level and the block size, and determines the
+   number of threads. Returns false, if a value is invalid. */
+bool prepare(int& level, unsigned int& threads, const std::size_t blockSize, const char * caller)
+{
+  if (level == Z_DEFAULT_COMPRESSION)
+    level = 6;
+  if ((level < 0) || (level > 9))
+  {
+    std::cerr << "zlib::" << caller << ": Error: " << level << " is not a valid compression level!\n";
+    return false;
+  }
+  if ((blockSize == 0) || (blockSize > UINT32_MAX / 2))
+  {
+    std::cerr << "zlib::" << caller << ": Error: " << blockSize << " is not a valid block size!\n";
+    return false;
+  }
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  return true;
+}
+
+} // anonymous namespace
+
+bool compressParallel(const uint8_t * rawData, const std::size_t rawSize, std::vector<uint8_t>& result,
+                      const Container container, const int level, const unsigned int threads,
+                      const std::size_t blockSize)
+{
+  result.clear();
+  int actualLevel = level;
+  unsigned int actualThreads = threads;
+  if (!prepare(actualLevel, actualThreads, blockSize, "compressParallel"))
+    return false;
+  if ((rawData == nullptr) && (rawSize != 0))
+  {
+    std::cerr << "zlib::compressParallel: Error: Invalid buffer values given!\n";
+    return false;
+  }
+
+  putHeader(result, container, actualLevel);
+  uLong check = (container == Container::gzip) ? crc32(0, Z_NULL, 0) : adler32(0, Z_NULL, 0);
+  if (!deflateBlocks(rawData, rawSize, 0, true, actualLevel, actualThreads, blockSize, container, check, result))
+  {
+    std::cerr << "zlib::compressParallel: Error while calling deflate()!\n";
+    result.clear();
+    return false;
+  }
+  putTrailer(result, container, check, rawSize);
+  return true;
+}
+
+bool gzipFile(const std::string& sourceFileName, const std::string& destFileName,
+              const int level, const unsigned int threads)
+{
+  int actualLevel = level;
+  unsigned int actualThreads = threads;
+  if (!prepare(actualLevel, actualThreads, defaultBlockSize, "gzipFile"))
+    return false;
+  /* Check whether destination file already exists, we do not want to overwrite
+     existing files. */
+  if (libstriezel::filesystem::file::exists(destFileName))
+  {
+    std::cerr << "zlib::gzipFile: Error: Destination file " << destFileName << " already exists!\n";
+    return false;
+  }
+  std::ifstream source(sourceFileName, std::ios_base::in | std::ios_base::binary);
+  if (!source.good())
+  {
+    std::cerr << "zlib::gzipFile: Error: Could not open file " << sourceFileName << "!\n";
+    return false;
+  }
+  std::ofstream destination(destFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!destination.good())
+  {
+    std::cerr << "zlib::gzipFile: Error: Could not create file " << destFileName << "!\n";
+    return false;
+  }
+
+  // A few blocks per thread in each batch keep all threads busy.
+  const std::size_t batchSize = defaultBlockSize * 4 * actualThreads;
+  // The end of the previous batch is kept in front of the next one as
+  // dictionary of its first block.
+  std::vector<uint8_t> input(windowSize + batchSize);
+  std::size_t dictionarySize = 0;
+  std::vector<uint8_t> output;
+  putHeader(output, Container::gzip, actualLevel);
+  uLong check = crc32(0, Z_NULL, 0);
+  uint64_t totalSize = 0;
+  bool last = false;
+  bool success = true;
+  while (!last)
+  {
+    source.read(reinterpret_cast<char*>(input.data() + dictionarySize), static_cast<std::streamsize>(batchSize));
+    const std::size_t size = static_cast<std::size_t>(source.gcount());
+    if (source.bad())
+    {
+      std::cerr << "zlib::gzipFile: Error: Could not read from file " << sourceFileName << "!\n";
+      success = false;
+      break;
+    }
+    last = size < batchSize;
+    if (!deflateBlocks(input.data() + dictionarySize, size, dictionarySize, last, actualLevel,
+                       actualThreads, defaultBlockSize, Container::gzip, check, output))
+    {
+      std::cerr << "zlib::gzipFile: Error while calling deflate()!\n";
+      success = false;
+      break;
+    }
+    totalSize += size;
+    if (last)
+      putTrailer(output, Container::gzip, check, totalSize);
+    destination.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(output.size()));
+    if (!destination.good())
+    {
+      std::cerr << "zlib::gzipFile: Error: Could not write to file " << destFileName << "!\n";
+      success = false;
+      break;
+    }
+    output.clear();
+    // Keep the last 32 KiB as dictionary for the next batch.
+    const std::size_t available = dictionarySize + size;
+    const std::size_t keep = std::min(windowSize, available);
+    std::memmove(input.data(), input.data() + available - keep, keep);
+    dictionarySize = keep;
+  }
+  destination.close();
+  if (!success || !destination.good())
+  {
+    libstriezel::filesystem::file::remove(destFileName);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
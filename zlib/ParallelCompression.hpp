@@ -0,0 +1,84 @@
+/*
+ -----------------------------------------------------------------------------
+    This file is part of the striezel's common code library.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------
+*/
+
+#ifndef LIBSTRIEZEL_PARALLELCOMPRESSION_HPP
+#define LIBSTRIEZEL_PARALLELCOMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace libstriezel::zlib
+{
+
+/** \brief enumeration of the containers around the deflate data */
+enum class Container
+{
+  zlib, /**< zlib stream as created by compress(), with Adler-32 checksum */
+  gzip  /**< gzip file with a single member, with CRC-32 checksum */
+};
+
+
+/// default size of the blocks that are compressed on separate threads
+const std::size_t defaultBlockSize = 128 * 1024;
+
+
+/** Compresses data on several threads into a single zlib or gzip stream.
+ *
+ * \param rawData    pointer to the buffer containing the uncompressed data
+ * \param rawSize    length of the buffer in bytes
+ * \param result     vector that will hold the compressed data
+ * \param container  the container of the compressed data
+ * \param level      compression level, should be in [0;9], where 0 is no
+ *                   compression and 9 is best compression
+ * \param threads    number of threads to use, zero means one thread per
+ *                   processor core
+ * \param blockSize  size of the blocks in bytes that are compressed on
+ *                   separate threads
+ * \return Returns true in case of success, or false if an error occurred.
+ * \remarks Like pigz, every block is compressed with the last 32 KiB of the
+ * block in front of it as dictionary, so the compression ratio is almost the
+ * same as with a single thread. The blocks are joined into one deflate
+ * stream, which any zlib or gzip implementation can decompress.
+ */
+bool compressParallel(const uint8_t * rawData, const std::size_t rawSize, std::vector<uint8_t>& result,
+                      const Container container, const int level = 6, const unsigned int threads = 0,
+                      const std::size_t blockSize = defaultBlockSize);
+
+
+/** Compresses a file into a gzip file on several threads.
+ *
+ * \param sourceFileName  name of the file to compress
+ * \param destFileName    name of the gzip file - file must not exist yet
+ * \param level           compression level, should be in [0;9], where 0 is
+ *                        no compression and 9 is best compression
+ * \param threads         number of threads to use, zero means one thread per
+ *                        processor core
+ * \return Returns true in case of success, or false if an error occurred.
+ * \remarks The file is read and compressed in batches of blocks, so the
+ * memory use does not depend on the size of the file.
+ */
+bool gzipFile(const std::string& sourceFileName, const std::string& destFileName,
+              const int level = 6, const unsigned int threads = 0);
+
+} // namespace
+
+#endif // LIBSTRIEZEL_PARALLELCOMPRESSION_HPP